@@ -0,0 +1,195 @@
+/***********************************************************************
+ * Source File:
+ *    ALLOCATION TRACKING
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The replacement operator new and delete behind ALLOC_SCOPE, and
+ *    the report of what they counted. Without ALLOC_TRACKING the
+ *    standard operators are left alone and the report is empty.
+ ************************************************************************/
+
+#include "allocTrack.h"
+#include <cstdio>     // for FPRINTF, which does not allocate
+#include <cstdlib>    // for MALLOC
+#include <mutex>      // for MUTEX
+#include <new>        // for BAD_ALLOC
+using namespace std;
+
+// allocations made outside any scope
+static AllocSite siteOther(ALLOC_OTHER, "(no scope)");
+
+// the site allocations on this thread are charged to, or null
+static thread_local AllocSite* pSiteCurrent = nullptr;
+
+// every site that has been used, newest first
+static AllocSite* pSites = nullptr;
+static mutex      mutexSites;
+
+static const char* SUBSYSTEM_NAMES[ALLOC_NUM_SUBSYSTEMS] =
+{
+   "other", "move generation", "board update", "rendering", "parsing"
+};
+
+/***************************************************
+ * REGISTER
+ * Put a site on the list the first time it is used
+ ***************************************************/
+static void registerSite(AllocSite& site)
+{
+   if (site.isRegistered.load(memory_order_acquire))
+      return;
+   lock_guard<mutex> lock(mutexSites);
+   if (site.isRegistered.load(memory_order_relaxed))
+      return;
+   site.pNext = pSites;
+   pSites = &site;
+   site.isRegistered.store(true, memory_order_release);
+}
+
+/***************************************************
+ * ALLOC SCOPE : CONSTRUCT and DESTRUCT
+ ***************************************************/
+AllocScope::AllocScope(AllocSite& site) : pSitePrevious(pSiteCurrent)
+{
+   registerSite(site);
+   pSiteCurrent = &site;
+}
+
+AllocScope::~AllocScope()
+{
+   pSiteCurrent = pSitePrevious;
+}
+
+/***************************************************
+ * GET ALLOC TOTALS
+ ***************************************************/
+void getAllocTotals(size_t& numAllocs, size_t& numBytes)
+{
+   registerSite(siteOther);
+   lock_guard<mutex> lock(mutexSites);
+   numAllocs = 0;
+   numBytes = 0;
+   for (AllocSite* p = pSites; p; p = p->pNext)
+   {
+      numAllocs += p->numAllocs.load(memory_order_relaxed);
+      numBytes  += p->numBytes.load(memory_order_relaxed);
+   }
+}
+
+/***************************************************
+ * REPORT ALLOCATIONS
+ * Subsystems first, then every site by bytes. Live
+ * is what was allocated there and is not yet freed
+ ***************************************************/
+void reportAllocations()
+{
+   registerSite(siteOther);
+   lock_guard<mutex> lock(mutexSites);
+
+   // copy the list so it can be sorted without allocating
+   const int MAX_SITES = 256;
+   AllocSite* sites[MAX_SITES];
+   int numSites = 0;
+   for (AllocSite* p = pSites; p && numSites < MAX_SITES; p = p->pNext)
+      sites[numSites++] = p;
+   for (int i = 1; i < numSites; i++)
+      for (int j = i; j > 0 && sites[j]->numBytes > sites[j - 1]->numBytes; j--)
+      {
+         AllocSite* pTemp = sites[j];
+         sites[j] = sites[j - 1];
+         sites[j - 1] = pTemp;
+      }
+
+   fprintf(stderr, "\nAllocations by subsystem:\n");
+   fprintf(stderr, "   %-32s %12s %12s %14s %12s\n",
+           "subsystem", "allocs", "frees", "bytes", "live bytes");
+   for (int s = 0; s < ALLOC_NUM_SUBSYSTEMS; s++)
+   {
+      size_t allocs = 0, frees = 0, bytes = 0, freed = 0;
+      for (int i = 0; i < numSites; i++)
+         if (sites[i]->subsystem == s)
+         {
+            allocs += sites[i]->numAllocs;
+            frees  += sites[i]->numFrees;
+            bytes  += sites[i]->numBytes;
+            freed  += sites[i]->numBytesFreed;
+         }
+      fprintf(stderr, "   %-32s %12zu %12zu %14zu %12zu\n",
+              SUBSYSTEM_NAMES[s], allocs, frees, bytes, bytes - freed);
+   }
+
+   fprintf(stderr, "\nAllocations by site:\n");
+   fprintf(stderr, "   %-32s %12s %12s %14s %12s\n",
+           "site", "allocs", "frees", "bytes", "live bytes");
+   for (int i = 0; i < numSites; i++)
+      if (sites[i]->numAllocs)
+         fprintf(stderr, "   %-32s %12zu %12zu %14zu %12zu\n",
+                 sites[i]->name,
+                 sites[i]->numAllocs.load(), sites[i]->numFrees.load(),
+                 sites[i]->numBytes.load(),
+                 sites[i]->numBytes.load() - sites[i]->numBytesFreed.load());
+}
+
+#ifdef ALLOC_TRACKING
+
+/***************************************************
+ * HEADER
+ * In front of every block: where it was allocated
+ * and how big it is. Sixteen bytes, so the block
+ * keeps malloc's alignment
+ ***************************************************/
+struct Header
+{
+   AllocSite* pSite;
+   size_t     size;
+};
+static_assert(sizeof(Header) == 16, "the header must keep the alignment");
+
+/***************************************************
+ * ALLOC REPORTER
+ * Print the report as the program exits. Sites are
+ * constant-initialized, so they outlive this. static
+ * does not hide a class name, so its name must differ
+ * from the trace reporter's
+ ***************************************************/
+static struct AllocReporter
+{
+   ~AllocReporter() { reportAllocations(); }
+} allocReporter;
+
+/***************************************************
+ * OPERATOR NEW and DELETE
+ ***************************************************/
+void* operator new(size_t size)
+{
+   AllocSite* pSite = pSiteCurrent ? pSiteCurrent : &siteOther;
+   if (pSite == &siteOther)
+      registerSite(siteOther);
+
+   Header* pHeader = (Header*)malloc(sizeof(Header) + size);
+   if (pHeader == nullptr)
+      throw bad_alloc();
+   pHeader->pSite = pSite;
+   pHeader->size = size;
+   pSite->numAllocs.fetch_add(1, memory_order_relaxed);
+   pSite->numBytes.fetch_add(size, memory_order_relaxed);
+   return pHeader + 1;
+}
+
+void operator delete(void* p) noexcept
+{
+   if (p == nullptr)
+      return;
+   Header* pHeader = (Header*)p - 1;
+   pHeader->pSite->numFrees.fetch_add(1, memory_order_relaxed);
+   pHeader->pSite->numBytesFreed.fetch_add(pHeader->size, memory_order_relaxed);
+   free(pHeader);
+}
+
+void* operator new[](size_t size)                 { return operator new(size); }
+void  operator delete[](void* p) noexcept         { operator delete(p); }
+void  operator delete(void* p, size_t) noexcept   { operator delete(p); }
+void  operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+#endif // ALLOC_TRACKING
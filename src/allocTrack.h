@@ -0,0 +1,93 @@
+/***********************************************************************
+ * Header File:
+ *    ALLOCATION TRACKING
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    An instrumented build that counts every heap allocation, who made
+ *    it, and who freed it. Compile everything with -DALLOC_TRACKING to
+ *    turn it on; otherwise ALLOC_SCOPE is nothing and costs nothing.
+ *
+ *    Code that allocates names itself with ALLOC_SCOPE:
+ *
+ *       void Pawn::getMoves(set <Move>& moves, const Board& board) const
+ *       {
+ *          ALLOC_SCOPE(ALLOC_MOVEGEN, "Pawn::getMoves");
+ *          ...
+ *
+ *    Until the scope ends, allocations on that thread are charged to
+ *    that call site and its subsystem; the innermost scope wins. When
+ *    the block is freed, the free is charged to the same site, even if
+ *    some other code frees it. The totals are printed at exit.
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/***************************************************
+ * ALLOC SUBSYSTEM
+ * The parts of the program allocations are charged to
+ ***************************************************/
+enum AllocSubsystem
+{
+   ALLOC_OTHER,       // outside any scope
+   ALLOC_MOVEGEN,     // move generation and the game state
+   ALLOC_BOARD,       // changing the pieces on the board
+   ALLOC_RENDER,      // drawing
+   ALLOC_PARSE,       // reading and writing moves, FEN, and PGN
+   ALLOC_NUM_SUBSYSTEMS
+};
+
+/***************************************************
+ * ALLOC SITE
+ * One place allocations are charged to. Sites are
+ * statics that are never destroyed, so they can
+ * still be read while the program exits
+ ***************************************************/
+struct AllocSite
+{
+   constexpr AllocSite(AllocSubsystem subsystem, const char* name) :
+      subsystem(subsystem), name(name), numAllocs(0), numFrees(0),
+      numBytes(0), numBytesFreed(0), isRegistered(false), pNext(nullptr) {}
+
+   AllocSubsystem           subsystem;
+   const char*              name;
+   std::atomic<size_t>      numAllocs;
+   std::atomic<size_t>      numFrees;
+   std::atomic<size_t>      numBytes;
+   std::atomic<size_t>      numBytesFreed;
+   std::atomic<bool>        isRegistered;  // on the list of every site
+   AllocSite*               pNext;
+};
+
+/***************************************************
+ * ALLOC SCOPE
+ * Charge this thread's allocations to a site
+ * until the scope ends
+ ***************************************************/
+class AllocScope
+{
+public:
+   AllocScope(AllocSite& site);
+   ~AllocScope();
+private:
+   AllocSite* pSitePrevious;
+};
+
+// every allocation so far, wherever it was made
+void getAllocTotals(size_t& numAllocs, size_t& numBytes);
+
+// print the totals by subsystem and by site. This happens at exit too
+void reportAllocations();
+
+#ifdef ALLOC_TRACKING
+#define ALLOC_CONCAT2(a, b) a##b
+#define ALLOC_CONCAT(a, b)  ALLOC_CONCAT2(a, b)
+#define ALLOC_SCOPE(subsystem, name)                                       \
+   static AllocSite ALLOC_CONCAT(allocSite, __LINE__)(subsystem, name);    \
+   AllocScope ALLOC_CONCAT(allocScope, __LINE__)(ALLOC_CONCAT(allocSite, __LINE__))
+#else
+#define ALLOC_SCOPE(subsystem, name) ((void)0)
+#endif
@@ -0,0 +1,146 @@
+/***********************************************************************
+ * Source File:
+ *    ANALYSIS
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The background worker that searches the position on the board
+ ************************************************************************/
+
+#include "analysis.h"
+#include "board.h"           // for BOARD
+#include "boardSnapshot.h"   // for BOARD SNAPSHOT
+#include "pgn.h"             // for MOVE TO SAN
+#include "search.h"          // for SEARCH
+#include <cstdio>            // for SNPRINTF
+using namespace std;
+
+// deeper than the search will reach before the player moves
+const int ANALYSIS_MAX_DEPTH = 32;
+
+/*************************************
+ * FORMAT STATUS
+ * The best move, the score from white's point of view
+ * in pawns or as a mate, and the depth
+ **************************************/
+static string formatStatus(const Board& board, const SearchResult& result)
+{
+   int score = board.whiteTurn() ? result.score : -result.score;
+   char text[32];
+   if (Search::isMateScore(score))
+   {
+      int moves = Search::getMateMoves(result.score);
+      snprintf(text, sizeof(text), "%s#%d", score > 0 ? "" : "-",
+               moves > 0 ? moves : -moves);
+   }
+   else
+      snprintf(text, sizeof(text), "%+.2f", score / 100.0);
+
+   return moveToSan(board, result.bestMove) + "  " + text +
+          "  depth " + to_string(result.depth);
+}
+
+/*************************************
+ * ANALYSIS : CONSTRUCT
+ **************************************/
+Analysis::Analysis() :
+   pSearch(nullptr),
+   isQuitting(false),
+   worker(&Analysis::work, this)
+{
+}
+
+/*************************************
+ * ANALYSIS : DESTRUCT
+ * Stop the search and wait for the worker to leave
+ **************************************/
+Analysis::~Analysis()
+{
+   {
+      lock_guard<mutex> lock(mutexAnalysis);
+      isQuitting = true;
+      if (pSearch)
+         pSearch->stop();
+   }
+   cvWork.notify_one();
+   worker.join();
+}
+
+/*************************************
+ * ANALYSIS : START
+ * Hand the worker a new position. If it is searching,
+ * it drops that search and picks this one up
+ **************************************/
+void Analysis::start(shared_ptr<const BoardSnapshot> pSnapshot,
+                     const vector<uint64_t>& history)
+{
+   {
+      lock_guard<mutex> lock(mutexAnalysis);
+      pSnapshotNext = pSnapshot;
+      historyNext   = history;
+      if (pSearch)
+         pSearch->stop();
+      status.clear();
+   }
+   cvWork.notify_one();
+}
+
+/*************************************
+ * ANALYSIS : STOP
+ **************************************/
+void Analysis::stop()
+{
+   lock_guard<mutex> lock(mutexAnalysis);
+   pSnapshotNext.reset();
+   if (pSearch)
+      pSearch->stop();
+   status.clear();
+}
+
+/*************************************
+ * ANALYSIS : GET STATUS
+ **************************************/
+string Analysis::getStatus() const
+{
+   lock_guard<mutex> lock(mutexAnalysis);
+   return status;
+}
+
+/*************************************
+ * ANALYSIS : WORK
+ * Wait for a position, search it, and repeat. Only the
+ * search that is still current may write the status;
+ * one that has been stopped is already out of date
+ **************************************/
+void Analysis::work()
+{
+   unique_lock<mutex> lock(mutexAnalysis);
+   while (true)
+   {
+      cvWork.wait(lock, [this] { return isQuitting || pSnapshotNext; });
+      if (isQuitting)
+         return;
+
+      shared_ptr<const BoardSnapshot> pSnapshot = pSnapshotNext;
+      vector<uint64_t> history;
+      history.swap(historyNext);
+      pSnapshotNext.reset();
+      Search search;
+      pSearch = &search;
+      lock.unlock();
+
+      Board board;
+      board.readFEN(pSnapshot->getFEN());
+      board.setHistory(history);
+      search.run(board, ANALYSIS_MAX_DEPTH, [&](const SearchResult& result)
+      {
+         string text = formatStatus(board, result);
+         lock_guard<mutex> lockStatus(mutexAnalysis);
+         if (!search.isStopped())
+            status = text;
+      });
+
+      lock.lock();
+      pSearch = nullptr;
+   }
+}
@@ -0,0 +1,64 @@
+/***********************************************************************
+ * Header File:
+ *    ANALYSIS
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Search the position on the board in the background while the
+ *    player thinks. A worker thread waits for a snapshot, searches it
+ *    deeper and deeper, and after each depth writes a line of status
+ *    such as "Nf3  +0.35  depth 4". The drawing thread reads the status
+ *    each frame and never waits for the search. The keys of the recent
+ *    positions come with the snapshot, so the search sees repetitions.
+ *
+ *    Starting on a new position stops the search of the old one. The
+ *    search checks for that at every node, so the worker moves on to the
+ *    new position within a millisecond or so.
+ ************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class BoardSnapshot;
+class Search;
+
+/***************************************************
+ * ANALYSIS
+ * A worker that searches the latest position
+ ***************************************************/
+class Analysis
+{
+public:
+   Analysis();
+   ~Analysis();
+
+   // search this position, dropping any search already running. The
+   // history is Board::getHistory() of the same position
+   void start(std::shared_ptr<const BoardSnapshot> pSnapshot,
+              const std::vector<uint64_t>& history);
+
+   // stop searching and clear the status
+   void stop();
+
+   // the best move, score, and depth found so far, or an empty string
+   std::string getStatus() const;
+
+private:
+   void work();
+
+   mutable std::mutex                   mutexAnalysis;
+   std::condition_variable              cvWork;
+   std::shared_ptr<const BoardSnapshot> pSnapshotNext; // waiting to be searched
+   std::vector<uint64_t>                historyNext;   // and the keys before it
+   Search*                              pSearch;       // running, or nullptr
+   std::string                          status;
+   bool                                 isQuitting;
+   std::thread                          worker;        // started last
+};
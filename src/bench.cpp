@@ -0,0 +1,563 @@
+/***********************************************************************
+ * Source File:
+ *    BENCH
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Microbenchmarks for the building blocks of the game: positions,
+ *    moves, move generation, and check detection. Usage:
+ *       chessBench [options] [name...]
+ *          -samples N   timed samples of each benchmark (15)
+ *          -time MS     length of one sample in milliseconds (20)
+ *          -json FILE   also write the results as JSON
+ *          -list        name the benchmarks
+ *    Only the benchmarks whose names contain one of the names given
+ *    are run. Each reports the median time per operation over the
+ *    samples along with the spread, and the heap allocations per
+ *    operation counted by a replacement operator new.
+ ************************************************************************/
+
+#include "position.h"    // for POSITION
+#include "move.h"        // for MOVE
+#include "piece.h"       // for PIECE
+#include "board.h"       // for BOARD
+#include "evaluate.h"    // for EVALUATE and EVALUATE BATCH
+#include "allocTrack.h"  // for the counts in an ALLOC_TRACKING build
+#include <algorithm>     // for SORT
+#include <atomic>        // for ATOMIC
+#include <chrono>        // for STEADY_CLOCK
+#include <cmath>         // for SQRT
+#include <cstdlib>       // for MALLOC and ATOI
+#include <fstream>       // for OFSTREAM
+#include <iomanip>       // for SETW
+#include <iostream>      // for COUT
+#include <new>           // for BAD_ALLOC
+#include <set>           // for SET
+#include <string>        // for STRING
+#include <vector>        // for VECTOR
+using namespace std;
+
+/*************************************
+ * ALLOCATION COUNTING
+ * Every allocation in the program goes through
+ * these, so a benchmark's allocations are the
+ * difference in the counts across it. An
+ * ALLOC_TRACKING build has its own operator new
+ * and keeps the counts for us
+ **************************************/
+#ifdef ALLOC_TRACKING
+static void countAllocations(size_t& numAllocs, size_t& numBytes)
+{
+   getAllocTotals(numAllocs, numBytes);
+}
+#else // !ALLOC_TRACKING
+static atomic<size_t> numAllocations(0);
+static atomic<size_t> numBytesAllocated(0);
+
+// Inlined into a caller that also holds the other half, a malloc and
+// a free look mismatched to GCC, which warns. Out of line, the caller
+// sees only operator new and the matching operator delete
+#if defined(__GNUC__) || defined(__clang__)
+#define ALLOC_OUT_OF_LINE __attribute__((noinline))
+#else
+#define ALLOC_OUT_OF_LINE
+#endif
+
+ALLOC_OUT_OF_LINE void* operator new(size_t size)
+{
+   numAllocations.fetch_add(1, memory_order_relaxed);
+   numBytesAllocated.fetch_add(size, memory_order_relaxed);
+   void* p = malloc(size ? size : 1);
+   if (p == nullptr)
+      throw bad_alloc();
+   return p;
+}
+ALLOC_OUT_OF_LINE void operator delete(void* p) noexcept
+{
+   free(p);
+}
+
+// the other forms go through the two above, so each pointer is freed
+// by the same pair of functions that allocated it
+ALLOC_OUT_OF_LINE void* operator new[](size_t size)                 { return operator new(size); }
+ALLOC_OUT_OF_LINE void  operator delete[](void* p) noexcept         { operator delete(p); }
+ALLOC_OUT_OF_LINE void  operator delete(void* p, size_t) noexcept   { operator delete(p); }
+ALLOC_OUT_OF_LINE void  operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+static void countAllocations(size_t& numAllocs, size_t& numBytes)
+{
+   numAllocs = numAllocations.load();
+   numBytes  = numBytesAllocated.load();
+}
+#endif // !ALLOC_TRACKING
+
+/*************************************
+ * KEEP
+ * Make the compiler believe a value is used, so
+ * the work that produced it is not optimized away
+ **************************************/
+template <class T>
+static void keep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   asm volatile("" : : "r"(&value) : "memory");
+#else
+   static const void* volatile sink;
+   sink = &value;
+#endif
+}
+
+// a middle game with every kind of piece able to move
+const char* FEN_MIDDLE =
+   "r1bqk2r/pp2bppp/2n1pn2/2pp4/2PP4/2N1PN2/PP2BPPP/R1BQK2R w KQkq - 0 7";
+
+// white's queen on h5 has black in check
+const char* FEN_CHECK =
+   "rnbqkbnr/ppppp1pp/5p2/7Q/4P3/8/PPPP1PPP/RNB1KBNR b KQkq - 1 2";
+
+// offsets for the position arithmetic
+const Delta DELTAS[8] =
+{
+   { 1, 2 }, { 2, 1 }, { 2, -1 }, { 1, -2 },
+   { -1, -2 }, { -2, -1 }, { -2, 1 }, { -1, 2 }
+};
+
+// moves in the text form Move::read() takes
+const char* MOVE_TEXT[8] =
+{
+   "e2e4", "g8f6", "e7e8Q", "a7b8r", "e5f6E", "e1g1c", "e1c1C", "d4e5p"
+};
+
+/*************************************
+ * POSITION BENCHMARKS
+ **************************************/
+static void benchPositionAdd(size_t numOps)
+{
+   for (size_t i = 0; i < numOps; i++)
+   {
+      Position pos((int)(i & 63));
+      pos += DELTAS[i & 7];
+      keep(pos);
+   }
+}
+
+static void benchPositionSetLocation(size_t numOps)
+{
+   Position pos;
+   for (size_t i = 0; i < numOps; i++)
+   {
+      pos.setLocation((int)(i & 63));
+      keep(pos);
+   }
+}
+
+static void benchPositionGetColRow(size_t numOps)
+{
+   Position positions[64];
+   for (int i = 0; i < 64; i++)
+      positions[i].setLocation(i);
+   int sum = 0;
+   for (size_t i = 0; i < numOps; i++)
+   {
+      sum += positions[i & 63].getCol() + positions[i & 63].getRow();
+      keep(sum);
+   }
+}
+
+/*************************************
+ * MOVE BENCHMARKS
+ **************************************/
+static void benchMoveConstruct(size_t numOps)
+{
+   for (size_t i = 0; i < numOps; i++)
+   {
+      Move move;
+      keep(move);
+   }
+}
+
+static void benchMoveRead(size_t numOps)
+{
+   vector<string> text(MOVE_TEXT, MOVE_TEXT + 8);
+   Move move;
+   for (size_t i = 0; i < numOps; i++)
+   {
+      move.read(text[i & 7]);
+      keep(move);
+   }
+}
+
+static void benchMoveGetText(size_t numOps)
+{
+   vector<Move> moves;
+   for (const char* text : MOVE_TEXT)
+      moves.push_back(Move(text));
+   for (size_t i = 0; i < numOps; i++)
+   {
+      string text = moves[i & 7].getText();
+      keep(text);
+   }
+}
+
+/*************************************
+ * GET MOVES
+ * The moves of the piece on one square of the
+ * middle game, collected into a fresh set
+ **************************************/
+static void benchGetMoves(size_t numOps, const char* square)
+{
+   Board board;
+   board.readFEN(FEN_MIDDLE);
+   const Piece& piece = board[Position(square)];
+   for (size_t i = 0; i < numOps; i++)
+   {
+      set<Move> moves;
+      piece.getMoves(moves, board);
+      keep(moves);
+   }
+}
+
+static void benchPawnGetMoves(size_t numOps)   { benchGetMoves(numOps, "e3"); }
+static void benchKnightGetMoves(size_t numOps) { benchGetMoves(numOps, "f3"); }
+static void benchBishopGetMoves(size_t numOps) { benchGetMoves(numOps, "e2"); }
+static void benchRookGetMoves(size_t numOps)   { benchGetMoves(numOps, "h1"); }
+static void benchQueenGetMoves(size_t numOps)  { benchGetMoves(numOps, "d1"); }
+static void benchKingGetMoves(size_t numOps)   { benchGetMoves(numOps, "e1"); }
+
+/*************************************
+ * BOARD MOVE
+ * Knights going out and back, so the board never
+ * needs to be set up again. The game state of
+ * each new position is part of the cost
+ **************************************/
+static void benchBoardMove(size_t numOps)
+{
+   Board board;
+   const Move moves[4] = { Move("g1f3"), Move("g8f6"), Move("f3g1"), Move("f6g8") };
+   for (size_t i = 0; i < numOps; i++)
+      board.move(moves[i & 3]);
+   keep(board);
+}
+
+/*************************************
+ * CHECK DETECTION
+ * Asked of the side that is not to move, so the
+ * answer is worked out rather than cached
+ **************************************/
+static void benchIsInCheck(size_t numOps)
+{
+   Board board;
+   board.readFEN(FEN_CHECK);
+   board.getGameState();
+   for (size_t i = 0; i < numOps; i++)
+   {
+      bool check = board.isInCheck(true);
+      keep(check);
+   }
+}
+
+/*************************************
+ * ATTACK MAP
+ * Every square one side attacks, as an evaluation
+ * would want it
+ **************************************/
+static void benchAttackMap(size_t numOps)
+{
+   Board board;
+   board.readFEN(FEN_CHECK);
+   for (size_t i = 0; i < numOps; i++)
+   {
+      Bitboard attacks = board.getAttackMap(i & 1);
+      keep(attacks);
+   }
+}
+
+static void benchIsInCheckmate(size_t numOps)
+{
+   Board board;
+   board.readFEN(FEN_MIDDLE);
+   board.getGameState();
+   for (size_t i = 0; i < numOps; i++)
+   {
+      bool mate = board.isInCheckmate(false);
+      keep(mate);
+   }
+}
+
+static void benchWouldLeaveInCheck(size_t numOps)
+{
+   Board board;
+   board.readFEN(FEN_CHECK);
+   const Move moves[2] = { Move("g7g6"), Move("a7a6") };
+   for (size_t i = 0; i < numOps; i++)
+   {
+      bool inCheck = board.wouldMoveLeaveKingInCheck(moves[i & 1], false);
+      keep(inCheck);
+   }
+}
+
+static void benchGameState(size_t numOps)
+{
+   Board board;
+   board.readFEN(FEN_MIDDLE);
+   for (size_t i = 0; i < numOps; i++)
+   {
+      board.readFEN(FEN_MIDDLE);
+      keep(board.getGameState());
+   }
+}
+
+/*************************************
+ * EVALUATION
+ * One position at a time, then a batch of positions
+ * on one thread, so the two compare per core
+ **************************************/
+static void benchEvaluate(size_t numOps)
+{
+   CompactPosition position;
+   position.readFEN(FEN_MIDDLE);
+   for (size_t i = 0; i < numOps; i++)
+   {
+      position.isWhiteToMove = (i & 1);
+      keep(evaluate(position));
+   }
+}
+
+static void benchEvaluateBatch(size_t numOps)
+{
+   const size_t BATCH = 4096;
+   vector<CompactPosition> positions(BATCH);
+   vector<int> scores(BATCH);
+   positions[0].readFEN(FEN_MIDDLE);
+   positions[1].readFEN(FEN_CHECK);
+   for (size_t i = 2; i < BATCH; i++)
+      positions[i] = positions[i % 2];
+   for (size_t done = 0; done < numOps; done += BATCH)
+   {
+      size_t num = min(BATCH, numOps - done);
+      evaluateBatch(positions.data(), num, scores.data(), 1);
+      keep(scores[0]);
+   }
+}
+
+/*************************************
+ * BENCHMARKS
+ * Each runs its operation numOps times
+ **************************************/
+struct Benchmark
+{
+   const char* name;
+   void (*run)(size_t numOps);
+};
+
+static const Benchmark BENCHMARKS[] =
+{
+   { "Position::operator+=",             benchPositionAdd         },
+   { "Position::setLocation",            benchPositionSetLocation },
+   { "Position::getCol/getRow",          benchPositionGetColRow   },
+   { "Move::Move",                       benchMoveConstruct       },
+   { "Move::read",                       benchMoveRead            },
+   { "Move::getText",                    benchMoveGetText         },
+   { "Pawn::getMoves",                   benchPawnGetMoves        },
+   { "Knight::getMoves",                 benchKnightGetMoves      },
+   { "Bishop::getMoves",                 benchBishopGetMoves      },
+   { "Rook::getMoves",                   benchRookGetMoves        },
+   { "Queen::getMoves",                  benchQueenGetMoves       },
+   { "King::getMoves",                   benchKingGetMoves        },
+   { "Board::move",                      benchBoardMove           },
+   { "Board::isInCheck",                 benchIsInCheck           },
+   { "Board::getAttackMap",              benchAttackMap           },
+   { "Board::isInCheckmate",             benchIsInCheckmate       },
+   { "Board::wouldMoveLeaveKingInCheck", benchWouldLeaveInCheck   },
+   { "evaluate",                         benchEvaluate            },
+   { "evaluateBatch",                    benchEvaluateBatch       },
+   { "Board::readFEN+getGameState",      benchGameState           }
+};
+
+/*************************************
+ * RESULT
+ * The statistics of one benchmark
+ **************************************/
+struct Result
+{
+   string name;
+   size_t opsPerSample;
+   int    numSamples;
+   double median;           // nanoseconds per operation
+   double minimum;
+   double mean;
+   double stddev;
+   double allocsPerOp;
+   double bytesPerOp;
+};
+
+/*************************************
+ * TIME
+ * Nanoseconds to run a benchmark numOps times
+ **************************************/
+static double timeRun(const Benchmark& bench, size_t numOps)
+{
+   auto start = chrono::steady_clock::now();
+   bench.run(numOps);
+   return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+/*************************************
+ * MEASURE
+ * Find how many operations fill a sample, warm
+ * up, and then time the samples
+ **************************************/
+static Result measure(const Benchmark& bench, int numSamples, double msPerSample)
+{
+   // double the count until one run is long enough
+   size_t numOps = 1;
+   double ns = timeRun(bench, numOps);
+   while (ns < msPerSample * 1e6 && numOps < ((size_t)1 << 40))
+   {
+      size_t scale = ns <= 0.0 ? 100 :
+                     (size_t)min(100.0, max(2.0, msPerSample * 1e6 / ns * 1.2));
+      numOps *= scale;
+      ns = timeRun(bench, numOps);
+   }
+
+   // the samples, counting allocations across them
+   vector<double> perOp;
+   size_t allocsBefore, bytesBefore, allocsAfter, bytesAfter;
+   countAllocations(allocsBefore, bytesBefore);
+   for (int i = 0; i < numSamples; i++)
+      perOp.push_back(timeRun(bench, numOps) / numOps);
+   countAllocations(allocsAfter, bytesAfter);
+   size_t numAllocs = allocsAfter - allocsBefore;
+   size_t numBytes  = bytesAfter  - bytesBefore;
+
+   Result result;
+   result.name = bench.name;
+   result.opsPerSample = numOps;
+   result.numSamples = numSamples;
+   result.allocsPerOp = (double)numAllocs / ((double)numOps * numSamples);
+   result.bytesPerOp  = (double)numBytes  / ((double)numOps * numSamples);
+
+   sort(perOp.begin(), perOp.end());
+   size_t mid = perOp.size() / 2;
+   result.median  = perOp.size() % 2 ? perOp[mid] : (perOp[mid - 1] + perOp[mid]) / 2.0;
+   result.minimum = perOp.front();
+   result.mean = 0.0;
+   for (double value : perOp)
+      result.mean += value;
+   result.mean /= perOp.size();
+   result.stddev = 0.0;
+   for (double value : perOp)
+      result.stddev += (value - result.mean) * (value - result.mean);
+   result.stddev = perOp.size() > 1 ? sqrt(result.stddev / (perOp.size() - 1)) : 0.0;
+   return result;
+}
+
+/*************************************
+ * WRITE JSON
+ * One object per benchmark. Names never need
+ * escaping, so they are written as they are
+ **************************************/
+static void writeJson(const vector<Result>& results, int numSamples,
+                      double msPerSample, ostream& out)
+{
+   out << "{\n  \"samples\": " << numSamples
+       << ",\n  \"ms_per_sample\": " << msPerSample
+       << ",\n  \"benchmarks\": [\n";
+   out.precision(6);
+   for (size_t i = 0; i < results.size(); i++)
+   {
+      const Result& r = results[i];
+      out << "    { \"name\": \"" << r.name << "\""
+          << ", \"ops_per_sample\": " << r.opsPerSample
+          << ", \"ns_per_op\": " << r.median
+          << ", \"ns_min\": " << r.minimum
+          << ", \"ns_mean\": " << r.mean
+          << ", \"ns_stddev\": " << r.stddev
+          << ", \"allocs_per_op\": " << r.allocsPerOp
+          << ", \"bytes_per_op\": " << r.bytesPerOp
+          << " }" << (i + 1 < results.size() ? ",\n" : "\n");
+   }
+   out << "  ]\n}\n";
+}
+
+/*************************************
+ * USAGE
+ **************************************/
+static int usage()
+{
+   cerr << "Usage: chessBench [-samples N] [-time MS] [-json FILE] [-list] [name...]\n";
+   return 1;
+}
+
+/*********************************
+ * MAIN - Run the benchmarks asked for
+ *********************************/
+int main(int argc, char** argv)
+{
+   int numSamples = 15;
+   double msPerSample = 20.0;
+   string fileJson;
+   vector<string> names;
+   for (int i = 1; i < argc; i++)
+   {
+      string arg = argv[i];
+      if (arg == "-samples" && i + 1 < argc)
+         numSamples = max(1, atoi(argv[++i]));
+      else if (arg == "-time" && i + 1 < argc)
+         msPerSample = max(0.1, atof(argv[++i]));
+      else if (arg == "-json" && i + 1 < argc)
+         fileJson = argv[++i];
+      else if (arg == "-list")
+      {
+         for (const Benchmark& bench : BENCHMARKS)
+            cout << bench.name << "\n";
+         return 0;
+      }
+      else if (arg[0] == '-')
+         return usage();
+      else
+         names.push_back(arg);
+   }
+
+   try
+   {
+      cout << left << setw(34) << "benchmark"
+           << right << setw(10) << "ns/op" << setw(10) << "min"
+           << setw(8) << "rsd" << setw(11) << "allocs/op"
+           << setw(10) << "bytes/op" << "\n";
+      cout.setf(ios::fixed);
+
+      vector<Result> results;
+      for (const Benchmark& bench : BENCHMARKS)
+      {
+         bool selected = names.empty();
+         for (const string& name : names)
+            selected |= string(bench.name).find(name) != string::npos;
+         if (!selected)
+            continue;
+
+         Result r = measure(bench, numSamples, msPerSample);
+         results.push_back(r);
+         cout << left << setw(34) << r.name << right
+              << setprecision(1) << setw(10) << r.median
+              << setw(10) << r.minimum
+              << setw(7) << (r.mean > 0.0 ? 100.0 * r.stddev / r.mean : 0.0) << "%"
+              << setprecision(2) << setw(11) << r.allocsPerOp
+              << setprecision(0) << setw(10) << r.bytesPerOp << endl;
+      }
+
+      if (!fileJson.empty())
+      {
+         ofstream fout(fileJson.c_str());
+         if (fout.fail())
+            throw string("Unable to open ") + fileJson + " for writing";
+         writeJson(results, numSamples, msPerSample, fout);
+      }
+   }
+   catch (const string& error)
+   {
+      cerr << "Error: " << error << endl;
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,933 @@
+/***********************************************************************
+ * Source File:
+ *    BITBASE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Win/draw/loss tables for small endgames, built by retrograde
+ *    analysis. Generation has two phases:
+ *
+ *    1. Every position is classified on its own: illegal, mate,
+ *       stalemate, or decided through a capture or promotion into a
+ *       smaller table. The rest are unknown.
+ *    2. Working backward one ply at a time from the decided positions:
+ *       a predecessor of a loss is a win, and a predecessor of a win is
+ *       a loss once all its moves lead to wins.
+ *
+ *    Whatever remains unknown is a draw. Both phases split the work
+ *    across threads; positions are claimed with compare-and-swap.
+ ************************************************************************/
+
+#include "bitbase.h"
+#include "tablebase.h"
+#include "board.h"
+#include "piece.h"
+#include "trace.h"
+#include "bitboard.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <cstring>
+#include <cassert>
+using namespace std;
+
+// the states used while generating; only the first four are stored
+const uint8_t GEN_DRAW    = BB_DRAW;
+const uint8_t GEN_WIN     = BB_WIN;
+const uint8_t GEN_LOSS    = BB_LOSS;
+const uint8_t GEN_ILLEGAL = BB_ILLEGAL;
+const uint8_t GEN_UNKNOWN = 4;
+
+const char  PIECE_ORDER[] = "QRBNP";              // strongest first
+const int   PIECE_VALUE[] = { 9, 5, 3, 3, 1 };
+const PieceType PROMOTIONS[] = { QUEEN, ROOK, BISHOP, KNIGHT };
+
+
+inline int getRow(int square) { return square >> 3; }
+inline int getCol(int square) { return square & 7;  }
+
+/***************************************************
+ * PIECE LETTER
+ ***************************************************/
+static char pieceLetter(PieceType type)
+{
+   switch (type)
+   {
+      case KING:   return 'K';
+      case QUEEN:  return 'Q';
+      case ROOK:   return 'R';
+      case BISHOP: return 'B';
+      case KNIGHT: return 'N';
+      case PAWN:   return 'P';
+      default:     return '?';
+   }
+}
+
+static PieceType pieceFromLetter(char letter)
+{
+   switch (letter)
+   {
+      case 'K': return KING;
+      case 'Q': return QUEEN;
+      case 'R': return ROOK;
+      case 'B': return BISHOP;
+      case 'N': return KNIGHT;
+      case 'P': return PAWN;
+      default:  return INVALID;
+   }
+}
+
+/***************************************************
+ * KING SQUARES
+ * Where the white king may stand after symmetry.
+ * Without pawns it is the a1-d1-d4 triangle; with
+ * pawns it is files a through d.
+ ***************************************************/
+struct KingSquares
+{
+   int indexNoPawns[64];
+   int squareNoPawns[10];
+   KingSquares()
+   {
+      int i = 0;
+      for (int square = 0; square < 64; square++)
+      {
+         int row = getRow(square);
+         int col = getCol(square);
+         indexNoPawns[square] = (col <= 3 && row <= col) ? i : -1;
+         if (indexNoPawns[square] >= 0)
+            squareNoPawns[i++] = square;
+      }
+      assert(i == 10);
+   }
+};
+static const KingSquares kingSquares;
+
+/***************************************************
+ * SYMMETRY
+ * The transform that puts the white king in its region:
+ * bit 1 mirrors the files, bit 2 the ranks, and bit 4
+ * flips along the a1-h8 diagonal
+ ***************************************************/
+static int getSymmetry(int squareKing, bool hasPawns)
+{
+   int row = getRow(squareKing);
+   int col = getCol(squareKing);
+   int symmetry = 0;
+   if (col > 3)
+   {
+      symmetry |= 1;
+      col = 7 - col;
+   }
+   if (!hasPawns)
+   {
+      if (row > 3)
+      {
+         symmetry |= 2;
+         row = 7 - row;
+      }
+      if (row > col)
+         symmetry |= 4;
+   }
+   return symmetry;
+}
+
+static int applySymmetry(int square, int symmetry)
+{
+   if (symmetry & 1)
+      square ^= 7;
+   if (symmetry & 2)
+      square ^= 56;
+   if (symmetry & 4)
+      square = (getCol(square) << 3) | getRow(square);
+   return square;
+}
+
+/***************************************************
+ * ATTACKS
+ * Does the piece on "from" attack "to"? occupied[] is
+ * non-zero wherever there is a piece
+ ***************************************************/
+static bool attacks(PieceType type, bool isWhite, int from, int to,
+                    const int occupied[64])
+{
+   if (from == to)
+      return false;
+   switch (type)
+   {
+      case KING:
+         return KING_ATTACKS[from] & squareBit(to);
+      case KNIGHT:
+         return KNIGHT_ATTACKS[from] & squareBit(to);
+      case PAWN:
+         return PAWN_ATTACKS[isWhite][from] & squareBit(to);
+      default:
+         break;
+   }
+
+   int dRow = getRow(to) - getRow(from);
+   int dCol = getCol(to) - getCol(from);
+   int aRow = abs(dRow);
+   int aCol = abs(dCol);
+
+   switch (type)
+   {
+      case ROOK:
+         if (dRow && dCol)
+            return false;
+         break;
+      case BISHOP:
+         if (aRow != aCol)
+            return false;
+         break;
+      case QUEEN:
+         if (dRow && dCol && aRow != aCol)
+            return false;
+         break;
+      default:
+         return false;
+   }
+
+   // a slider needs a clear path
+   int step = (dRow > 0 ? 8 : dRow < 0 ? -8 : 0) + (dCol > 0 ? 1 : dCol < 0 ? -1 : 0);
+   for (int square = from + step; square != to; square += step)
+      if (occupied[square])
+         return false;
+   return true;
+}
+
+/***************************************************
+ * FILL OCCUPIED
+ * Piece number + 1 on every square with a piece
+ ***************************************************/
+static void fillOccupied(const BitbasePosition& pos, int occupied[64])
+{
+   memset(occupied, 0, 64 * sizeof(int));
+   for (int i = 0; i < pos.numPieces; i++)
+      occupied[pos.square[i]] = i + 1;
+}
+
+/***************************************************
+ * IS IN CHECK
+ * Is the king of the given side attacked?
+ ***************************************************/
+static bool isInCheck(const BitbasePosition& pos, bool isWhite)
+{
+   int occupied[64];
+   fillOccupied(pos, occupied);
+
+   int squareKing = -1;
+   for (int i = 0; i < pos.numPieces; i++)
+      if (pos.type[i] == KING && pos.isWhite[i] == isWhite)
+         squareKing = pos.square[i];
+   assert(squareKing >= 0);
+
+   for (int i = 0; i < pos.numPieces; i++)
+      if (pos.isWhite[i] != isWhite &&
+          attacks(pos.type[i], pos.isWhite[i], pos.square[i], squareKing, occupied))
+         return true;
+   return false;
+}
+
+/***************************************************
+ * IS LEGAL
+ * Pieces on distinct squares, no pawn on the first or
+ * last rank, and the side that just moved is not in check
+ ***************************************************/
+static bool isLegal(const BitbasePosition& pos)
+{
+   for (int i = 0; i < pos.numPieces; i++)
+   {
+      if (pos.type[i] == PAWN &&
+          (getRow(pos.square[i]) == 0 || getRow(pos.square[i]) == 7))
+         return false;
+      for (int j = 0; j < i; j++)
+         if (pos.square[i] == pos.square[j])
+            return false;
+   }
+   return !isInCheck(pos, !pos.whiteToMove);
+}
+
+/***************************************************
+ * FOR EACH TARGET
+ * The squares a piece can move to, ignoring checks.
+ * Pawns only push here; their captures are separate.
+ ***************************************************/
+template <class F>
+static void forEachTarget(PieceType type, int square, const int occupied[64], F f)
+{
+   int row = getRow(square);
+   int col = getCol(square);
+
+   if (type == KING || type == KNIGHT)
+   {
+      Bitboard targets = (type == KING) ? KING_ATTACKS[square] : KNIGHT_ATTACKS[square];
+      while (targets)
+         f(popSquare(targets));
+      return;
+   }
+
+   // sliders stop at the first piece, which they may capture
+   for (int i = 0; i < 8; i++)
+   {
+      int dRow = KING_STEPS[i][0];
+      int dCol = KING_STEPS[i][1];
+      bool diagonal = dRow && dCol;
+      if ((type == ROOK && diagonal) || (type == BISHOP && !diagonal))
+         continue;
+      for (int r = row + dRow, c = col + dCol;
+           r >= 0 && r < 8 && c >= 0 && c < 8;
+           r += dRow, c += dCol)
+      {
+         f(r * 8 + c);
+         if (occupied[r * 8 + c])
+            break;
+      }
+   }
+}
+
+/***************************************************
+ * REMOVE PIECE
+ ***************************************************/
+static void removePiece(BitbasePosition& pos, int iPiece)
+{
+   for (int i = iPiece; i + 1 < pos.numPieces; i++)
+   {
+      pos.type[i]    = pos.type[i + 1];
+      pos.isWhite[i] = pos.isWhite[i + 1];
+      pos.square[i]  = pos.square[i + 1];
+   }
+   pos.numPieces--;
+}
+
+/***************************************************
+ * FOR EACH MOVE
+ * Call f(child, same) for every legal move, where same
+ * is false when the move captures or promotes and so
+ * leaves this table
+ ***************************************************/
+template <class F>
+static void forEachMove(const BitbasePosition& pos, F f)
+{
+   int occupied[64];
+   fillOccupied(pos, occupied);
+   bool isWhite = pos.whiteToMove;
+
+   auto tryMove = [&](int iPiece, int to)
+   {
+      int iCaptured = occupied[to] - 1;
+      if (iCaptured >= 0 &&
+          (pos.isWhite[iCaptured] == isWhite || pos.type[iCaptured] == KING))
+         return;
+
+      BitbasePosition child = pos;
+      child.square[iPiece] = to;
+      child.whiteToMove = !isWhite;
+      int iMoved = iPiece;
+      if (iCaptured >= 0)
+      {
+         removePiece(child, iCaptured);
+         if (iCaptured < iPiece)
+            iMoved--;
+      }
+
+      bool promote = pos.type[iPiece] == PAWN && getRow(to) == (isWhite ? 7 : 0);
+      for (int i = 0; i < (promote ? 4 : 1); i++)
+      {
+         if (promote)
+            child.type[iMoved] = PROMOTIONS[i];
+         if (!isInCheck(child, isWhite))
+            f(child, iCaptured < 0 && !promote);
+      }
+   };
+
+   for (int iPiece = 0; iPiece < pos.numPieces; iPiece++)
+   {
+      if (pos.isWhite[iPiece] != isWhite)
+         continue;
+      int square = pos.square[iPiece];
+
+      if (pos.type[iPiece] != PAWN)
+      {
+         forEachTarget(pos.type[iPiece], square, occupied,
+                       [&](int to) { tryMove(iPiece, to); });
+         continue;
+      }
+
+      // pawns push onto empty squares and capture diagonally
+      int dir = isWhite ? 8 : -8;
+      int ahead = square + dir;
+      if (!occupied[ahead])
+      {
+         tryMove(iPiece, ahead);
+         if (getRow(square) == (isWhite ? 1 : 6) && !occupied[ahead + dir])
+            tryMove(iPiece, ahead + dir);
+      }
+      for (Bitboard targets = PAWN_ATTACKS[isWhite][square]; targets; )
+      {
+         int to = popSquare(targets);
+         if (occupied[to])
+            tryMove(iPiece, to);
+      }
+   }
+}
+
+/***************************************************
+ * FOR EACH UNMOVE
+ * Call f(parent) for every legal position that reaches
+ * this one by a move that is not a capture or promotion
+ ***************************************************/
+template <class F>
+static void forEachUnmove(const BitbasePosition& pos, F f)
+{
+   int occupied[64];
+   fillOccupied(pos, occupied);
+   bool isWhite = !pos.whiteToMove;   // the side that just moved
+
+   auto tryUnmove = [&](int iPiece, int from)
+   {
+      if (occupied[from])
+         return;
+      BitbasePosition parent = pos;
+      parent.square[iPiece] = from;
+      parent.whiteToMove = isWhite;
+      if (!isInCheck(parent, !isWhite))
+         f(parent);
+   };
+
+   for (int iPiece = 0; iPiece < pos.numPieces; iPiece++)
+   {
+      if (pos.isWhite[iPiece] != isWhite)
+         continue;
+      int square = pos.square[iPiece];
+
+      if (pos.type[iPiece] != PAWN)
+      {
+         forEachTarget(pos.type[iPiece], square, occupied,
+                       [&](int from) { tryUnmove(iPiece, from); });
+         continue;
+      }
+
+      // a pawn came from one square back, or two from its start
+      int dir = isWhite ? -8 : 8;
+      int row = getRow(square);
+      if (isWhite ? row >= 2 : row <= 5)
+      {
+         tryUnmove(iPiece, square + dir);
+         if (row == (isWhite ? 3 : 4) && !occupied[square + dir])
+            tryUnmove(iPiece, square + 2 * dir);
+      }
+   }
+}
+
+/***************************************************
+ * BITBASE : SET SIGNATURE
+ * Parse "KRKP" into the pieces of the table
+ ***************************************************/
+void Bitbase::setSignature(const string& signature)
+{
+   size_t iSecondKing = signature.find('K', 1);
+   if (signature.size() < 2 || signature[0] != 'K' ||
+       iSecondKing == string::npos ||
+       (int)signature.size() > BITBASE_MAX_PIECES)
+      throw string("Bad bitbase signature: ") + signature;
+
+   this->signature = signature;
+   numPieces = 0;
+   hasPawns = false;
+   type[numPieces] = KING;  isWhite[numPieces++] = true;
+   type[numPieces] = KING;  isWhite[numPieces++] = false;
+   for (size_t i = 1; i < signature.size(); i++)
+   {
+      if (i == iSecondKing)
+         continue;
+      PieceType pt = pieceFromLetter(signature[i]);
+      if (pt == INVALID || pt == KING)
+         throw string("Bad bitbase signature: ") + signature;
+      type[numPieces] = pt;
+      isWhite[numPieces++] = i < iSecondKing;
+      hasPawns = hasPawns || pt == PAWN;
+   }
+
+   numPositions = (hasPawns ? 32 : 10) * 2;
+   for (int i = 1; i < numPieces; i++)
+      numPositions *= 64;
+}
+
+/***************************************************
+ * BITBASE : GET INDEX
+ * Match the pieces to the table's slots, move the white
+ * king into its region, and pack the squares
+ ***************************************************/
+size_t Bitbase::getIndex(const BitbasePosition& pos) const
+{
+   assert(pos.numPieces == numPieces);
+
+   int  square[BITBASE_MAX_PIECES];
+   bool used[BITBASE_MAX_PIECES] = { false, false, false, false };
+   for (int iSlot = 0; iSlot < numPieces; iSlot++)
+   {
+      square[iSlot] = -1;
+      for (int i = 0; i < pos.numPieces; i++)
+         if (!used[i] && pos.type[i] == type[iSlot] && pos.isWhite[i] == isWhite[iSlot])
+         {
+            used[i] = true;
+            square[iSlot] = pos.square[i];
+            break;
+         }
+      assert(square[iSlot] >= 0);
+   }
+
+   int symmetry = getSymmetry(square[0], hasPawns);
+   int squareKing = applySymmetry(square[0], symmetry);
+   size_t index = hasPawns ?
+      (size_t)(getRow(squareKing) * 4 + getCol(squareKing)) :
+      (size_t)kingSquares.indexNoPawns[squareKing];
+   for (int iSlot = 1; iSlot < numPieces; iSlot++)
+      index = index * 64 + applySymmetry(square[iSlot], symmetry);
+   return index * 2 + (pos.whiteToMove ? 0 : 1);
+}
+
+/***************************************************
+ * BITBASE : GET POSITION
+ * The inverse of getIndex()
+ ***************************************************/
+void Bitbase::getPosition(size_t index, BitbasePosition& pos) const
+{
+   assert(index < numPositions);
+   pos.numPieces = numPieces;
+   pos.whiteToMove = (index & 1) == 0;
+   index /= 2;
+   for (int iSlot = numPieces - 1; iSlot >= 1; iSlot--)
+   {
+      pos.square[iSlot] = (int)(index % 64);
+      index /= 64;
+   }
+   pos.square[0] = hasPawns ?
+      (int)((index / 4) * 8 + index % 4) :
+      kingSquares.squareNoPawns[index];
+   for (int iSlot = 0; iSlot < numPieces; iSlot++)
+   {
+      pos.type[iSlot] = type[iSlot];
+      pos.isWhite[iSlot] = isWhite[iSlot];
+   }
+}
+
+/***************************************************
+ * RUN THREADS
+ * Split [0, num) into one range per thread
+ ***************************************************/
+template <class F>
+static void runThreads(int numThreads, size_t num, F f)
+{
+   vector<thread> threads;
+   for (int i = 0; i < numThreads; i++)
+   {
+      size_t begin = num * i / numThreads;
+      size_t end   = num * (i + 1) / numThreads;
+      threads.push_back(thread([=, &f]() { f(i, begin, end); }));
+   }
+   for (thread& t : threads)
+      t.join();
+}
+
+/***************************************************
+ * BITBASE : GENERATE
+ * Retrograde analysis. Tables reached through captures
+ * and promotions must already be in the set.
+ ***************************************************/
+void Bitbase::generate(const BitbaseSet& set, int numThreads)
+{
+   TRACE_SCOPE("Bitbase::generate");
+   unique_ptr<atomic<uint8_t>[]> state(new atomic<uint8_t>[numPositions]);
+   vector<vector<size_t>> frontiers(numThreads);
+
+   // the value of a move that leaves this table
+   auto probeChild = [&](const BitbasePosition& child)
+   {
+      BitbaseValue value = BB_DRAW;
+      bool found = set.probe(child, value);
+      assert(found);
+      return value;
+   };
+
+   // phase 1: classify every position by itself
+   runThreads(numThreads, numPositions, [&](int iThread, size_t begin, size_t end)
+   {
+      TRACE_SCOPE("Bitbase::classify");
+      TRACE_COUNT("bitbase positions classified", end - begin);
+      for (size_t index = begin; index < end; index++)
+      {
+         BitbasePosition pos;
+         getPosition(index, pos);
+         if (!isLegal(pos))
+         {
+            state[index] = GEN_ILLEGAL;
+            continue;
+         }
+
+         bool anyMove  = false;
+         bool win      = false;   // a move leaves the opponent lost
+         bool allLoses = true;    // every move leaves the opponent won
+         forEachMove(pos, [&](const BitbasePosition& child, bool same)
+         {
+            anyMove = true;
+            if (same)
+               allLoses = false;
+            else
+            {
+               BitbaseValue value = probeChild(child);
+               win = win || value == BB_LOSS;
+               allLoses = allLoses && value == BB_WIN;
+            }
+         });
+
+         uint8_t value = GEN_UNKNOWN;
+         if (!anyMove)
+            value = isInCheck(pos, pos.whiteToMove) ? GEN_LOSS : GEN_DRAW;
+         else if (win)
+            value = GEN_WIN;
+         else if (allLoses)
+            value = GEN_LOSS;
+         state[index] = value;
+         if (value == GEN_WIN || value == GEN_LOSS)
+            frontiers[iThread].push_back(index);
+      }
+   });
+
+   // does every move from this position lead to a win for the opponent?
+   auto allMovesLose = [&](const BitbasePosition& pos)
+   {
+      bool allLoses = true;
+      forEachMove(pos, [&](const BitbasePosition& child, bool same)
+      {
+         if (!allLoses)
+            return;
+         if (same)
+            allLoses = state[getIndex(child)] == GEN_WIN;
+         else
+            allLoses = probeChild(child) == BB_WIN;
+      });
+      return allLoses;
+   };
+
+   // phase 2: one ply further back each round. A position is examined
+   // again every time one of its children is decided, so a child that
+   // another thread decides late is never missed.
+   vector<size_t> frontier;
+   for (vector<size_t>& f : frontiers)
+      frontier.insert(frontier.end(), f.begin(), f.end());
+   while (!frontier.empty())
+   {
+      vector<vector<size_t>> next(numThreads);
+      runThreads(numThreads, frontier.size(), [&](int iThread, size_t begin, size_t end)
+      {
+         TRACE_SCOPE("Bitbase::retrograde");
+         size_t numNodes = 0;
+         for (size_t i = begin; i < end; i++)
+         {
+            BitbasePosition pos;
+            getPosition(frontier[i], pos);
+            uint8_t value = state[frontier[i]];
+
+            auto examine = [&](size_t iParent, const BitbasePosition& parent)
+            {
+               if (state[iParent] != GEN_UNKNOWN)
+                  return;
+               uint8_t expected = GEN_UNKNOWN;
+               if (value == GEN_LOSS)
+               {
+                  if (state[iParent].compare_exchange_strong(expected, GEN_WIN))
+                     next[iThread].push_back(iParent);
+               }
+               else if (allMovesLose(parent))
+               {
+                  if (state[iParent].compare_exchange_strong(expected, GEN_LOSS))
+                     next[iThread].push_back(iParent);
+               }
+            };
+
+            forEachUnmove(pos, [&](const BitbasePosition& parent)
+            {
+               numNodes++;
+               size_t iParent = getIndex(parent);
+               examine(iParent, parent);
+
+               // with the white king on the diagonal, the parent and its
+               // reflection are stored separately, so examine both
+               if (!hasPawns)
+               {
+                  BitbasePosition reflected;
+                  getPosition(iParent, reflected);
+                  if (getRow(reflected.square[0]) == getCol(reflected.square[0]))
+                  {
+                     for (int i = 0; i < reflected.numPieces; i++)
+                        reflected.square[i] = applySymmetry(reflected.square[i], 4);
+                     size_t iReflected = getIndex(reflected);
+                     if (iReflected != iParent)
+                        examine(iReflected, reflected);
+                  }
+               }
+            });
+         }
+         TRACE_COUNT("bitbase nodes examined", numNodes);
+      });
+
+      frontier.clear();
+      for (vector<size_t>& f : next)
+         frontier.insert(frontier.end(), f.begin(), f.end());
+   }
+
+   // pack two bits per position; the undecided are draws
+   bits.assign(getNumBytes(), 0);
+   for (size_t index = 0; index < numPositions; index++)
+   {
+      uint8_t value = state[index];
+      if (value == GEN_UNKNOWN)
+         value = GEN_DRAW;
+      bits[index >> 2] |= value << ((index & 3) * 2);
+   }
+   pBits = bits.data();
+}
+
+/***************************************************
+ * BITBASE : SAVE
+ * The header is the magic number, the signature padded
+ * to four bytes, and the number of positions
+ ***************************************************/
+void Bitbase::save(const string& fileName) const
+{
+   ofstream fout(fileName.c_str(), ios::binary);
+   if (fout.fail())
+      throw string("Unable to open ") + fileName + " for writing";
+
+   char name[4] = { 0, 0, 0, 0 };
+   memcpy(name, signature.data(), signature.size());
+   fout.write(BITBASE_MAGIC, sizeof(BITBASE_MAGIC));
+   fout.write(name, sizeof(name));
+   for (int i = 0; i < 8; i++)
+      fout.put((char)((numPositions >> (8 * i)) & 0xff));
+   fout.write((const char*)pBits, getNumBytes());
+   if (fout.fail())
+      throw string("Unable to write ") + fileName;
+}
+
+/***************************************************
+ * BITBASE SET : GET SIGNATURE
+ * The stronger side goes first. flip is set when that
+ * is black, meaning the colors must be swapped
+ ***************************************************/
+string BitbaseSet::getSignature(const BitbasePosition& pos, bool& flip)
+{
+   string side[2];     // white, black
+   int    value[2] = { 0, 0 };
+   for (const char* p = PIECE_ORDER; *p; p++)
+      for (int i = 0; i < pos.numPieces; i++)
+         if (pieceLetter(pos.type[i]) == *p)
+         {
+            int iSide = pos.isWhite[i] ? 0 : 1;
+            side[iSide] += *p;
+            value[iSide] += PIECE_VALUE[p - PIECE_ORDER];
+         }
+
+   // "B" sorts before "N" because of the order above, so compare
+   // by the position of each letter in PIECE_ORDER
+   auto rank = [](const string& s)
+   {
+      string r;
+      for (char c : s)
+         r += (char)('0' + (strchr(PIECE_ORDER, c) - PIECE_ORDER));
+      return r;
+   };
+   flip = value[1] > value[0] ||
+          (value[1] == value[0] && rank(side[1]) < rank(side[0]));
+   return flip ? "K" + side[1] + "K" + side[0] : "K" + side[0] + "K" + side[1];
+}
+
+/***************************************************
+ * BITBASE SET : GENERATE
+ * Every capture and promotion leads to another table,
+ * so build those first
+ ***************************************************/
+const Bitbase& BitbaseSet::generate(const string& signature)
+{
+   auto it = bases.find(signature);
+   if (it != bases.end())
+      return *it->second;
+
+   unique_ptr<Bitbase> pBase(new Bitbase);
+   pBase->setSignature(signature);
+
+   // the tables one capture or one promotion away
+   BitbasePosition pos;
+   pos.numPieces = pBase->numPieces;
+   pos.whiteToMove = true;
+   for (int i = 0; i < pos.numPieces; i++)
+   {
+      pos.type[i] = pBase->type[i];
+      pos.isWhite[i] = pBase->isWhite[i];
+   }
+   for (int i = 2; i < pos.numPieces; i++)
+   {
+      BitbasePosition smaller = pos;
+      removePiece(smaller, i);
+      bool flip;
+      if (smaller.numPieces > 2)
+         generate(getSignature(smaller, flip));
+
+      if (pos.type[i] == PAWN)
+         for (PieceType promotion : PROMOTIONS)
+         {
+            BitbasePosition promoted = pos;
+            promoted.type[i] = promotion;
+            generate(getSignature(promoted, flip));
+         }
+   }
+
+   int threads = numThreads > 0 ? numThreads :
+                 max(1, (int)thread::hardware_concurrency());
+   pBase->generate(*this, threads);
+   return *(bases[signature] = std::move(pBase));
+}
+
+/***************************************************
+ * BITBASE SET : LOAD
+ * Map a saved table into memory
+ ***************************************************/
+const Bitbase& BitbaseSet::load(const string& fileName)
+{
+   unique_ptr<Bitbase> pBase(new Bitbase);
+   pBase->file.open(fileName);
+   const uint8_t* pData = pBase->file.data();
+   if (pBase->file.size() < BITBASE_HEADER ||
+       memcmp(pData, BITBASE_MAGIC, sizeof(BITBASE_MAGIC)) != 0)
+      throw string("Not a bitbase: ") + fileName;
+
+   string signature((const char*)pData + 4, strnlen((const char*)pData + 4, 4));
+   pBase->setSignature(signature);
+   if (readLittle(pData + 8, 8) != pBase->numPositions ||
+       pBase->file.size() != BITBASE_HEADER + pBase->getNumBytes())
+      throw string("Corrupt bitbase: ") + fileName;
+
+   pBase->pBits = pData + BITBASE_HEADER;
+   return *(bases[signature] = std::move(pBase));
+}
+
+/***************************************************
+ * BITBASE SET : LOAD TABLEBASE
+ * Map a compressed table. Its blocks are expanded as
+ * they are probed
+ ***************************************************/
+const Tablebase& BitbaseSet::loadTablebase(const string& fileName,
+                                           size_t cacheBlocks)
+{
+   unique_ptr<Tablebase> pTable(new Tablebase(fileName, cacheBlocks));
+   string signature = pTable->getSignature();
+   return *(tablebases[signature] = std::move(pTable));
+}
+
+/***************************************************
+ * BITBASE SET : CONSTRUCT and DESTRUCT
+ * Here because Tablebase is incomplete in the header
+ ***************************************************/
+BitbaseSet::BitbaseSet(int numThreads) : numThreads(numThreads)
+{
+}
+
+BitbaseSet::~BitbaseSet()
+{
+}
+
+/***************************************************
+ * BITBASE SET : FIND
+ ***************************************************/
+const Bitbase* BitbaseSet::find(const string& signature) const
+{
+   auto it = bases.find(signature);
+   return it == bases.end() ? nullptr : it->second.get();
+}
+
+/***************************************************
+ * BITBASE SET : GET SIGNATURES
+ * Every table we have, smallest material first
+ ***************************************************/
+vector<string> BitbaseSet::getSignatures() const
+{
+   vector<string> signatures;
+   for (const auto& pair : bases)
+      signatures.push_back(pair.first);
+   stable_sort(signatures.begin(), signatures.end(),
+               [](const string& lhs, const string& rhs)
+   {
+      return lhs.size() < rhs.size();
+   });
+   return signatures;
+}
+
+/***************************************************
+ * BITBASE SET : PROBE
+ * Bare kings are always a draw
+ ***************************************************/
+bool BitbaseSet::probe(const BitbasePosition& pos, BitbaseValue& value) const
+{
+   if (pos.numPieces == 2)
+   {
+      value = BB_DRAW;
+      return true;
+   }
+
+   // swap the colors and mirror the ranks if black is stronger
+   bool flip;
+   string signature = getSignature(pos, flip);
+   BitbasePosition canonical = pos;
+   if (flip)
+   {
+      canonical.whiteToMove = !pos.whiteToMove;
+      for (int i = 0; i < pos.numPieces; i++)
+      {
+         canonical.isWhite[i] = !pos.isWhite[i];
+         canonical.square[i] = pos.square[i] ^ 56;
+      }
+   }
+
+   const Bitbase* pBase = find(signature);
+   if (pBase)
+   {
+      value = pBase->get(pBase->getIndex(canonical));
+      return true;
+   }
+
+   auto it = tablebases.find(signature);
+   if (it != tablebases.end())
+   {
+      value = it->second->get(it->second->getIndex(canonical));
+      return true;
+   }
+   return false;
+}
+
+/***************************************************
+ * BITBASE SET : PROBE
+ * Look up a board with few enough pieces
+ ***************************************************/
+bool BitbaseSet::probe(const Board& board, BitbaseValue& value) const
+{
+   BitbasePosition pos;
+   pos.numPieces = 0;
+   pos.whiteToMove = board.whiteTurn();
+   for (int col = 0; col < 8; col++)
+      for (int row = 0; row < 8; row++)
+      {
+         const Piece* pPiece = board.getPiece(Position(col, row));
+         if (!pPiece || pPiece->getType() == SPACE)
+            continue;
+         if (pos.numPieces == BITBASE_MAX_PIECES)
+            return false;
+         pos.type[pos.numPieces]    = pPiece->getType();
+         pos.isWhite[pos.numPieces] = pPiece->isWhite();
+         pos.square[pos.numPieces]  = row * 8 + col;
+         pos.numPieces++;
+      }
+   return probe(pos, value);
+}
@@ -0,0 +1,142 @@
+/***********************************************************************
+ * Header File:
+ *    BITBASE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Win/draw/loss tables for endgames of up to four pieces, built by
+ *    retrograde analysis. Each position takes two bits. The tables are
+ *    indexed so that probing is a few shifts and one memory read:
+ *
+ *       index = ((wk * 64 + bk) * 64 + piece3) * 64 + piece4) * 2 + stm
+ *
+ *    The white king is reduced by symmetry to the a1-d1-d4 triangle
+ *    (10 squares) when there are no pawns, or to files a-d (32 squares)
+ *    when there are. The side with more material is always white in
+ *    the table; positions where it is black are flipped before lookup.
+ *    En passant is ignored.
+ ************************************************************************/
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "pieceType.h"   // for PieceType
+#include "mappedFile.h"  // because tables on disk are memory-mapped
+
+class Board;
+class BitbaseSet;
+class Tablebase;
+class TestBitbase;
+
+const int      BITBASE_MAX_PIECES = 4;      // kings included
+const char     BITBASE_MAGIC[4]   = { 'C', 'B', 'B', '1' };
+const size_t   BITBASE_HEADER     = 16;     // magic, signature, size
+
+/***************************************************
+ * BITBASE VALUE
+ * From the point of view of the side to move
+ ***************************************************/
+enum BitbaseValue { BB_DRAW, BB_WIN, BB_LOSS, BB_ILLEGAL };
+
+/***************************************************
+ * BITBASE POSITION
+ * A handful of pieces and the side to move. Squares
+ * are numbered row * 8 + col, so a1 is 0 and h8 is 63.
+ ***************************************************/
+struct BitbasePosition
+{
+   int       numPieces;
+   PieceType type[BITBASE_MAX_PIECES];
+   bool      isWhite[BITBASE_MAX_PIECES];
+   int       square[BITBASE_MAX_PIECES];
+   bool      whiteToMove;
+};
+
+/***************************************************
+ * BITBASE
+ * The table for one material signature, such as "KPK"
+ ***************************************************/
+class Bitbase
+{
+   friend BitbaseSet;
+   friend Tablebase;
+   friend TestBitbase;
+public:
+   Bitbase() : numPieces(0), hasPawns(false), numPositions(0), pBits(nullptr) {}
+
+   // getters
+   const std::string& getSignature() const { return signature;    }
+   size_t             size()         const { return numPositions; }
+   size_t             getNumBytes()  const { return (numPositions + 3) / 4; }
+   BitbaseValue       get(size_t index) const
+   {
+      return (BitbaseValue)((pBits[index >> 2] >> ((index & 3) * 2)) & 3);
+   }
+
+   // translate between positions and indices. The pieces of pos must
+   // match the signature, white being the side listed first
+   size_t getIndex(const BitbasePosition& pos) const;
+   void   getPosition(size_t index, BitbasePosition& pos) const;
+
+   // write the table out
+   void save(const std::string& fileName) const;
+
+private:
+   void setSignature(const std::string& signature);
+   void generate(const BitbaseSet& set, int numThreads);
+
+   std::string          signature;                      // "KQKR"
+   int                  numPieces;                      // 2 to 4
+   PieceType            type[BITBASE_MAX_PIECES];       // kings first
+   bool                 isWhite[BITBASE_MAX_PIECES];
+   bool                 hasPawns;                       // less symmetry
+   size_t               numPositions;                   // entries
+   std::vector<uint8_t> bits;                           // if generated
+   MappedFile           file;                           // if loaded
+   const uint8_t*       pBits;                          // one or other
+};
+
+/***************************************************
+ * BITBASE SET
+ * Every table we have, found by material
+ ***************************************************/
+class BitbaseSet
+{
+   friend TestBitbase;
+public:
+   // numThreads of 0 means one per hardware thread
+   BitbaseSet(int numThreads = 0);
+   ~BitbaseSet();
+
+   // build a table, and first every table it depends on through
+   // captures and promotions. Throws a string on a bad signature
+   const Bitbase& generate(const std::string& signature);
+
+   // read a table saved with Bitbase::save. Throws a string on error
+   const Bitbase& load(const std::string& fileName);
+
+   // map a compressed table saved with Tablebase::write
+   const Tablebase& loadTablebase(const std::string& fileName,
+                                  size_t cacheBlocks = 256);
+
+   // the table for a signature, or null
+   const Bitbase* find(const std::string& signature) const;
+   std::vector<std::string> getSignatures() const;
+
+   // look a position up. Returns false if we have no table for it.
+   // Safe to call from many threads once the tables are loaded
+   bool probe(const BitbasePosition& pos, BitbaseValue& value) const;
+   bool probe(const Board& board, BitbaseValue& value) const;
+
+   // the canonical signature of some material, such as "KRKP"
+   static std::string getSignature(const BitbasePosition& pos, bool& flip);
+
+private:
+   int numThreads;
+   std::map<std::string, std::unique_ptr<Bitbase>>   bases;
+   std::map<std::string, std::unique_ptr<Tablebase>> tablebases;
+};
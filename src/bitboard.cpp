@@ -0,0 +1,243 @@
+/***********************************************************************
+ * Source File:
+ *    BITBOARD
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The slider attack tables. For each square, every arrangement of
+ *    blockers in its mask gets one entry. The entry is found with a magic
+ *    number: multiplying by it moves the mask's bits into the top of the
+ *    word without two arrangements that attack differently landing on
+ *    the same index. PEXT was tried as well; called through a check for
+ *    BMI2 it could not be inlined, and it was a quarter slower. The magics were found by trying sparse random numbers
+ *    until one worked; searching takes a third of a second, so the
+ *    results are kept here and only the tables are built at startup.
+ *    The slider fill is here too, so it can pick AVX2 at startup.
+ ************************************************************************/
+
+#include "bitboard.h"
+#include <vector>
+#include <cassert>
+using namespace std;
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(BITBOARD_NO_AVX2)
+#include <immintrin.h>   // for the _MM256 intrinsics
+#define BITBOARD_AVX2
+#endif
+
+/***************************************************
+ * SLIDER
+ * How to find one square's attacks
+ ***************************************************/
+struct Slider
+{
+   Bitboard  mask;        // the squares that can block
+   Bitboard  magic;       // the multiplier
+   int       shift;       // 64 less the number of squares in the mask
+   Bitboard* pAttacks;    // this square's part of the table
+};
+
+static Slider           rookSliders[64];
+static Slider           bishopSliders[64];
+static vector<Bitboard> rookTable;
+static vector<Bitboard> bishopTable;
+static bool             hasAvx2 = false;
+
+/***************************************************
+ * GET INDEX
+ * The magic multiply and shift
+ ***************************************************/
+inline unsigned getIndex(const Slider& slider, Bitboard occupied)
+{
+   return (unsigned)(((occupied & slider.mask) * slider.magic) >> slider.shift);
+}
+
+// one magic per square, a1 first
+static const Bitboard ROOK_MAGICS[64] =
+{
+   0x1080004008801020ull, 0x0840092002c03000ull, 0x1900200010400900ull, 0x0880100008000480ull,
+   0x4200100420080200ull, 0x8100020100080400ull, 0x0200040110886200ull, 0x0200008040220411ull,
+   0x0404800084400220ull, 0x0000401000402000ull, 0x0086001081220440ull, 0x0408800800100280ull,
+   0x000a001201040820ull, 0x8848800200840080ull, 0x4001000100040200ull, 0x0442000102105084ull,
+   0x9080010020804100ull, 0x0040404000201009ull, 0x0000808010002009ull, 0x2200090021d00100ull,
+   0x0008008008040080ull, 0x0004004002010040ull, 0x0011040008015042ull, 0x00000a0001768104ull,
+   0x0000800080204009ull, 0x2010004140002001ull, 0x9800200280100080ull, 0x1000100080080080ull,
+   0x0442000a00049020ull, 0x2100040080020080ull, 0x0800120400900148ull, 0x0010040a00128541ull,
+   0x2800804000800030ull, 0x1010002000400041ull, 0x4000200011004100ull, 0x0610008410800800ull,
+   0x0400802402800800ull, 0xc100020080800400ull, 0x0002000802000401ull, 0x0182085882000401ull,
+   0x0220204000808000ull, 0x2860100040024022ull, 0x0001002004110040ull, 0x99101042000a0020ull,
+   0x0004080004008080ull, 0x0010040002008080ull, 0x2012004881020004ull, 0x8300842444820011ull,
+   0x0088403882010200ull, 0x0820400080210100ull, 0x0110910040a00300ull, 0x0801100280080480ull,
+   0x0242009008200600ull, 0x1002000489500200ull, 0x0040800200010080ull, 0x0091800041000080ull,
+   0x0000209300488001ull, 0x04c1002414824001ull, 0x020020000b001041ull, 0x7000100004200901ull,
+   0x8002002004100802ull, 0x30010002084c0007ull, 0x0888221800813004ull, 0x4000002840840112ull
+};
+
+static const Bitboard BISHOP_MAGICS[64] =
+{
+   0x10102002004a1420ull, 0x8020040400584008ull, 0x10510800811201c8ull, 0x5204042080000088ull,
+   0x2204106880000002ull, 0x1401042004000000ull, 0x0400880410042004ull, 0x0028208200a02020ull,
+   0x1500241990010e00ull, 0x8001200182020a40ull, 0x40004101030b0000ull, 0x8002041042000100ull,
+   0x4010011041020038ull, 0x0000010421044000ull, 0x1500210808020a00ull, 0x8000088400880520ull,
+   0x0405004010040100ull, 0x1005823210040108ull, 0x2708008102040011ull, 0x4048200404009100ull,
+   0x0018104101400024ull, 0x0003000601190101ull, 0x8004803108491000ull, 0x8014241200820800ull,
+   0x0006e080100c3040ull, 0x0501044a11041800ull, 0x9020300008004045ull, 0x0894080000220040ull,
+   0x1001010083104000ull, 0x5004030040900080ull, 0x000400422c012400ull, 0x0002128698404812ull,
+   0x1010108404900440ull, 0x0928021182084100ull, 0x2006080409020024ull, 0x1010202020180080ull,
+   0xa010008200202200ull, 0x2098015100019004ull, 0x0002041440810811ull, 0x802a02020000b098ull,
+   0x0009015090004060ull, 0x4000821082081001ull, 0x0100210040420800ull, 0x0800004010488a00ull,
+   0x2000081104004040ull, 0x4c8e029015000082ull, 0x0420340322224842ull, 0x1298260043400210ull,
+   0x0000822802400008ull, 0x00008a0101600000ull, 0x3040003412080021ull, 0x3040290220884800ull,
+   0x4a1500401041004aull, 0x8010200282020781ull, 0x0020203142209091ull, 0x0070300600902110ull,
+   0x0040808800b62048ull, 0x0000810400c44420ull, 0x00080400440c0441ull, 0x8340080020840411ull,
+   0x0000000104208200ull, 0x0000800810d00080ull, 0x0400530411080200ull, 0x4040702400932244ull
+};
+
+/***************************************************
+ * INIT SLIDERS
+ * Fill one piece's table, square by square
+ ***************************************************/
+template <int N>
+static void initSliders(Slider sliders[64], vector<Bitboard>& table,
+                        const array<Bitboard, 64>& masks,
+                        const Bitboard magics[64],
+                        const int (&steps)[N][2])
+{
+   size_t size = 0;
+   for (int square = 0; square < 64; square++)
+      size += (size_t)1 << countSquares(masks[square]);
+   table.assign(size, 0);
+
+   size_t offset = 0;
+   for (int square = 0; square < 64; square++)
+   {
+      Slider& slider = sliders[square];
+      int numBits = countSquares(masks[square]);
+      slider.mask     = masks[square];
+      slider.magic    = magics[square];
+      slider.shift    = 64 - numBits;
+      slider.pAttacks = &table[offset];
+      offset += (size_t)1 << numBits;
+
+      // every subset of the mask and what the slider attacks with it.
+      // Subsets that share an entry must attack the same squares
+      Bitboard subset = 0;
+      do
+      {
+         Bitboard attacks = getRayAttacks(square, subset, steps);
+         Bitboard& entry = slider.pAttacks[getIndex(slider, subset)];
+         assert(entry == 0 || entry == attacks);
+         entry = attacks;
+         subset = (subset - slider.mask) & slider.mask;
+      }
+      while (subset);
+   }
+}
+
+/***************************************************
+ * SLIDER INIT
+ * Build both tables as the program starts
+ ***************************************************/
+static struct SliderInit
+{
+   SliderInit()
+   {
+#ifdef BITBOARD_AVX2
+      __builtin_cpu_init();
+      hasAvx2 = __builtin_cpu_supports("avx2");
+#endif // BITBOARD_AVX2
+      initSliders(rookSliders,   rookTable,   ROOK_MASKS,   ROOK_MAGICS,   ROOK_STEPS);
+      initSliders(bishopSliders, bishopTable, BISHOP_MASKS, BISHOP_MAGICS, BISHOP_STEPS);
+   }
+} sliderInit;
+
+/***************************************************
+ * GET ROOK and BISHOP ATTACKS
+ ***************************************************/
+Bitboard getRookAttacks(int square, Bitboard occupied)
+{
+   const Slider& slider = rookSliders[square];
+   return slider.pAttacks[getIndex(slider, occupied)];
+}
+
+Bitboard getBishopAttacks(int square, Bitboard occupied)
+{
+   const Slider& slider = bishopSliders[square];
+   return slider.pAttacks[getIndex(slider, occupied)];
+}
+
+#ifdef BITBOARD_AVX2
+/***************************************************
+ * SLIDER FILL AVX2
+ * The scalar fill, four directions to a vector. The
+ * lanes of the first all shift up the board: north
+ * and east for the rooks, north east and north west
+ * for the bishops. The lanes of the second shift down
+ * by the same amounts: south, west, south west, and
+ * south east. Each lane keeps its own wrap mask
+ ***************************************************/
+__attribute__((target("avx2")))
+static Bitboard getSliderFillAvx2(Bitboard rooks, Bitboard bishops,
+                                  Bitboard occupied)
+{
+   const __m256i shift1 = _mm256_setr_epi64x( 8, 1,  9,  7);
+   const __m256i shift2 = _mm256_setr_epi64x(16, 2, 18, 14);
+   const __m256i shift4 = _mm256_setr_epi64x(32, 4, 36, 28);
+   const __m256i wrapUp   = _mm256_setr_epi64x((long long)ALL_FILES,
+                                               (long long)NOT_FILE_A,
+                                               (long long)NOT_FILE_A,
+                                               (long long)NOT_FILE_H);
+   const __m256i wrapDown = _mm256_setr_epi64x((long long)ALL_FILES,
+                                               (long long)NOT_FILE_H,
+                                               (long long)NOT_FILE_H,
+                                               (long long)NOT_FILE_A);
+
+   __m256i pieces = _mm256_setr_epi64x((long long)rooks,   (long long)rooks,
+                                       (long long)bishops, (long long)bishops);
+   __m256i empty  = _mm256_set1_epi64x((long long)~occupied);
+
+   __m256i up        = pieces;
+   __m256i emptyUp   = _mm256_and_si256(empty, wrapUp);
+   __m256i down      = pieces;
+   __m256i emptyDown = _mm256_and_si256(empty, wrapDown);
+
+   up        = _mm256_or_si256(up,   _mm256_and_si256(emptyUp,   _mm256_sllv_epi64(up,   shift1)));
+   down      = _mm256_or_si256(down, _mm256_and_si256(emptyDown, _mm256_srlv_epi64(down, shift1)));
+   emptyUp   = _mm256_and_si256(emptyUp,   _mm256_sllv_epi64(emptyUp,   shift1));
+   emptyDown = _mm256_and_si256(emptyDown, _mm256_srlv_epi64(emptyDown, shift1));
+   up        = _mm256_or_si256(up,   _mm256_and_si256(emptyUp,   _mm256_sllv_epi64(up,   shift2)));
+   down      = _mm256_or_si256(down, _mm256_and_si256(emptyDown, _mm256_srlv_epi64(down, shift2)));
+   emptyUp   = _mm256_and_si256(emptyUp,   _mm256_sllv_epi64(emptyUp,   shift2));
+   emptyDown = _mm256_and_si256(emptyDown, _mm256_srlv_epi64(emptyDown, shift2));
+   up        = _mm256_or_si256(up,   _mm256_and_si256(emptyUp,   _mm256_sllv_epi64(up,   shift4)));
+   down      = _mm256_or_si256(down, _mm256_and_si256(emptyDown, _mm256_srlv_epi64(down, shift4)));
+
+   // one more step onto the blockers, then fold the eight lanes together
+   __m256i attacks = _mm256_or_si256(
+      _mm256_and_si256(_mm256_sllv_epi64(up,   shift1), wrapUp),
+      _mm256_and_si256(_mm256_srlv_epi64(down, shift1), wrapDown));
+   __m128i half = _mm_or_si128(_mm256_castsi256_si128(attacks),
+                               _mm256_extracti128_si256(attacks, 1));
+   return (Bitboard)_mm_cvtsi128_si64(half) | (Bitboard)_mm_extract_epi64(half, 1);
+}
+#endif // BITBOARD_AVX2
+
+/***************************************************
+ * GET SLIDER FILL
+ ***************************************************/
+Bitboard getSliderFill(Bitboard rooks, Bitboard bishops, Bitboard occupied)
+{
+#ifdef BITBOARD_AVX2
+   if (hasAvx2)
+      return getSliderFillAvx2(rooks, bishops, occupied);
+#endif // BITBOARD_AVX2
+   return getSliderFillScalar(rooks, bishops, occupied);
+}
+
+/***************************************************
+ * IS USING AVX2
+ ***************************************************/
+bool isUsingAvx2()
+{
+   return hasAvx2;
+}
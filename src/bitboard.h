@@ -0,0 +1,290 @@
+/***********************************************************************
+ * Header File:
+ *    BITBOARD
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A set of squares as one 64-bit word, and the attack tables of the
+ *    pieces. Square numbers match Position::getLocation(): a1 is 0, h1
+ *    is 7, and h8 is 63. The tables of the pieces that jump are built by
+ *    the compiler, so finding where a knight, a king, or a pawn attacks
+ *    is a single load. The sliders need to know what is in the way, so
+ *    their tables are indexed by the occupied squares and built at
+ *    startup; a lookup is a multiply, a shift, and a load. To find every
+ *    square a whole side's sliders attack, the fill slides them all at
+ *    once instead.
+ ************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <bit>        // for COUNTR_ZERO and POPCOUNT
+#include <cstdint>
+
+typedef uint64_t Bitboard;
+
+/***************************************************
+ * SQUARE BIT
+ * The bitboard with just this square
+ ***************************************************/
+constexpr Bitboard squareBit(int square)
+{
+   return (Bitboard)1 << square;
+}
+
+/***************************************************
+ * POP SQUARE
+ * Remove the lowest square from the set and return it.
+ * The set must not be empty
+ ***************************************************/
+inline int popSquare(Bitboard& squares)
+{
+   int square = std::countr_zero(squares);
+   squares &= squares - 1;
+   return square;
+}
+
+/***************************************************
+ * COUNT SQUARES
+ ***************************************************/
+constexpr int countSquares(Bitboard squares)
+{
+   return std::popcount(squares);
+}
+
+/***************************************************
+ * GET JUMPS
+ * Every square one of these steps lands on from here
+ ***************************************************/
+template <int N>
+constexpr Bitboard getJumps(int square, const int (&delta)[N][2])
+{
+   Bitboard targets = 0;
+   for (int i = 0; i < N; i++)
+   {
+      int row = square / 8 + delta[i][0];
+      int col = square % 8 + delta[i][1];
+      if (row >= 0 && row < 8 && col >= 0 && col < 8)
+         targets |= squareBit(row * 8 + col);
+   }
+   return targets;
+}
+
+template <int N>
+constexpr std::array<Bitboard, 64> makeJumpTable(const int (&delta)[N][2])
+{
+   std::array<Bitboard, 64> table = {};
+   for (int square = 0; square < 64; square++)
+      table[square] = getJumps(square, delta);
+   return table;
+}
+
+// the steps, as { dRow, dCol }
+constexpr int KNIGHT_STEPS[8][2]     = { {-2,-1}, {-2, 1}, {-1,-2}, {-1, 2},
+                                         { 1,-2}, { 1, 2}, { 2,-1}, { 2, 1} };
+constexpr int KING_STEPS[8][2]       = { {-1,-1}, {-1, 0}, {-1, 1}, { 0,-1},
+                                         { 0, 1}, { 1,-1}, { 1, 0}, { 1, 1} };
+constexpr int PAWN_STEPS_BLACK[2][2] = { {-1,-1}, {-1, 1} };
+constexpr int PAWN_STEPS_WHITE[2][2] = { { 1,-1}, { 1, 1} };
+
+// the squares attacked from each square
+inline constexpr std::array<Bitboard, 64> KNIGHT_ATTACKS = makeJumpTable(KNIGHT_STEPS);
+inline constexpr std::array<Bitboard, 64> KING_ATTACKS   = makeJumpTable(KING_STEPS);
+
+// the squares a pawn captures on: [0] for black and [1] for white, so
+// a bool isWhite picks the row
+inline constexpr std::array<std::array<Bitboard, 64>, 2> PAWN_ATTACKS =
+{
+   makeJumpTable(PAWN_STEPS_BLACK),
+   makeJumpTable(PAWN_STEPS_WHITE)
+};
+
+static_assert(KNIGHT_ATTACKS[0] == (squareBit(10) | squareBit(17)),
+              "a knight on a1 attacks b3 and c2");
+static_assert(countSquares(KING_ATTACKS[27]) == 8, "a king on d4 attacks eight squares");
+static_assert(PAWN_ATTACKS[1][8] == squareBit(17) && PAWN_ATTACKS[0][48] == squareBit(41),
+              "pawns on the a-file attack only toward b");
+
+/***************************************************
+ * GET RAY ATTACKS
+ * Walk out from a square in each direction until a
+ * piece or the edge stops the walk. The blocker is
+ * included. This is the slow, obvious way; it builds
+ * the slider tables and checks them
+ ***************************************************/
+template <int N>
+constexpr Bitboard getRayAttacks(int square, Bitboard occupied,
+                                 const int (&steps)[N][2])
+{
+   Bitboard targets = 0;
+   for (int i = 0; i < N; i++)
+      for (int row = square / 8 + steps[i][0], col = square % 8 + steps[i][1];
+           row >= 0 && row < 8 && col >= 0 && col < 8;
+           row += steps[i][0], col += steps[i][1])
+      {
+         targets |= squareBit(row * 8 + col);
+         if (occupied & squareBit(row * 8 + col))
+            break;
+      }
+   return targets;
+}
+
+/***************************************************
+ * GET SLIDER MASK
+ * The squares that can block a slider: its rays without
+ * the last square of each, since a piece there blocks
+ * nothing further
+ ***************************************************/
+template <int N>
+constexpr Bitboard getSliderMask(int square, const int (&steps)[N][2])
+{
+   Bitboard mask = 0;
+   for (int i = 0; i < N; i++)
+      for (int row = square / 8 + steps[i][0], col = square % 8 + steps[i][1];
+           row + steps[i][0] >= 0 && row + steps[i][0] < 8 &&
+           col + steps[i][1] >= 0 && col + steps[i][1] < 8;
+           row += steps[i][0], col += steps[i][1])
+         mask |= squareBit(row * 8 + col);
+   return mask;
+}
+
+template <int N>
+constexpr std::array<Bitboard, 64> makeSliderMasks(const int (&steps)[N][2])
+{
+   std::array<Bitboard, 64> masks = {};
+   for (int square = 0; square < 64; square++)
+      masks[square] = getSliderMask(square, steps);
+   return masks;
+}
+
+constexpr int ROOK_STEPS[4][2]   = { {-1, 0}, { 0,-1}, { 0, 1}, { 1, 0} };
+constexpr int BISHOP_STEPS[4][2] = { {-1,-1}, {-1, 1}, { 1,-1}, { 1, 1} };
+
+// the squares that can block a slider on each square
+inline constexpr std::array<Bitboard, 64> ROOK_MASKS   = makeSliderMasks(ROOK_STEPS);
+inline constexpr std::array<Bitboard, 64> BISHOP_MASKS = makeSliderMasks(BISHOP_STEPS);
+
+static_assert(countSquares(ROOK_MASKS[0]) == 12 && countSquares(BISHOP_MASKS[27]) == 9,
+              "a rook on a1 has twelve blockers, a bishop on d4 nine");
+
+/***************************************************
+ * SLIDER ATTACKS
+ * Where a rook or bishop attacks from a square, given
+ * which squares hold pieces. Only the squares in the
+ * mask matter, so only they need to be filled in.
+ * The tables are built once at startup, and indexed
+ * with a magic multiply and shift
+ ***************************************************/
+Bitboard getRookAttacks(int square, Bitboard occupied);
+Bitboard getBishopAttacks(int square, Bitboard occupied);
+inline Bitboard getQueenAttacks(int square, Bitboard occupied)
+{
+   return getRookAttacks(square, occupied) | getBishopAttacks(square, occupied);
+}
+
+/***************************************************
+ * FILES
+ * A shift left one square wraps h onto the next a,
+ * and right one wraps a onto h. Masking off the file
+ * the shift lands on from the wrong side stops that
+ ***************************************************/
+constexpr Bitboard FILE_A     = 0x0101010101010101ull;
+constexpr Bitboard FILE_H     = 0x8080808080808080ull;
+constexpr Bitboard NOT_FILE_A = ~FILE_A;
+constexpr Bitboard NOT_FILE_H = ~FILE_H;
+constexpr Bitboard ALL_FILES  = ~(Bitboard)0;
+
+/***************************************************
+ * SHIFT SQUARES
+ * Up the board for a positive shift, down for negative
+ ***************************************************/
+constexpr Bitboard shiftSquares(Bitboard squares, int shift)
+{
+   return shift > 0 ? squares << shift : squares >> -shift;
+}
+
+/***************************************************
+ * GET FILL ATTACKS
+ * Kogge-Stone: slide every piece in the set one way
+ * at once. Each step doubles how far the pieces have
+ * slid and how far an empty run reaches, so three
+ * steps cover the board. The result is every square
+ * attacked that way, blockers included
+ ***************************************************/
+constexpr Bitboard getFillAttacks(Bitboard pieces, Bitboard empty,
+                                  int shift, Bitboard wrap)
+{
+   empty &= wrap;
+   pieces |= empty  & shiftSquares(pieces, shift);
+   empty  &=          shiftSquares(empty,  shift);
+   pieces |= empty  & shiftSquares(pieces, 2 * shift);
+   empty  &=          shiftSquares(empty,  2 * shift);
+   pieces |= empty  & shiftSquares(pieces, 4 * shift);
+   return shiftSquares(pieces, shift) & wrap;
+}
+
+/***************************************************
+ * GET KNIGHT FILL and GET PAWN FILL
+ * Every square a set of knights or pawns attacks. A
+ * knight move crosses one or two files, so the one or
+ * two files it cannot land on are masked off
+ ***************************************************/
+constexpr Bitboard getKnightFill(Bitboard knights)
+{
+   constexpr Bitboard NOT_FILE_AB = ~(FILE_A | FILE_A << 1);
+   constexpr Bitboard NOT_FILE_GH = ~(FILE_H | FILE_H >> 1);
+   return ((knights << 17 | knights >> 15) & NOT_FILE_A)  |
+          ((knights << 15 | knights >> 17) & NOT_FILE_H)  |
+          ((knights << 10 | knights >>  6) & NOT_FILE_AB) |
+          ((knights <<  6 | knights >> 10) & NOT_FILE_GH);
+}
+
+constexpr Bitboard getPawnFill(Bitboard pawns, bool isWhite)
+{
+   return isWhite ? ((pawns << 9) & NOT_FILE_A) | ((pawns << 7) & NOT_FILE_H)
+                  : ((pawns >> 7) & NOT_FILE_A) | ((pawns >> 9) & NOT_FILE_H);
+}
+
+static_assert(getKnightFill(squareBit(0) | squareBit(63)) ==
+              (KNIGHT_ATTACKS[0] | KNIGHT_ATTACKS[63]),
+              "the knight fill matches the table in the corners");
+static_assert(getPawnFill(squareBit(8) | squareBit(15), true) ==
+              (PAWN_ATTACKS[1][8] | PAWN_ATTACKS[1][15]),
+              "the pawn fill matches the table on the edges");
+
+/***************************************************
+ * GET SLIDER FILL SCALAR
+ * Every square attacked by a set of rooks and a set
+ * of bishops; a queen belongs in both. One word at a
+ * time, one direction after another
+ ***************************************************/
+constexpr Bitboard getSliderFillScalar(Bitboard rooks, Bitboard bishops,
+                                       Bitboard occupied)
+{
+   Bitboard empty = ~occupied;
+   return getFillAttacks(rooks,   empty,  8, ALL_FILES)  |   // north
+          getFillAttacks(rooks,   empty, -8, ALL_FILES)  |   // south
+          getFillAttacks(rooks,   empty,  1, NOT_FILE_A) |   // east
+          getFillAttacks(rooks,   empty, -1, NOT_FILE_H) |   // west
+          getFillAttacks(bishops, empty,  9, NOT_FILE_A) |   // north east
+          getFillAttacks(bishops, empty,  7, NOT_FILE_H) |   // north west
+          getFillAttacks(bishops, empty, -7, NOT_FILE_A) |   // south east
+          getFillAttacks(bishops, empty, -9, NOT_FILE_H);    // south west
+}
+
+static_assert(getSliderFillScalar(squareBit(0), 0, squareBit(3)) ==
+              (0x0101010101010100ull | squareBit(1) | squareBit(2) | squareBit(3)),
+              "a rook on a1 stops at the piece on d1");
+
+/***************************************************
+ * GET SLIDER FILL
+ * The same, for evaluation terms such as mobility and
+ * king attacks that want every slider of a side at
+ * once. Where the CPU has AVX2, the eight directions
+ * run in two vectors of four lanes. Build with
+ * -DBITBOARD_NO_AVX2 to always use the scalar fill
+ ***************************************************/
+Bitboard getSliderFill(Bitboard rooks, Bitboard bishops, Bitboard occupied);
+
+// is the slider fill done with AVX2?
+bool isUsingAvx2();
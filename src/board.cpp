@@ -18,7 +18,13 @@
 #include "pieceQueen.h"
 #include "pieceKing.h"
 #include "piecePawn.h"
+#include "allocTrack.h"
+#include "trace.h"
+#include "polyglot.h"    // for the key of each position
+#include "boardSnapshot.h" // for BOARD SNAPSHOT
+#include <algorithm>     // for MAX
 #include <cassert>
+#include <sstream>
 using namespace std;
 
 
@@ -40,6 +46,7 @@ using namespace std;
  ***********************************************/
 void Board::reset(bool fFree)
 {
+   ALLOC_SCOPE(ALLOC_BOARD, "Board::reset");
    // Free all pieces if requested
    if (fFree)
       free();
@@ -88,9 +95,220 @@ void Board::reset(bool fFree)
             board[c][r] = new Space(c, r);
    
    numMoves = 0;
+   castling = CASTLE_ALL;
+   enPassant.setInvalid();
+   syncOccupied();
+   startHistory(0);
+   publishSnapshot();
+   stateValid = false;
    assertBoard();
 }
 
+/***********************************************
+ * IS PIECE LETTER
+ *         Is this the FEN letter of a piece?
+ ***********************************************/
+static bool isPieceLetter(char letter)
+{
+   return letter != '\0' && string("KQRBNPkqrbnp").find(letter) != string::npos;
+}
+
+/***********************************************
+ * CREATE PIECE
+ *         Make a piece from its FEN letter: upper case is white.
+ *         A letter that is no piece gives null
+ ***********************************************/
+static Piece* createPiece(char letter, int c, int r)
+{
+   bool isWhite = (letter >= 'A' && letter <= 'Z');
+   switch (isWhite ? letter : letter - 'a' + 'A')
+   {
+      case 'K': return new King(c, r, isWhite);
+      case 'Q': return new Queen(c, r, isWhite);
+      case 'R': return new Rook(c, r, isWhite);
+      case 'B': return new Bishop(c, r, isWhite);
+      case 'N': return new Knight(c, r, isWhite);
+      case 'P': return new Pawn(c, r, isWhite);
+   }
+   return nullptr;
+}
+
+/***********************************************
+ * BOARD : READ FEN
+ *         Set up a position in Forsyth-Edwards Notation:
+ *   rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1
+ *         Only the placement is required; the other fields
+ *         default to white to move, no castling, and move 1. A
+ *         castling right is dropped if its king or rook is not at
+ *         home. Throws a string on error, leaving the board as it was
+ ***********************************************/
+void Board::readFEN(const string& fen)
+{
+   ALLOC_SCOPE(ALLOC_PARSE, "Board::readFEN");
+   istringstream sin(fen);
+   string placement;
+   string side = "w";
+   string castling = "-";
+   string enPassant = "-";
+   int halfmoves = 0;
+   int fullmoves = 1;
+   sin >> placement >> side >> castling >> enPassant >> halfmoves >> fullmoves;
+   
+   // the placement, from a8 across and then down to h1
+   char letters[8][8];
+   int c = 0;
+   int r = 7;
+   for (char ch : placement)
+   {
+      if (ch == '/')
+      {
+         if (c != 8 || r == 0)
+            throw string("Bad FEN placement: ") + fen;
+         c = 0;
+         r--;
+      }
+      else if (ch >= '1' && ch <= '8' && c + (ch - '0') <= 8)
+         for (int i = 0; i < ch - '0'; i++)
+            letters[c++][r] = ' ';
+      else if (c < 8 && isPieceLetter(ch))
+         letters[c++][r] = ch;
+      else
+         throw string("Bad FEN placement: ") + fen;
+   }
+   if (c != 8 || r != 0)
+      throw string("Bad FEN placement: ") + fen;
+   if ((side != "w" && side != "b") || fullmoves < 1)
+      throw string("Bad FEN side to move: ") + fen;
+   if (halfmoves < 0)
+      throw string("Bad FEN halfmove clock: ") + fen;
+   if (castling != "-" &&
+       (castling.empty() || castling.find_first_not_of("KQkq") != string::npos))
+      throw string("Bad FEN castling: ") + fen;
+   
+   // the square skipped is behind the pawn of the side that just moved
+   Position posEnPassant(enPassant.c_str());
+   if (enPassant != "-" &&
+       (enPassant.size() != 2 || posEnPassant.isInvalid() ||
+        posEnPassant.getRow() != (side == "w" ? 5 : 2)))
+      throw string("Bad FEN en passant square: ") + fen;
+   
+   // replace the pieces
+   free();
+   for (c = 0; c < 8; c++)
+      for (r = 0; r < 8; r++)
+      {
+         board[c][r] = createPiece(letters[c][r], c, r);
+         if (board[c][r] == nullptr)
+            board[c][r] = new Space(c, r);
+      }
+   numMoves = 2 * (fullmoves - 1) + (side == "b" ? 1 : 0);
+   
+   // a right needs its king and rook where they started
+   this->castling = CASTLE_NONE;
+   for (int i = 0; i < 4; i++)
+   {
+      bool isWhite = (i < 2);
+      int row = isWhite ? 0 : 7;
+      int colRook = (i % 2 == 0) ? 7 : 0;
+      const Piece* pKing = board[4][row];
+      const Piece* pRook = board[colRook][row];
+      if (castling.find("KQkq"[i]) != string::npos &&
+          pKing->getType() == KING && pKing->isWhite() == isWhite &&
+          pRook->getType() == ROOK && pRook->isWhite() == isWhite)
+         this->castling |= (1 << i);
+   }
+   
+   if (enPassant == "-")
+      this->enPassant.setInvalid();
+   else
+      this->enPassant = posEnPassant;
+   
+   syncOccupied();
+   startHistory(halfmoves);
+   publishSnapshot();
+   stateValid = false;
+}
+
+/***********************************************
+ * BOARD : GET FEN
+ *         The position as readFEN() takes it. Every field is
+ *         written, so a board made from it plays on the same
+ ***********************************************/
+string Board::getFEN() const
+{
+   ALLOC_SCOPE(ALLOC_PARSE, "Board::getFEN");
+   return BoardSnapshot(*this).getFEN();
+}
+
+/***********************************************
+ * BOARD : CAN CASTLE
+ *         Does the side still hold the right? Whether it can
+ *         castle now is up to the king
+ ***********************************************/
+bool Board::canCastle(bool isWhite, bool isKingSide) const
+{
+   int right = isWhite ? (isKingSide ? CASTLE_WHITE_SHORT : CASTLE_WHITE_LONG)
+                       : (isKingSide ? CASTLE_BLACK_SHORT : CASTLE_BLACK_LONG);
+   return (castling & right) != 0;
+}
+
+/***********************************************
+ * CASTLING LOST
+ *         The rights lost when a piece moves from or to this
+ *         square: from a king's home, both of that side; from
+ *         or onto a rook's corner, that one
+ ***********************************************/
+static int castlingLost(const Position& pos)
+{
+   switch (pos.getLocation())
+   {
+      case  0: return CASTLE_WHITE_LONG;                        // a1
+      case  4: return CASTLE_WHITE_SHORT | CASTLE_WHITE_LONG;   // e1
+      case  7: return CASTLE_WHITE_SHORT;                       // h1
+      case 56: return CASTLE_BLACK_LONG;                        // a8
+      case 60: return CASTLE_BLACK_SHORT | CASTLE_BLACK_LONG;   // e8
+      case 63: return CASTLE_BLACK_SHORT;                       // h8
+   }
+   return CASTLE_NONE;
+}
+
+/***********************************************
+ * GET SQUARES CHANGED
+ *         The squares a move puts a piece on or takes one off:
+ *         the source and destination, the pawn taken en passant,
+ *         and the corner and landing square of a castling rook
+ ***********************************************/
+static int getSquaresChanged(const Move& move, Position squares[4])
+{
+   int row = move.getSource().getRow();
+   int num = 0;
+   squares[num++] = move.getSource();
+   squares[num++] = move.getDest();
+   if (move.getMoveType() == Move::ENPASSANT)
+      squares[num++] = Position(move.getDest().getCol(), row);
+   else if (move.getMoveType() == Move::CASTLE_KING)
+   {
+      squares[num++] = Position(7, row);
+      squares[num++] = Position(5, row);
+   }
+   else if (move.getMoveType() == Move::CASTLE_QUEEN)
+   {
+      squares[num++] = Position(0, row);
+      squares[num++] = Position(3, row);
+   }
+   return num;
+}
+
+/***********************************************
+ * GET PIECE KEY
+ *         The key of what stands on a square. A test may leave
+ *         a square empty
+ ***********************************************/
+static uint64_t getPieceKey(const Piece* pPiece, const Position& pos)
+{
+   return pPiece ? polyglotPieceKey(*pPiece, pos) : 0;
+}
+
 /***********************************************
  * BOARD : GET
  *         Get a piece from a given position.
@@ -115,22 +333,27 @@ Piece& Board::operator[](const Position& pos)
  ***********************************************/
 void Board::display(const Position& posHover, const Position& posSelect) const
 {
+   ALLOC_SCOPE(ALLOC_RENDER, "Board::display");
+   TRACE_SCOPE("Board::display");
    // Draw the board
    pgout->drawBoard();
 
-   // Check game status and display message
-   bool currentPlayerIsWhite = whiteTurn();
-   if (isInCheckmate(currentPlayerIsWhite))
-   {
-      pgout->drawGameStatus("CHECKMATE!");
-   }
-   else if (isInStalemate(currentPlayerIsWhite))
+   // Display the game status of the side to move
+   switch (getGameState().status)
    {
-      pgout->drawGameStatus("STALEMATE!");
-   }
-   else if (isInCheck(currentPlayerIsWhite))
-   {
-      pgout->drawGameStatus("CHECK!");
+      case CHECKMATE:
+         pgout->drawGameStatus("CHECKMATE!");
+         break;
+      case STALEMATE:
+         pgout->drawGameStatus("STALEMATE!");
+         break;
+      case CHECK:
+         pgout->drawGameStatus("CHECK!");
+         break;
+      case PLAYING:
+         if (isDrawClaimable())
+            pgout->drawGameStatus("DRAW MAY BE CLAIMED");
+         break;
    }
   
    if (posHover.isValid() && (*this)[posHover].getType() != SPACE)
@@ -144,7 +367,10 @@ void Board::display(const Position& posHover, const Position& posSelect) const
       {
          pgout->drawSelected(posSelect);
          set<Move> possibleMoves;
-         selectedPiece->getMoves(possibleMoves, *this);
+         if (selectedPiece->isWhite() == whiteTurn())
+            getLegalMoves(posSelect, possibleMoves);
+         else
+            selectedPiece->getMoves(possibleMoves, *this);
          for (const Move& m : possibleMoves)
             pgout->drawPossible(m.getDest());
       }
@@ -159,6 +385,9 @@ void Board::display(const Position& posHover, const Position& posSelect) const
             board[c][r]->display(pgout);
       }
    }
+   
+   // the highlights and pieces are drawn together, in a few calls
+   pgout->finishFrame();
 }
 
 
@@ -166,7 +395,9 @@ void Board::display(const Position& posHover, const Position& posSelect) const
  * BOARD : CONSTRUCT
  *         Free up all the allocated memory
  ************************************************/
-Board::Board(ogstream* pgout, bool noreset) : pgout(pgout), numMoves(0)
+Board::Board(ogstream* pgout, bool noreset) :
+   pgout(pgout), numMoves(0), halfmoveClock(0), castling(CASTLE_ALL),
+   isPublishing(true), stateValid(false)
 {
    // Initialize all board pointers to nullptr
    for (int c = 0; c < 8; ++c)
@@ -211,9 +442,59 @@ Board::Board(ogstream* pgout, bool noreset) : pgout(pgout), numMoves(0)
          if (board[c][r] == nullptr)
             board[c][r] = new Space(c, r);
    
+   syncOccupied();
+   startHistory(0);
+   publishSnapshot();
    if (noreset) reset();
 }
 
+/***********************************************
+ * CLONE PIECE
+ *         A piece of the same type and color that has moved
+ *         as often, and as lately, as this one
+ ***********************************************/
+static Piece* clonePiece(const Piece* pPiece)
+{
+   if (pPiece == nullptr)
+      return nullptr;
+   
+   Piece* pClone = nullptr;
+   switch (pPiece->getType())
+   {
+      case KING:   pClone = new King  (*static_cast<const King*  >(pPiece)); break;
+      case QUEEN:  pClone = new Queen (*static_cast<const Queen* >(pPiece)); break;
+      case ROOK:   pClone = new Rook  (*static_cast<const Rook*  >(pPiece)); break;
+      case BISHOP: pClone = new Bishop(*static_cast<const Bishop*>(pPiece)); break;
+      case KNIGHT: pClone = new Knight(*static_cast<const Knight*>(pPiece)); break;
+      case PAWN:   pClone = new Pawn  (*static_cast<const Pawn*  >(pPiece)); break;
+      default:     pClone = new Space (*static_cast<const Space* >(pPiece)); break;
+   }
+   
+   // Piece::operator= leaves the position alone
+   const Position& pos = pPiece->getPosition();
+   pClone->setPosition(pos.getCol(), pos.getRow());
+   return pClone;
+}
+
+/************************************************
+ * BOARD : COPY CONSTRUCT
+ *         Copy the pieces and the history rather than going
+ *         through a FEN, which has neither the history nor how
+ *         often each piece has moved. The game state is worked
+ *         out again when it is first asked for
+ ************************************************/
+Board::Board(const Board& rhs) :
+   numMoves(rhs.numMoves), halfmoveClock(rhs.halfmoveClock),
+   castling(rhs.castling), enPassant(rhs.enPassant), occupied(rhs.occupied),
+   key(rhs.key), history(rhs.history),
+   isPublishing(false), stateValid(false), pgout(nullptr)
+{
+   ALLOC_SCOPE(ALLOC_BOARD, "Board::Board(copy)");
+   for (int c = 0; c < 8; ++c)
+      for (int r = 0; r < 8; ++r)
+         board[c][r] = clonePiece(rhs.board[c][r]);
+}
+
 /************************************************
  * BOARD : FREE
  *         Free up all the allocated memory
@@ -223,8 +504,11 @@ void Board::free()
    // Delete all pieces and set pointers to nullptr
    for (int c = 0; c < 8; ++c)
       for (int r = 0; r < 8; ++r)
-         if (board[c][r] == nullptr)
+         if (board[c][r] != nullptr)
+         {
             delete board[c][r];
+            board[c][r] = nullptr;
+         }
 }
 
 
@@ -261,6 +545,8 @@ void Board::assertBoard()
  *********************************************/
 void Board::move(const Move& move)
 {
+   ALLOC_SCOPE(ALLOC_BOARD, "Board::move");
+   TRACE_SCOPE("Board::move");
    int srcCol = move.getSource().getCol();
    int srcRow = move.getSource().getRow();
    Piece* pMoving = board[srcCol][srcRow];
@@ -274,8 +560,62 @@ void Board::move(const Move& move)
    if (legalMoves.find(move) == legalMoves.end())
       return;
    
+   // a capture or a pawn move can never be undone, so no position
+   // before it can come again
+   Piece* pTarget = board[move.getDest().getCol()][move.getDest().getRow()];
+   bool isIrreversible = pMoving->getType() == PAWN ||
+                         (pTarget && pTarget->getType() != SPACE);
+   
+   // the key loses the rights and the pieces the move changes, and
+   // gains them back as they are after it
+   Position squares[4];
+   int numSquares = getSquaresChanged(move, squares);
+   key ^= polyglotRightsKey(*this);
+   for (int i = 0; i < numSquares; i++)
+      key ^= getPieceKey(getPiece(squares[i]), squares[i]);
+   
+   pMoving->setLastMove(numMoves);
    ++numMoves;
    
+   // the rights and the en passant square before the pieces move
+   castling &= ~(castlingLost(move.getSource()) | castlingLost(move.getDest()));
+   int rowsMoved = move.getDest().getRow() - srcRow;
+   if (pMoving->getType() == PAWN && (rowsMoved == 2 || rowsMoved == -2))
+      enPassant = Position(srcCol, srcRow + rowsMoved / 2);
+   else
+      enPassant.setInvalid();
+   
+   placePieces(move);
+   for (int i = 0; i < numSquares; i++)
+   {
+      const Piece* pPiece = getPiece(squares[i]);
+      key ^= getPieceKey(pPiece, squares[i]);
+      if (pPiece && pPiece->getType() != SPACE)
+         occupied |= squareBit(squares[i].getLocation());
+      else
+         occupied &= ~squareBit(squares[i].getLocation());
+   }
+   key ^= polyglotRightsKey(*this) ^ polyglotTurnKey();
+   
+   halfmoveClock = isIrreversible ? 0 : halfmoveClock + 1;
+   history.push_back(key);
+   publishSnapshot();
+   
+   // the position changed. The game state is worked out the first time
+   // it is asked for, so replaying a game that never asks costs nothing
+   stateValid = false;
+}
+
+/**********************************************
+ * BOARD : PLACE PIECES
+ *         Rearrange the pieces for a move already known to be legal
+ *   INPUT move The instructions of the move
+ *********************************************/
+void Board::placePieces(const Move& move)
+{
+   int srcCol = move.getSource().getCol();
+   int srcRow = move.getSource().getRow();
+   Piece* pMoving = board[srcCol][srcRow];
    int dstCol = move.getDest().getCol();
    int dstRow = move.getDest().getRow();
    
@@ -377,44 +717,161 @@ Position Board::findKing(bool isWhite) const
 }
 
 /**********************************************
- * BOARD : IS SQUARE UNDER ATTACK
- * Check if a square is under attack by the opponent
+ * BOARD : SYNC OCCUPIED
+ * Look at every square. Only setting up a position
+ * needs this; a move changes the few squares it touches
  *********************************************/
-bool Board::isSquareUnderAttack(const Position& pos, bool byWhite) const
+void Board::syncOccupied()
 {
-   if (!pos.isValid())
-      return false;
-   
-   // Check all opponent pieces
+   occupied = 0;
    for (int c = 0; c < 8; ++c)
-   {
       for (int r = 0; r < 8; ++r)
+         if (board[c][r] && board[c][r]->getType() != SPACE)
+            occupied |= squareBit(r * 8 + c);
+}
+
+/**********************************************
+ * BOARD : GET ATTACK MAP
+ * One pass over the board: the jumpers add their
+ * table entries, and the sliders are collected and
+ * filled all together
+ *********************************************/
+Bitboard Board::getAttackMap(bool byWhite) const
+{
+   TRACE_SCOPE("Board::getAttackMap");
+   Bitboard attacks  = 0;
+   Bitboard rooks    = 0;
+   Bitboard bishops  = 0;
+   Bitboard occupied = 0;
+   for (int square = 0; square < 64; square++)
+   {
+      Piece* piece = board[square % 8][square / 8];
+      if (!piece || piece->getType() == SPACE)
+         continue;
+      occupied |= squareBit(square);
+      if (piece->isWhite() != byWhite)
+         continue;
+      switch (piece->getType())
       {
-         Piece* piece = board[c][r];
-         if (piece && piece->getType() != SPACE && piece->isWhite() == byWhite)
-         {
-            set<Move> moves;
-            piece->getMoves(moves, *this);
-            
-            // Check if any move targets this position
-            for (const Move& move : moves)
-            {
-               if (move.getDest() == pos)
-               {
-                  return true;
-               }
-            }
-         }
+         case PAWN:
+            attacks |= PAWN_ATTACKS[byWhite][square];
+            break;
+         case KNIGHT:
+            attacks |= KNIGHT_ATTACKS[square];
+            break;
+         case KING:
+            attacks |= KING_ATTACKS[square];
+            break;
+         case ROOK:
+            rooks |= squareBit(square);
+            break;
+         case BISHOP:
+            bishops |= squareBit(square);
+            break;
+         case QUEEN:
+            rooks |= squareBit(square);
+            bishops |= squareBit(square);
+            break;
+         default:
+            break;
       }
    }
-   return false;
+   return attacks | getSliderFill(rooks, bishops, occupied);
+}
+
+/**********************************************
+ * BOARD : GET ATTACK SQUARES
+ * The squares of every piece of the given color that
+ * attacks this one. The jumping pieces are found with
+ * the attack tables: a knight attacks here if it stands
+ * where a knight from here would land. The sliders work
+ * the same way: a rook attacks here if it stands where
+ * a rook from here would stop.
+ *
+ * To ask about a move without making it, the squares it
+ * empties are vacated, and the square it lands on is
+ * filled by a piece that attacks nothing
+ *********************************************/
+Bitboard Board::getAttackSquares(const Position& pos, bool byWhite,
+                                 Bitboard vacated, Bitboard filled) const
+{
+   Bitboard attackers = 0;
+   if (!pos.isValid())
+      return attackers;
+   int square = pos.getLocation();
+
+   auto isPiece = [&](int squareFrom, PieceType type)
+   {
+      if ((vacated | filled) & squareBit(squareFrom))
+         return false;
+      Piece* piece = board[squareFrom % 8][squareFrom / 8];
+      return piece && piece->getType() == type && piece->isWhite() == byWhite;
+   };
+   auto addAttackers = [&](Bitboard squares, PieceType type, PieceType typeOther)
+   {
+      while (squares)
+      {
+         int squareFrom = popSquare(squares);
+         if (isPiece(squareFrom, type) || isPiece(squareFrom, typeOther))
+            attackers |= squareBit(squareFrom);
+      }
+   };
+
+   // a white pawn attacks here from where a black pawn here would capture
+   addAttackers(KNIGHT_ATTACKS[square], KNIGHT, KNIGHT);
+   addAttackers(KING_ATTACKS[square], KING, KING);
+   addAttackers(PAWN_ATTACKS[!byWhite][square], PAWN, PAWN);
+
+   // a slider can only stand on a square we know is occupied or on the
+   // edge, which is not in the mask
+   Bitboard mask = ROOK_MASKS[square] | BISHOP_MASKS[square];
+   Bitboard occupied = (getOccupied(mask) & ~vacated) | (filled & mask);
+   Bitboard candidates = occupied | ~mask;
+   addAttackers(getRookAttacks(square, candidates & mask) & candidates, ROOK, QUEEN);
+   addAttackers(getBishopAttacks(square, candidates & mask) & candidates, BISHOP, QUEEN);
+   return attackers;
+}
+
+/**********************************************
+ * BOARD : IS SQUARE UNDER ATTACK
+ * Can a piece of the given color capture on this square?
+ *********************************************/
+bool Board::isSquareUnderAttack(const Position& pos, bool byWhite) const
+{
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Board::isSquareUnderAttack");
+   TRACE_SCOPE("Board::isSquareUnderAttack");
+   return getAttackSquares(pos, byWhite) != 0;
+}
+
+/**********************************************
+ * BOARD : GET ATTACKERS
+ * Every piece of the given color that can reach a square
+ *********************************************/
+void Board::getAttackers(const Position& pos, bool byWhite,
+                         vector<Position>& attackers) const
+{
+   Bitboard squares = getAttackSquares(pos, byWhite);
+   while (squares)
+      attackers.push_back(Position(popSquare(squares)));
 }
 
 /**********************************************
  * BOARD : IS IN CHECK
- * Determine if the king of the given color is in check
+ * Determine if the king of the given color is in check.
+ * The side to move is answered from the game state
  *********************************************/
 bool Board::isInCheck(bool isWhite) const
+{
+   if (isWhite == whiteTurn())
+      return !getGameState().checkers.empty();
+   return isKingAttacked(isWhite);
+}
+
+/**********************************************
+ * BOARD : IS KING ATTACKED
+ * Look at the board to see if the king of the given color is in check
+ *********************************************/
+bool Board::isKingAttacked(bool isWhite) const
 {
    Position kingPos = findKing(isWhite);
    
@@ -431,38 +888,25 @@ bool Board::isInCheck(bool isWhite) const
  *********************************************/
 bool Board::wouldMoveLeaveKingInCheck(const Move& move, bool isWhite) const
 {
-   // Make a temporary copy of the board state
-   Piece* tempBoard[8][8];
-   for (int c = 0; c < 8; ++c)
-      for (int r = 0; r < 8; ++r)
-         tempBoard[c][r] = board[c][r];
-   
-   int srcCol = move.getSource().getCol();
-   int srcRow = move.getSource().getRow();
-   int dstCol = move.getDest().getCol();
-   int dstRow = move.getDest().getRow();
-   
-   // Simulate the move
-   Piece* movingPiece = board[srcCol][srcRow];
-   Piece* capturedPiece = board[dstCol][dstRow];
-   
-   // Temporarily modify the board array
-   const_cast<Board*>(this)->board[dstCol][dstRow] = movingPiece;
-   const_cast<Board*>(this)->board[srcCol][srcRow] = nullptr;
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Board::wouldMoveLeaveKingInCheck");
+   const Position& src = move.getSource();
+   const Position& dst = move.getDest();
    
-   // Update piece position temporarily
-   Position originalPos = movingPiece->getPosition();
-   const_cast<Piece*>(movingPiece)->setPosition(dstCol, dstRow);
-   
-   // Check if king is in check after this move
-   bool kingInCheck = isInCheck(isWhite);
+   // the move empties its source, and en passant the square of the
+   // pawn it takes. Whatever stood on the destination is gone
+   Bitboard vacated = squareBit(src.getLocation());
+   if (move.getMoveType() == Move::ENPASSANT)
+      vacated |= squareBit(Position(dst.getCol(), src.getRow()).getLocation());
+   Bitboard filled = squareBit(dst.getLocation());
    
-   // Restore the board
-   const_cast<Board*>(this)->board[srcCol][srcRow] = movingPiece;
-   const_cast<Board*>(this)->board[dstCol][dstRow] = capturedPiece;
-   const_cast<Piece*>(movingPiece)->setPosition(originalPos.getCol(), originalPos.getRow());
+   const Piece* movingPiece = board[src.getCol()][src.getRow()];
+   Position kingPos = (movingPiece && movingPiece->getType() == KING) ?
+                      dst : findKing(isWhite);
+   if (kingPos.isInvalid())
+      return false;
    
-   return kingInCheck;
+   // the board is only read, so other readers are never disturbed
+   return getAttackSquares(kingPos, !isWhite, vacated, filled) != 0;
 }
 
 /**********************************************
@@ -471,6 +915,7 @@ bool Board::wouldMoveLeaveKingInCheck(const Move& move, bool isWhite) const
  *********************************************/
 bool Board::hasLegalMoves(bool isWhite) const
 {
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Board::hasLegalMoves");
    for (int c = 0; c < 8; ++c)
    {
       for (int r = 0; r < 8; ++r)
@@ -495,13 +940,208 @@ bool Board::hasLegalMoves(bool isWhite) const
    return false;
 }
 
+/**********************************************
+ * BOARD : GET LEGAL MOVES
+ * Collect every move the side to move may make. Because
+ * the set is ordered, the position of a move within it is
+ * stable and can be used to encode the move compactly
+ *********************************************/
+void Board::getLegalMoves(set <Move>& moves) const
+{
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Board::getLegalMoves");
+   const set <Move>& legalMoves = getGameState().legalMoves;
+   moves.insert(legalMoves.begin(), legalMoves.end());
+}
+
+void Board::getLegalMoves(const Position& posFrom, set <Move>& moves) const
+{
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Board::getLegalMoves(from)");
+   for (const Move& move : getGameState().legalMoves)
+      if (move.getSource() == posFrom)
+         moves.insert(move);
+}
+
+/**********************************************
+ * BOARD : GET GAME STATE
+ * Worked out the first time it is asked for after each
+ * move, then kept until the next one
+ *********************************************/
+const GameState& Board::getGameState() const
+{
+   if (!stateValid)
+      computeGameState();
+   return state;
+}
+
+/**********************************************
+ * BOARD : COMPUTE GAME STATE
+ * Generate the legal moves and find the checkers of the
+ * side to move. This is the expensive part of the game
+ * status, so it is done once per position
+ *********************************************/
+void Board::computeGameState() const
+{
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Board::computeGameState");
+   TRACE_SCOPE("Board::computeGameState");
+   bool isWhite = whiteTurn();
+   state.legalMoves.clear();
+   state.checkers.clear();
+   
+   for (int c = 0; c < 8; ++c)
+   {
+      for (int r = 0; r < 8; ++r)
+      {
+         Piece* piece = board[c][r];
+         if (piece && piece->getType() != SPACE && piece->isWhite() == isWhite)
+         {
+            set<Move> pieceMoves;
+            piece->getMoves(pieceMoves, *this);
+            for (const Move& move : pieceMoves)
+               if (!wouldMoveLeaveKingInCheck(move, isWhite))
+                  state.legalMoves.insert(move);
+         }
+      }
+   }
+   
+   Position kingPos = findKing(isWhite);
+   if (kingPos.isValid())
+      getAttackers(kingPos, !isWhite, state.checkers);
+   
+   if (state.checkers.empty())
+      state.status = state.legalMoves.empty() ? STALEMATE : PLAYING;
+   else
+      state.status = state.legalMoves.empty() ? CHECKMATE : CHECK;
+   TRACE_COUNT("legal moves generated", state.legalMoves.size());
+   stateValid = true;
+}
+
+/**********************************************
+ * BOARD : COUNT REPETITIONS
+ * How many times this position was seen before. Only
+ * the same side can be to move, so every other key is
+ * compared, back as far as the last capture or pawn move
+ *********************************************/
+int Board::countRepetitions() const
+{
+   int count = 0;
+   int iLast = (int)history.size() - 1;
+   int iFirst = max(0, iLast - halfmoveClock);
+   for (int i = iLast - 2; i >= iFirst; i -= 2)
+      if (history[i] == key)
+         count++;
+   return count;
+}
+
+/**********************************************
+ * BOARD : GET DRAW CLAIM
+ * The third time a position comes, or the hundredth
+ * move by either side without a capture or pawn move,
+ * either player may claim a draw. Neither ends the game
+ * by itself, and a mate on that move still counts
+ *********************************************/
+DrawClaim Board::getDrawClaim() const
+{
+   if (isThreefoldRepetition())
+      return DRAW_REPETITION;
+   if (isFiftyMoveDraw())
+      return DRAW_FIFTY_MOVES;
+   return DRAW_NONE;
+}
+
+/**********************************************
+ * BOARD : START HISTORY
+ * A new position with nothing behind it
+ *********************************************/
+void Board::startHistory(int halfmoveClock)
+{
+   this->halfmoveClock = halfmoveClock;
+   key = polyglotKey(*this);
+   history.clear();
+   history.push_back(key);
+}
+
+/**********************************************
+ * BOARD : GET HISTORY
+ *********************************************/
+vector<uint64_t> Board::getHistory() const
+{
+   size_t num = min(history.size(), (size_t)halfmoveClock + 1);
+   return vector<uint64_t>(history.end() - num, history.end());
+}
+
+/**********************************************
+ * BOARD : SET HISTORY
+ * The last key must be this position's, or the keys
+ * are of another game
+ *********************************************/
+void Board::setHistory(const vector<uint64_t>& history)
+{
+   if (history.empty() || history.back() != getKey())
+      throw string("The history does not end in this position");
+   this->history = history;
+}
+
+/**********************************************
+ * BOARD : PUBLISH SNAPSHOT
+ * Called by the thread that owns the board each time
+ * the position changes. The lock is held only to swap
+ * the pointer; a reader holding the old snapshot keeps
+ * it alive until it lets go. A copy publishes nothing:
+ * the search plays a move on one at every node
+ *********************************************/
+void Board::publishSnapshot()
+{
+   if (!isPublishing)
+      return;
+   
+   shared_ptr<const BoardSnapshot> snapshotNew = make_shared<const BoardSnapshot>(*this);
+   lock_guard<mutex> lock(mutexSnapshot);
+   snapshot.swap(snapshotNew);
+}
+
+/**********************************************
+ * BOARD : GET SNAPSHOT
+ *********************************************/
+shared_ptr<const BoardSnapshot> Board::getSnapshot() const
+{
+   lock_guard<mutex> lock(mutexSnapshot);
+   return snapshot;
+}
+
+/**********************************************
+ * BOARD : PERFT
+ * Count the positions at the end of every line of legal
+ * moves this deep. There is no undo, so each move is
+ * played on a copy of this board. A draw that may be
+ * claimed ends no line; the moves are still legal
+ *********************************************/
+uint64_t Board::perft(int depth) const
+{
+   if (depth <= 0)
+      return 1;
+   const set<Move>& moves = getGameState().legalMoves;
+   if (depth == 1)
+      return moves.size();
+   
+   uint64_t count = 0;
+   for (const Move& move : moves)
+   {
+      Board copy(*this);
+      copy.move(move);
+      count += copy.perft(depth - 1);
+   }
+   return count;
+}
+
 /**********************************************
  * BOARD : IS IN CHECKMATE
  * Determine if the player is in checkmate
  *********************************************/
 bool Board::isInCheckmate(bool isWhite) const
 {
-   return isInCheck(isWhite) && !hasLegalMoves(isWhite);
+   if (isWhite == whiteTurn())
+      return getGameState().status == CHECKMATE;
+   return isKingAttacked(isWhite) && !hasLegalMoves(isWhite);
 }
 
 /**********************************************
@@ -510,7 +1150,9 @@ bool Board::isInCheckmate(bool isWhite) const
  *********************************************/
 bool Board::isInStalemate(bool isWhite) const
 {
-   return !isInCheck(isWhite) && !hasLegalMoves(isWhite);
+   if (isWhite == whiteTurn())
+      return getGameState().status == STALEMATE;
+   return !isKingAttacked(isWhite) && !hasLegalMoves(isWhite);
 }
 
 /**********************************************
@@ -525,6 +1167,7 @@ BoardEmpty::BoardEmpty() : BoardDummy(), pSpace(nullptr), moveNumber(0)
       for (int r = 0; r < 8; ++r)
          board[c][r] = nullptr;
    pSpace = new Space(0, 0);
+   occupied = 0;
 }
 BoardEmpty::~BoardEmpty()
 {
@@ -9,10 +9,16 @@
 
 #pragma once
 
+#include <set>
 #include <stack>
+#include <string>
+#include <vector>
+#include <memory>      // for SHARED_PTR
+#include <mutex>
 #include <cassert>
 #include "move.h"      // Because we return a set of Move
 #include "position.h"  // Because we use Position in method signatures
+#include "bitboard.h"  // for the squares a piece is attacked from
 
 class ogstream;
 class TestPawn;
@@ -23,8 +29,51 @@ class TestQueen;
 class TestKing;
 class TestBoard;
 class Piece;
+class BoardSnapshot;
 
+/***************************************************
+ * GAME STATUS
+ * Where the side to move stands
+ **************************************************/
+enum GameStatus { PLAYING, CHECK, CHECKMATE, STALEMATE };
+
+/***************************************************
+ * DRAW CLAIM
+ * A draw by rule the side to move may claim. The game
+ * goes on unless it does, so the moves stay legal
+ **************************************************/
+enum DrawClaim { DRAW_NONE, DRAW_REPETITION, DRAW_FIFTY_MOVES };
 
+/***************************************************
+ * CASTLING RIGHTS
+ * One bit for each side and wing that may still castle.
+ * A right is lost for good when the king or that rook
+ * moves, or the rook is taken in its corner
+ **************************************************/
+enum CastlingRights
+{
+   CASTLE_NONE        = 0,
+   CASTLE_WHITE_SHORT = 1,
+   CASTLE_WHITE_LONG  = 2,
+   CASTLE_BLACK_SHORT = 4,
+   CASTLE_BLACK_LONG  = 8,
+   CASTLE_ALL         = 15
+};
+
+/***************************************************
+ * GAME STATE
+ * Everything about the position the display and the
+ * check queries need. It only changes when a move is
+ * made, so it is worked out once per move
+ **************************************************/
+struct GameState
+{
+   GameState() : status(PLAYING) {}
+
+   GameStatus            status;
+   std::set <Move>       legalMoves;  // for the side to move
+   std::vector<Position> checkers;    // pieces giving check
+};
 
 /***************************************************
  * BOARD
@@ -45,6 +94,12 @@ public:
    Board(ogstream* pgout = nullptr, bool noreset = false);
    virtual ~Board()   { free(); }
    
+   // a board to play moves on without disturbing this one. It has the
+   // same history, so it sees the same repetitions. It draws nowhere,
+   // and publishes no snapshots since no other thread reads it
+   Board(const Board& rhs);
+   Board& operator = (const Board& rhs) = delete;
+   
    // getters
    virtual int  getCurrentMove() const { return numMoves;      }
    virtual bool whiteTurn()      const { return getCurrentMove() % 2==0;  }
@@ -56,6 +111,34 @@ public:
       return board[pos.getCol()][pos.getRow()];
    }
    
+   // who may still castle, and the square a pawn skipped over with its
+   // double step on the last move (invalid if there was none)
+   bool canCastle(bool isWhite, bool isKingSide) const;
+   int  getCastlingRights()         const { return castling;  }
+   const Position& getEnPassant()   const { return enPassant; }
+   
+   // the position in Forsyth-Edwards Notation, as readFEN() takes it
+   std::string getFEN() const;
+   
+   // the position as of the last move. Only this may be called from
+   // another thread: the snapshot never changes, and a move publishes
+   // a new one rather than waiting for readers of the old. A copy of a
+   // board has none
+   std::shared_ptr<const BoardSnapshot> getSnapshot() const;
+   
+   // the number of lines of legal moves this deep. The counts of some
+   // positions are published, so this checks the move generator
+   uint64_t perft(int depth) const;
+   
+   // which of these squares hold a piece
+   Bitboard getOccupied(Bitboard squares) const { return occupied & squares; }
+   
+   // every square a piece of this color attacks
+   Bitboard getAttackMap(bool byWhite) const;
+   
+   // can a piece of the given color capture on this square?
+   bool isSquareUnderAttack(const Position& pos, bool byWhite) const;
+   
    // Check and Checkmate detection
    virtual bool isInCheck(bool isWhite) const;
    virtual bool isInCheckmate(bool isWhite) const;
@@ -63,19 +146,72 @@ public:
    virtual Position findKing(bool isWhite) const;
    virtual bool wouldMoveLeaveKingInCheck(const Move& move, bool isWhite) const;
    
+   // every legal move for the side to move, ordered by Move::operator<
+   virtual void getLegalMoves(std::set <Move>& moves) const;
+   virtual void getLegalMoves(const Position& posFrom, std::set <Move>& moves) const;
+   
+   // status, legal moves, and checkers of the side to move
+   const GameState& getGameState() const;
+   
+   // draws by rule. A search can ask these at every node: only the
+   // positions since the last capture or pawn move are looked at
+   int  getHalfmoveClock() const { return halfmoveClock; }
+   uint64_t getKey()       const { return key;           }
+   int  countRepetitions() const;
+   bool isRepetition()     const { return countRepetitions() >= 1; }
+   bool isThreefoldRepetition() const { return countRepetitions() >= 2; }
+   bool isFiftyMoveDraw()  const { return halfmoveClock >= 100; }
+   
+   // the keys a repetition may still come from: the positions since the
+   // last capture or pawn move, this one last. A board read from a FEN
+   // takes them back so it sees the repetitions of the game
+   std::vector<uint64_t> getHistory() const;
+   void setHistory(const std::vector<uint64_t>& history);
+   
+   // the draw the side to move may claim. Whether to claim it, or to
+   // score it as one, is up to the player or the search
+   DrawClaim getDrawClaim()   const;
+   bool      isDrawClaimable() const { return getDrawClaim() != DRAW_NONE; }
+   
    // setters
    virtual void free();
    virtual void reset(bool fFree = true);
+   virtual void readFEN(const std::string& fen);
    virtual void move(const Move & move);
    virtual Piece& operator [] (const Position& pos);
    
 protected:
    void  assertBoard();
-   bool isSquareUnderAttack(const Position& pos, bool byWhite) const;
+   void  placePieces(const Move& move);
+   Bitboard getAttackSquares(const Position& pos, bool byWhite,
+                             Bitboard vacated = 0, Bitboard filled = 0) const;
+   void getAttackers(const Position& pos, bool byWhite,
+                     std::vector<Position>& attackers) const;
+   bool isKingAttacked(bool isWhite) const;
    bool hasLegalMoves(bool isWhite) const;
+   void computeGameState() const;
+   void startHistory(int halfmoveClock);
+   void publishSnapshot();
+   
+   // work out the occupied squares from the pieces. A move keeps them
+   // up to date; a test that puts pieces on the board itself calls this
+   void syncOccupied();
    
    Piece * board[8][8];    // the board of chess pieces
    int numMoves;
+   int halfmoveClock;               // moves since a capture or pawn move
+   int castling;                    // the CastlingRights still held
+   Position enPassant;              // skipped by a double step, or invalid
+   Bitboard occupied;               // the squares that hold a piece
+   uint64_t key;                    // polyglotKey(), kept up to date by move()
+   std::vector<uint64_t> history;   // the key of each position, this one last
+   
+   std::shared_ptr<const BoardSnapshot> snapshot;   // the latest published
+   mutable std::mutex mutexSnapshot;                // guards the pointer only
+   bool isPublishing;                               // false for a copy
+   
+   mutable GameState state;      // of the side to move
+   mutable bool      stateValid; // false until computed for this position
    
    ogstream* pgout;
 };
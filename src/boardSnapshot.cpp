@@ -0,0 +1,79 @@
+/***********************************************************************
+ * Source File:
+ *    BOARD SNAPSHOT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Taking a snapshot of a Board, and writing it out as a FEN
+ ************************************************************************/
+
+#include "boardSnapshot.h"
+#include "board.h"       // for BOARD and CASTLING RIGHTS
+#include <sstream>       // for OSTRINGSTREAM
+using namespace std;
+
+/*************************************
+ * BOARD SNAPSHOT : CONSTRUCT
+ **************************************/
+BoardSnapshot::BoardSnapshot(const Board& board) :
+   position(board),
+   key(board.getKey()),
+   numMoves(board.getCurrentMove()),
+   halfmoveClock(board.getHalfmoveClock()),
+   castling(board.getCastlingRights()),
+   enPassant(board.getEnPassant())
+{
+}
+
+/*************************************
+ * BOARD SNAPSHOT : GET FEN
+ * Every field is written, so a Board that reads it
+ * plays on from the same position
+ **************************************/
+string BoardSnapshot::getFEN() const
+{
+   static const char LETTERS[] = "KQRBNP";
+   ostringstream sout;
+   for (int row = 7; row >= 0; row--)
+   {
+      int numEmpty = 0;
+      for (int col = 0; col < 8; col++)
+      {
+         Bitboard bit = squareBit(row * 8 + col);
+         char letter = '\0';
+         for (int type = 0; type < NUM_PIECE_TYPES; type++)
+            if (position.pieces[true][type] & bit)
+               letter = LETTERS[type];
+            else if (position.pieces[false][type] & bit)
+               letter = LETTERS[type] - 'A' + 'a';
+         if (letter == '\0')
+         {
+            numEmpty++;
+            continue;
+         }
+         if (numEmpty)
+            sout << numEmpty;
+         numEmpty = 0;
+         sout << letter;
+      }
+      if (numEmpty)
+         sout << numEmpty;
+      if (row > 0)
+         sout << '/';
+   }
+
+   sout << (whiteTurn() ? " w " : " b ");
+   if (castling == CASTLE_NONE)
+      sout << '-';
+   for (int i = 0; i < 4; i++)
+      if (castling & (1 << i))
+         sout << "KQkq"[i];
+
+   sout << ' ';
+   if (enPassant.isValid())
+      sout << enPassant;
+   else
+      sout << '-';
+   sout << ' ' << halfmoveClock << ' ' << numMoves / 2 + 1;
+   return sout.str();
+}
@@ -0,0 +1,58 @@
+/***********************************************************************
+ * Header File:
+ *    BOARD SNAPSHOT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A copy of everything about a position that cannot be worked out
+ *    from the pieces: the pieces as bitboards, who is to move, castling,
+ *    en passant, the move counters, and the key. It is a few hundred
+ *    bytes with no pointers, so taking one is a copy, and once made it
+ *    never changes, so any number of threads can read it at once.
+ *
+ *    The Board publishes a new snapshot after every move. Another
+ *    thread asks for the latest and keeps it as long as it likes; the
+ *    Board never waits for it.
+ ************************************************************************/
+
+#pragma once
+
+#include "evaluate.h"    // for COMPACT POSITION
+#include "position.h"    // for POSITION
+#include <cstdint>
+#include <string>
+#include <type_traits>   // for IS_TRIVIALLY_COPYABLE
+
+class Board;
+
+/***************************************************
+ * BOARD SNAPSHOT
+ * A position as it stood after one move
+ ***************************************************/
+class BoardSnapshot
+{
+public:
+   BoardSnapshot(const Board& board);
+
+   const CompactPosition& getPosition()     const { return position;             }
+   bool            whiteTurn()              const { return position.isWhiteToMove; }
+   int             getCurrentMove()         const { return numMoves;             }
+   int             getHalfmoveClock()       const { return halfmoveClock;        }
+   int             getCastlingRights()      const { return castling;             }
+   const Position& getEnPassant()           const { return enPassant;            }
+   uint64_t        getKey()                 const { return key;                  }
+
+   // the position in Forsyth-Edwards Notation, for a Board to read
+   std::string getFEN() const;
+
+private:
+   CompactPosition position;
+   uint64_t        key;
+   int             numMoves;
+   int             halfmoveClock;
+   int             castling;      // the CastlingRights still held
+   Position        enPassant;
+};
+
+static_assert(std::is_trivially_copyable<BoardSnapshot>::value,
+              "a snapshot is copied as a block of bytes");
@@ -0,0 +1,164 @@
+/***********************************************************************
+ * Source File:
+ *    BOOK
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    An opening book in the Polyglot format
+ ************************************************************************/
+
+#include "book.h"
+#include "polyglot.h"
+#include "board.h"
+#include <cassert>
+using namespace std;
+
+/***************************************************
+ * OPENING BOOK : OPEN
+ * Map the book into memory
+ ***************************************************/
+void OpeningBook::open(const string& fileName)
+{
+   file.open(fileName);
+   if (file.size() % BOOK_ENTRY_SIZE != 0)
+   {
+      close();
+      throw string("Not a Polyglot book: ") + fileName;
+   }
+   numEntries = file.size() / BOOK_ENTRY_SIZE;
+}
+
+/***************************************************
+ * OPENING BOOK : OPEN
+ * Use a book already in memory. The buffer must
+ * outlive the book.
+ ***************************************************/
+void OpeningBook::open(const uint8_t* pBuffer, size_t size)
+{
+   if (size % BOOK_ENTRY_SIZE != 0)
+   {
+      close();
+      throw string("Not a Polyglot book");
+   }
+   file.open(pBuffer, size);
+   numEntries = size / BOOK_ENTRY_SIZE;
+}
+
+/***************************************************
+ * OPENING BOOK : CLOSE
+ ***************************************************/
+void OpeningBook::close()
+{
+   file.close();
+   numEntries = 0;
+}
+
+/***************************************************
+ * OPENING BOOK : GET ENTRY
+ * Decode one entry straight out of the mapped file
+ ***************************************************/
+BookEntry OpeningBook::getEntry(size_t i) const
+{
+   assert(i < numEntries);
+   const uint8_t* p = file.data() + i * BOOK_ENTRY_SIZE;
+   BookEntry entry;
+   entry.key    =           readBig(p,      8);
+   entry.move   = (uint16_t)readBig(p + 8,  2);
+   entry.weight = (uint16_t)readBig(p + 10, 2);
+   entry.learn  = (uint32_t)readBig(p + 12, 4);
+   return entry;
+}
+
+/***************************************************
+ * OPENING BOOK : LOWER BOUND
+ * Binary search for the first entry whose key is not
+ * less than the one given. Only the key is decoded so
+ * a probe touches about log2(n) cache lines.
+ ***************************************************/
+size_t OpeningBook::lowerBound(uint64_t key) const
+{
+   size_t lo = 0;
+   size_t hi = numEntries;
+   while (lo < hi)
+   {
+      size_t mid = lo + (hi - lo) / 2;
+      if (readBig(file.data() + mid * BOOK_ENTRY_SIZE, 8) < key)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+/***************************************************
+ * OPENING BOOK : PROBE
+ * Collect the entries for a position
+ ***************************************************/
+size_t OpeningBook::probe(uint64_t key, vector<BookEntry>& entries) const
+{
+   entries.clear();
+   for (size_t i = lowerBound(key); i < numEntries; i++)
+   {
+      BookEntry entry = getEntry(i);
+      if (entry.key != key)
+         break;
+      entries.push_back(entry);
+   }
+   return entries.size();
+}
+
+/***************************************************
+ * OPENING BOOK : GET MOVE
+ * Pick a book move. Entries that are not legal here
+ * (a hash collision, or a move we do not generate) and
+ * entries with no weight are never chosen.
+ ***************************************************/
+bool OpeningBook::getMove(const Board& board, Move& move, bool best)
+{
+   vector<BookEntry> entries;
+   if (!probe(polyglotKey(board), entries))
+      return false;
+
+   vector<Move>     moves;
+   vector<unsigned> weights;
+   for (const BookEntry& entry : entries)
+   {
+      Move candidate;
+      if (entry.weight && polyglotToMove(board, entry.move, candidate))
+      {
+         moves.push_back(candidate);
+         weights.push_back(entry.weight);
+      }
+   }
+   if (moves.empty())
+      return false;
+
+   // the highest weight, first one wins a tie
+   if (best)
+   {
+      size_t iBest = 0;
+      for (size_t i = 1; i < moves.size(); i++)
+         if (weights[i] > weights[iBest])
+            iBest = i;
+      move = moves[iBest];
+      return true;
+   }
+
+   // at random, in proportion to the weight
+   unsigned total = 0;
+   for (unsigned weight : weights)
+      total += weight;
+   unsigned pick = uniform_int_distribution<unsigned>(0, total - 1)(random);
+   for (size_t i = 0; i < moves.size(); i++)
+   {
+      if (pick < weights[i])
+      {
+         move = moves[i];
+         return true;
+      }
+      pick -= weights[i];
+   }
+
+   assert(false);
+   return false;
+}
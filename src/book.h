@@ -0,0 +1,81 @@
+/***********************************************************************
+ * Header File:
+ *    BOOK
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    An opening book in the Polyglot format. The file is an array of
+ *    16-byte big-endian entries sorted by position key:
+ *
+ *       key (8 bytes) | move (2) | weight (2) | learn (4)
+ *
+ *    The file is memory-mapped and searched in place, so opening
+ *    even a very large book costs almost nothing.
+ ************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include "move.h"        // because we return the book move
+#include "mappedFile.h"  // because the book is memory-mapped
+
+class Board;
+class TestBook;
+
+const size_t BOOK_ENTRY_SIZE = 16;   // bytes in one entry
+
+/***************************************************
+ * BOOK ENTRY
+ * One move for one position
+ ***************************************************/
+struct BookEntry
+{
+   uint64_t key;      // Polyglot key of the position
+   uint16_t move;     // Polyglot encoding of the move
+   uint16_t weight;   // how often the move should be played
+   uint32_t learn;    // unused by us, kept for compatibility
+};
+
+/***************************************************
+ * OPENING BOOK
+ * Look up and choose moves from a Polyglot book
+ ***************************************************/
+class OpeningBook
+{
+   friend TestBook;
+public:
+   OpeningBook() : numEntries(0), random(std::random_device()()) {}
+   OpeningBook(const std::string& fileName) :
+      numEntries(0), random(std::random_device()()) { open(fileName); }
+
+   // open and close the book. Throws a string on error
+   void open(const std::string& fileName);
+   void open(const uint8_t* pBuffer, size_t size);
+   void close();
+   bool isOpen() const { return file.isOpen(); }
+
+   // getters
+   size_t    size()              const { return numEntries; }
+   BookEntry getEntry(size_t i)  const;
+
+   // every entry for a position, in book order. Returns how many
+   size_t probe(uint64_t key, std::vector<BookEntry>& entries) const;
+
+   // choose a legal book move for this position: the highest weight
+   // if best is set, otherwise at random in proportion to weight.
+   // Returns false when the position is not in the book
+   bool getMove(const Board& board, Move& move, bool best = false);
+
+   // make the random choice repeatable
+   void seed(unsigned int value) { random.seed(value); }
+
+private:
+   size_t lowerBound(uint64_t key) const;
+
+   MappedFile   file;          // the bytes of the book
+   size_t       numEntries;    // number of 16-byte entries
+   std::mt19937 random;        // for the weighted choice
+};
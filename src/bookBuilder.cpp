@@ -0,0 +1,633 @@
+/***********************************************************************
+ * Source File:
+ *    BOOK BUILDER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Build a Polyglot opening book from game archives
+ ************************************************************************/
+
+#include "bookBuilder.h"
+#include "book.h"        // for BOOK_ENTRY_SIZE
+#include "polyglot.h"    // for the key and the move encoding
+#include "pgn.h"         // for readPgnGame
+#include "board.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <queue>
+#include <sstream>
+#include <thread>
+#include <cassert>
+using namespace std;
+
+const size_t GAMES_PER_BATCH = 256;   // games handed to a thread at once
+const size_t RECORDS_PER_READ = 4096; // records read from a run at once
+
+/***************************************************
+ * PUT BIG
+ * Write an integer in network order, as Polyglot expects
+ ***************************************************/
+static void putBig(ostream& out, uint64_t value, int numBytes)
+{
+   for (int i = numBytes - 1; i >= 0; i--)
+      out.put((char)((value >> (8 * i)) & 0xff));
+}
+
+/***************************************************
+ * BOOK BUILDER : CONSTRUCT
+ ***************************************************/
+BookBuilder::BookBuilder(int maxPly, size_t memoryLimit, int numThreads) :
+   maxPly(maxPly), memoryLimit(memoryLimit), numThreads(numThreads),
+   minGames(1), numGames(0)
+{
+}
+
+/***************************************************
+ * BOOK BUILDER : DESTRUCT
+ * The run files are temporary and vanish when closed
+ ***************************************************/
+BookBuilder::~BookBuilder()
+{
+   for (FILE* run : runs)
+      fclose(run);
+}
+
+/***************************************************
+ * BOOK BUILDER : GET NUM THREADS
+ ***************************************************/
+int BookBuilder::getNumThreads() const
+{
+   if (numThreads > 0)
+      return numThreads;
+   return max(1, (int)thread::hardware_concurrency());
+}
+
+/***************************************************
+ * BOOK BUILDER : GET BUFFER LIMIT
+ * Every worker thread and the caller get an equal
+ * share of the memory limit
+ ***************************************************/
+size_t BookBuilder::getBufferLimit() const
+{
+   size_t limit = memoryLimit / sizeof(Record) / (getNumThreads() + 1);
+   return max(limit, (size_t)1);
+}
+
+/***************************************************
+ * BOOK BUILDER : ADD POSITION
+ * Count one move played from one position
+ ***************************************************/
+void BookBuilder::addPosition(const Board& board, const Move& move,
+                              GameResult result, Buffer& buffer)
+{
+   bool isWhite = board.whiteTurn();
+   Record record;
+   record.key   = polyglotKey(board);
+   record.move  = moveToPolyglot(move);
+   record.games = 1;
+   record.wins  = (result == (isWhite ? RESULT_WHITE : RESULT_BLACK)) ? 1 : 0;
+   record.draws = (result == RESULT_DRAW) ? 1 : 0;
+   buffer.push_back(record);
+
+   if (buffer.size() >= getBufferLimit())
+      spill(buffer);
+}
+
+/***************************************************
+ * BOOK BUILDER : ADD GAME
+ * Replay a game from the start, counting each move
+ * up to the ply limit. Nothing is counted if any of
+ * those moves is illegal.
+ ***************************************************/
+void BookBuilder::addGame(const vector<Move>& moves, GameResult result)
+{
+   Board board;
+   Buffer game;
+   for (size_t i = 0; i < moves.size() && (int)i < maxPly; i++)
+   {
+      addPosition(board, moves[i], result, game);
+      board.move(moves[i]);
+      if (board.getCurrentMove() != (int)i + 1)
+         throw string("Illegal move: ") + moves[i].getText();
+   }
+
+   for (const Record& record : game)
+   {
+      buffer.push_back(record);
+      if (buffer.size() >= getBufferLimit())
+         spill(buffer);
+   }
+   numGames++;
+}
+
+/***************************************************
+ * BOOK BUILDER : ADD PGN
+ * The caller splits the text into games and queues them
+ * in batches; the workers parse, replay, and count. SAN
+ * parsing is the expensive part so it is done in parallel.
+ ***************************************************/
+size_t BookBuilder::addPgn(istream& in, size_t* numSkipped)
+{
+   int numWorkers = getNumThreads();
+   size_t numBefore = numGames;
+   atomic<size_t> numBad(0);
+
+   mutex                  mutexQueue;
+   condition_variable     cvWork;      // a batch is ready, or we are done
+   condition_variable     cvSpace;     // the queue has room
+   deque<vector<string>>  queue;
+   bool                   done = false;
+   string                 error;
+
+   auto worker = [&]()
+   {
+      Buffer local;
+      try
+      {
+         while (true)
+         {
+            vector<string> batch;
+            {
+               unique_lock<mutex> lock(mutexQueue);
+               cvWork.wait(lock, [&]() { return !queue.empty() || done; });
+               if (queue.empty())
+                  break;
+               batch = std::move(queue.front());
+               queue.pop_front();
+            }
+            cvSpace.notify_one();
+
+            for (const string& text : batch)
+            {
+               istringstream gin(text);
+               while (true)
+               {
+                  PgnGame game;
+                  try
+                  {
+                     if (!readPgnGame(gin, game))
+                        break;
+                  }
+                  catch (const string&)
+                  {
+                     numBad++;
+                     continue;
+                  }
+
+                  Board board;
+                  for (size_t i = 0; i < game.moves.size() && (int)i < maxPly; i++)
+                  {
+                     addPosition(board, game.moves[i], game.result, local);
+                     board.move(game.moves[i]);
+                  }
+                  numGames++;
+               }
+            }
+         }
+         spill(local);
+      }
+      catch (const string& e)
+      {
+         {
+            lock_guard<mutex> lock(mutexQueue);
+            error = e;
+         }
+         // the reader may be waiting for room this worker would have made
+         cvSpace.notify_all();
+      }
+   };
+
+   vector<thread> threads;
+   for (int i = 0; i < numWorkers; i++)
+      threads.push_back(thread(worker));
+
+   // a new game starts with a tag after some movetext. Once a worker
+   // fails there is no point reading on, so push reports false
+   auto push = [&](vector<string>& batch)
+   {
+      unique_lock<mutex> lock(mutexQueue);
+      cvSpace.wait(lock, [&]()
+      {
+         return queue.size() < 2 * (size_t)numWorkers || !error.empty();
+      });
+      if (!error.empty())
+         return false;
+      queue.push_back(std::move(batch));
+      batch.clear();
+      lock.unlock();
+      cvWork.notify_one();
+      return true;
+   };
+   vector<string> batch;
+   string text;
+   string line;
+   bool inMoves = false;
+   bool isReading = true;
+   while (isReading && getline(in, line))
+   {
+      if (!line.empty() && line[0] == '[' && inMoves)
+      {
+         batch.push_back(std::move(text));
+         text.clear();
+         inMoves = false;
+         if (batch.size() == GAMES_PER_BATCH)
+            isReading = push(batch);
+      }
+      else if (line.find_first_not_of(" \t\r") != string::npos && line[0] != '[')
+         inMoves = true;
+      text += line;
+      text += '\n';
+   }
+   if (isReading && !text.empty())
+      batch.push_back(std::move(text));
+   if (isReading && !batch.empty())
+      push(batch);
+
+   {
+      lock_guard<mutex> lock(mutexQueue);
+      done = true;
+   }
+   cvWork.notify_all();
+   for (thread& t : threads)
+      t.join();
+
+   if (!error.empty())
+      throw error;
+   if (numSkipped)
+      *numSkipped = numBad;
+   return numGames - numBefore;
+}
+
+/***************************************************
+ * BOOK BUILDER : ADD RECORD
+ * The archive is random-access, so the workers simply
+ * claim batches of game numbers
+ ***************************************************/
+size_t BookBuilder::addRecord(const GameRecordReader& reader)
+{
+   size_t numBefore = numGames;
+   atomic<size_t> next(0);
+   mutex mutexError;
+   string error;
+
+   auto worker = [&]()
+   {
+      Buffer local;
+      try
+      {
+         size_t iFirst;
+         while ((iFirst = next.fetch_add(GAMES_PER_BATCH)) < reader.size())
+         {
+            size_t iLast = min(iFirst + GAMES_PER_BATCH, reader.size());
+            for (size_t iGame = iFirst; iGame < iLast; iGame++)
+            {
+               const uint8_t* indices = reader.getMoveIndices(iGame);
+               size_t numMoves = min(reader.getNumMoves(iGame), (size_t)maxPly);
+               GameResult result = reader.getResult(iGame);
+
+               Board board;
+               for (size_t i = 0; i < numMoves; i++)
+               {
+                  Move move = GameRecordReader::decodeMove(board, indices[i]);
+                  addPosition(board, move, result, local);
+                  board.move(move);
+               }
+               numGames++;
+            }
+         }
+         spill(local);
+      }
+      catch (const string& e)
+      {
+         lock_guard<mutex> lock(mutexError);
+         error = e;
+      }
+   };
+
+   vector<thread> threads;
+   for (int i = 0; i < getNumThreads(); i++)
+      threads.push_back(thread(worker));
+   for (thread& t : threads)
+      t.join();
+
+   if (!error.empty())
+      throw error;
+   return numGames - numBefore;
+}
+
+/***************************************************
+ * LESS RECORD
+ * Runs are sorted by position, then by move
+ ***************************************************/
+static bool lessRecord(uint64_t keyLHS, uint16_t moveLHS,
+                       uint64_t keyRHS, uint16_t moveRHS)
+{
+   return keyLHS < keyRHS || (keyLHS == keyRHS && moveLHS < moveRHS);
+}
+
+/***************************************************
+ * BOOK BUILDER : SPILL
+ * Sort a buffer, combine duplicate moves, and write it
+ * to a temporary run file
+ ***************************************************/
+void BookBuilder::spill(Buffer& buffer)
+{
+   if (buffer.empty())
+      return;
+
+   sort(buffer.begin(), buffer.end(), [](const Record& lhs, const Record& rhs)
+   {
+      return lessRecord(lhs.key, lhs.move, rhs.key, rhs.move);
+   });
+
+   size_t iOut = 0;
+   for (size_t i = 1; i < buffer.size(); i++)
+   {
+      Record& out = buffer[iOut];
+      if (buffer[i].key == out.key && buffer[i].move == out.move)
+      {
+         out.games += buffer[i].games;
+         out.wins  += buffer[i].wins;
+         out.draws += buffer[i].draws;
+      }
+      else
+         buffer[++iOut] = buffer[i];
+   }
+   size_t numRecords = iOut + 1;
+
+   FILE* run = tmpfile();
+   if (!run)
+      throw string("Unable to create a temporary file");
+   if (fwrite(buffer.data(), sizeof(Record), numRecords, run) != numRecords)
+   {
+      fclose(run);
+      throw string("Unable to write a temporary file");
+   }
+   buffer.clear();
+
+   // the merging is done outside the lock, so other threads can spill
+   // while it runs. Only taking a tier and putting back its run lock
+   int level = 0;
+   vector<FILE*> merging;
+   {
+      lock_guard<mutex> lock(mutexRuns);
+      addRun(run, 0);
+      merging = takeTier(level);
+   }
+   while (!merging.empty())
+   {
+      try
+      {
+         run = compact(merging);
+      }
+      catch (const string&)
+      {
+         // put the tier back so the runs are still closed with the rest
+         lock_guard<mutex> lock(mutexRuns);
+         for (FILE* old : merging)
+            addRun(old, level);
+         throw;
+      }
+      lock_guard<mutex> lock(mutexRuns);
+      addRun(run, level + 1);
+      merging = takeTier(level);
+   }
+}
+
+/***************************************************
+ * BOOK BUILDER : ADD RUN
+ * The runs are in tiers, the most merged first. A run
+ * goes at the end of its tier. The caller holds mutexRuns.
+ ***************************************************/
+void BookBuilder::addRun(FILE* run, int level)
+{
+   size_t i = runLevels.size();
+   while (i > 0 && runLevels[i - 1] < level)
+      i--;
+   runs.insert(runs.begin() + i, run);
+   runLevels.insert(runLevels.begin() + i, level);
+}
+
+/***************************************************
+ * BOOK BUILDER : TAKE TIER
+ * When a tier fills, it is taken out of the runs to be
+ * merged into one run of the next tier, which may fill
+ * that one. Returns the runs of the full tier, and its
+ * level, or nothing if no tier is full. The caller holds
+ * mutexRuns.
+ ***************************************************/
+vector<FILE*> BookBuilder::takeTier(int& level)
+{
+   size_t iEnd = runs.size();
+   while (iEnd > 0)
+   {
+      size_t iFirst = iEnd - 1;
+      while (iFirst > 0 && runLevels[iFirst - 1] == runLevels[iEnd - 1])
+         iFirst--;
+      if (iEnd - iFirst >= BOOK_MERGE_RUNS)
+      {
+         iFirst = iEnd - BOOK_MERGE_RUNS;
+         level = runLevels[iFirst];
+         vector<FILE*> tier(runs.begin() + iFirst, runs.begin() + iEnd);
+         runs.erase(runs.begin() + iFirst, runs.begin() + iEnd);
+         runLevels.erase(runLevels.begin() + iFirst, runLevels.begin() + iEnd);
+         return tier;
+      }
+      iEnd = iFirst;
+   }
+   return vector<FILE*>();
+}
+
+/***************************************************
+ * BOOK BUILDER : COMPACT
+ * Merge a tier of runs into one, so we never hold too
+ * many files open. The runs are merged in tiers, so each
+ * record is copied once per tier rather than every time
+ * the files fill up. The runs are closed; the merged run
+ * is returned
+ ***************************************************/
+FILE* BookBuilder::compact(vector<FILE*>& merging)
+{
+   FILE* run = tmpfile();
+   if (!run)
+      throw string("Unable to create a temporary file");
+
+   vector<Record> out;
+   out.reserve(RECORDS_PER_READ);
+   auto flush = [&]()
+   {
+      if (fwrite(out.data(), sizeof(Record), out.size(), run) != out.size())
+         throw string("Unable to write a temporary file");
+      out.clear();
+   };
+   try
+   {
+      merge(merging, [&](const Record& record)
+      {
+         out.push_back(record);
+         if (out.size() == RECORDS_PER_READ)
+            flush();
+      });
+      flush();
+   }
+   catch (const string&)
+   {
+      fclose(run);
+      throw;
+   }
+
+   for (FILE* old : merging)
+      fclose(old);
+   merging.clear();
+   return run;
+}
+
+/***************************************************
+ * BOOK BUILDER : MERGE
+ * A k-way merge of sorted runs. Each (position, move)
+ * is emitted once with its counts summed.
+ ***************************************************/
+void BookBuilder::merge(vector<FILE*>& runs,
+                        const function<void(const Record&)>& emit)
+{
+   // the unread part of each run
+   struct Reader
+   {
+      FILE*          run;
+      vector<Record> records;
+      size_t         i;
+      bool next()
+      {
+         if (++i < records.size())
+            return true;
+         records.resize(RECORDS_PER_READ);
+         records.resize(fread(records.data(), sizeof(Record),
+                              RECORDS_PER_READ, run));
+         i = 0;
+         return !records.empty();
+      }
+      const Record& get() const { return records[i]; }
+   };
+
+   vector<Reader> readers(runs.size());
+   auto greater = [&](size_t lhs, size_t rhs)
+   {
+      const Record& l = readers[lhs].get();
+      const Record& r = readers[rhs].get();
+      return lessRecord(r.key, r.move, l.key, l.move);
+   };
+   priority_queue<size_t, vector<size_t>, decltype(greater)> heap(greater);
+
+   for (size_t i = 0; i < runs.size(); i++)
+   {
+      rewind(runs[i]);
+      readers[i].run = runs[i];
+      readers[i].i = 0;
+      if (readers[i].next())
+         heap.push(i);
+   }
+
+   bool   any = false;
+   Record current = {};
+   while (!heap.empty())
+   {
+      size_t iReader = heap.top();
+      heap.pop();
+      const Record& record = readers[iReader].get();
+
+      if (any && record.key == current.key && record.move == current.move)
+      {
+         current.games += record.games;
+         current.wins  += record.wins;
+         current.draws += record.draws;
+      }
+      else
+      {
+         if (any)
+            emit(current);
+         current = record;
+         any = true;
+      }
+
+      if (readers[iReader].next())
+         heap.push(iReader);
+   }
+   if (any)
+      emit(current);
+
+   for (FILE* run : runs)
+      fseek(run, 0, SEEK_END);
+}
+
+/***************************************************
+ * BOOK BUILDER : WRITE
+ * Merge the runs and write the Polyglot entries. The
+ * weight of a move is 2 * wins + draws, scaled down
+ * within its position when it would not fit in 16 bits.
+ * The best move of each position comes first.
+ ***************************************************/
+size_t BookBuilder::write(ostream& out)
+{
+   spill(buffer);
+
+   size_t numEntries = 0;
+   vector<Record> position;
+   auto flush = [&]()
+   {
+      uint64_t maxScore = 0;
+      for (const Record& record : position)
+         maxScore = max(maxScore, 2 * (uint64_t)record.wins + record.draws);
+
+      vector<BookEntry> entries;
+      for (const Record& record : position)
+      {
+         uint64_t score = 2 * (uint64_t)record.wins + record.draws;
+         if (maxScore > 0xffff)
+            score = score * 0xffff / maxScore;
+         entries.push_back({ record.key, record.move, (uint16_t)score, 0 });
+      }
+      stable_sort(entries.begin(), entries.end(),
+                  [](const BookEntry& lhs, const BookEntry& rhs)
+      {
+         return lhs.weight > rhs.weight;
+      });
+
+      for (const BookEntry& entry : entries)
+      {
+         putBig(out, entry.key,    8);
+         putBig(out, entry.move,   2);
+         putBig(out, entry.weight, 2);
+         putBig(out, entry.learn,  4);
+      }
+      numEntries += entries.size();
+      position.clear();
+   };
+
+   lock_guard<mutex> lock(mutexRuns);
+   merge(runs, [&](const Record& record)
+   {
+      if (!position.empty() && position.front().key != record.key)
+         flush();
+      if (record.games >= minGames)
+         position.push_back(record);
+   });
+   flush();
+   return numEntries;
+}
+
+/***************************************************
+ * BOOK BUILDER : WRITE
+ * Write the book to a file
+ ***************************************************/
+size_t BookBuilder::write(const string& fileName)
+{
+   ofstream fout(fileName.c_str(), ios::binary);
+   if (fout.fail())
+      throw string("Unable to open ") + fileName + " for writing";
+   size_t numEntries = write(fout);
+   if (fout.fail())
+      throw string("Unable to write ") + fileName;
+   return numEntries;
+}
@@ -0,0 +1,100 @@
+/***********************************************************************
+ * Header File:
+ *    BOOK BUILDER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Build a Polyglot opening book from game archives. Every position
+ *    up to a ply limit is hashed and each (position, move) pair counts
+ *    its games, wins, and draws. Counts are gathered in fixed-size
+ *    buffers; a full buffer is sorted, combined, and spilled to a
+ *    temporary run file. Writing the book merges the runs, so memory
+ *    stays bounded no matter how many games are read.
+ ************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <iostream>
+#include "move.h"        // because a game is a list of moves
+#include "gameRecord.h"  // for GameResult and GAME RECORD READER
+
+class Board;
+class TestBook;
+
+const size_t BOOK_MERGE_RUNS = 8;  // runs of one size merged into one larger run
+
+/***************************************************
+ * BOOK BUILDER
+ * Gather statistics from many games, then write a book
+ ***************************************************/
+class BookBuilder
+{
+   friend TestBook;
+public:
+   // maxPly:      positions deeper than this are not recorded
+   // memoryLimit: bytes of statistics held before spilling to disk
+   // numThreads:  0 means one per hardware thread
+   BookBuilder(int maxPly = 24, size_t memoryLimit = 64 << 20,
+               int numThreads = 0);
+   ~BookBuilder();
+
+   // moves played fewer than this many times are left out of the book
+   void setMinGames(unsigned int minGames) { this->minGames = minGames; }
+
+   // read whole archives, spreading the games across the threads.
+   // Games that cannot be replayed are skipped and counted.
+   size_t addPgn(std::istream& in, size_t* numSkipped = nullptr);
+   size_t addRecord(const GameRecordReader& reader);
+
+   // one game at a time, on the calling thread
+   void addGame(const std::vector<Move>& moves, GameResult result);
+
+   // merge everything gathered so far and write the book.
+   // Returns the number of entries written
+   size_t write(std::ostream& out);
+   size_t write(const std::string& fileName);
+
+   // getters
+   size_t getNumGames() const { return numGames;    }
+   size_t getNumRuns()  const { return runs.size(); }
+
+private:
+   // what we know about one move in one position
+   struct Record
+   {
+      uint64_t key;       // Polyglot key of the position
+      uint16_t move;      // Polyglot encoding of the move
+      uint32_t games;     // times the move was played
+      uint32_t wins;      // ... and won by the side that played it
+      uint32_t draws;     // ... and drawn
+   };
+   typedef std::vector<Record> Buffer;
+
+   void   addPosition(const Board& board, const Move& move, GameResult result,
+                      Buffer& buffer);
+   void   spill(Buffer& buffer);
+   void   addRun(FILE* run, int level);
+   std::vector<FILE*> takeTier(int& level);
+   static FILE* compact(std::vector<FILE*>& merging);
+   static void merge(std::vector<FILE*>& runs,
+                     const std::function<void(const Record&)>& emit);
+   size_t getBufferLimit() const;
+   int    getNumThreads()  const;
+
+   int                 maxPly;        // deepest position recorded
+   size_t              memoryLimit;   // bytes shared by all buffers
+   int                 numThreads;    // 0 for hardware concurrency
+   unsigned int        minGames;      // filter for rare moves
+   std::atomic<size_t> numGames;      // games added so far
+   Buffer              buffer;        // for addGame() on the caller
+   std::mutex          mutexRuns;     // guards runs and runLevels
+   std::vector<FILE*>  runs;          // sorted, combined spill files
+   std::vector<int>    runLevels;     // times each run has been merged
+};
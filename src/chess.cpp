@@ -13,7 +13,7 @@
 #include "position.h"     // for POSITION
 #include "piece.h"        // for PIECE and company
 #include "board.h"        // for BOARD
-#include "test.h"
+#include "analysis.h"     // for ANALYSIS
 #include <set>            // for STD::SET
 #include <cassert>        // for ASSERT
 #include <fstream>        // for IFSTREAM
@@ -21,6 +21,19 @@
 #include <iostream>       // for COUT
 using namespace std;
 
+/*************************************
+ * GAME
+ * The board, and the analysis of it that
+ * the 'a' key turns on and off
+ **************************************/
+struct Game
+{
+   Game(ogstream* pgout) : board(pgout), pgout(pgout), isAnalyzing(false) {}
+   Board     board;
+   ogstream* pgout;
+   Analysis  analysis;
+   bool      isAnalyzing;
+};
 
 /*************************************
  * All the interesting work happens here, when
@@ -31,7 +44,21 @@ using namespace std;
  **************************************/
 void callBack(Interface* pUI, void* p)
 {
-   Board* pBoard = (Board*)p;
+   Game* pGame = (Game*)p;
+   Board* pBoard = &pGame->board;
+   
+   // Turn the analysis on or off. While it is on, frames are drawn
+   // ten times a second so each new depth shows up
+   if (pUI->getKey() == 'a')
+   {
+      pUI->resetKey();
+      pGame->isAnalyzing = !pGame->isAnalyzing;
+      if (pGame->isAnalyzing)
+         pGame->analysis.start(pBoard->getSnapshot(), pBoard->getHistory());
+      else
+         pGame->analysis.stop();
+      pUI->setFramesPerSecond(pGame->isAnalyzing ? 10.0 : 0.0);
+   }
    
    Move move;
    set <Move> possible;
@@ -39,25 +66,9 @@ void callBack(Interface* pUI, void* p)
    Position src = pUI->getPreviousPosition();
    Position dest = pUI->getSelectPosition();
    
-   // Get possible moves for selected piece
+   // Get the legal moves for the selected piece
    if (src.isValid())
-   {
-      (*pBoard)[src].getMoves(possible, *pBoard);
-      
-      // Filter out moves that would leave king in check
-      set<Move> legalMoves;
-      bool currentPlayerIsWhite = pBoard->whiteTurn();
-      
-      for (const Move& m : possible)
-      {
-         // Check if this move would leave the king in check
-         if (!pBoard->wouldMoveLeaveKingInCheck(m, currentPlayerIsWhite))
-         {
-            legalMoves.insert(m);
-         }
-      }
-      possible = legalMoves;
-   }
+      pBoard->getLegalMoves(src, possible);
    
    // If the source and destination are valid, and the move is possible
    if (dest.isValid() && src.isValid())
@@ -66,50 +77,47 @@ void callBack(Interface* pUI, void* p)
    // Attempt to make the move
    if (possible.find(move) != possible.end())
    {
-      // Perform the move
+      // Perform the move. This works out the new game state
       pBoard->move(move);
       pUI->clearSelectPosition();
+      if (pGame->isAnalyzing)
+         pGame->analysis.start(pBoard->getSnapshot(), pBoard->getHistory());
       
-      // Check game state after the move
+      // Report the game state after the move
       bool nextPlayerIsWhite = pBoard->whiteTurn();
-      
-      if (pBoard->isInCheckmate(nextPlayerIsWhite))
-      {
-         // Game over - checkmate
-         string winner = nextPlayerIsWhite ? "Black" : "White";
-         cout << "\n*** CHECKMATE! " << winner << " wins! ***\n" << endl;
-      }
-      else if (pBoard->isInStalemate(nextPlayerIsWhite))
+      switch (pBoard->getGameState().status)
       {
-         // Game over - stalemate
-         cout << "\n*** STALEMATE! Game is a draw! ***\n" << endl;
+         case CHECKMATE:
+            cout << "\n*** CHECKMATE! " << (nextPlayerIsWhite ? "Black" : "White")
+                 << " wins! ***\n" << endl;
+            break;
+         case STALEMATE:
+            cout << "\n*** STALEMATE! Game is a draw! ***\n" << endl;
+            break;
+         case CHECK:
+            cout << "\n*** CHECK! " << (nextPlayerIsWhite ? "White" : "Black")
+                 << " king is in check! ***\n" << endl;
+            break;
+         case PLAYING:
+            break;
       }
-      else if (pBoard->isInCheck(nextPlayerIsWhite))
-      {
-         // Player is in check but not checkmate
-         string player = nextPlayerIsWhite ? "White" : "Black";
-         cout << "\n*** CHECK! " << player << " king is in check! ***\n" << endl;
-      }
-   }
-   
-   // If no possible move was found, draw current selection possible moves
-   else if (dest.isValid())
-   {
-      possible.clear();
-      (*pBoard)[dest].getMoves(possible, *pBoard);
-      
-      // Filter out illegal moves for display
-      set<Move> legalMoves;
-      bool currentPlayerIsWhite = pBoard->whiteTurn();
       
-      for (const Move& m : possible)
-      {
-         if (!pBoard->wouldMoveLeaveKingInCheck(m, currentPlayerIsWhite))
+      // a draw by rule only ends the game if it is claimed, so the
+      // player is told and play goes on
+      if (pBoard->getGameState().status != CHECKMATE)
+         switch (pBoard->getDrawClaim())
          {
-            legalMoves.insert(m);
+            case DRAW_REPETITION:
+               cout << "\n*** The same position three times! "
+                    << "Either player may claim a draw. ***\n" << endl;
+               break;
+            case DRAW_FIFTY_MOVES:
+               cout << "\n*** Fifty moves without a capture or pawn move! "
+                    << "Either player may claim a draw. ***\n" << endl;
+               break;
+            case DRAW_NONE:
+               break;
          }
-      }
-      possible = legalMoves;
    }
    
    // if blank spot clicked, clear selection
@@ -118,6 +126,8 @@ void callBack(Interface* pUI, void* p)
    
    // Draw the board
    pBoard->display(pUI->getHoverPosition(), pUI->getSelectPosition());
+   if (pGame->isAnalyzing)
+      pGame->pgout->drawGameStatus(pGame->analysis.getStatus().c_str(), 1 /*line*/);
 }
 
 
@@ -135,19 +145,15 @@ int WINAPI WinMain(
 int main(int argc, char** argv)
 #endif // !_WIN32
 {
-   
-   // run all the unit tests
-   testRunner();
-   
    // Instantiate the graphics window
    Interface ui("Chess");
    
    // Initialize the game class
    ogstream* pgout = new ogstream;
-   Board board(pgout);
+   Game game(pgout);
    
    // set everything into action
-   ui.run(callBack, (void*)(&board));
+   ui.run(callBack, (void*)(&game));
    
    // All done.
    delete pgout;
@@ -0,0 +1,381 @@
+/***********************************************************************
+ * Source File:
+ *    EVALUATE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The compact position, the evaluation of one position, and the
+ *    evaluation of a batch: chunks of positions laid out one bitboard to
+ *    an array, handed out to worker threads.
+ ************************************************************************/
+
+#include "evaluate.h"
+#include "board.h"       // for BOARD
+#include "piece.h"       // for PIECE
+#include "trace.h"       // for TRACE_SCOPE
+#include <algorithm>     // for MAX and MIN
+#include <atomic>
+#include <cctype>        // for ISUPPER and TOLOWER
+#include <cstring>       // for STRCHR
+#include <memory>        // for UNIQUE_PTR
+#include <sstream>       // for ISTRINGSTREAM
+#include <thread>
+#include <vector>
+using namespace std;
+
+// a chunk is small enough to stay in the cache while every term is added
+const size_t EVAL_CHUNK = 256;
+
+// centipawns for each piece, KING through PAWN
+static const int PIECE_VALUES[NUM_PIECE_TYPES] = { 0, 900, 500, 330, 320, 100 };
+
+// centipawns for each square of the board a piece can reach, beyond
+// the squares its own pieces stand on or enemy pawns attack
+const int MOBILITY_VALUE = 2;
+
+// where each piece would like to stand, KING through PAWN. The tables are
+// from white's side of the board as it is drawn: a8 first, h1 last
+static const int PIECE_SQUARES[NUM_PIECE_TYPES][64] =
+{
+   {  // king
+      -30,-40,-40,-50,-50,-40,-40,-30,
+      -30,-40,-40,-50,-50,-40,-40,-30,
+      -30,-40,-40,-50,-50,-40,-40,-30,
+      -30,-40,-40,-50,-50,-40,-40,-30,
+      -20,-30,-30,-40,-40,-30,-30,-20,
+      -10,-20,-20,-20,-20,-20,-20,-10,
+       20, 20,  0,  0,  0,  0, 20, 20,
+       20, 30, 10,  0,  0, 10, 30, 20
+   },
+   {  // queen
+      -20,-10,-10, -5, -5,-10,-10,-20,
+      -10,  0,  0,  0,  0,  0,  0,-10,
+      -10,  0,  5,  5,  5,  5,  0,-10,
+       -5,  0,  5,  5,  5,  5,  0, -5,
+        0,  0,  5,  5,  5,  5,  0, -5,
+      -10,  5,  5,  5,  5,  5,  0,-10,
+      -10,  0,  5,  0,  0,  0,  0,-10,
+      -20,-10,-10, -5, -5,-10,-10,-20
+   },
+   {  // rook
+        0,  0,  0,  0,  0,  0,  0,  0,
+        5, 10, 10, 10, 10, 10, 10,  5,
+       -5,  0,  0,  0,  0,  0,  0, -5,
+       -5,  0,  0,  0,  0,  0,  0, -5,
+       -5,  0,  0,  0,  0,  0,  0, -5,
+       -5,  0,  0,  0,  0,  0,  0, -5,
+       -5,  0,  0,  0,  0,  0,  0, -5,
+        0,  0,  0,  5,  5,  0,  0,  0
+   },
+   {  // bishop
+      -20,-10,-10,-10,-10,-10,-10,-20,
+      -10,  0,  0,  0,  0,  0,  0,-10,
+      -10,  0,  5, 10, 10,  5,  0,-10,
+      -10,  5,  5, 10, 10,  5,  5,-10,
+      -10,  0, 10, 10, 10, 10,  0,-10,
+      -10, 10, 10, 10, 10, 10, 10,-10,
+      -10,  5,  0,  0,  0,  0,  5,-10,
+      -20,-10,-10,-10,-10,-10,-10,-20
+   },
+   {  // knight
+      -50,-40,-30,-30,-30,-30,-40,-50,
+      -40,-20,  0,  0,  0,  0,-20,-40,
+      -30,  0, 10, 15, 15, 10,  0,-30,
+      -30,  5, 15, 20, 20, 15,  5,-30,
+      -30,  0, 15, 20, 20, 15,  0,-30,
+      -30,  5, 10, 15, 15, 10,  5,-30,
+      -40,-20,  0,  5,  5,  0,-20,-40,
+      -50,-40,-30,-30,-30,-30,-40,-50
+   },
+   {  // pawn
+        0,  0,  0,  0,  0,  0,  0,  0,
+       50, 50, 50, 50, 50, 50, 50, 50,
+       10, 10, 20, 30, 30, 20, 10, 10,
+        5,  5, 10, 25, 25, 10,  5,  5,
+        0,  0,  0, 20, 20,  0,  0,  0,
+        5, -5,-10,  0,  0,-10, -5,  5,
+        5, 10, 10,-20,-20, 10, 10,  5,
+        0,  0,  0,  0,  0,  0,  0,  0
+   }
+};
+
+/***************************************************
+ * GET PIECE SQUARE
+ * The table value of a piece on a square, for white.
+ * Black's board is white's flipped top to bottom,
+ * which is the order the tables are written in
+ ***************************************************/
+inline int getPieceSquare(int iType, int square, bool isWhite)
+{
+   return isWhite ? PIECE_SQUARES[iType][square ^ 56] : -PIECE_SQUARES[iType][square];
+}
+
+/***************************************************
+ * GET MOBILITY
+ * The squares a side's knights, bishops, rooks, and
+ * queens attack that are not its own and that no
+ * enemy pawn guards. The fills are used even for one
+ * position: written this way, the same code runs across
+ * many positions in the batch
+ ***************************************************/
+inline Bitboard getMobility(Bitboard own, Bitboard occupied, Bitboard knights,
+                            Bitboard rooks, Bitboard bishops,
+                            Bitboard pawnsEnemy, bool isWhite)
+{
+   Bitboard attacks = getKnightFill(knights) |
+                      getSliderFillScalar(rooks, bishops, occupied);
+   return attacks & ~own & ~getPawnFill(pawnsEnemy, !isWhite);
+}
+
+/*************************************
+ * COMPACT POSITION : CONSTRUCT
+ * From a board
+ **************************************/
+CompactPosition::CompactPosition(const Board& board) :
+   pieces{}, isWhiteToMove(board.whiteTurn())
+{
+   for (int square = 0; square < 64; square++)
+   {
+      const Piece& piece = board[Position(square % 8, square / 8)];
+      PieceType type = piece.getType();
+      if (type >= KING && type <= PAWN)
+         pieces[piece.isWhite()][type - KING] |= squareBit(square);
+   }
+}
+
+/*************************************
+ * COMPACT POSITION : READ FEN
+ * Only the placement and the side to move
+ **************************************/
+void CompactPosition::readFEN(const string& fen)
+{
+   static const char LETTERS[] = "kqrbnp";
+   istringstream sin(fen);
+   string placement;
+   string side = "w";
+   sin >> placement >> side;
+
+   // the placement, from a8 across and then down to h1
+   Bitboard piecesNew[2][NUM_PIECE_TYPES] = {};
+   int c = 0;
+   int r = 7;
+   for (char ch : placement)
+   {
+      const char* pLetter = ch ? strchr(LETTERS, tolower(ch)) : nullptr;
+      if (ch == '/')
+      {
+         if (c != 8 || r == 0)
+            throw string("Bad FEN placement: ") + fen;
+         c = 0;
+         r--;
+      }
+      else if (ch >= '1' && ch <= '8' && c + (ch - '0') <= 8)
+         c += ch - '0';
+      else if (c < 8 && pLetter)
+         piecesNew[isupper(ch) != 0][pLetter - LETTERS] |= squareBit(r * 8 + c++);
+      else
+         throw string("Bad FEN placement: ") + fen;
+   }
+   if (c != 8 || r != 0)
+      throw string("Bad FEN placement: ") + fen;
+   if (side != "w" && side != "b")
+      throw string("Bad FEN side to move: ") + fen;
+
+   for (int iColor = 0; iColor < 2; iColor++)
+      for (int iType = 0; iType < NUM_PIECE_TYPES; iType++)
+         pieces[iColor][iType] = piecesNew[iColor][iType];
+   isWhiteToMove = (side == "w");
+}
+
+/*************************************
+ * COMPACT POSITION : GET PIECES
+ * Every piece of one color
+ **************************************/
+Bitboard CompactPosition::getPieces(bool isWhite) const
+{
+   Bitboard all = 0;
+   for (int iType = 0; iType < NUM_PIECE_TYPES; iType++)
+      all |= pieces[isWhite][iType];
+   return all;
+}
+
+/*************************************
+ * EVALUATE
+ * One position, a term at a time
+ **************************************/
+int evaluate(const CompactPosition& position)
+{
+   int score = 0;
+   Bitboard occupied = position.getPieces(true) | position.getPieces(false);
+   for (int iColor = 0; iColor < 2; iColor++)
+   {
+      bool isWhite = (iColor == 1);
+      int sign = isWhite ? 1 : -1;
+      for (int iType = 0; iType < NUM_PIECE_TYPES; iType++)
+      {
+         Bitboard squares = position.pieces[iColor][iType];
+         score += sign * PIECE_VALUES[iType] * countSquares(squares);
+         while (squares)
+            score += getPieceSquare(iType, popSquare(squares), isWhite);
+      }
+
+      Bitboard queens = position.getPieces(isWhite, QUEEN);
+      Bitboard mobility = getMobility(position.getPieces(isWhite), occupied,
+                                      position.getPieces(isWhite, KNIGHT),
+                                      position.getPieces(isWhite, ROOK) | queens,
+                                      position.getPieces(isWhite, BISHOP) | queens,
+                                      position.getPieces(!isWhite, PAWN), isWhite);
+      score += sign * MOBILITY_VALUE * countSquares(mobility);
+   }
+   return score;
+}
+
+/***************************************************
+ * CHUNK
+ * A run of positions turned on its side: the white
+ * pawns of every position, then the white knights,
+ * and so on. The terms are added into scores
+ ***************************************************/
+struct Chunk
+{
+   Bitboard pieces[2][NUM_PIECE_TYPES][EVAL_CHUNK];
+   Bitboard occupied[EVAL_CHUNK];
+   Bitboard mobility[2][EVAL_CHUNK];
+   int      scores[EVAL_CHUNK];
+};
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(BITBOARD_NO_AVX2)
+#define EVALUATE_AVX2
+#define EVALUATE_INLINE __attribute__((always_inline)) inline
+#else
+#define EVALUATE_INLINE inline
+#endif
+
+/***************************************************
+ * GET MOBILITY
+ * Of one side in one position of the chunk
+ ***************************************************/
+EVALUATE_INLINE Bitboard getMobility(const Chunk& chunk, size_t i, bool isWhite)
+{
+   const Bitboard (&own)[NUM_PIECE_TYPES][EVAL_CHUNK] = chunk.pieces[isWhite];
+   Bitboard queens = own[QUEEN - KING][i];
+   Bitboard all = own[KING - KING][i] | queens | own[ROOK - KING][i] |
+                  own[BISHOP - KING][i] | own[KNIGHT - KING][i] |
+                  own[PAWN - KING][i];
+   return getMobility(all, chunk.occupied[i], own[KNIGHT - KING][i],
+                      own[ROOK - KING][i] | queens, own[BISHOP - KING][i] | queens,
+                      chunk.pieces[!isWhite][PAWN - KING][i], isWhite);
+}
+
+/***************************************************
+ * EVALUATE CHUNK
+ * Every term for every position of the chunk, each a
+ * loop across positions. The loops always run the whole
+ * chunk, so the compiler knows how far they go; the
+ * end of the last chunk is empty. Counting squares and
+ * looking up the piece-square tables do not vectorize,
+ * so they are kept out of the loops that do
+ ***************************************************/
+EVALUATE_INLINE void evaluateChunk(Chunk& chunk)
+{
+   for (size_t i = 0; i < EVAL_CHUNK; i++)
+      chunk.occupied[i] = 0;
+   for (int iColor = 0; iColor < 2; iColor++)
+      for (int iType = 0; iType < NUM_PIECE_TYPES; iType++)
+         for (size_t i = 0; i < EVAL_CHUNK; i++)
+            chunk.occupied[i] |= chunk.pieces[iColor][iType][i];
+
+   // which squares each side's pieces can go to
+   for (size_t i = 0; i < EVAL_CHUNK; i++)
+   {
+      chunk.mobility[0][i] = getMobility(chunk, i, false /*isWhite*/);
+      chunk.mobility[1][i] = getMobility(chunk, i, true  /*isWhite*/);
+   }
+
+   // count the material and the mobility
+   for (size_t i = 0; i < EVAL_CHUNK; i++)
+      chunk.scores[i] = MOBILITY_VALUE * (countSquares(chunk.mobility[1][i]) -
+                                          countSquares(chunk.mobility[0][i]));
+   for (int iColor = 0; iColor < 2; iColor++)
+   {
+      bool isWhite = (iColor == 1);
+      for (int iType = 0; iType < NUM_PIECE_TYPES; iType++)
+      {
+         int value = isWhite ? PIECE_VALUES[iType] : -PIECE_VALUES[iType];
+         for (size_t i = 0; i < EVAL_CHUNK; i++)
+            chunk.scores[i] += value * countSquares(chunk.pieces[iColor][iType][i]);
+         for (size_t i = 0; i < EVAL_CHUNK; i++)
+            for (Bitboard squares = chunk.pieces[iColor][iType][i]; squares; )
+               chunk.scores[i] += getPieceSquare(iType, popSquare(squares), isWhite);
+      }
+   }
+}
+
+#ifdef EVALUATE_AVX2
+/***************************************************
+ * EVALUATE CHUNK AVX2
+ * The same loops, compiled for AVX2 so the mobility
+ * loop works on four positions per instruction
+ ***************************************************/
+__attribute__((target("avx2")))
+static void evaluateChunkAvx2(Chunk& chunk)
+{
+   evaluateChunk(chunk);
+}
+#endif // EVALUATE_AVX2
+
+/*************************************
+ * EVALUATE BATCH
+ * Each worker claims the next chunk until none are
+ * left, so a slow chunk does not hold the others up
+ **************************************/
+void evaluateBatch(const CompactPosition* positions, size_t numPositions,
+                   int* scores, int numThreads)
+{
+   TRACE_SCOPE("evaluateBatch");
+   size_t numChunks = (numPositions + EVAL_CHUNK - 1) / EVAL_CHUNK;
+   int threads = numThreads > 0 ? numThreads :
+                 max(1, (int)thread::hardware_concurrency());
+   threads = (int)min((size_t)threads, numChunks);
+
+   atomic<size_t> chunkNext(0);
+   auto worker = [&]()
+   {
+      unique_ptr<Chunk> pChunk(new Chunk);
+      for (size_t iChunk = chunkNext++; iChunk < numChunks; iChunk = chunkNext++)
+      {
+         size_t begin = iChunk * EVAL_CHUNK;
+         size_t num = min(EVAL_CHUNK, numPositions - begin);
+         for (int iColor = 0; iColor < 2; iColor++)
+            for (int iType = 0; iType < NUM_PIECE_TYPES; iType++)
+            {
+               for (size_t i = 0; i < num; i++)
+                  pChunk->pieces[iColor][iType][i] = positions[begin + i].pieces[iColor][iType];
+               for (size_t i = num; i < EVAL_CHUNK; i++)
+                  pChunk->pieces[iColor][iType][i] = 0;
+            }
+
+#ifdef EVALUATE_AVX2
+         if (isUsingAvx2())
+            evaluateChunkAvx2(*pChunk);
+         else
+#endif // EVALUATE_AVX2
+            evaluateChunk(*pChunk);
+
+         for (size_t i = 0; i < num; i++)
+            scores[begin + i] = pChunk->scores[i];
+      }
+   };
+
+   if (threads <= 1)
+      worker();
+   else
+   {
+      vector<thread> workers;
+      for (int i = 0; i < threads; i++)
+         workers.push_back(thread(worker));
+      for (thread& t : workers)
+         t.join();
+   }
+   TRACE_COUNT("positions evaluated", numPositions);
+}
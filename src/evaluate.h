@@ -0,0 +1,61 @@
+/***********************************************************************
+ * Header File:
+ *    EVALUATE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A static evaluation of a position: material, piece-square tables,
+ *    and mobility, in centipawns from white's point of view. It works on
+ *    a compact position of twelve bitboards rather than on a Board, so
+ *    millions of positions can be scored without making a piece for
+ *    every square.
+ *
+ *    evaluateBatch() scores many positions at once. Each thread takes a
+ *    chunk of positions, turns it on its side so each bitboard of every
+ *    position in the chunk sits in one array, and works through the
+ *    terms one array at a time. Those loops have no branches, so the
+ *    compiler can run them on several positions per instruction.
+ ************************************************************************/
+
+#pragma once
+
+#include "bitboard.h"    // for BITBOARD
+#include "pieceType.h"   // for PIECE TYPE
+#include <string>
+
+class Board;
+
+// the pieces a compact position keeps, KING through PAWN
+const int NUM_PIECE_TYPES = PAWN - KING + 1;
+
+/***************************************************
+ * COMPACT POSITION
+ * Where each piece is and who is to move. Nothing
+ * else: no castling, en passant, or move counts
+ ***************************************************/
+struct CompactPosition
+{
+   CompactPosition() : pieces{}, isWhiteToMove(true) {}
+   CompactPosition(const Board& board);
+
+   // the placement and side to move of a FEN. Throws a string if they
+   // are bad; the rest of the FEN is ignored
+   void readFEN(const std::string& fen);
+
+   Bitboard getPieces(bool isWhite, PieceType type) const
+   {
+      return pieces[isWhite][type - KING];
+   }
+   Bitboard getPieces(bool isWhite) const;
+
+   Bitboard pieces[2][NUM_PIECE_TYPES];   // [isWhite][type - KING]
+   bool     isWhiteToMove;
+};
+
+// score one position
+int evaluate(const CompactPosition& position);
+
+// score many. scores[i] is what evaluate(positions[i]) would give.
+// numThreads of 0 means one per hardware thread
+void evaluateBatch(const CompactPosition* positions, size_t numPositions,
+                   int* scores, int numThreads = 0);
@@ -0,0 +1,240 @@
+/***********************************************************************
+ * Source File:
+ *    GAME RECORD
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A compact binary archive of chess games
+ ************************************************************************/
+
+#include "gameRecord.h"
+#include "board.h"
+#include <set>
+#include <fstream>
+#include <cstring>    // for memcmp
+#include <cassert>
+
+using namespace std;
+
+/***************************************************
+ * GAME RECORD WRITER : ENCODE MOVE
+ * The index of the move in the ordered legal move list.
+ * The four promotions share a source and destination,
+ * so the promoted piece must match too
+ ***************************************************/
+uint8_t GameRecordWriter::encodeMove(const Board& board, const Move& move)
+{
+   set<Move> moves;
+   board.getLegalMoves(moves);
+   assert(moves.size() <= 256);
+
+   int index = 0;
+   for (const Move& m : moves)
+   {
+      if (m.getSource() == move.getSource() &&
+          m.getDest()   == move.getDest()   &&
+          m.getMoveType() == move.getMoveType() &&
+          m.getPromote()  == move.getPromote())
+         return (uint8_t)index;
+      index++;
+   }
+   throw string("Move is not legal in this position: ") + move.getText();
+}
+
+/***************************************************
+ * GAME RECORD WRITER : ADD GAME
+ * Replay the game from the start so every move can be encoded
+ ***************************************************/
+void GameRecordWriter::addGame(const vector<Move>& moves, GameResult result)
+{
+   Board board;
+   vector<uint8_t> indices;
+   indices.reserve(moves.size());
+   for (const Move& move : moves)
+   {
+      uint8_t index = encodeMove(board, move);
+      indices.push_back(index);
+      board.move(GameRecordReader::decodeMove(board, index));
+   }
+   addEncoded(indices.data(), indices.size(), result);
+}
+
+/***************************************************
+ * GAME RECORD WRITER : ADD ENCODED
+ * Append a game whose moves are already indices
+ ***************************************************/
+void GameRecordWriter::addEncoded(const uint8_t* indices, size_t numMoves,
+                                  GameResult result)
+{
+   data.push_back((uint8_t)result);
+   data.insert(data.end(), indices, indices + numMoves);
+   offsets.push_back(data.size());
+}
+
+/***************************************************
+ * GAME RECORD WRITER : WRITE
+ * Header, then the index table, then the games
+ ***************************************************/
+void GameRecordWriter::write(ostream& out) const
+{
+   // header
+   out.write(GAME_RECORD_MAGIC, sizeof(GAME_RECORD_MAGIC));
+   putLittle(out, GAME_RECORD_VERSION, 4);
+   putLittle(out, size(), 8);
+
+   // index table: offsets are from the start of the file
+   uint64_t base = GAME_RECORD_HEADER + 8 * offsets.size();
+   for (uint64_t offset : offsets)
+      putLittle(out, base + offset, 8);
+
+   // games
+   out.write((const char*)data.data(), data.size());
+}
+
+void GameRecordWriter::write(const string& fileName) const
+{
+   ofstream fout(fileName.c_str(), ios::binary);
+   if (fout.fail())
+      throw string("Unable to open ") + fileName + " for writing";
+   write(fout);
+   if (fout.fail())
+      throw string("Error writing ") + fileName;
+}
+
+/***************************************************
+ * GAME RECORD READER : OPEN
+ * Map the archive into memory. Nothing is read until a
+ * game is requested.
+ ***************************************************/
+void GameRecordReader::open(const string& fileName)
+{
+   file.open(fileName);
+   validate();
+}
+
+/***************************************************
+ * GAME RECORD READER : OPEN
+ * Read an archive already in memory. The buffer must
+ * outlive the reader.
+ ***************************************************/
+void GameRecordReader::open(const uint8_t* pBuffer, size_t size)
+{
+   file.open(pBuffer, size);
+   validate();
+}
+
+/***************************************************
+ * GAME RECORD READER : VALIDATE
+ * Check the header and the index table. Every game has
+ * at least its result byte, so the offsets must rise
+ * strictly from the end of the index to the end of the
+ * file; otherwise getGame() would read out of bounds
+ ***************************************************/
+void GameRecordReader::validate()
+{
+   const uint8_t* pData = file.data();
+   size_t length = file.size();
+   if (length < GAME_RECORD_HEADER ||
+       memcmp(pData, GAME_RECORD_MAGIC, sizeof(GAME_RECORD_MAGIC)) != 0 ||
+       readLittle(pData + 4, 4) != GAME_RECORD_VERSION)
+   {
+      close();
+      throw string("Not a game record");
+   }
+
+   numGames = readLittle(pData + 8, 8);
+   if (numGames >= (length - GAME_RECORD_HEADER) / 8 ||
+       getOffset(numGames) != length)
+   {
+      close();
+      throw string("Corrupt game record index");
+   }
+
+   uint64_t offsetPrev = GAME_RECORD_HEADER + 8 * (numGames + 1) - 1;
+   for (size_t iGame = 0; iGame <= numGames; iGame++)
+   {
+      uint64_t offset = getOffset(iGame);
+      if (offset <= offsetPrev || offset > length)
+      {
+         close();
+         throw string("Corrupt game record index");
+      }
+      offsetPrev = offset;
+   }
+}
+
+/***************************************************
+ * GAME RECORD READER : CLOSE
+ ***************************************************/
+void GameRecordReader::close()
+{
+   file.close();
+   numGames = 0;
+}
+
+/***************************************************
+ * GAME RECORD READER : GET OFFSET
+ * Entry iGame of the index table
+ ***************************************************/
+uint64_t GameRecordReader::getOffset(size_t iGame) const
+{
+   assert(iGame <= numGames);
+   return readLittle(file.data() + GAME_RECORD_HEADER + 8 * iGame, 8);
+}
+
+/***************************************************
+ * GAME RECORD READER : GETTERS
+ ***************************************************/
+GameResult GameRecordReader::getResult(size_t iGame) const
+{
+   assert(iGame < numGames);
+   return (GameResult)file.data()[getOffset(iGame)];
+}
+
+size_t GameRecordReader::getNumMoves(size_t iGame) const
+{
+   assert(iGame < numGames);
+   return (size_t)(getOffset(iGame + 1) - getOffset(iGame) - 1);
+}
+
+const uint8_t* GameRecordReader::getMoveIndices(size_t iGame) const
+{
+   assert(iGame < numGames);
+   return file.data() + getOffset(iGame) + 1;
+}
+
+/***************************************************
+ * GAME RECORD READER : DECODE MOVE
+ * The move at a given index in the ordered legal move list
+ ***************************************************/
+Move GameRecordReader::decodeMove(const Board& board, uint8_t index)
+{
+   set<Move> moves;
+   board.getLegalMoves(moves);
+   if (index >= moves.size())
+      throw string("Corrupt game record: move index out of range");
+
+   set<Move>::const_iterator it = moves.begin();
+   advance(it, index);
+   return *it;
+}
+
+/***************************************************
+ * GAME RECORD READER : GET MOVES
+ * Replay game iGame from the starting position
+ ***************************************************/
+void GameRecordReader::getMoves(size_t iGame, vector<Move>& moves) const
+{
+   moves.clear();
+   const uint8_t* indices = getMoveIndices(iGame);
+   size_t numMoves = getNumMoves(iGame);
+   moves.reserve(numMoves);
+
+   Board board;
+   for (size_t i = 0; i < numMoves; i++)
+   {
+      Move move = decodeMove(board, indices[i]);
+      board.move(move);
+      moves.push_back(move);
+   }
+}
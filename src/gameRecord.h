@@ -0,0 +1,109 @@
+/***********************************************************************
+ * Header File:
+ *    GAME RECORD
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A compact binary archive of chess games. Each move is stored as
+ *    a single byte: its index within the ordered list of legal moves
+ *    in the position where it was played. The layout is
+ *
+ *       +--------------------+
+ *       | header (16 bytes)  |  magic "CGR1", version, number of games
+ *       +--------------------+
+ *       | index table        |  (numGames + 1) 64-bit file offsets
+ *       +--------------------+
+ *       | game 0             |  result byte, then one byte per move
+ *       | game 1             |
+ *       | ...                |
+ *       +--------------------+
+ *
+ *    All integers are little-endian. Game N lives between offsets
+ *    N and N+1 so it can be found without reading any other game.
+ ************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include "move.h"      // because we encode and decode moves
+#include "mappedFile.h" // because the archive is memory-mapped
+
+class Board;
+class TestGameRecord;
+
+/***************************************************
+ * GAME RESULT
+ * How the game ended, as recorded in the archive
+ ***************************************************/
+enum GameResult { RESULT_UNKNOWN, RESULT_WHITE, RESULT_BLACK, RESULT_DRAW };
+
+const char     GAME_RECORD_MAGIC[4] = { 'C', 'G', 'R', '1' };
+const uint32_t GAME_RECORD_VERSION  = 1;
+const size_t   GAME_RECORD_HEADER   = 16;   // bytes in the header
+
+/***************************************************
+ * GAME RECORD WRITER
+ * Accumulate encoded games and write out the archive
+ ***************************************************/
+class GameRecordWriter
+{
+   friend TestGameRecord;
+public:
+   GameRecordWriter() : offsets(1, 0) {}
+
+   // encode one game from the starting position
+   void addGame(const std::vector<Move>& moves, GameResult result);
+   void addEncoded(const uint8_t* indices, size_t numMoves, GameResult result);
+
+   // how many games have been added so far?
+   size_t size() const { return offsets.size() - 1; }
+
+   // write the archive
+   void write(std::ostream& out) const;
+   void write(const std::string& fileName) const;
+
+   // the move encoding itself
+   static uint8_t encodeMove(const Board& board, const Move& move);
+
+private:
+   std::vector<uint8_t>  data;      // result and move bytes of every game
+   std::vector<uint64_t> offsets;   // where each game starts in data
+};
+
+/***************************************************
+ * GAME RECORD READER
+ * Memory-map an archive and fetch any game by number
+ ***************************************************/
+class GameRecordReader
+{
+   friend TestGameRecord;
+public:
+   GameRecordReader() : numGames(0) {}
+   GameRecordReader(const std::string& fileName) : numGames(0) { open(fileName); }
+
+   // open and close the archive. Throws a string on error
+   void open(const std::string& fileName);
+   void open(const uint8_t* pBuffer, size_t size);
+   void close();
+   bool isOpen() const { return file.isOpen(); }
+
+   // getters: all are O(1)
+   size_t         size()                      const { return (size_t)numGames; }
+   GameResult     getResult(size_t iGame)     const;
+   size_t         getNumMoves(size_t iGame)   const;
+   const uint8_t* getMoveIndices(size_t iGame) const;
+
+   // replay a game to recover the moves
+   void getMoves(size_t iGame, std::vector<Move>& moves) const;
+   static Move decodeMove(const Board& board, uint8_t index);
+
+private:
+   uint64_t getOffset(size_t iGame) const;
+   void validate();
+
+   MappedFile file;                 // the bytes of the archive
+   uint64_t   numGames;             // from the header
+};
@@ -0,0 +1,88 @@
+/***********************************************************************
+ * Source File:
+ *    MAPPED FILE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A read-only view of a file's bytes
+ ************************************************************************/
+
+#include "mappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <sys/mman.h> // for mmap
+#include <sys/stat.h> // for fstat
+#include <fcntl.h>    // for open
+#include <unistd.h>   // for close
+#endif // !_WIN32
+
+using namespace std;
+
+/***************************************************
+ * MAPPED FILE : OPEN
+ * Map the file into memory
+ ***************************************************/
+void MappedFile::open(const string& fileName)
+{
+   close();
+
+#ifdef _WIN32
+   ifstream fin(fileName.c_str(), ios::binary);
+   if (fin.fail())
+      throw string("Unable to open ") + fileName;
+   buffer.assign(istreambuf_iterator<char>(fin), istreambuf_iterator<char>());
+   if (buffer.empty())
+      throw string("Empty file: ") + fileName;
+   pData = buffer.data();
+   length = buffer.size();
+#else // !_WIN32
+   int fd = ::open(fileName.c_str(), O_RDONLY);
+   if (fd < 0)
+      throw string("Unable to open ") + fileName;
+
+   struct stat st;
+   if (fstat(fd, &st) != 0 || st.st_size == 0)
+   {
+      ::close(fd);
+      throw string("Empty file: ") + fileName;
+   }
+
+   void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   ::close(fd);
+   if (p == MAP_FAILED)
+      throw string("Unable to map ") + fileName;
+
+   pData = (const uint8_t*)p;
+   length = (size_t)st.st_size;
+   mapped = true;
+#endif // !_WIN32
+}
+
+/***************************************************
+ * MAPPED FILE : OPEN
+ * Use a buffer already in memory. The buffer must
+ * outlive the MappedFile.
+ ***************************************************/
+void MappedFile::open(const uint8_t* pBuffer, size_t size)
+{
+   close();
+   pData = pBuffer;
+   length = size;
+}
+
+/***************************************************
+ * MAPPED FILE : CLOSE
+ ***************************************************/
+void MappedFile::close()
+{
+#ifndef _WIN32
+   if (mapped && pData)
+      munmap((void*)pData, length);
+#endif // !_WIN32
+   buffer.clear();
+   pData = nullptr;
+   length = 0;
+   mapped = false;
+}
@@ -0,0 +1,74 @@
+/***********************************************************************
+ * Header File:
+ *    MAPPED FILE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A read-only view of a file's bytes. On POSIX systems the file is
+ *    memory-mapped so nothing is read until it is touched; on Windows
+ *    the file is read into memory.
+ ************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>   // for putLittle
+
+/***************************************************
+ * MAPPED FILE
+ * The bytes of a file, or of a buffer owned by the caller
+ ***************************************************/
+class MappedFile
+{
+public:
+   MappedFile() : pData(nullptr), length(0), mapped(false) {}
+   ~MappedFile() { close(); }
+
+   // open and close. Throws a string on error
+   void open(const std::string& fileName);
+   void open(const uint8_t* pBuffer, size_t size);
+   void close();
+
+   // getters
+   bool           isOpen() const { return pData != nullptr; }
+   const uint8_t* data()   const { return pData;            }
+   size_t         size()   const { return length;           }
+
+private:
+   MappedFile(const MappedFile& rhs) = delete;
+   MappedFile& operator = (const MappedFile& rhs) = delete;
+
+   const uint8_t*       pData;      // start of the file
+   size_t               length;     // number of bytes in the file
+   bool                 mapped;     // did we mmap pData?
+   std::vector<uint8_t> buffer;     // used when we cannot mmap
+};
+
+/***************************************************
+ * BIG and LITTLE ENDIAN
+ * Read integers from a byte buffer, and write them to a
+ * stream, independent of the host
+ ***************************************************/
+inline uint64_t readLittle(const uint8_t* p, int numBytes)
+{
+   uint64_t value = 0;
+   for (int i = numBytes - 1; i >= 0; i--)
+      value = (value << 8) | p[i];
+   return value;
+}
+
+inline uint64_t readBig(const uint8_t* p, int numBytes)
+{
+   uint64_t value = 0;
+   for (int i = 0; i < numBytes; i++)
+      value = (value << 8) | p[i];
+   return value;
+}
+
+inline void putLittle(std::ostream& out, uint64_t value, int numBytes)
+{
+   for (int i = 0; i < numBytes; i++)
+      out.put((char)((value >> (8 * i)) & 0xff));
+}
@@ -9,6 +9,7 @@
 
 #include "move.h"
 #include "pieceType.h"
+#include "allocTrack.h"
 #include <cassert>
 #include <sstream>
 #include <cctype>
@@ -101,6 +102,7 @@ bool Move::operator==(const Move& rhs) const
  ***************************************************/
 void Move::read(const string& rhs)
 {
+   ALLOC_SCOPE(ALLOC_PARSE, "Move::read");
    text = rhs;
    source.setInvalid();
    dest.setInvalid();
@@ -142,6 +144,7 @@ void Move::read(const string& rhs)
  ***************************************************/
 string Move::getText() const
 {
+   ALLOC_SCOPE(ALLOC_PARSE, "Move::getText");
    stringstream ss;
    if (!source.isValid() || !dest.isValid())
       return "";
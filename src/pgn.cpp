@@ -0,0 +1,512 @@
+/***********************************************************************
+ * Source File:
+ *    PGN
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Read and write games in Portable Game Notation, and convert
+ *    between PGN and the binary game record format
+ ************************************************************************/
+
+#include "pgn.h"
+#include "board.h"
+#include "piece.h"
+#include "allocTrack.h"
+#include <set>
+#include <cctype>
+#include <cassert>
+
+using namespace std;
+
+/***************************************************
+ * SAN LETTER
+ * The upper-case letter SAN uses for a piece
+ ***************************************************/
+static char sanLetter(PieceType pt)
+{
+   switch (pt)
+   {
+      case KING:   return 'K';
+      case QUEEN:  return 'Q';
+      case ROOK:   return 'R';
+      case BISHOP: return 'B';
+      case KNIGHT: return 'N';
+      default:     return '\0';
+   }
+}
+
+static PieceType sanPiece(char letter)
+{
+   switch (letter)
+   {
+      case 'K': return KING;
+      case 'Q': return QUEEN;
+      case 'R': return ROOK;
+      case 'B': return BISHOP;
+      case 'N': return KNIGHT;
+      default:  return PAWN;
+   }
+}
+
+/***************************************************
+ * MOVE TO SAN
+ * Describe a move in Standard Algebraic Notation. The check
+ * and checkmate suffixes are left to the caller because
+ * they depend on the position after the move.
+ ***************************************************/
+string moveToSan(const Board& board, const Move& move)
+{
+   ALLOC_SCOPE(ALLOC_PARSE, "moveToSan");
+   if (move.getMoveType() == Move::CASTLE_KING)
+      return "O-O";
+   if (move.getMoveType() == Move::CASTLE_QUEEN)
+      return "O-O-O";
+
+   Position src = move.getSource();
+   Position dest = move.getDest();
+   PieceType pt = board[src].getType();
+   bool isCapture = board[dest].getType() != SPACE ||
+                    move.getMoveType() == Move::ENPASSANT;
+   string san;
+
+   if (pt == PAWN)
+   {
+      if (isCapture)
+      {
+         san += (char)('a' + src.getCol());
+         san += 'x';
+      }
+   }
+   else
+   {
+      san += sanLetter(pt);
+
+      // disambiguate when another piece of this type can reach dest
+      bool isAmbiguous = false;
+      bool sameCol = false;
+      bool sameRow = false;
+      set<Move> moves;
+      board.getLegalMoves(moves);
+      for (const Move& m : moves)
+         if (m.getDest() == dest && m.getSource() != src &&
+             board[m.getSource()].getType() == pt)
+         {
+            isAmbiguous = true;
+            sameCol |= m.getSource().getCol() == src.getCol();
+            sameRow |= m.getSource().getRow() == src.getRow();
+         }
+      if (isAmbiguous && (!sameCol || sameRow))
+         san += (char)('a' + src.getCol());
+      if (isAmbiguous && sameCol)
+         san += (char)('1' + src.getRow());
+
+      if (isCapture)
+         san += 'x';
+   }
+
+   san += (char)('a' + dest.getCol());
+   san += (char)('1' + dest.getRow());
+
+   if (move.getPromote() != SPACE)
+   {
+      san += '=';
+      san += sanLetter(move.getPromote());
+   }
+   return san;
+}
+
+/***************************************************
+ * SAN TO MOVE
+ * Find the legal move described by a SAN token such as
+ * "Nbd7", "exd6", "e8=Q+", or "O-O-O". Throws a string if
+ * no single legal move matches.
+ ***************************************************/
+Move sanToMove(const Board& board, const string& sanIn)
+{
+   ALLOC_SCOPE(ALLOC_PARSE, "sanToMove");
+   // strip the check, checkmate, and annotation suffixes
+   string san = sanIn;
+   while (!san.empty() && string("+#!?").find(san.back()) != string::npos)
+      san.pop_back();
+
+   set<Move> moves;
+   board.getLegalMoves(moves);
+
+   // castling
+   Move::MoveType castle = Move::MOVE;
+   if (san == "O-O" || san == "0-0")
+      castle = Move::CASTLE_KING;
+   else if (san == "O-O-O" || san == "0-0-0")
+      castle = Move::CASTLE_QUEEN;
+   if (castle != Move::MOVE)
+   {
+      for (const Move& m : moves)
+         if (m.getMoveType() == castle)
+            return m;
+      throw string("Illegal castle: ") + sanIn;
+   }
+
+   // promotion: "e8=Q" or "e8Q"
+   PieceType promote = SPACE;
+   if (san.size() > 2 && isupper(san.back()))
+   {
+      promote = sanPiece(san.back());
+      san.pop_back();
+      if (!san.empty() && san.back() == '=')
+         san.pop_back();
+   }
+
+   // the piece, the destination, and whatever is between them
+   PieceType pt = PAWN;
+   size_t start = 0;
+   if (!san.empty() && isupper(san[0]))
+   {
+      pt = sanPiece(san[0]);
+      start = 1;
+   }
+   if (san.size() < start + 2)
+      throw string("Malformed move: ") + sanIn;
+   Position dest = san.substr(san.size() - 2).c_str();
+   if (dest.isInvalid())
+      throw string("Malformed move: ") + sanIn;
+
+   int col = -1;
+   int row = -1;
+   for (size_t i = start; i < san.size() - 2; i++)
+      if (san[i] >= 'a' && san[i] <= 'h')
+         col = san[i] - 'a';
+      else if (san[i] >= '1' && san[i] <= '8')
+         row = san[i] - '1';
+      else if (san[i] != 'x')
+         throw string("Malformed move: ") + sanIn;
+
+   // find the one legal move that fits
+   const Move* pFound = nullptr;
+   for (const Move& m : moves)
+   {
+      Position src = m.getSource();
+      if (m.getDest() != dest ||
+          board[src].getType() != pt ||
+          m.getPromote() != promote ||
+          (col >= 0 && src.getCol() != col) ||
+          (row >= 0 && src.getRow() != row) ||
+          m.getMoveType() == Move::CASTLE_KING ||
+          m.getMoveType() == Move::CASTLE_QUEEN)
+         continue;
+      if (pFound)
+         throw string("Ambiguous move: ") + sanIn;
+      pFound = &m;
+   }
+   if (!pFound)
+      throw string("Illegal move: ") + sanIn;
+   return *pFound;
+}
+
+/***************************************************
+ * PLAY SAN
+ * Make a sequence of SAN moves on a board. Throws a
+ * string if one of them is not legal
+ ***************************************************/
+void playSan(Board& board, const char* moves[], int num)
+{
+   for (int i = 0; i < num; i++)
+      board.move(sanToMove(board, moves[i]));
+}
+
+/***************************************************
+ * RESULT TO TEXT and RESULT FROM TEXT
+ ***************************************************/
+const char* resultToText(GameResult result)
+{
+   switch (result)
+   {
+      case RESULT_WHITE: return "1-0";
+      case RESULT_BLACK: return "0-1";
+      case RESULT_DRAW:  return "1/2-1/2";
+      default:           return "*";
+   }
+}
+
+GameResult resultFromText(const string& text)
+{
+   if (text == "1-0")
+      return RESULT_WHITE;
+   if (text == "0-1")
+      return RESULT_BLACK;
+   if (text == "1/2-1/2")
+      return RESULT_DRAW;
+   return RESULT_UNKNOWN;
+}
+
+static bool isResult(const string& token)
+{
+   return token == "*" || resultFromText(token) != RESULT_UNKNOWN;
+}
+
+/***************************************************
+ * SKIP UNTIL
+ * Discard characters through the closing delimiter
+ ***************************************************/
+static void skipUntil(istream& in, char close)
+{
+   char c;
+   while (in.get(c) && c != close)
+      ;
+}
+
+static void skipVariation(istream& in)
+{
+   int depth = 1;
+   char c;
+   while (depth > 0 && in.get(c))
+      if (c == '(')
+         depth++;
+      else if (c == ')')
+         depth--;
+      else if (c == '{')
+         skipUntil(in, '}');
+}
+
+/***************************************************
+ * READ TAG
+ * [Name "Value"] where the opening bracket is consumed
+ ***************************************************/
+static void readTag(istream& in, PgnGame& game)
+{
+   string name;
+   string value;
+   char c;
+   while (in.get(c) && isspace(c))
+      ;
+   while (in && !isspace(c) && c != '"' && c != ']')
+   {
+      name += c;
+      in.get(c);
+   }
+   while (in && c != '"' && c != ']')
+      in.get(c);
+   if (c == '"')
+   {
+      while (in.get(c) && c != '"')
+      {
+         if (c == '\\')
+            in.get(c);
+         value += c;
+      }
+      skipUntil(in, ']');
+   }
+   if (!name.empty())
+      game.tags[name] = value;
+}
+
+/***************************************************
+ * READ PGN GAME
+ * Tag pairs, then movetext, then a result token
+ ***************************************************/
+bool readPgnGame(istream& in, PgnGame& game)
+{
+   ALLOC_SCOPE(ALLOC_PARSE, "readPgnGame");
+   game = PgnGame();
+   vector<string> tokens;
+   bool found = false;
+   bool done = false;
+   char c;
+
+   while (!done && in.get(c))
+   {
+      if (isspace(c))
+         continue;
+
+      switch (c)
+      {
+         case '[':
+            // a tag after movetext belongs to the next game
+            if (!tokens.empty())
+            {
+               in.putback(c);
+               done = true;
+               break;
+            }
+            readTag(in, game);
+            found = true;
+            break;
+         case '{':
+            skipUntil(in, '}');
+            break;
+         case ';':
+         case '%':
+            skipUntil(in, '\n');
+            break;
+         case '(':
+            skipVariation(in);
+            break;
+         case '$':
+            while (in.get(c) && isdigit(c))
+               ;
+            if (in)
+               in.putback(c);
+            break;
+         default:
+         {
+            string token(1, c);
+            while (in.get(c) && !isspace(c) && string("{}()[];").find(c) == string::npos)
+               token += c;
+            if (in)
+               in.putback(c);
+            found = true;
+
+            if (isResult(token))
+            {
+               game.result = resultFromText(token);
+               done = true;
+               break;
+            }
+
+            // drop move numbers such as "12." and "12..."
+            size_t i = 0;
+            while (i < token.size() && isdigit(token[i]))
+               i++;
+            if (i < token.size() && token[i] == '.')
+            {
+               while (i < token.size() && token[i] == '.')
+                  i++;
+               token = token.substr(i);
+            }
+            else if (i == token.size())
+               token.clear();
+            if (!token.empty())
+               tokens.push_back(token);
+         }
+      }
+   }
+
+   if (!found)
+      return false;
+
+   if (game.result == RESULT_UNKNOWN && game.tags.count("Result"))
+      game.result = resultFromText(game.tags["Result"]);
+
+   // replay the movetext to turn SAN into moves
+   Board board;
+   for (const string& token : tokens)
+   {
+      Move move = sanToMove(board, token);
+      game.moves.push_back(move);
+      board.move(move);
+   }
+   return true;
+}
+
+/***************************************************
+ * WRITE PGN GAME
+ * The seven tag roster first, then any other tags,
+ * then the movetext wrapped to 80 columns
+ ***************************************************/
+void writePgnGame(ostream& out, const PgnGame& game)
+{
+   ALLOC_SCOPE(ALLOC_PARSE, "writePgnGame");
+   static const char* roster[] =
+      { "Event", "Site", "Date", "Round", "White", "Black", "Result" };
+
+   for (const char* name : roster)
+   {
+      string value;
+      if (string(name) == "Result")
+         value = resultToText(game.result);
+      else if (game.tags.count(name))
+         value = game.tags.at(name);
+      else
+         value = "?";
+      out << '[' << name << " \"" << value << "\"]\n";
+   }
+   for (const auto& tag : game.tags)
+   {
+      bool inRoster = false;
+      for (const char* name : roster)
+         inRoster |= tag.first == name;
+      if (!inRoster)
+         out << '[' << tag.first << " \"" << tag.second << "\"]\n";
+   }
+   out << '\n';
+
+   Board board;
+   size_t column = 0;
+   for (size_t i = 0; i < game.moves.size(); i++)
+   {
+      string token;
+      if (i % 2 == 0)
+         token = to_string(i / 2 + 1) + ". ";
+      token += moveToSan(board, game.moves[i]);
+      board.move(game.moves[i]);
+
+      bool isWhite = board.whiteTurn();
+      if (board.isInCheckmate(isWhite))
+         token += '#';
+      else if (board.isInCheck(isWhite))
+         token += '+';
+
+      if (column > 0 && column + token.size() + 1 > 80)
+      {
+         out << '\n';
+         column = 0;
+      }
+      else if (column > 0)
+      {
+         out << ' ';
+         column++;
+      }
+      out << token;
+      column += token.size();
+   }
+   if (column > 0)
+      out << ' ';
+   out << resultToText(game.result) << "\n\n";
+}
+
+/***************************************************
+ * CONVERT PGN TO RECORD
+ * Encode every game in a PGN stream
+ ***************************************************/
+size_t convertPgnToRecord(istream& in, GameRecordWriter& writer,
+                          size_t* numSkipped)
+{
+   size_t numGames = 0;
+   if (numSkipped)
+      *numSkipped = 0;
+
+   while (true)
+   {
+      PgnGame game;
+      try
+      {
+         if (!readPgnGame(in, game))
+            break;
+      }
+      catch (const string&)
+      {
+         if (numSkipped)
+            (*numSkipped)++;
+         continue;
+      }
+      writer.addGame(game.moves, game.result);
+      numGames++;
+   }
+   return numGames;
+}
+
+/***************************************************
+ * CONVERT RECORD TO PGN
+ * Decode every game in an archive. The archive does not
+ * keep tags, so only the result is known.
+ ***************************************************/
+size_t convertRecordToPgn(const GameRecordReader& reader, ostream& out)
+{
+   for (size_t i = 0; i < reader.size(); i++)
+   {
+      PgnGame game;
+      game.result = reader.getResult(i);
+      reader.getMoves(i, game.moves);
+      writePgnGame(out, game);
+   }
+   return reader.size();
+}
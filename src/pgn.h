@@ -0,0 +1,54 @@
+/***********************************************************************
+ * Header File:
+ *    PGN
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Read and write games in Portable Game Notation, and convert
+ *    between PGN and the binary game record format
+ ************************************************************************/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "move.h"        // because a game is a list of moves
+#include "gameRecord.h"  // for GameResult and the converters
+
+class Board;
+
+/***************************************************
+ * PGN GAME
+ * The tags, moves, and result of one game
+ ***************************************************/
+struct PgnGame
+{
+   PgnGame() : result(RESULT_UNKNOWN) {}
+   std::map<std::string, std::string> tags;
+   std::vector<Move> moves;
+   GameResult result;
+};
+
+// Standard Algebraic Notation for a single move
+std::string moveToSan(const Board& board, const Move& move);
+Move sanToMove(const Board& board, const std::string& san);
+
+// make a sequence of SAN moves on a board, as the tests do
+void playSan(Board& board, const char* moves[], int num);
+
+// result tokens such as "1-0" and "1/2-1/2"
+const char* resultToText(GameResult result);
+GameResult  resultFromText(const std::string& text);
+
+// read the next game from a stream. Returns false at end of input.
+// Throws a string if the movetext cannot be replayed.
+bool readPgnGame(std::istream& in, PgnGame& game);
+void writePgnGame(std::ostream& out, const PgnGame& game);
+
+// convert whole archives. Games that cannot be replayed are skipped
+// and counted in numSkipped
+size_t convertPgnToRecord(std::istream& in, GameRecordWriter& writer,
+                          size_t* numSkipped = nullptr);
+size_t convertRecordToPgn(const GameRecordReader& reader, std::ostream& out);
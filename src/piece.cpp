@@ -19,6 +19,7 @@
 #include "piecePawn.h"
 #include "board.h"     // for BOARD
 #include "uiDraw.h"    // for draw*()
+#include "allocTrack.h" // for ALLOC_SCOPE
 #include <cassert>     // because we are paranoid
 using namespace std;
 
@@ -37,12 +38,39 @@ const Piece& Piece::operator = (const Piece& rhs)
    return *this;
 }
 
+/************************************************
+ * PIECE : ADD MOVES
+ * A move to every target square, unless one of our
+ * own pieces stands there
+ ***********************************************/
+void Piece::addMoves(Bitboard targets, set<Move>& moves, const Board& board) const
+{
+   while (targets)
+   {
+      Position dest(popSquare(targets));
+      Piece* pDest = board.getPiece(dest);
+      bool isEmpty = pDest == nullptr || pDest->getType() == SPACE;
+      if (!isEmpty && pDest->isWhite() == fWhite)
+         continue;
+
+      Move m;
+      m.setSource(position);
+      m.setDest(dest);
+      m.setMoveType(Move::MOVE);
+      m.setWhiteTurn(fWhite);
+      if (!isEmpty)
+         m.setCapture(pDest->getType());
+      moves.insert(m);
+   }
+}
+
 /************************************************
  * PIECE : GET MOVES
  * Iterate through the moves decorator to allow a piece to move
  ***********************************************/
 void Piece::getMoves(set<Move>& movesSet, const Board& board) const
 {
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Piece::getMoves");
    switch (getType())
    {
       case KING:
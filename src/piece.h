@@ -14,6 +14,7 @@
 #include <list>        // for the move-type,list
 #include <cassert>
 #include "position.h"  // Because Position is a member variable
+#include "bitboard.h"  // for the squares a piece can move to
 #include "move.h"      // Because we return a set of Move
 #include "pieceType.h" // A piece type.
 using std::set;
@@ -88,6 +89,9 @@ public:
    virtual void getMoves(set <Move> & moves, const Board & board) const;
    
 protected:
+   // a move to each target that is empty or holds an opponent
+   void addMoves(Bitboard targets, set <Move> & moves, const Board & board) const;
+   
    
    int  nMoves;                    // how many times have you moved?
    bool fWhite;                    // which team are you on?
@@ -10,6 +10,9 @@
 #include "pieceBishop.h"
 #include "board.h"
 #include "uiDraw.h"    // for draw*()
+#include "allocTrack.h" // for ALLOC_SCOPE
+#include "trace.h"      // for TRACE_SCOPE
+#include "bitboard.h"   // for the slider attacks
 
 /***************************************************
  * PIECE DRAW
@@ -26,49 +29,11 @@ void Bishop::display(ogstream* pgout) const
  *********************************************/
 void Bishop::getMoves(set <Move>& moves, const Board& board) const
 {
-   static const int dCol[] = { 1,  1, -1, -1 };
-   static const int dRow[] = { 1, -1,  1, -1 };
-   
-   int col = position.getCol();
-   int row = position.getRow();
-   
-   // For each diagonal direction
-   for (int dir = 0; dir < 4; ++dir)
-   {
-      int c = col + dCol[dir];
-      int r = row + dRow[dir];
-      
-      // Slide in this direction until blocked
-      while (c > -1 && c < 8 && r > -1 && r < 8)
-      {
-         Piece* pDest = board.getPiece(Position(c, r));
-         
-         if (pDest == nullptr || pDest->getType() == SPACE)
-         {
-            Move m;
-            m.setSource(position);
-            m.setDest(Position(c, r));
-            m.setMoveType(Move::MOVE);
-            m.setWhiteTurn(this->fWhite);
-            moves.insert(m);
-         }
-         else
-         {
-            if (pDest->isWhite() != this->fWhite)
-            {
-               Move m;
-               m.setSource(position);
-               m.setDest(Position(c, r));
-               m.setMoveType(Move::MOVE);
-               m.setWhiteTurn(this->fWhite);
-               m.setCapture(pDest->getType());
-               moves.insert(m);
-            }
-            // Stop sliding after hitting any piece
-            break;
-         }
-         c += dCol[dir];
-         r += dRow[dir];
-      }
-   }
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Bishop::getMoves");
+   TRACE_SCOPE("Bishop::getMoves");
+
+   // slide along both diagonals up to the first piece in the way
+   int square = position.getLocation();
+   Bitboard occupied = board.getOccupied(BISHOP_MASKS[square]);
+   addMoves(getBishopAttacks(square, occupied), moves, board);
 }
@@ -10,6 +10,9 @@
 #include "pieceKing.h"
 #include "board.h"
 #include "uiDraw.h"    // for draw*()
+#include "allocTrack.h" // for ALLOC_SCOPE
+#include "trace.h"      // for TRACE_SCOPE
+#include "bitboard.h"   // for KING_ATTACKS
 
 /***************************************************
  * PIECE DRAW
@@ -26,81 +29,72 @@ void King::display(ogstream* pgout) const
  *********************************************/
 void King::getMoves(set <Move>& moves, const Board& board) const
 {
-   Move m;
-   // Directions: up, down, left, right, and 4 diagonals
-   static const int dCol[] = { 0,  0, -1, 1,  1,  1, -1, -1 };
-   static const int dRow[] = { 1, -1,  0, 0,  1, -1,  1, -1 };
-   
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "King::getMoves");
+   TRACE_SCOPE("King::getMoves");
    int col = position.getCol();
    int row = position.getRow();
    
-   for (int dir = 0; dir < 8; ++dir)
+   // one step in any direction that stays on the board
+   Bitboard targets = KING_ATTACKS[position.getLocation()];
+   while (targets)
    {
-      int c = col + dCol[dir];
-      int r = row + dRow[dir];
+      Position dest(popSquare(targets));
+      Piece* pDest = board.getPiece(dest);
       
-      // Check boundaries: king moves only one step
-      if (c >= 0 && c < 8 && r >= 0 && r < 8)
+      if (pDest == nullptr || pDest->getType() == SPACE)
+      {
+         Move m;
+         m.setSource(position);
+         m.setDest(dest);
+         m.setMoveType(Move::MOVE);
+         m.setWhiteTurn(this->fWhite);
+         moves.insert(m);
+      }
+      else if (pDest->isWhite() != this->fWhite)
       {
-         Piece* pDest = board.getPiece(Position(c, r));
-         
-         if (pDest == nullptr || pDest->getType() == SPACE)
-         {
-            m.setSource(position);
-            m.setDest(Position(c, r));
-            m.setMoveType(Move::MOVE);
-            m.setWhiteTurn(this->fWhite);
-            moves.insert(m);
-         }
-         else if (pDest->isWhite() != this->fWhite)
-         {
-            m.setSource(position);
-            m.setDest(Position(c, r));
-            m.setMoveType(Move::MOVE);
-            m.setWhiteTurn(this->fWhite);
-            m.setCapture(pDest->getType());
-            moves.insert(m);
-         }
-         // No further movement, king only moves one square
+         Move m;
+         m.setSource(position);
+         m.setDest(dest);
+         m.setMoveType(Move::MOVE);
+         m.setWhiteTurn(this->fWhite);
+         m.setCapture(pDest->getType());
+         moves.insert(m);
       }
    }
    
-   if (nMoves == 0 && col == 4)
+   // castling: the right is still held, the rook is in its corner, the
+   // squares between are empty, and the king neither starts in check
+   // nor crosses or lands on an attacked square
+   if (col != 4 || row != (fWhite ? 0 : 7))
+      return;
+   for (int side = 0; side < 2; side++)
    {
-      Piece* qSideRook = board.getPiece(Position(0, row));
-      Piece* kSideRook = board.getPiece(Position(7, row));
+      bool isKingSide = (side == 0);
+      int colRook = isKingSide ? 7 : 0;
+      int dir     = isKingSide ? 1 : -1;
+      if (!board.canCastle(fWhite, isKingSide))
+         continue;
       
-      // King has not moved yet, check for King castling
-      if (qSideRook && qSideRook->getNMoves() == 0)
-      {
-         if ((board.getPiece(Position(1, row)) == nullptr &&
-              board.getPiece(Position(2, row)) == nullptr &&
-              board.getPiece(Position(3, row)) == nullptr) ||
-             (board.getPiece(Position(1, row))->getType() == SPACE &&
-              board.getPiece(Position(2, row))->getType() == SPACE &&
-              board.getPiece(Position(3, row))->getType() == SPACE))
-         {
-            m.setSource(position);
-            m.setDest(Position(2, row));
-            m.setMoveType(Move::CASTLE_QUEEN);
-            m.setWhiteTurn(this->fWhite);
-            moves.insert(m);
-         }
-      }
+      Piece* pRook = board.getPiece(Position(colRook, row));
+      if (!pRook || pRook->getType() != ROOK || pRook->isWhite() != fWhite)
+         continue;
       
-      if (kSideRook && kSideRook->getNMoves() == 0)
+      bool isClear = true;
+      for (int c = col + dir; c != colRook && isClear; c += dir)
       {
-         if ((board.getPiece(Position(5, row)) == nullptr &&
-              board.getPiece(Position(6, row)) == nullptr) ||
-             (board.getPiece(Position(5, row))->getType() == SPACE &&
-              board.getPiece(Position(6, row))->getType() == SPACE))
-         {
-            m.setSource(position);
-            m.setDest(Position(6, row));
-            m.setMoveType(Move::CASTLE_KING);
-            m.setWhiteTurn(this->fWhite);
-            moves.insert(m);
-         }
+         Piece* pBetween = board.getPiece(Position(c, row));
+         isClear = (pBetween == nullptr || pBetween->getType() == SPACE);
       }
+      for (int c = col; c != col + 3 * dir && isClear; c += dir)
+         isClear = !board.isSquareUnderAttack(Position(c, row), !fWhite);
+      if (!isClear)
+         continue;
+      
+      Move m;
+      m.setSource(position);
+      m.setDest(Position(col + 2 * dir, row));
+      m.setMoveType(isKingSide ? Move::CASTLE_KING : Move::CASTLE_QUEEN);
+      m.setWhiteTurn(this->fWhite);
+      moves.insert(m);
    }
 }
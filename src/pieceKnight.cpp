@@ -10,6 +10,9 @@
 #include "pieceKnight.h"
 #include "board.h"
 #include "uiDraw.h"    // for draw*()
+#include "allocTrack.h" // for ALLOC_SCOPE
+#include "trace.h"      // for TRACE_SCOPE
+#include "bitboard.h"   // for KNIGHT_ATTACKS
 
 /***************************************************
  * PIECE DRAW
@@ -26,30 +29,22 @@ void Knight::display(ogstream* pgout) const
  *********************************************/
 void Knight::getMoves(set <Move>& moves, const Board& board) const
 {
-   static const int dCol[] = { 1,  2,  2,  1, -1, -2, -2, -1 };
-   static const int dRow[] = { -2, -1,  1,  2,  2,  1, -1, -2 };
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Knight::getMoves");
+   TRACE_SCOPE("Knight::getMoves");
+   // every square on the board a knight from here lands on
+   Bitboard targets = KNIGHT_ATTACKS[position.getLocation()];
    
-   int col = position.getCol();
-   int row = position.getRow();
-   
-   for (int i = 0; i < 8; ++i)
+   while (targets)
    {
-      int c = col + dCol[i];
-      int r = row + dRow[i];
-      
-      // Check if the target position is on the board
-      if (c < 0 || c > 7 || r < 0 || r > 7)
-         continue;
-      
-      // Use Board's board array directly (allowed by friend)
-      Piece* pDest = board.getPiece(Position(c, r));
+      Position dest(popSquare(targets));
+      Piece* pDest = board.getPiece(dest);
       
       // If the destination is empty or a SPACE, it's a valid move
       if (pDest == nullptr || pDest->getType() == SPACE)
       {
          Move m;
          m.setSource(position);
-         m.setDest(Position(c, r));
+         m.setDest(dest);
          m.setMoveType(Move::MOVE);
          m.setWhiteTurn(this->fWhite);
          moves.insert(m);
@@ -59,7 +54,7 @@ void Knight::getMoves(set <Move>& moves, const Board& board) const
       {
          Move m;
          m.setSource(position);
-         m.setDest(Position(c, r));
+         m.setDest(dest);
          m.setMoveType(Move::MOVE);
          m.setWhiteTurn(this->fWhite);
          m.setCapture(pDest->getType());
@@ -10,6 +10,9 @@
 #include "piecePawn.h"
 #include "board.h"
 #include "uiDraw.h"    // for draw*()
+#include "allocTrack.h" // for ALLOC_SCOPE
+#include "trace.h"      // for TRACE_SCOPE
+#include "bitboard.h"   // for PAWN_ATTACKS
 
 /***************************************************
  * PIECE DRAW
@@ -21,11 +24,32 @@ void Pawn::display(ogstream* pgout) const
 }
 
 
+/**********************************************
+ * Pawn : ADD MOVE
+ * A move onto the last rank is four moves, one for
+ * each piece the pawn may become
+ *********************************************/
+static void addMove(set <Move>& moves, Move& move, bool isPromotion)
+{
+   if (!isPromotion)
+   {
+      moves.insert(move);
+      return;
+   }
+   for (PieceType type : { QUEEN, ROOK, BISHOP, KNIGHT })
+   {
+      move.setPromote(type);
+      moves.insert(move);
+   }
+}
+
 /**********************************************
  * Pawn : GET POSITIONS
  *********************************************/
 void Pawn::getMoves(set <Move>& moves, const Board& board) const
 {
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Pawn::getMoves");
+   TRACE_SCOPE("Pawn::getMoves");
    int col = position.getCol();
    int row = position.getRow();
    
@@ -45,9 +69,7 @@ void Pawn::getMoves(set <Move>& moves, const Board& board) const
          m.setDest(Position(col, nextRow));
          m.setMoveType(Move::MOVE);
          m.setWhiteTurn(this->fWhite);
-         if (isPromotion)
-            m.setPromote(QUEEN);
-         moves.insert(m);
+         addMove(moves, m, isPromotion);
          
          // Initial two-square advance
          int startRow = fWhite ? 1 : 6;
@@ -66,39 +88,31 @@ void Pawn::getMoves(set <Move>& moves, const Board& board) const
             }
          }
       }
-      // Diagonal captures
-      for (int dCol = -1; dCol <= 1; dCol += 2) // -1 (left), +1 (right)
+      // Diagonal captures, one square forward to either side
+      Bitboard targets = PAWN_ATTACKS[fWhite][position.getLocation()];
+      while (targets)
       {
-         int diagCol = col + dCol;
-         if (diagCol >= 0 && diagCol < 8)
+         Position posDiag(popSquare(targets));
+         Piece* pDiag = board.getPiece(posDiag);
+         bool isPromotionCapture = (fWhite && nextRow == 7) || (!fWhite && nextRow == 0);
+         if (pDiag && pDiag->getType() != SPACE && pDiag->isWhite() != this->isWhite())
          {
-            Piece* pDiag = board.getPiece(Position(diagCol, nextRow));
-            bool isPromotionCapture = (fWhite && nextRow == 7) || (!fWhite && nextRow == 0);
-            if (pDiag && pDiag->getType() != SPACE && pDiag->isWhite() != this->isWhite())
-            {
-               Move m;
-               m.setSource(position);
-               m.setDest(Position(diagCol, nextRow));
-               m.setMoveType(Move::MOVE);
-               m.setWhiteTurn(this->fWhite);
-               if (isPromotionCapture)
-                  m.setPromote(QUEEN);
-               moves.insert(m);
-            }
-            // En passant (non-standard: no move history, just check adjacent pawn in correct position)
-            Piece* pSide = board.getPiece(Position(diagCol, row));
-            int enPassantRow = fWhite ? 4 : 3; // 5th rank for white, 4th for black (0-based)
-            if (pSide && pSide->getType() == PAWN
-                && pSide->isWhite() != this->isWhite()
-                && row == enPassantRow)
-            {
-               Move m;
-               m.setSource(position);
-               m.setDest(Position(diagCol, nextRow));
-               m.setMoveType(Move::ENPASSANT);
-               m.setWhiteTurn(this->fWhite);
-               moves.insert(m);
-            }
+            Move m;
+            m.setSource(position);
+            m.setDest(posDiag);
+            m.setMoveType(Move::MOVE);
+            m.setWhiteTurn(this->fWhite);
+            addMove(moves, m, isPromotionCapture);
+         }
+         // En passant: onto the square the enemy pawn just skipped over
+         else if (posDiag == board.getEnPassant())
+         {
+            Move m;
+            m.setSource(position);
+            m.setDest(posDiag);
+            m.setMoveType(Move::ENPASSANT);
+            m.setWhiteTurn(this->fWhite);
+            moves.insert(m);
          }
       }
    }
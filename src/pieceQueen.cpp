@@ -10,6 +10,9 @@
 #include "pieceQueen.h"
 #include "board.h"
 #include "uiDraw.h"    // for draw*()
+#include "allocTrack.h" // for ALLOC_SCOPE
+#include "trace.h"      // for TRACE_SCOPE
+#include "bitboard.h"   // for the slider attacks
 
 /***************************************************
  * PIECE DRAW
@@ -26,48 +29,11 @@ void Queen::display(ogstream* pgout) const
  *********************************************/
 void Queen::getMoves(set <Move>& moves, const Board& board) const
 {
-   // Directions: up, down, left, right, and 4 diagonals
-   static const int dCol[] = { 0,  0, -1, 1,  1,  1, -1, -1 };
-   static const int dRow[] = { 1, -1,  0, 0,  1, -1,  1, -1 };
-   
-   int col = position.getCol();
-   int row = position.getRow();
-   
-   for (int dir = 0; dir < 8; ++dir)
-   {
-      int c = col + dCol[dir];
-      int r = row + dRow[dir];
-      
-      while (c > -1 && c < 8 && r > -1 && r < 8)
-      {
-         Piece* pDest = board.getPiece(Position(c, r));
-         
-         if (pDest == nullptr || pDest->getType() == SPACE)
-         {
-            Move m;
-            m.setSource(position);
-            m.setDest(Position(c, r));
-            m.setMoveType(Move::MOVE);
-            m.setWhiteTurn(this->fWhite);
-            moves.insert(m);
-         }
-         else
-         {
-            if (pDest->isWhite() != this->fWhite)
-            {
-               Move m;
-               m.setSource(position);
-               m.setDest(Position(c, r));
-               m.setMoveType(Move::MOVE);
-               m.setWhiteTurn(this->fWhite);
-               m.setCapture(pDest->getType());
-               moves.insert(m);
-            }
-            break;
-         }
-         
-         c += dCol[dir];
-         r += dRow[dir];
-      }
-   }
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Queen::getMoves");
+   TRACE_SCOPE("Queen::getMoves");
+
+   // slide in all eight directions up to the first piece in the way
+   int square = position.getLocation();
+   Bitboard occupied = board.getOccupied(ROOK_MASKS[square] | BISHOP_MASKS[square]);
+   addMoves(getQueenAttacks(square, occupied), moves, board);
 }
@@ -10,6 +10,9 @@
 #include "pieceRook.h"
 #include "board.h"
 #include "uiDraw.h"    // for draw*()
+#include "allocTrack.h" // for ALLOC_SCOPE
+#include "trace.h"      // for TRACE_SCOPE
+#include "bitboard.h"   // for the slider attacks
 
 /***************************************************
  * PIECE DRAW
@@ -26,49 +29,11 @@ void Rook::display(ogstream* pgout) const
  *********************************************/
 void Rook::getMoves(set <Move>& moves, const Board& board) const
 {
-   static const int dCol[] = { 0,  0, -1, 1 };
-   static const int dRow[] = { 1, -1,  0, 0 };
-   
-   int col = position.getCol();
-   int row = position.getRow();
-   
-   // For each diagonal direction
-   for (int dir = 0; dir < 4; ++dir)
-   {
-      int c = col + dCol[dir];
-      int r = row + dRow[dir];
-      
-      // Slide in this direction until blocked
-      while (c > -1 && c < 8 && r > -1 && r < 8)
-      {
-         Piece* pDest = board.getPiece(Position(c, r));
-         
-         if (pDest == nullptr || pDest->getType() == SPACE)
-         {
-            Move m;
-            m.setSource(position);
-            m.setDest(Position(c, r));
-            m.setMoveType(Move::MOVE);
-            m.setWhiteTurn(this->fWhite);
-            moves.insert(m);
-         }
-         else
-         {
-            if (pDest->isWhite() != this->fWhite)
-            {
-               Move m;
-               m.setSource(position);
-               m.setDest(Position(c, r));
-               m.setMoveType(Move::MOVE);
-               m.setWhiteTurn(this->fWhite);
-               m.setCapture(pDest->getType());
-               moves.insert(m);
-            }
-            // Stop sliding after hitting any piece
-            break;
-         }
-         c += dCol[dir];
-         r += dRow[dir];
-      }
-   }
+   ALLOC_SCOPE(ALLOC_MOVEGEN, "Rook::getMoves");
+   TRACE_SCOPE("Rook::getMoves");
+
+   // slide along the row and column up to the first piece in the way
+   int square = position.getLocation();
+   Bitboard occupied = board.getOccupied(ROOK_MASKS[square]);
+   addMoves(getRookAttacks(square, occupied), moves, board);
 }
@@ -0,0 +1,44 @@
+/***********************************************************************
+ * Header File:
+ *    POLYGLOT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Position hashing and move encoding compatible with Polyglot
+ *    opening books. Books built by other programs can be read here,
+ *    and books built here can be read by other programs.
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "move.h"      // because we encode and decode moves
+
+class Board;
+class Piece;
+
+// number of entries in the Polyglot random table:
+// 768 piece-squares, 4 castling rights, 8 en-passant files, 1 turn
+const int POLYGLOT_NUM_RANDOM = 781;
+
+// the Zobrist key of a position, as Polyglot computes it
+uint64_t polyglotKey(const Board& board);
+
+// the same without the castling and en-passant terms
+uint64_t polyglotPlacementKey(const Board& board);
+
+// the terms of the key one at a time, so a board can keep its key up to
+// date as it moves: a piece on a square (0 for a space), the castling
+// and en-passant terms of a position, and the side-to-move term
+uint64_t polyglotPieceKey(const Piece& piece, const Position& pos);
+uint64_t polyglotRightsKey(const Board& board);
+uint64_t polyglotTurnKey();
+
+// Polyglot moves are 16 bits: to-file, to-row, from-file, from-row,
+// and promotion, 3 bits each. Castling is encoded as the king
+// capturing its own rook.
+uint16_t moveToPolyglot(const Move& move);
+
+// find the legal move matching a Polyglot move. Returns false if
+// the move is not legal in this position
+bool polyglotToMove(const Board& board, uint16_t pgMove, Move& move);
@@ -11,6 +11,7 @@
 
 #include <string>
 #include <cstdint>
+#include <type_traits>
 using std::string;
 using std::ostream;
 using std::istream;
@@ -35,33 +36,38 @@ const Delta SUB_C = { 0, -1 };
 
 
 class PositionTest;
+class Screen;
 
 /***************************************************
  * POSITION
- * The location of a piece on the board
+ * The location of a piece on the board. One byte with
+ * the column in the high nibble and the row in the low
+ * one, so a bit in 0x88 means it is off the board. It
+ * has no virtual methods, so it copies like a char and
+ * works in a constexpr table. Pixels belong to the
+ * user interface; see Screen in uiDraw.h
  ***************************************************/
 class Position
 {
    friend class PositionTest;
+   friend class Screen;
 public:
    
    // Position :    The Position class can work with other positions,
    //               Allowing for comparisions, copying, etc.
-   Position(const Position& rhs) { set(rhs.colRow); }
-   Position() : colRow(0x99) { set(0xff); }
-   bool isInvalid() const { return (colRow == 0xff) || (colRow & 0x88); }
-   bool isValid() const { return !isInvalid(); }
-   void setValid()   { colRow = 0x00; }
-   void setInvalid() { colRow = 0xff; }
-   bool operator <  (const Position & rhs) const { return this->colRow < rhs.colRow; }
-   bool operator == (const Position & rhs) const { return this->colRow == rhs.colRow; }
-   bool operator != (const Position & rhs) const { return this->colRow != rhs.colRow; }
-   const Position& operator = (const Position& rhs) { set(rhs.colRow); return *this; }
+   constexpr Position() : colRow(0xff) { }
+   constexpr bool isInvalid() const { return (colRow == 0xff) || (colRow & 0x88); }
+   constexpr bool isValid() const { return !isInvalid(); }
+   constexpr void setValid()   { colRow = 0x00; }
+   constexpr void setInvalid() { colRow = 0xff; }
+   constexpr bool operator <  (const Position & rhs) const { return this->colRow < rhs.colRow; }
+   constexpr bool operator == (const Position & rhs) const { return this->colRow == rhs.colRow; }
+   constexpr bool operator != (const Position & rhs) const { return this->colRow != rhs.colRow; }
    
    // Location : The Position class can work with locations, which
    //            are 0...63 where we start in row 0, then row 1, etc.
-   Position(int location) : colRow(0x99) { setLocation(location); }
-   int getLocation() const
+   constexpr Position(int location) : colRow(0xff) { setLocation(location); }
+   constexpr int getLocation() const
    {
       if (isInvalid()) return -1;
       int col = getCol();
@@ -69,7 +75,7 @@ public:
       if (col < 0 || row < 0) return -1;
       return row * 8 + col;
    }
-   void setLocation(int location)
+   constexpr void setLocation(int location)
    {
       if (0 <= location && location < 64)
          set(location % 8, location / 8);
@@ -80,36 +86,36 @@ public:
    
    // Row/Col : The position class can work with row/column,
    //           which are 0..7 and 0...7
-   Position(int c, int r) : colRow(0x99) { set(c, r); }
-   virtual int getCol() const
+   constexpr Position(int c, int r) : colRow(0xff) { set(c, r); }
+   constexpr int getCol() const
    {
       if (isInvalid()) return -1;
       int col = (colRow & 0xf0) >> 4;
       if (col > 7) return -1;
       return col;
    }
-   virtual int getRow() const
+   constexpr int getRow() const
    {
       if (isInvalid()) return -1;
       int row = (colRow & 0x0f);
       if (row > 7) return -1;
       return row;
    }
-   void setCol(int c)
+   constexpr void setCol(int c)
    {
       if (c >= 0 && c < 8)
          set((colRow & 0x0f) | ((c & 0x0f) << 4));
       else
          set(0xff);
    }
-   void setRow(int r)
+   constexpr void setRow(int r)
    {
       if (r >= 0 && r < 8)
          set((colRow & 0xf0) | (r & 0x0f));
       else
          set(0xff);
    }
-   void set(int c, int r)
+   constexpr void set(int c, int r)
    {
       if (c < 0 || c > 7 || r < 0 || r > 7)
          colRow = 0xff;
@@ -120,7 +126,7 @@ public:
    // Text:    The Position class can work with textual coordinates,
    //          such as "d4"
    
-   Position(const char* s) : colRow(0x99)
+   constexpr Position(const char* s) : colRow(0xff)
    {
       if (!s || s[0] < 'a' || s[0] > 'h' || s[1] < '1' || s[1] > '8')
       {
@@ -133,7 +139,7 @@ public:
          set(col, row);
       }
    }
-   const Position& operator =  (const char* rhs)
+   constexpr const Position& operator =  (const char* rhs)
    {
       if (!rhs || rhs[0] < 'a' || rhs[0] > 'h' || rhs[1] < '1' || rhs[1] > '8')
       {
@@ -153,45 +159,11 @@ public:
       return *this;
    }
    
-   
-   // Pixels:    The Position class can work with screen coordinates,
-   //            a.k.a. Pixels, these are X and Y coordinates. Note that
-   //            we need to scale them according to the size of the board.
-   
-   int getX()   const
-   {
-      return (int)((double)getCol() * getSquareWidth() + getSquareWidth());
-   }
-   int getY()   const
-   {
-      return (int)((double)getRow() * getSquareHeight() + getSquareHeight());
-   }
-   void setXY(double x, double y)
-   {
-      int col = (int)(x / getSquareWidth()) - 1;
-      int row = 8 - (int)(y / getSquareHeight());
-      if (col < 0 || col > 7)
-         colRow = 0xff;
-      else if (row < 0 || row > 7)
-         colRow = 0x3f;
-      else
-         set(col, row);
-   }
-   double getSquareWidth()  const { return squareWidth; }
-   double getSquareHeight() const { return squareHeight; }
-   void setBoardWidthHeight(int widthBoard, int heightBoard)
-   {
-      if (widthBoard < 0 || heightBoard < 0)
-         return;
-      squareWidth = (double)widthBoard / 10.0; // 8 squares + 2 spaces
-      squareHeight = (double)heightBoard / 10.0;
-   }
-   
    // Delta:    The Position class can work with deltas, which are
    //           offsets from a given location. This helps pieces move
    //           on the chess board.
-   Position(const Position& rhs, const Delta& delta) : colRow(-1) {  }
-   void adjustCol(int dCol)
+   constexpr Position(const Position& rhs, const Delta& delta) : colRow(0xff) {  }
+   constexpr void adjustCol(int dCol)
    {
       if (isInvalid()) return;
       int newCol = getCol() + dCol;
@@ -200,7 +172,7 @@ public:
       else
          setCol(newCol);
    }
-   void adjustRow(int dRow)
+   constexpr void adjustRow(int dRow)
    {
       if (isInvalid()) return;
       int newRow = getRow() + dRow;
@@ -209,7 +181,7 @@ public:
       else
          setRow(newRow);
    }
-   const Position& operator += (const Delta& rhs)
+   constexpr const Position& operator += (const Delta& rhs)
    {
       if (isInvalid())
          return *this;
@@ -221,7 +193,7 @@ public:
          set(newCol, newRow);
       return *this;
    }
-   Position operator + (const Delta& rhs) const
+   constexpr Position operator + (const Delta& rhs) const
    {
       Position temp(*this);
       temp += rhs;
@@ -229,13 +201,16 @@ public:
    }
    
 private:
-   void set(uint8_t colRowNew) { colRow = colRowNew; }
+   constexpr void set(uint8_t colRowNew) { colRow = colRowNew; }
    
    uint8_t colRow;
-   static double squareWidth;
-   static double squareHeight;
 };
 
+static_assert(sizeof(Position) == 1, "a Position is one byte");
+static_assert(std::is_trivially_copyable<Position>::value,
+              "a Position copies like a char");
+static_assert(Position("e4").getLocation() == 28, "a Position works at compile time");
+
 
 ostream& operator << (ostream& out, const Position& pos);
 istream& operator >> (istream& in, Position& pos);
@@ -0,0 +1,187 @@
+/***********************************************************************
+ * Source File:
+ *    SEARCH
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Iterative deepening alpha-beta over the legal moves
+ ************************************************************************/
+
+#include "search.h"
+#include "board.h"       // for BOARD and GAME STATE
+#include "evaluate.h"    // for EVALUATE
+#include "timeManager.h" // for TIME MANAGER
+#include "piece.h"       // for PIECE
+#include "trace.h"       // for TRACE_SCOPE
+#include <algorithm>     // for STABLE_PARTITION
+#include <vector>
+using namespace std;
+
+/*************************************
+ * IS CAPTURE
+ * Does the move take a piece? The pawn moves carry no
+ * capture, so look at what stands on the destination
+ **************************************/
+static bool isCapture(const Board& board, const Move& move)
+{
+   return move.getMoveType() == Move::ENPASSANT ||
+          board.getPiece(move.getDest())->getType() != SPACE;
+}
+
+/*************************************
+ * ORDER MOVES
+ * The move that was best last iteration goes first,
+ * then the captures, then the rest. Alpha-beta cuts
+ * off the most when the best move is tried first
+ **************************************/
+static vector<Move> orderMoves(const Board& board, const set<Move>& moves,
+                               const Move& moveFirst)
+{
+   vector<Move> ordered(moves.begin(), moves.end());
+   auto itQuiet = stable_partition(ordered.begin(), ordered.end(),
+                                   [&moveFirst](const Move& move)
+                                   { return move == moveFirst; });
+   stable_partition(itQuiet, ordered.end(), [&board](const Move& move)
+                    { return isCapture(board, move); });
+   return ordered;
+}
+
+/*************************************
+ * SEARCH : GET MATE MOVES
+ * How many moves until mate: positive if the side to
+ * move mates, negative if it is mated
+ **************************************/
+int Search::getMateMoves(int score)
+{
+   if (score > 0)
+      return (SCORE_MATE - score + 1) / 2;
+   return -(SCORE_MATE + score) / 2;
+}
+
+/*************************************
+ * SEARCH : RUN
+ * From a FEN, with no history before it
+ **************************************/
+SearchResult Search::run(const string& fen, int maxDepth,
+                         const function<void(const SearchResult&)>& onDepth)
+{
+   Board board;
+   board.readFEN(fen);
+   return run(board, maxDepth, onDepth);
+}
+
+/*************************************
+ * SEARCH : RUN
+ * One iteration per depth. An iteration that is stopped
+ * part of the way through is thrown away, so the result
+ * is always from a search that looked at every move
+ **************************************/
+SearchResult Search::run(const Board& board, int maxDepth,
+                         const function<void(const SearchResult&)>& onDepth)
+{
+   SearchResult result;
+   numNodes  = 0;
+   depthDone = 0;
+   isTimeUp  = false;
+
+   const GameState& state = board.getGameState();
+   if (state.legalMoves.empty())
+      return result;
+
+   for (int depth = 1; depth <= maxDepth && !isAborted(); depth++)
+   {
+      int alpha = -SCORE_MATE - 1;
+      Move bestMove;
+      for (const Move& move : orderMoves(board, state.legalMoves, result.bestMove))
+      {
+         Board child(board);
+         child.move(move);
+         int score = -alphaBeta(child, depth - 1, 1, -SCORE_MATE - 1, -alpha);
+         if (isAborted())
+            break;
+         if (score > alpha)
+         {
+            alpha = score;
+            bestMove = move;
+         }
+      }
+      if (isAborted())
+         break;
+
+      result.bestMove = bestMove;
+      result.score    = alpha;
+      result.depth    = depth;
+      result.numNodes = numNodes;
+      depthDone       = depth;
+      if (onDepth)
+         onDepth(result);
+
+      // would the next iteration run past the time for this move?
+      if (pTimeManager)
+      {
+         pTimeManager->update(result);
+         if (pTimeManager->isSoftLimitReached())
+            break;
+      }
+
+      // nothing deeper will find a faster mate
+      if (isMateScore(alpha))
+         break;
+   }
+
+   result.numNodes = numNodes;
+   return result;
+}
+
+/*************************************
+ * SEARCH : ALPHA BETA
+ * The score of this position for the side to move,
+ * looking depth plies ahead. There is no undo, so each
+ * move is played on a copy of the board, which keeps
+ * the history so a repetition is seen
+ **************************************/
+int Search::alphaBeta(const Board& board, int depth, int ply, int alpha, int beta)
+{
+   TRACE_SCOPE("Search::alphaBeta");
+   numNodes++;
+   if (pTimeManager && depthDone > 0 && pTimeManager->isHardLimitReached(numNodes))
+      isTimeUp = true;
+   if (isAborted())
+      return 0;
+
+   const GameState& state = board.getGameState();
+   switch (state.status)
+   {
+      case CHECKMATE:
+         return -(SCORE_MATE - ply);
+      case STALEMATE:
+         return 0;
+      case CHECK:
+      case PLAYING:
+         break;
+   }
+   
+   // a draw either side may claim is worth no more than a draw
+   if (board.isDrawClaimable())
+      return 0;
+
+   if (depth <= 0)
+   {
+      int score = evaluate(CompactPosition(board));
+      return board.whiteTurn() ? score : -score;
+   }
+
+   for (const Move& move : orderMoves(board, state.legalMoves, Move()))
+   {
+      Board child(board);
+      child.move(move);
+      int score = -alphaBeta(child, depth - 1, ply + 1, -beta, -alpha);
+      if (isAborted())
+         return 0;
+      if (score >= beta)
+         return beta;
+      if (score > alpha)
+         alpha = score;
+   }
+   return alpha;
+}
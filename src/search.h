@@ -0,0 +1,93 @@
+/***********************************************************************
+ * Header File:
+ *    SEARCH
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Look ahead from a position to find the best move. The search is
+ *    alpha-beta over the legal moves, one ply deeper each iteration, and
+ *    reports what it found after every iteration. Another thread may ask
+ *    it to stop at any time; it checks at every node, so it returns
+ *    within a fraction of a millisecond with the best move of the last
+ *    iteration it finished.
+ *
+ *    In a timed game a TimeManager decides when to stop: the search
+ *    starts no iteration past its soft limit, and gives up on the one it
+ *    is in at the hard limit.
+ ************************************************************************/
+
+#pragma once
+
+#include "move.h"        // for MOVE
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+class Board;
+class TimeManager;
+
+// a mate this many plies away scores SCORE_MATE - plies
+const int SCORE_MATE = 100000;
+
+/***************************************************
+ * SEARCH RESULT
+ * The best move found, its score in centipawns for
+ * the side to move, and how deep the search looked
+ ***************************************************/
+struct SearchResult
+{
+   SearchResult() : score(0), depth(0), numNodes(0) {}
+   Move     bestMove;      // invalid if no iteration finished
+   int      score;
+   int      depth;
+   uint64_t numNodes;
+};
+
+/***************************************************
+ * SEARCH
+ * One search of one position
+ ***************************************************/
+class Search
+{
+public:
+   Search() : isStopping(false), isTimeUp(false), numNodes(0), depthDone(0),
+              pTimeManager(nullptr) {}
+
+   // search the position on this board, deeper and deeper until maxDepth,
+   // a mate, or stop(). onDepth is called after every iteration. The
+   // history of the board counts: a line that repeats a position of the
+   // game is scored as a draw
+   SearchResult run(const Board& board, int maxDepth,
+                    const std::function<void(const SearchResult&)>& onDepth = nullptr);
+
+   // search the position of this FEN, which has no history
+   SearchResult run(const std::string& fen, int maxDepth,
+                    const std::function<void(const SearchResult&)>& onDepth = nullptr);
+
+   // stop when this manager says time is up. The first iteration always
+   // finishes, so there is a move to play however little time is left
+   void setTimeManager(TimeManager* pTimeManager) { this->pTimeManager = pTimeManager; }
+
+   // safe to call from any thread, before or during run(). A stopped
+   // search stays stopped; running out of time only ends that one run
+   void stop()                { isStopping = true; }
+   bool isStopped()     const { return isStopping; }
+
+   // is this score a mate, and in how many moves?
+   static bool isMateScore(int score) { return score >  SCORE_MATE - 1000 ||
+                                               score < -SCORE_MATE + 1000; }
+   static int  getMateMoves(int score);
+
+private:
+   int alphaBeta(const Board& board, int depth, int ply, int alpha, int beta);
+
+   // has stop() been called, or is the time for this run up?
+   bool isAborted() const { return isStopping || isTimeUp; }
+
+   std::atomic<bool> isStopping;
+   bool              isTimeUp;       // the hard limit of this run passed
+   uint64_t          numNodes;
+   int               depthDone;      // the deepest iteration finished
+   TimeManager*      pTimeManager;   // or nullptr to search until stop()
+};
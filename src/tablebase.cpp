@@ -0,0 +1,301 @@
+/***********************************************************************
+ * Source File:
+ *    TABLEBASE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A compressed, memory-mapped form of a bitbase
+ ************************************************************************/
+
+#include "tablebase.h"
+#include <algorithm>
+#include <tuple>       // for FORWARD AS TUPLE
+#include <fstream>
+#include <cstring>
+#include <cassert>
+using namespace std;
+
+/***************************************************
+ * TABLEBASE : COMPRESS BLOCK
+ * Run-length encoding suits bitbases: whole regions
+ * are won or drawn, so long runs of one byte are common.
+ * A control byte below 128 is followed by that many + 1
+ * literal bytes; 128 and above repeats the next byte
+ * (control - 125) times, 3 to 130.
+ ***************************************************/
+void Tablebase::compressBlock(const uint8_t* in, size_t size, vector<uint8_t>& out)
+{
+   size_t i = 0;
+   while (i < size)
+   {
+      // a run of three or more
+      size_t run = 1;
+      while (i + run < size && in[i + run] == in[i] && run < 130)
+         run++;
+      if (run >= 3)
+      {
+         out.push_back((uint8_t)(run + 125));
+         out.push_back(in[i]);
+         i += run;
+         continue;
+      }
+
+      // literals until the next run of three
+      size_t start = i;
+      while (i < size && i - start < 128 &&
+             !(i + 2 < size && in[i] == in[i + 1] && in[i] == in[i + 2]))
+         i++;
+      out.push_back((uint8_t)(i - start - 1));
+      out.insert(out.end(), in + start, in + i);
+   }
+}
+
+/***************************************************
+ * TABLEBASE : DECOMPRESS BLOCK
+ * The inverse of compressBlock()
+ ***************************************************/
+void Tablebase::decompressBlock(const uint8_t* in, size_t sizeIn,
+                                uint8_t* out, size_t sizeOut)
+{
+   size_t iIn = 0;
+   size_t iOut = 0;
+   while (iIn < sizeIn)
+   {
+      uint8_t control = in[iIn++];
+      if (control < 128)
+      {
+         size_t num = control + 1;
+         if (iIn + num > sizeIn || iOut + num > sizeOut)
+            throw string("Corrupt tablebase block");
+         memcpy(out + iOut, in + iIn, num);
+         iIn += num;
+         iOut += num;
+      }
+      else
+      {
+         size_t num = control - 125;
+         if (iIn >= sizeIn || iOut + num > sizeOut)
+            throw string("Corrupt tablebase block");
+         memset(out + iOut, in[iIn++], num);
+         iOut += num;
+      }
+   }
+   if (iOut != sizeOut)
+      throw string("Corrupt tablebase block");
+}
+
+/***************************************************
+ * TABLEBASE : CONSTRUCT
+ ***************************************************/
+Tablebase::Tablebase(size_t cacheBlocks) :
+   blockSize(0), numBlocks(0), cacheBlocks(max(cacheBlocks, (size_t)1)),
+   shards(new Shard[TABLEBASE_SHARDS]), numHits(0), numMisses(0)
+{
+}
+
+Tablebase::Tablebase(const string& fileName, size_t cacheBlocks) :
+   Tablebase(cacheBlocks)
+{
+   open(fileName);
+}
+
+/***************************************************
+ * TABLEBASE : OPEN
+ ***************************************************/
+void Tablebase::open(const string& fileName)
+{
+   close();
+   file.open(fileName);
+   validate();
+}
+
+void Tablebase::open(const uint8_t* pBuffer, size_t size)
+{
+   close();
+   file.open(pBuffer, size);
+   validate();
+}
+
+/***************************************************
+ * TABLEBASE : CLOSE
+ * Also empty the cache
+ ***************************************************/
+void Tablebase::close()
+{
+   file.close();
+   blockSize = 0;
+   numBlocks = 0;
+   for (int i = 0; i < TABLEBASE_SHARDS; i++)
+   {
+      unique_lock<shared_mutex> lock(shards[i].mutex);
+      shards[i].blocks.clear();
+   }
+}
+
+/***************************************************
+ * TABLEBASE : VALIDATE
+ * Check the header and the block index
+ ***************************************************/
+void Tablebase::validate()
+{
+   const uint8_t* pData = file.data();
+   size_t length = file.size();
+   if (length < TABLEBASE_HEADER ||
+       memcmp(pData, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC)) != 0)
+   {
+      close();
+      throw string("Not a tablebase");
+   }
+
+   try
+   {
+      layout.setSignature(string((const char*)pData + 4,
+                                 strnlen((const char*)pData + 4, 4)));
+   }
+   catch (const string&)
+   {
+      close();
+      throw;
+   }
+
+   blockSize = (size_t)readLittle(pData + 16, 4);
+   numBlocks = (size_t)readLittle(pData + 20, 4);
+   size_t sizeIndex = (numBlocks + 1) * 8;
+   if (readLittle(pData + 8, 8) != layout.size() || blockSize == 0 ||
+       numBlocks != (layout.getNumBytes() + blockSize - 1) / blockSize ||
+       TABLEBASE_HEADER + sizeIndex > length ||
+       readLittle(pData + TABLEBASE_HEADER + numBlocks * 8, 8) != length)
+   {
+      close();
+      throw string("Corrupt tablebase index");
+   }
+}
+
+/***************************************************
+ * TABLEBASE : DECOMPRESS
+ * Expand one block. No lock is held while we do this
+ ***************************************************/
+Tablebase::Block Tablebase::decompress(size_t iBlock) const
+{
+   const uint8_t* pIndex = file.data() + TABLEBASE_HEADER;
+   uint64_t begin = readLittle(pIndex + iBlock * 8, 8);
+   uint64_t end   = readLittle(pIndex + iBlock * 8 + 8, 8);
+   if (begin > end || end > file.size())
+      throw string("Corrupt tablebase index");
+
+   size_t size = min(blockSize, layout.getNumBytes() - iBlock * blockSize);
+   shared_ptr<vector<uint8_t>> pBlock(new vector<uint8_t>(size));
+   decompressBlock(file.data() + begin, (size_t)(end - begin),
+                   pBlock->data(), size);
+   return pBlock;
+}
+
+/***************************************************
+ * TABLEBASE : GET BLOCK
+ * Look in this block's shard of the cache first, with
+ * the lock shared so hits run side by side. A hit
+ * stamps the block with the shard's tick, which is
+ * only written when the stamp is old, so hits on a
+ * block that is already recent write nothing.
+ *
+ * On a miss the block is decompressed outside the
+ * lock; if another thread got there first we use its
+ * copy. Each miss moves the tick on two: the new block
+ * gets the first, and hits after it the second, so a
+ * block hit since is never taken for older than it
+ ***************************************************/
+Tablebase::Block Tablebase::getBlock(size_t iBlock) const
+{
+   Shard& shard = shards[iBlock % TABLEBASE_SHARDS];
+   size_t capacity = max(cacheBlocks / TABLEBASE_SHARDS, (size_t)1);
+
+   {
+      shared_lock<shared_mutex> lock(shard.mutex);
+      auto it = shard.blocks.find(iBlock);
+      if (it != shard.blocks.end())
+      {
+         if (it->second.stamp.load(memory_order_relaxed) != shard.tick)
+            it->second.stamp.store(shard.tick, memory_order_relaxed);
+         numHits++;
+         return it->second.pBlock;
+      }
+   }
+
+   numMisses++;
+   Block pBlock = decompress(iBlock);
+
+   unique_lock<shared_mutex> lock(shard.mutex);
+   auto it = shard.blocks.find(iBlock);
+   if (it != shard.blocks.end())
+      return it->second.pBlock;
+
+   while (shard.blocks.size() >= capacity)
+   {
+      auto itOldest = shard.blocks.begin();
+      for (auto itEntry = shard.blocks.begin(); itEntry != shard.blocks.end(); ++itEntry)
+         if (itEntry->second.stamp.load(memory_order_relaxed) <
+             itOldest->second.stamp.load(memory_order_relaxed))
+            itOldest = itEntry;
+      shard.blocks.erase(itOldest);
+   }
+   shard.tick += 2;
+   shard.blocks.emplace(piecewise_construct, forward_as_tuple(iBlock),
+                        forward_as_tuple(pBlock, shard.tick - 1));
+   return pBlock;
+}
+
+/***************************************************
+ * TABLEBASE : GET
+ * Two bits per position, four positions per byte
+ ***************************************************/
+BitbaseValue Tablebase::get(size_t index) const
+{
+   assert(index < size());
+   size_t iByte = index >> 2;
+   Block pBlock = getBlock(iByte / blockSize);
+   uint8_t byte = (*pBlock)[iByte % blockSize];
+   return (BitbaseValue)((byte >> ((index & 3) * 2)) & 3);
+}
+
+/***************************************************
+ * TABLEBASE : WRITE
+ * Compress a bitbase block by block
+ ***************************************************/
+void Tablebase::write(const Bitbase& base, ostream& out, size_t blockSize)
+{
+   assert(blockSize > 0);
+   size_t numBytes = base.getNumBytes();
+   size_t numBlocks = (numBytes + blockSize - 1) / blockSize;
+
+   vector<uint8_t>  data;
+   vector<uint64_t> offsets;
+   uint64_t start = TABLEBASE_HEADER + (numBlocks + 1) * 8;
+   for (size_t iBlock = 0; iBlock < numBlocks; iBlock++)
+   {
+      offsets.push_back(start + data.size());
+      size_t begin = iBlock * blockSize;
+      compressBlock(base.pBits + begin, min(blockSize, numBytes - begin), data);
+   }
+   offsets.push_back(start + data.size());
+
+   char name[4] = { 0, 0, 0, 0 };
+   memcpy(name, base.getSignature().data(), base.getSignature().size());
+   out.write(TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC));
+   out.write(name, sizeof(name));
+   putLittle(out, base.size(), 8);
+   putLittle(out, blockSize, 4);
+   putLittle(out, numBlocks, 4);
+   for (uint64_t offset : offsets)
+      putLittle(out, offset, 8);
+   out.write((const char*)data.data(), data.size());
+}
+
+void Tablebase::write(const Bitbase& base, const string& fileName, size_t blockSize)
+{
+   ofstream fout(fileName.c_str(), ios::binary);
+   if (fout.fail())
+      throw string("Unable to open ") + fileName + " for writing";
+   write(base, fout, blockSize);
+   if (fout.fail())
+      throw string("Unable to write ") + fileName;
+}
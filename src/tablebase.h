@@ -0,0 +1,123 @@
+/***********************************************************************
+ * Header File:
+ *    TABLEBASE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A compressed, memory-mapped form of a bitbase for tables too big
+ *    to keep in memory. The packed two-bit values are cut into blocks
+ *    of a fixed size and each block is compressed on its own:
+ *
+ *       +--------------------+
+ *       | header (24 bytes)  |  "CBZ1", signature, positions,
+ *       +--------------------+  block size, number of blocks
+ *       | block index        |  (numBlocks + 1) 64-bit file offsets
+ *       +--------------------+
+ *       | block 0            |  run-length encoded
+ *       | block 1            |
+ *       | ...                |
+ *       +--------------------+
+ *
+ *    Probing finds the block through the index, and keeps recently
+ *    decompressed blocks in a small cache. The cache is split into
+ *    shards, each with its own reader-writer lock. A hit only takes
+ *    the lock shared and marks the block used with an atomic stamp,
+ *    so probes that hit never wait on one another; only a miss, which
+ *    decompresses a block anyway, takes its shard's lock alone to put
+ *    the block in place of the one used least recently.
+ ************************************************************************/
+
+#pragma once
+
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "bitbase.h"     // for the indexing and BitbaseValue
+#include "mappedFile.h"  // because the table is memory-mapped
+
+class TestTablebase;
+
+const char   TABLEBASE_MAGIC[4] = { 'C', 'B', 'Z', '1' };
+const size_t TABLEBASE_HEADER   = 24;     // bytes in the header
+const int    TABLEBASE_SHARDS   = 16;     // independent parts of the cache
+
+/***************************************************
+ * TABLEBASE
+ * One compressed table, probed in place
+ ***************************************************/
+class Tablebase
+{
+   friend TestTablebase;
+public:
+   // cacheBlocks is how many decompressed blocks to keep
+   Tablebase(size_t cacheBlocks = 256);
+   Tablebase(const std::string& fileName, size_t cacheBlocks = 256);
+
+   // open and close. Throws a string on error
+   void open(const std::string& fileName);
+   void open(const uint8_t* pBuffer, size_t size);
+   void close();
+   bool isOpen() const { return file.isOpen(); }
+
+   // getters
+   const std::string& getSignature() const { return layout.getSignature(); }
+   size_t             size()         const { return layout.size();         }
+   size_t getIndex(const BitbasePosition& pos) const { return layout.getIndex(pos); }
+
+   // the value of one position. Safe to call from any thread
+   BitbaseValue get(size_t index) const;
+
+   // cache statistics
+   size_t getNumHits()   const { return numHits;   }
+   size_t getNumMisses() const { return numMisses; }
+
+   // compress a bitbase. blockSize is in bytes of packed values
+   static void write(const Bitbase& base, std::ostream& out,
+                     size_t blockSize = 4096);
+   static void write(const Bitbase& base, const std::string& fileName,
+                     size_t blockSize = 4096);
+
+private:
+   typedef std::shared_ptr<const std::vector<uint8_t>> Block;
+
+   // a cached block, and when it was last used
+   struct Entry
+   {
+      Entry(const Block& pBlock, uint64_t stamp) : pBlock(pBlock), stamp(stamp) {}
+      Block                         pBlock;
+      mutable std::atomic<uint64_t> stamp;
+   };
+
+   // one part of the cache. Hits hold the lock shared; misses alone
+   struct Shard
+   {
+      Shard() : tick(0) {}
+      std::shared_mutex                 mutex;
+      std::unordered_map<size_t, Entry> blocks;
+      uint64_t                          tick;   // only changed by a miss
+   };
+
+   // the block codec
+   static void compressBlock(const uint8_t* in, size_t size,
+                             std::vector<uint8_t>& out);
+   static void decompressBlock(const uint8_t* in, size_t sizeIn,
+                               uint8_t* out, size_t sizeOut);
+
+   void  validate();
+   Block getBlock(size_t iBlock) const;
+   Block decompress(size_t iBlock) const;
+
+   Bitbase                   layout;        // signature and indexing only
+   MappedFile                file;          // the compressed table
+   size_t                    blockSize;     // bytes per decompressed block
+   size_t                    numBlocks;
+   size_t                    cacheBlocks;   // across all shards
+   std::unique_ptr<Shard[]>  shards;
+   mutable std::atomic<size_t> numHits;
+   mutable std::atomic<size_t> numMisses;
+};
@@ -19,19 +19,26 @@
 #include "testPosition.h"
 #include "testBoard.h"
 #include "testMove.h"
+#include "testGameRecord.h"
+#include "testBook.h"
+#include "testBitbase.h"
+#include "testTablebase.h"
+#include "testRaster.h"
+#include "testTrace.h"
+#include "testBitboard.h"
+#include "testEvaluate.h"
+#include "testSnapshot.h"
+#include "testSearch.h"
+#include "testTimeManager.h"
 
-// This code, and the similar IF_DEF in testRunner(), is to ensure that
-// you can see the text output (called the console window) and OpenGL's
-// graphics at the same time. It is not required on Apple's XCode, only
-// on Window's Visual Studio. If you have problems seeing the output window
-// and your team is exclusively on Visual Studio, you can safely remove
-// these two "#ifdef _WIN32" and the "#endif" below it.
-#ifdef _WIN32
-#include <windows.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <thread>
 using namespace std;
-#endif
-
 
 int PieceSpy::numConstruct = 0;
 int PieceSpy::numCopy = 0;
@@ -39,29 +46,187 @@ int PieceSpy::numDelete = 0;
 int PieceSpy::numAssign = 0;
 int PieceSpy::numMove = 0;
 
+/*****************************************************************
+ * RUN SUITE
+ * Run one test class, returning how many of its tests failed
+ ****************************************************************/
+template <class T>
+static int runSuite(ostream& out, vector<TestTime>& times)
+{
+   T test;
+   test.setOutput(out);
+   test.run();
+   times = test.getTimes();
+   return test.getNumFailed();
+}
+
+/*****************************************************************
+ * SUITES
+ * Every test class, by the name it reports under. A suite is not
+ * independent if it changes state other suites can see, such as
+ * the size of a square, so it never runs alongside another
+ ****************************************************************/
+struct Suite
+{
+   const char* name;
+   int (*run)(ostream& out, vector<TestTime>& times);
+   bool isIndependent;
+};
+
+static const Suite SUITES[] =
+{
+   { "Position",   runSuite<PositionTest>,   false },
+   { "Move",       runSuite<TestMove>,       true  },
+   { "Board",      runSuite<TestBoard>,      true  },
+   { "Piece",      runSuite<TestPiece>,      true  },
+   { "Space",      runSuite<TestSpace>,      true  },
+   { "Knight",     runSuite<TestKnight>,     true  },
+   { "King",       runSuite<TestKing>,       true  },
+   { "Rook",       runSuite<TestRook>,       true  },
+   { "Bishop",     runSuite<TestBishop>,     true  },
+   { "Pawn",       runSuite<TestPawn>,       true  },
+   { "Queen",      runSuite<TestQueen>,      true  },
+   { "GameRecord", runSuite<TestGameRecord>, true  },
+   { "Book",       runSuite<TestBook>,       true  },
+   { "Bitbase",    runSuite<TestBitbase>,    true  },
+   { "Tablebase",  runSuite<TestTablebase>,  true  },
+   { "Raster",     runSuite<TestRaster>,     true  },
+   { "Trace",      runSuite<TestTrace>,      true  },
+   { "Bitboard",   runSuite<TestBitboard>,   true  },
+   { "Evaluate",   runSuite<TestEvaluate>,   true  },
+   { "Snapshot",   runSuite<TestSnapshot>,   true  },
+   { "Search",     runSuite<TestSearch>,     true  },
+   { "TimeManager", runSuite<TestTimeManager>, true  }
+};
+
+/*****************************************************************
+ * SUITE RESULT
+ * What one suite printed, how long it took, and how it did
+ ****************************************************************/
+struct SuiteResult
+{
+   ostringstream    out;
+   vector<TestTime> times;
+   int              numFailed = 0;
+   double           milliseconds = 0.0;
+};
+
+/*****************************************************************
+ * RUN ONE
+ ****************************************************************/
+static void runOne(const Suite& suite, SuiteResult& result)
+{
+   auto start = chrono::steady_clock::now();
+   result.numFailed = suite.run(result.out, result.times);
+   result.milliseconds = chrono::duration<double, milli>(
+                         chrono::steady_clock::now() - start).count();
+}
+
+/*****************************************************************
+ * GET TEST SUITES
+ ****************************************************************/
+vector<string> getTestSuites()
+{
+   vector<string> names;
+   for (const Suite& suite : SUITES)
+      names.push_back(suite.name);
+   return names;
+}
+
 /*****************************************************************
  * TEST RUNNER
- * Runs all the unit tests
+ * Runs the unit tests, timing each suite and each test. Suites
+ * that are not independent run first, one at a time; the rest
+ * are shared among the threads. Each suite's report is printed
+ * whole, so the output of two suites is never mixed
  ****************************************************************/
-void testRunner()
+int testRunner(const vector<string>& suites, const TestOptions& options)
 {
-#ifdef _WIN32
-   AllocConsole();
-   FILE* stream;
-   errno_t err;
-   err = freopen_s(&stream, "CONOUT$", "a", stdout);
-#endif // _WIN32
-
-   // unit tests
-   PositionTest().run();
-   TestMove().run();
-   TestBoard().run();
-   TestPiece().run();
-   TestSpace().run();
-   TestKnight().run();
-   TestKing().run();
-   TestRook().run();
-   TestBishop().run();
-   TestPawn().run();
-   TestQueen().run();
+   // check every name before running anything
+   vector<const Suite*> selected;
+   for (const string& name : suites)
+   {
+      const Suite* pSuite = nullptr;
+      for (const Suite& suite : SUITES)
+         if (name == suite.name)
+            pSuite = &suite;
+      if (pSuite == nullptr)
+         throw string("Unknown test suite: ") + name;
+      selected.push_back(pSuite);
+   }
+   if (selected.empty())
+      for (const Suite& suite : SUITES)
+         selected.push_back(&suite);
+
+   int numThreads = options.numThreads > 0 ? options.numThreads :
+                    max(1, (int)thread::hardware_concurrency());
+   auto start = chrono::steady_clock::now();
+
+   // unit tests: alone if they must be, or if there is only one thread
+   vector<SuiteResult> results(selected.size());
+   vector<size_t> pooled;
+   for (size_t i = 0; i < selected.size(); i++)
+      if (numThreads > 1 && selected[i]->isIndependent)
+         pooled.push_back(i);
+      else
+      {
+         runOne(*selected[i], results[i]);
+         cout << results[i].out.str() << flush;
+      }
+
+   // the rest on the pool
+   atomic<size_t> next(0);
+   auto worker = [&]()
+   {
+      for (size_t i = next++; i < pooled.size(); i = next++)
+         runOne(*selected[pooled[i]], results[pooled[i]]);
+   };
+   vector<thread> threads;
+   for (int i = 0; i < min(numThreads, (int)pooled.size()); i++)
+      threads.push_back(thread(worker));
+   for (thread& t : threads)
+      t.join();
+   for (size_t i : pooled)
+      cout << results[i].out.str();
+
+   double wall = chrono::duration<double, milli>(
+                 chrono::steady_clock::now() - start).count();
+
+   // how long each suite took
+   int numFailed = 0;
+   double total = 0.0;
+   vector<TestTime> times;
+   cout << "\nTime per suite:\n";
+   cout.setf(ios::fixed | ios::showpoint);
+   cout.precision(1);
+   for (size_t i = 0; i < selected.size(); i++)
+   {
+      cout << "\t" << left << setw(15) << selected[i]->name
+           << right << setw(10) << results[i].milliseconds << " ms\n";
+      total += results[i].milliseconds;
+      numFailed += results[i].numFailed ? 1 : 0;
+      times.insert(times.end(), results[i].times.begin(), results[i].times.end());
+   }
+   cout << "\t" << left << setw(15) << "total"
+        << right << setw(10) << total << " ms\n";
+   if (numThreads > 1)
+      cout << "\t" << left << setw(15) << "wall"
+           << right << setw(10) << wall << " ms on "
+           << numThreads << " threads\n";
+
+   // the slowest tests
+   size_t numSlowest = min((size_t)max(options.numSlowest, 0), times.size());
+   partial_sort(times.begin(), times.begin() + numSlowest, times.end(),
+                [](const TestTime& lhs, const TestTime& rhs)
+                {
+                   return lhs.milliseconds > rhs.milliseconds;
+                });
+   if (numSlowest)
+      cout << "\nSlowest tests:\n";
+   for (size_t i = 0; i < numSlowest; i++)
+      cout << "\t" << right << setw(10) << times[i].milliseconds << " ms  "
+           << times[i].suite << "::" << times[i].test << "()\n";
+   cout << left;
+
+   return numFailed;
 }
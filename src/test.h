@@ -9,4 +9,22 @@
 
 #pragma once
 
-void testRunner();
+#include <string>
+#include <vector>
+
+// how to run the suites
+struct TestOptions
+{
+   int numThreads = 1;    // 0 is one per core. Above 1, independent
+                          // suites run on a pool of threads
+   int numSlowest = 10;   // how many of the slowest tests to list
+};
+
+// run the suites named, or every suite if none are. Reports how long
+// each suite and the slowest tests took, and returns the number of
+// suites with a failing test. Throws a string if a name is not a suite
+int testRunner(const std::vector<std::string>& suites = std::vector<std::string>(),
+               const TestOptions& options = TestOptions());
+
+// the names of the suites, in the order they run
+std::vector<std::string> getTestSuites();
@@ -44,6 +44,7 @@ void TestBishop::getMoves_blocked()
    White w3(PAWN); board.board[1][2] = &w3; // b3
    White w4(PAWN); board.board[3][2] = &w4; // d3
    set <Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    bishop.getMoves(moves, board);
@@ -85,6 +86,7 @@ void TestBishop::getMoves_slideToEnd()
    board.board[2][1] = &bishop; // c2
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    bishop.getMoves(moves, board);
@@ -136,6 +138,7 @@ void TestBishop::getMoves_slideToBlock()
 
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    bishop.getMoves(moves, board);
@@ -197,6 +200,7 @@ void TestBishop::getMoves_slideToCapture()
 
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    bishop.getMoves(moves, board);
@@ -22,12 +22,12 @@ public:
 
    void run()
    {
-      getMoves_blocked();
-      getMoves_slideToEnd();
-      getMoves_slideToBlock();
-      getMoves_slideToCapture();
+      timeTest(getMoves_blocked);
+      timeTest(getMoves_slideToEnd);
+      timeTest(getMoves_slideToBlock);
+      timeTest(getMoves_slideToCapture);
 
-      getType();
+      timeTest(getType);
       
       report("Bishop");
    }
@@ -0,0 +1,333 @@
+/***********************************************************************
+ * Source File:
+ *    TEST BITBASE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the endgame bitbases
+ ************************************************************************/
+
+#include "testBitbase.h"
+#include "bitbase.h"
+#include <cstdio>
+#include <string>
+#include <sstream>
+#include <cassert>
+using namespace std;
+
+/***************************************************
+ * MAKE POSITION
+ * "Ke5 Pe4 ke7": upper case is white, lower case black
+ ***************************************************/
+static BitbasePosition makePosition(const string& pieces, bool whiteToMove)
+{
+   BitbasePosition pos;
+   pos.numPieces = 0;
+   pos.whiteToMove = whiteToMove;
+   istringstream in(pieces);
+   string piece;
+   while (in >> piece)
+   {
+      assert(piece.size() == 3 && pos.numPieces < BITBASE_MAX_PIECES);
+      switch (toupper(piece[0]))
+      {
+         case 'K': pos.type[pos.numPieces] = KING;   break;
+         case 'Q': pos.type[pos.numPieces] = QUEEN;  break;
+         case 'R': pos.type[pos.numPieces] = ROOK;   break;
+         case 'B': pos.type[pos.numPieces] = BISHOP; break;
+         case 'N': pos.type[pos.numPieces] = KNIGHT; break;
+         default:  pos.type[pos.numPieces] = PAWN;   break;
+      }
+      pos.isWhite[pos.numPieces] = isupper(piece[0]) != 0;
+      pos.square[pos.numPieces] = (piece[2] - '1') * 8 + (piece[1] - 'a');
+      pos.numPieces++;
+   }
+   return pos;
+}
+
+/***************************************************
+ * PROBE
+ * The value of a position, or BB_ILLEGAL if missing
+ ***************************************************/
+static BitbaseValue probe(const BitbaseSet& set, const string& pieces,
+                          bool whiteToMove)
+{
+   BitbaseValue value = BB_ILLEGAL;
+   set.probe(makePosition(pieces, whiteToMove), value);
+   return value;
+}
+
+/***************************************************
+ * RUN
+ * Generating KPK (and the tables it promotes into)
+ * takes a moment, so it is done once for every test
+ ***************************************************/
+void TestBitbase::run()
+{
+   BitbaseSet set;
+   set.generate("KPK");
+   pSet = &set;
+
+   // indexing
+   timeTest(signature_canonical);
+   timeTest(index_roundTrip);
+   timeTest(index_symmetry);
+
+   // known positions
+   timeTest(kqk_win);
+   timeTest(kqk_stalemate);
+   timeTest(kqk_hangingQueen);
+   timeTest(krk_mate);
+   timeTest(kpk_opposition);
+   timeTest(kpk_rookPawn);
+   timeTest(kpk_blackPawn);
+
+   // storage
+   timeTest(save_load);
+
+   pSet = nullptr;
+   report("Bitbase");
+}
+
+/*************************************
+ * SIGNATURE canonical
+ * Input:  material with the stronger side black
+ * Output: stronger side first, flip set
+ **************************************/
+void TestBitbase::signature_canonical()
+{
+   // SETUP
+   BitbasePosition krk = makePosition("Ka1 kc3 rh8", true);
+   BitbasePosition krkp = makePosition("Ka1 Ra2 kh8 ph7", true);
+   BitbasePosition knkb = makePosition("Ka1 Na2 kh8 bh7", true);
+   bool flip1;
+   bool flip2;
+   bool flip3;
+
+   // EXERCISE
+   string sig1 = BitbaseSet::getSignature(krk, flip1);
+   string sig2 = BitbaseSet::getSignature(krkp, flip2);
+   string sig3 = BitbaseSet::getSignature(knkb, flip3);
+
+   // VERIFY
+   assertUnit(sig1 == "KRK");
+   assertUnit(flip1);
+   assertUnit(sig2 == "KRKP");
+   assertUnit(!flip2);
+   assertUnit(sig3 == "KBKN");
+   assertUnit(flip3);
+}  // TEARDOWN
+
+/*************************************
+ * INDEX round trip
+ * Input:  every KQK index
+ * Output: decoding then encoding gives the same index
+ **************************************/
+void TestBitbase::index_roundTrip()
+{
+   // SETUP
+   const Bitbase* pBase = pSet->find("KQK");
+   int numWrong = 0;
+
+   // EXERCISE
+   if (pBase)
+      for (size_t index = 0; index < pBase->size(); index++)
+      {
+         BitbasePosition pos;
+         pBase->getPosition(index, pos);
+         if (pBase->getIndex(pos) != index)
+            numWrong++;
+      }
+
+   // VERIFY
+   assertUnit(pBase != nullptr);
+   assertUnit(pBase && pBase->size() == 10 * 64 * 64 * 2);
+   assertUnit(numWrong == 0);
+}  // TEARDOWN
+
+/*************************************
+ * INDEX symmetry
+ * Input:  a KQK position and its mirror images
+ * Output: all share one index; with a pawn only the file mirrors
+ **************************************/
+void TestBitbase::index_symmetry()
+{
+   // SETUP
+   const Bitbase* pKQK = pSet->find("KQK");
+   const Bitbase* pKPK = pSet->find("KPK");
+   assert(pKQK && pKPK);
+
+   // EXERCISE
+   size_t a = pKQK->getIndex(makePosition("Kc2 Qc5 kf7", true));
+   size_t b = pKQK->getIndex(makePosition("Kf2 Qf5 kc7", true));   // files
+   size_t c = pKQK->getIndex(makePosition("Kc7 Qc4 kf2", true));   // ranks
+   size_t d = pKQK->getIndex(makePosition("Kb3 Qe3 kg6", true));   // diagonal
+   size_t e = pKPK->getIndex(makePosition("Kb2 Pc5 kf7", true));
+   size_t f = pKPK->getIndex(makePosition("Kg2 Pf5 kc7", true));   // files
+   size_t g = pKPK->getIndex(makePosition("Kb7 Pc4 kf2", true));   // ranks
+
+   // VERIFY
+   assertUnit(a == b);
+   assertUnit(a == c);
+   assertUnit(a == d);
+   assertUnit(e == f);
+   assertUnit(e != g);
+}  // TEARDOWN
+
+/*************************************
+ * KQK win
+ * Input:  Ke1 Qd1 ke8
+ * Output: white to move wins, black to move loses
+ **************************************/
+void TestBitbase::kqk_win()
+{
+   // SETUP
+   string pieces = "Ke1 Qd1 ke8";
+
+   // EXERCISE
+   BitbaseValue white = probe(*pSet, pieces, true);
+   BitbaseValue black = probe(*pSet, pieces, false);
+
+   // VERIFY
+   assertUnit(white == BB_WIN);
+   assertUnit(black == BB_LOSS);
+}  // TEARDOWN
+
+/*************************************
+ * KQK stalemate
+ * Input:  Kb6 Qc7 ka8, black to move
+ * Output: a draw
+ **************************************/
+void TestBitbase::kqk_stalemate()
+{
+   // SETUP
+   string pieces = "Kb6 Qc7 ka8";
+
+   // EXERCISE
+   BitbaseValue value = probe(*pSet, pieces, false);
+
+   // VERIFY
+   assertUnit(value == BB_DRAW);
+}  // TEARDOWN
+
+/*************************************
+ * KQK hanging queen
+ * Input:  Kh1 Qb2 ka1, black to move
+ * Output: a draw because the queen is taken
+ **************************************/
+void TestBitbase::kqk_hangingQueen()
+{
+   // SETUP
+   string pieces = "Kh1 Qb2 ka1";
+
+   // EXERCISE
+   BitbaseValue value = probe(*pSet, pieces, false);
+
+   // VERIFY
+   assertUnit(value == BB_DRAW);
+}  // TEARDOWN
+
+/*************************************
+ * KRK mate
+ * Input:  Ka6 Rh8 ka8
+ * Output: black to move is mated, and with white
+ *         to move the position cannot arise
+ **************************************/
+void TestBitbase::krk_mate()
+{
+   // SETUP
+   string pieces = "Ka6 Rh8 ka8";
+
+   // EXERCISE
+   BitbaseValue black = probe(*pSet, pieces, false);
+   BitbaseValue white = probe(*pSet, pieces, true);
+
+   // VERIFY
+   assertUnit(black == BB_LOSS);
+   assertUnit(white == BB_ILLEGAL);
+}  // TEARDOWN
+
+/*************************************
+ * KPK opposition
+ * Input:  Ke5 Pe4 ke7
+ * Output: white to move draws, black to move loses
+ **************************************/
+void TestBitbase::kpk_opposition()
+{
+   // SETUP
+   string pieces = "Ke5 Pe4 ke7";
+
+   // EXERCISE
+   BitbaseValue white = probe(*pSet, pieces, true);
+   BitbaseValue black = probe(*pSet, pieces, false);
+
+   // VERIFY
+   assertUnit(white == BB_DRAW);
+   assertUnit(black == BB_LOSS);
+}  // TEARDOWN
+
+/*************************************
+ * KPK rook pawn
+ * Input:  Kb6 Pa5 ka8 and Kd6 Pe5 ke8, white to move
+ * Output: the rook pawn draws, the king pawn wins
+ **************************************/
+void TestBitbase::kpk_rookPawn()
+{
+   // SETUP
+   string rookPawn = "Kb6 Pa5 ka8";
+   string kingPawn = "Kd6 Pe5 ke8";
+
+   // EXERCISE
+   BitbaseValue rook = probe(*pSet, rookPawn, true);
+   BitbaseValue king = probe(*pSet, kingPawn, true);
+
+   // VERIFY
+   assertUnit(rook == BB_DRAW);
+   assertUnit(king == BB_WIN);
+}  // TEARDOWN
+
+/*************************************
+ * KPK black pawn
+ * Input:  ke4 pe5 Ke2, the opposition test with colors swapped
+ * Output: black to move draws, white to move loses
+ **************************************/
+void TestBitbase::kpk_blackPawn()
+{
+   // SETUP
+   string pieces = "ke4 pe5 Ke2";
+
+   // EXERCISE
+   BitbaseValue black = probe(*pSet, pieces, false);
+   BitbaseValue white = probe(*pSet, pieces, true);
+
+   // VERIFY
+   assertUnit(black == BB_DRAW);
+   assertUnit(white == BB_LOSS);
+}  // TEARDOWN
+
+/*************************************
+ * SAVE and LOAD
+ * Input:  the generated KPK table
+ * Output: the mapped copy has the same bits
+ **************************************/
+void TestBitbase::save_load()
+{
+   // SETUP
+   const Bitbase* pBase = pSet->find("KPK");
+   assert(pBase);
+   string fileName = string(P_tmpdir) + "/testBitbase.cbb";
+   BitbaseSet loaded;
+
+   // EXERCISE
+   pBase->save(fileName);
+   const Bitbase& copy = loaded.load(fileName);
+   bool same = copy.size() == pBase->size();
+   for (size_t index = 0; same && index < copy.size(); index++)
+      same = copy.get(index) == pBase->get(index);
+
+   // VERIFY
+   assertUnit(copy.getSignature() == "KPK");
+   assertUnit(same);
+   assertUnit(probe(loaded, "Ke5 Pe4 ke7", false) == BB_LOSS);
+   assertUnit(probe(loaded, "Ke1 Qd1 ke8", true) == BB_ILLEGAL);
+}  // TEARDOWN
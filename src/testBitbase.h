@@ -0,0 +1,44 @@
+/***********************************************************************
+ * Header File:
+ *    TEST BITBASE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the endgame bitbases
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+
+class BitbaseSet;
+
+/***************************************************
+ * BITBASE TEST
+ * Test indexing, generation, and probing
+ ***************************************************/
+class TestBitbase : public UnitTest
+{
+public:
+   void run();
+
+private:
+   // indexing
+   void signature_canonical();
+   void index_roundTrip();
+   void index_symmetry();
+
+   // known positions
+   void kqk_win();
+   void kqk_stalemate();
+   void kqk_hangingQueen();
+   void krk_mate();
+   void kpk_opposition();
+   void kpk_rookPawn();
+   void kpk_blackPawn();
+
+   // storage
+   void save_load();
+
+   BitbaseSet* pSet;    // generated once and shared by the tests
+};
@@ -0,0 +1,357 @@
+/***********************************************************************
+ * Source File:
+ *    TEST BITBOARD
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the bitboards and the attack tables
+ ************************************************************************/
+
+#include "testBitboard.h"
+#include "bitboard.h"
+#include "position.h"
+using namespace std;
+
+/***************************************************
+ * RUN
+ ***************************************************/
+void TestBitboard::run()
+{
+   // the square sets
+   timeTest(popSquare_order);
+
+   // the attack tables
+   timeTest(knight_corner);
+   timeTest(knight_center);
+   timeTest(king_edge);
+   timeTest(pawn_colors);
+   timeTest(tables_symmetric);
+
+   // the sliders
+   timeTest(sliderMask_edges);
+   timeTest(rook_blocked);
+   timeTest(bishop_blocked);
+   timeTest(sliders_matchRays);
+
+   // the fill
+   timeTest(fill_rookBlocked);
+   timeTest(fill_noWrap);
+   timeTest(fill_matchesLookups);
+
+   report("Bitboard");
+}
+
+/*************************************
+ * POP SQUARE order
+ * Input:  h8, a1, and e4
+ * Output: a1, e4, h8, then the set is empty
+ **************************************/
+void TestBitboard::popSquare_order()
+{
+   // SETUP
+   Bitboard squares = squareBit(63) | squareBit(0) | squareBit(28);
+
+   // EXERCISE
+   int first  = popSquare(squares);
+   int second = popSquare(squares);
+   int third  = popSquare(squares);
+
+   // VERIFY
+   assertUnit(first  == Position("a1").getLocation());
+   assertUnit(second == Position("e4").getLocation());
+   assertUnit(third  == Position("h8").getLocation());
+   assertUnit(squares == 0);
+}  // TEARDOWN
+
+/*************************************
+ * KNIGHT corner
+ * Input:  a knight on h8
+ * Output: f7 and g6
+ **************************************/
+void TestBitboard::knight_corner()
+{
+   // SETUP
+   int square = Position("h8").getLocation();
+
+   // EXERCISE
+   Bitboard targets = KNIGHT_ATTACKS[square];
+
+   // VERIFY
+   assertUnit(targets == (squareBit(Position("f7").getLocation()) |
+                          squareBit(Position("g6").getLocation())));
+}  // TEARDOWN
+
+/*************************************
+ * KNIGHT center
+ * Input:  a knight on d4
+ * Output: the eight squares a knight's move away
+ **************************************/
+void TestBitboard::knight_center()
+{
+   // SETUP
+   const char* expected[] = { "c2", "e2", "b3", "f3", "b5", "f5", "c6", "e6" };
+   Bitboard squares = 0;
+   for (const char* text : expected)
+      squares |= squareBit(Position(text).getLocation());
+
+   // EXERCISE
+   Bitboard targets = KNIGHT_ATTACKS[Position("d4").getLocation()];
+
+   // VERIFY
+   assertUnit(targets == squares);
+   assertUnit(countSquares(targets) == 8);
+}  // TEARDOWN
+
+/*************************************
+ * KING edge
+ * Input:  a king on a1 and one on e1
+ * Output: three squares and five squares
+ **************************************/
+void TestBitboard::king_edge()
+{
+   // SETUP
+   // EXERCISE
+   Bitboard corner = KING_ATTACKS[Position("a1").getLocation()];
+   Bitboard edge   = KING_ATTACKS[Position("e1").getLocation()];
+
+   // VERIFY
+   assertUnit(countSquares(corner) == 3);
+   assertUnit(corner & squareBit(Position("b2").getLocation()));
+   assertUnit(countSquares(edge) == 5);
+   assertUnit(!(edge & squareBit(Position("e3").getLocation())));
+}  // TEARDOWN
+
+/*************************************
+ * PAWN colors
+ * Input:  pawns of both colors on e4 and on h5
+ * Output: white captures up the board, black down
+ **************************************/
+void TestBitboard::pawn_colors()
+{
+   // SETUP
+   int e4 = Position("e4").getLocation();
+   int h5 = Position("h5").getLocation();
+
+   // EXERCISE
+   Bitboard white = PAWN_ATTACKS[true][e4];
+   Bitboard black = PAWN_ATTACKS[false][e4];
+
+   // VERIFY
+   assertUnit(white == (squareBit(Position("d5").getLocation()) |
+                        squareBit(Position("f5").getLocation())));
+   assertUnit(black == (squareBit(Position("d3").getLocation()) |
+                        squareBit(Position("f3").getLocation())));
+   assertUnit(PAWN_ATTACKS[true][h5] == squareBit(Position("g6").getLocation()));
+   assertUnit(PAWN_ATTACKS[true][Position("a8").getLocation()] == 0);
+}  // TEARDOWN
+
+/*************************************
+ * TABLES symmetric
+ * Input:  every pair of squares
+ * Output: a knight or king on one attacks the other exactly when
+ *         the reverse is true, and a white pawn attacks a square
+ *         exactly when a black pawn there attacks back
+ **************************************/
+void TestBitboard::tables_symmetric()
+{
+   // SETUP
+   bool symmetric = true;
+
+   // EXERCISE
+   for (int from = 0; from < 64; from++)
+      for (int to = 0; to < 64; to++)
+      {
+         symmetric = symmetric &&
+            !(KNIGHT_ATTACKS[from] & squareBit(to)) == !(KNIGHT_ATTACKS[to] & squareBit(from)) &&
+            !(KING_ATTACKS[from]   & squareBit(to)) == !(KING_ATTACKS[to]   & squareBit(from)) &&
+            !(PAWN_ATTACKS[true][from] & squareBit(to)) == !(PAWN_ATTACKS[false][to] & squareBit(from));
+      }
+
+   // VERIFY
+   assertUnit(symmetric);
+}  // TEARDOWN
+
+/*************************************
+ * SLIDER MASK edges
+ * Input:  a rook on a1 and a bishop on d4
+ * Output: neither mask reaches the edge of the board
+ **************************************/
+void TestBitboard::sliderMask_edges()
+{
+   // SETUP
+   int a1 = Position("a1").getLocation();
+   int d4 = Position("d4").getLocation();
+
+   // EXERCISE
+   Bitboard rook   = ROOK_MASKS[a1];
+   Bitboard bishop = BISHOP_MASKS[d4];
+
+   // VERIFY
+   assertUnit(countSquares(rook) == 12);
+   assertUnit(rook & squareBit(Position("a7").getLocation()));
+   assertUnit(!(rook & squareBit(Position("a8").getLocation())));
+   assertUnit(!(rook & squareBit(Position("h1").getLocation())));
+   assertUnit(countSquares(bishop) == 9);
+   assertUnit(!(bishop & squareBit(Position("h8").getLocation())));
+   assertUnit(!(bishop & squareBit(Position("a1").getLocation())));
+}  // TEARDOWN
+
+/*************************************
+ * ROOK blocked
+ * Input:  a rook on d4, pieces on d6 and b4, and one on h4
+ *         that is behind nothing
+ * Output: it stops on d6 and b4, and reaches h4 and d1
+ **************************************/
+void TestBitboard::rook_blocked()
+{
+   // SETUP
+   Bitboard occupied = squareBit(Position("d6").getLocation()) |
+                       squareBit(Position("b4").getLocation()) |
+                       squareBit(Position("h4").getLocation());
+   const char* expected[] = { "d5", "d6", "c4", "b4", "e4", "f4", "g4",
+                              "h4", "d3", "d2", "d1" };
+   Bitboard squares = 0;
+   for (const char* text : expected)
+      squares |= squareBit(Position(text).getLocation());
+
+   // EXERCISE
+   Bitboard targets = getRookAttacks(Position("d4").getLocation(), occupied);
+
+   // VERIFY
+   assertUnit(targets == squares);
+}  // TEARDOWN
+
+/*************************************
+ * BISHOP blocked
+ * Input:  a bishop on c1 with a piece on e3
+ * Output: b2, a3, d2, and e3
+ **************************************/
+void TestBitboard::bishop_blocked()
+{
+   // SETUP
+   Bitboard occupied = squareBit(Position("e3").getLocation());
+
+   // EXERCISE
+   Bitboard targets = getBishopAttacks(Position("c1").getLocation(), occupied);
+
+   // VERIFY
+   assertUnit(targets == (squareBit(Position("b2").getLocation()) |
+                          squareBit(Position("a3").getLocation()) |
+                          squareBit(Position("d2").getLocation()) |
+                          squareBit(Position("e3").getLocation())));
+}  // TEARDOWN
+
+/*************************************
+ * SLIDERS match rays
+ * Input:  every square, with a thousand random boards each
+ * Output: the table lookup is what walking the rays gives
+ **************************************/
+void TestBitboard::sliders_matchRays()
+{
+   // SETUP
+   uint64_t state = 12345;
+   auto getRandom = [&state]()
+   {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      return state;
+   };
+   bool rookSame   = true;
+   bool bishopSame = true;
+
+   // EXERCISE
+   for (int square = 0; square < 64; square++)
+      for (int i = 0; i < 1000; i++)
+      {
+         Bitboard occupied = getRandom() & getRandom();
+         rookSame = rookSame &&
+            getRookAttacks(square, occupied) == getRayAttacks(square, occupied, ROOK_STEPS);
+         bishopSame = bishopSame &&
+            getBishopAttacks(square, occupied) == getRayAttacks(square, occupied, BISHOP_STEPS);
+      }
+
+   // VERIFY
+   assertUnit(rookSame);
+   assertUnit(bishopSame);
+}  // TEARDOWN
+
+/*************************************
+ * FILL rook blocked
+ * Input:  a rook on d4 with pieces on d6 and f4
+ * Output: the same squares the rook table gives
+ **************************************/
+void TestBitboard::fill_rookBlocked()
+{
+   // SETUP
+   int square = Position("d4").getLocation();
+   Bitboard occupied = squareBit(Position("d6").getLocation()) |
+                       squareBit(Position("f4").getLocation());
+
+   // EXERCISE
+   Bitboard targets = getSliderFill(squareBit(square), 0, occupied);
+
+   // VERIFY
+   assertUnit(targets == getRookAttacks(square, occupied));
+   assertUnit(targets == getSliderFillScalar(squareBit(square), 0, occupied));
+   assertUnit(countSquares(targets) == 10);
+}  // TEARDOWN
+
+/*************************************
+ * FILL no wrap
+ * Input:  a bishop on h4 and a rook on a5, nothing else
+ * Output: no ray runs off one edge and onto the other
+ **************************************/
+void TestBitboard::fill_noWrap()
+{
+   // SETUP
+   Bitboard bishop = squareBit(Position("h4").getLocation());
+   Bitboard rook   = squareBit(Position("a5").getLocation());
+
+   // EXERCISE
+   Bitboard targetsBishop = getSliderFill(0, bishop, bishop);
+   Bitboard targetsRook   = getSliderFill(rook, 0, rook);
+
+   // VERIFY
+   assertUnit((targetsBishop & FILE_A) == 0);
+   assertUnit(countSquares(targetsBishop) == 7);
+   assertUnit((targetsRook & squareBit(Position("h4").getLocation())) == 0);
+   assertUnit(countSquares(targetsRook) == 14);
+}  // TEARDOWN
+
+/*************************************
+ * FILL matches lookups
+ * Input:  a thousand random boards, each with a few
+ *         random rooks, bishops, and queens
+ * Output: the fill is the union of each slider's table
+ *         lookup, whether it runs on AVX2 or not
+ **************************************/
+void TestBitboard::fill_matchesLookups()
+{
+   // SETUP
+   uint64_t state = 54321;
+   auto getRandom = [&state]()
+   {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      return state;
+   };
+   bool fillSame   = true;
+   bool scalarSame = true;
+
+   // EXERCISE
+   for (int i = 0; i < 1000; i++)
+   {
+      Bitboard occupied = getRandom() & getRandom();
+      Bitboard rooks    = occupied & getRandom() & getRandom();
+      Bitboard bishops  = occupied & getRandom() & getRandom();
+      Bitboard expected = 0;
+      for (Bitboard squares = rooks; squares; )
+         expected |= getRookAttacks(popSquare(squares), occupied);
+      for (Bitboard squares = bishops; squares; )
+         expected |= getBishopAttacks(popSquare(squares), occupied);
+      fillSame   = fillSame   && getSliderFill(rooks, bishops, occupied) == expected;
+      scalarSame = scalarSame && getSliderFillScalar(rooks, bishops, occupied) == expected;
+   }
+
+   // VERIFY
+   assertUnit(fillSame);
+   assertUnit(scalarSame);
+}  // TEARDOWN
@@ -0,0 +1,44 @@
+/***********************************************************************
+ * Header File:
+ *    TEST BITBOARD
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the bitboards and the attack tables
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+
+/***************************************************
+ * BITBOARD TEST
+ * Test the square sets and the attack tables
+ ***************************************************/
+class TestBitboard : public UnitTest
+{
+public:
+   void run();
+
+private:
+   // the square sets
+   void popSquare_order();
+
+   // the attack tables
+   void knight_corner();
+   void knight_center();
+   void king_edge();
+   void pawn_colors();
+   void tables_symmetric();
+
+   // the sliders
+   void sliderMask_edges();
+   void rook_blocked();
+   void bishop_blocked();
+   void sliders_matchRays();
+
+   // the fill
+   void fill_rookBlocked();
+   void fill_noWrap();
+   void fill_matchesLookups();
+};
@@ -12,7 +12,9 @@
 #include "position.h"
 #include "piece.h"
 #include "board.h"
+#include "polyglot.h"
 #include <cassert>
+#include <string>
 
 
 
@@ -148,6 +150,7 @@ void TestBoard::move_pawnSimple()
    board.board[0][2] = new PieceSpy(0, 2, false /*isWhite*/, SPACE);
    board.board[0][1]->nMoves = 0;
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -200,6 +203,7 @@ void TestBoard::move_pawnCapture()
    board.board[1][6] = new PieceSpy(1, 6, false /*isWhite*/, ROOK);
    board.board[0][5]->nMoves = 0;
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -252,6 +256,7 @@ void TestBoard::move_pawnDouble()
    board.board[4][3] = new PieceSpy(4, 3, false /*isWhite*/, SPACE);
    board.board[4][1]->nMoves = 0;
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -304,6 +309,7 @@ void TestBoard::move_pawnEnpassant()
    board.board[1][6] = new PieceSpy(1, 6, false /*isWhite*/, PAWN);
    board.board[0][5]->nMoves = 0;
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -356,6 +362,7 @@ void TestBoard::move_pawnPromotion()
    board.board[0][7] = new PieceSpy(0, 7, false /*isWhite*/, SPACE);
    board.board[0][6]->nMoves = 0;
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -407,6 +414,7 @@ void TestBoard::move_rookSlide()
    board.board[4][4] = new PieceSpy(4, 4, true  /*isWhite*/, ROOK);
    board.board[0][4] = new PieceSpy(0, 4, false /*isWhite*/, SPACE);
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -458,6 +466,7 @@ void TestBoard::move_rookAttack()
    board.board[4][4] = new PieceSpy(4, 4, true  /*isWhite*/, ROOK);
    board.board[0][4] = new PieceSpy(0, 4, false /*isWhite*/, BISHOP);
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -509,6 +518,7 @@ void TestBoard::move_bishopSlide()
    board.board[4][4] = new PieceSpy(4, 4, true  /*isWhite*/, BISHOP);
    board.board[6][2] = new PieceSpy(6, 2, false /*isWhite*/, SPACE);
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -560,6 +570,7 @@ void TestBoard::move_bishopAttack()
    board.board[4][4] = new PieceSpy(4, 4, true  /*isWhite*/, BISHOP);
    board.board[6][2] = new PieceSpy(6, 2, false /*isWhite*/, QUEEN);
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -610,6 +621,7 @@ void TestBoard::move_queenSlide()
    board.board[4][4] = new PieceSpy(4, 4, true  /*isWhite*/, QUEEN);
    board.board[6][2] = new PieceSpy(6, 2, false /*isWhite*/, SPACE);
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -661,6 +673,7 @@ void TestBoard::move_queenAttack()
    board.board[4][4] = new PieceSpy(4, 4, true  /*isWhite*/, QUEEN);
    board.board[0][4] = new PieceSpy(0, 4, false /*isWhite*/, BISHOP);
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -712,6 +725,7 @@ void TestBoard::move_kingMove()
    board.board[4][0] = new PieceSpy(4, 0, true  /*isWhite*/, KING);
    board.board[5][0] = new PieceSpy(5, 0, false /*isWhite*/, SPACE);
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -763,6 +777,7 @@ void TestBoard::move_kingAttack()
    board.board[4][0] = new PieceSpy(4, 0, true  /*isWhite*/, KING);
    board.board[5][0] = new PieceSpy(5, 0, false /*isWhite*/, ROOK);
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -815,6 +830,7 @@ void TestBoard::move_kingShortCastle()
    board.board[4][0]->nMoves = 0;
    board.board[7][0]->nMoves = 0;
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -872,6 +888,7 @@ void TestBoard::move_kingLongCastle()
    board.board[4][0]->nMoves = 0;
    board.board[0][0]->nMoves = 0;
    PieceSpy::reset();
+   board.syncOccupied();
    
    // EXERCISE
    board.move(move);
@@ -956,3 +973,699 @@ void TestBoard::construct_default()
    assertUnit(PieceSpy::numAssign == 0);
    assertUnit(PieceSpy::numMove == 0);
 }
+
+
+/********************************************************
+ *        +---a-b-c-d-e-f-g-h---+
+ *        |                     |
+ *        8   R N B Q K B N R   8
+ *        7   P P P P P P P P   7
+ *        6                     6
+ *        5                     5
+ *   -->  4                     4
+ *        3                     3
+ *        2   p p p p p p p p   2
+ *        1   r n b q k b n r   1
+ *        |                     |
+ *        +---a-b-c-d-e-f-g-h---+
+ * Input:  the starting position
+ * Output: PLAYING with 20 legal moves and no checkers
+ ********************************************************/
+void TestBoard::gameState_initial()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   
+   // EXERCISE
+   const GameState& state = board.getGameState();
+   
+   // VERIFY
+   assertUnit(state.status == PLAYING);
+   assertUnit(state.legalMoves.size() == 20);
+   assertUnit(state.checkers.empty());
+   assertUnit(!board.isInCheck(true));
+   assertUnit(!board.isInCheckmate(true));
+   assertUnit(!board.isInStalemate(true));
+}  // TEARDOWN
+
+/********************************************************
+ *    e2e4 f7f6 d1h5
+ *        +---a-b-c-d-e-f-g-h---+
+ *        |                     |
+ *        8   R N B Q K B N R   8
+ *        7   P P P P P   P P   7
+ *        6             P       6
+ *        5                 q   5
+ *   -->  4           p         4
+ *        3                     3
+ *        2   p p p p   p p p   2
+ *        1   r n b   k b n r   1
+ *        |                     |
+ *        +---a-b-c-d-e-f-g-h---+
+ * Input:  the queen checks from h5
+ * Output: CHECK, computed when first asked for after the
+ *         move rather than by it, with only g7g6 legal
+ ********************************************************/
+void TestBoard::gameState_check()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   board.move(Move("e2e4"));
+   board.move(Move("f7f6"));
+   board.move(Move("d1h5"));
+   bool isValidAfterMove = board.stateValid;
+   
+   // EXERCISE
+   const GameState& state = board.getGameState();
+   
+   // VERIFY
+   assertUnit(!isValidAfterMove);
+   assertUnit(board.stateValid);
+   assertUnit(state.status == CHECK);
+   assertUnit(state.checkers.size() == 1);
+   if (state.checkers.size() == 1)
+      assertUnit(state.checkers[0] == Position("h5"));
+   assertUnit(state.legalMoves.size() == 1);
+   if (state.legalMoves.size() == 1)
+      assertUnit(state.legalMoves.begin()->getDest() == Position("g6"));
+   assertUnit(board.isInCheck(false));
+   assertUnit(!board.isInCheck(true));
+   assertUnit(!board.isInCheckmate(false));
+}  // TEARDOWN
+
+/********************************************************
+ *    f2f3 e7e5 g2g4 d8h4
+ *        +---a-b-c-d-e-f-g-h---+
+ *        |                     |
+ *        8   R N B   K B N R   8
+ *        7   P P P P   P P P   7
+ *        6                     6
+ *        5           P         5
+ *   -->  4               p Q   4
+ *        3             p       3
+ *        2   p p p p p     p   2
+ *        1   r n b q k b n r   1
+ *        |                     |
+ *        +---a-b-c-d-e-f-g-h---+
+ * Input:  fool's mate
+ * Output: CHECKMATE with no legal moves
+ ********************************************************/
+void TestBoard::gameState_checkmate()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   
+   // EXERCISE
+   board.move(Move("f2f3"));
+   board.move(Move("e7e5"));
+   board.move(Move("g2g4"));
+   board.move(Move("d8h4"));
+   
+   // VERIFY
+   assertUnit(board.getGameState().status == CHECKMATE);
+   assertUnit(board.getGameState().legalMoves.empty());
+   assertUnit(board.getGameState().checkers.size() == 1);
+   assertUnit(board.isInCheckmate(true));
+   assertUnit(!board.isInStalemate(true));
+   assertUnit(!board.isInCheck(false));
+}  // TEARDOWN
+
+/********************************************************
+ *        +---a-b-c-d-e-f-g-h---+
+ *        |                     |
+ *        8           K         8
+ *        7                     7
+ *        6                     6
+ *        5                     5
+ *        4                     4
+ *        3             N       3
+ *        2         P           2
+ *   -->  1           k         1
+ *        |                     |
+ *        +---a-b-c-d-e-f-g-h---+
+ * Input:  a black pawn and knight both reach e1
+ * Output: both are checkers, found from the attack tables
+ ********************************************************/
+void TestBoard::getAttackers_jumpers()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   board.readFEN("4k3/8/8/8/8/5n2/3p4/4K3 w - - 0 1");
+   std::vector<Position> attackers;
+
+   // EXERCISE
+   board.getAttackers(Position("e1"), false /*byWhite*/, attackers);
+
+   // VERIFY
+   assertUnit(attackers.size() == 2);
+   assertUnit(attackers.size() == 2 && attackers[0] == Position("d2"));
+   assertUnit(attackers.size() == 2 && attackers[1] == Position("f3"));
+   assertUnit(board.getGameState().status == CHECK);
+   assertUnit(board.getGameState().checkers.size() == 2);
+}  // TEARDOWN
+
+/********************************************************
+ *        +---a-b-c-d-e-f-g-h---+
+ *        |                     |
+ *        8           K         8
+ *        7                     7
+ *        6                     6
+ *        5                     5
+ *        4           R         4
+ *        3                     3
+ *        2           p         2
+ *   -->  1           k         1
+ *        |                     |
+ *        +---a-b-c-d-e-f-g-h---+
+ * Input:  a black rook on e4 behind a white pawn on e2
+ * Output: the pawn is attacked, the king behind it is not
+ ********************************************************/
+void TestBoard::isSquareUnderAttack_blocked()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   board.readFEN("4k3/8/8/8/4r3/8/4P3/4K3 w - - 0 1");
+
+   // EXERCISE
+   bool isPawnAttacked = board.isSquareUnderAttack(Position("e2"), false);
+   bool isKingAttacked = board.isSquareUnderAttack(Position("e1"), false);
+
+   // VERIFY
+   assertUnit(isPawnAttacked);
+   assertUnit(!isKingAttacked);
+   assertUnit(!board.isSquareUnderAttack(Position("e3"), true));
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  the starting position
+ * Output: white attacks the first three ranks but for
+ *         the corners, and black the last three likewise
+ ********************************************************/
+void TestBoard::getAttackMap_start()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   Bitboard corners = squareBit(Position("a1").getLocation()) |
+                      squareBit(Position("h1").getLocation());
+
+   // EXERCISE
+   Bitboard white = board.getAttackMap(true  /*byWhite*/);
+   Bitboard black = board.getAttackMap(false /*byWhite*/);
+
+   // VERIFY
+   assertUnit(white == (0x0000000000ffffffull & ~corners));
+   assertUnit(black == (0xffffff0000000000ull & ~(corners << 56)));
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  a middle game with every kind of piece
+ * Output: each square is in the map exactly when
+ *         isSquareUnderAttack() says so, for both colors
+ ********************************************************/
+void TestBoard::getAttackMap_matchesAttacks()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   board.readFEN("r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP1QBPPP/R3KB1R w KQ - 0 1");
+   bool isSame = true;
+
+   // EXERCISE
+   Bitboard white = board.getAttackMap(true  /*byWhite*/);
+   Bitboard black = board.getAttackMap(false /*byWhite*/);
+
+   // VERIFY
+   for (int square = 0; square < 64; square++)
+   {
+      Position pos(square % 8, square / 8);
+      isSame = isSame &&
+         ((white & squareBit(square)) != 0) == board.isSquareUnderAttack(pos, true) &&
+         ((black & squareBit(square)) != 0) == board.isSquareUnderAttack(pos, false);
+   }
+   assertUnit(isSame);
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  both knights out and back, twice
+ * Output: the starting position has come a third time,
+ *         so a draw may be claimed, but the game goes on
+ *         with all twenty moves
+ ********************************************************/
+void TestBoard::repetition_threefold()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   const char* moves[4] = { "g1f3", "g8f6", "f3g1", "f6g8" };
+   for (int i = 0; i < 4; i++)
+      board.move(Move(moves[i]));
+   bool isRepeatedOnce = board.isRepetition() && !board.isThreefoldRepetition();
+
+   // EXERCISE
+   for (int i = 0; i < 4; i++)
+      board.move(Move(moves[i]));
+
+   // VERIFY
+   assertUnit(isRepeatedOnce);
+   assertUnit(board.countRepetitions() == 2);
+   assertUnit(board.getHalfmoveClock() == 8);
+   assertUnit(board.getDrawClaim() == DRAW_REPETITION);
+   assertUnit(board.getGameState().status == PLAYING);
+   assertUnit(board.getGameState().legalMoves.size() == 20);
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  both knights out and back once, then a copy
+ *         of the board plays them out and back again
+ * Output: the copy has the history, so it may claim the
+ *         draw; the board itself has not moved
+ ********************************************************/
+void TestBoard::copy_keepsHistory()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   const char* moves[4] = { "g1f3", "g8f6", "f3g1", "f6g8" };
+   for (int i = 0; i < 4; i++)
+      board.move(Move(moves[i]));
+
+   // EXERCISE
+   Board copy(board);
+   for (int i = 0; i < 4; i++)
+      copy.move(Move(moves[i]));
+
+   // VERIFY
+   assertUnit(copy.getDrawClaim() == DRAW_REPETITION);
+   assertUnit(copy.getCurrentMove() == 8);
+   assertUnit(copy.getFEN() == "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 8 5");
+   assertUnit(board.countRepetitions() == 1);
+   assertUnit(board.getCurrentMove() == 4);
+   assertUnit(board.getPiece(Position("g1"))->getType() == KNIGHT);
+   assertUnit(board.getPiece(Position("g1"))->getNMoves() == 2);
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  both knights out and back twice, then the
+ *         position read from its FEN with the history
+ *         of the board, and with the history of another
+ * Output: the history carries the repetitions over, and
+ *         one that ends elsewhere throws
+ ********************************************************/
+void TestBoard::setHistory_fromFEN()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   const char* moves[4] = { "g1f3", "g8f6", "f3g1", "f6g8" };
+   for (int i = 0; i < 8; i++)
+      board.move(Move(moves[i % 4]));
+   Board other(nullptr, false /*noreset*/);
+   other.move(Move("e2e4"));
+   Board fromFEN(nullptr, false /*noreset*/);
+   fromFEN.readFEN(board.getFEN());
+   bool isRepetitionBefore = fromFEN.isRepetition();
+   bool thrown = false;
+
+   // EXERCISE
+   try
+   {
+      fromFEN.setHistory(other.getHistory());
+   }
+   catch (const string&)
+   {
+      thrown = true;
+   }
+   fromFEN.setHistory(board.getHistory());
+
+   // VERIFY
+   assertUnit(!isRepetitionBefore);
+   assertUnit(thrown);
+   assertUnit(board.getHistory().size() == 9);
+   assertUnit(fromFEN.countRepetitions() == 2);
+   assertUnit(fromFEN.getDrawClaim() == DRAW_REPETITION);
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  a capture, a double step taken en passant,
+ *         castling, and a promotion
+ *         +---a-b-c-d-e-f-g-h---+
+ *         |                     |
+ *         8         k           8
+ *         7   P p               7
+ *         5       p             5
+ *         4         P           4
+ *         1 R       K     R     1
+ *         |                     |
+ *         +---a-b-c-d-e-f-g-h---+
+ * Output: after every move the key kept by the board is
+ *         the key worked out from the whole position
+ ********************************************************/
+void TestBoard::key_incremental()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   board.readFEN("4k3/1Pp5/8/3p4/4P3/8/8/R3K2R w KQ - 0 1");
+   const char* moves[7] = { "e4d5", "c7c5", "d5c6E", "e8e7", "e1g1c", "e7e6", "b7b8Q" };
+   bool isSame = true;
+
+   // EXERCISE
+   for (int i = 0; i < 7; i++)
+   {
+      board.move(Move(moves[i]));
+      isSame = isSame && board.getKey() == polyglotKey(board);
+   }
+
+   // VERIFY
+   assertUnit(isSame);
+   assertUnit(board.getFEN() == "1Q6/8/2P1k3/8/8/8/8/R4RK1 b - - 0 4");
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  the moves of key_incremental
+ * Output: after every move the occupied squares kept by
+ *         the board are those worked out from the pieces
+ ********************************************************/
+void TestBoard::occupied_incremental()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   board.readFEN("4k3/1Pp5/8/3p4/4P3/8/8/R3K2R w KQ - 0 1");
+   const char* moves[7] = { "e4d5", "c7c5", "d5c6E", "e8e7", "e1g1c", "e7e6", "b7b8Q" };
+   bool isSame = true;
+
+   // EXERCISE
+   for (int i = 0; i < 7; i++)
+   {
+      board.move(Move(moves[i]));
+      Bitboard occupied = board.getOccupied(~(Bitboard)0);
+      board.syncOccupied();
+      isSame = isSame && occupied == board.getOccupied(~(Bitboard)0);
+   }
+
+   // VERIFY
+   assertUnit(isSame);
+   assertUnit(countSquares(board.getOccupied(~(Bitboard)0)) == 6);
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  knights out and back, a pawn move, and the
+ *         knights out and back again
+ * Output: nothing before the pawn move counts
+ ********************************************************/
+void TestBoard::repetition_pawnMove()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   const char* moves[4] = { "g1f3", "g8f6", "f3g1", "f6g8" };
+   for (int i = 0; i < 4; i++)
+      board.move(Move(moves[i]));
+   board.move(Move("e2e4"));
+   board.move(Move("e7e5"));
+
+   // EXERCISE
+   for (int i = 0; i < 4; i++)
+      board.move(Move(moves[i]));
+
+   // VERIFY
+   assertUnit(board.getHalfmoveClock() == 4);
+   assertUnit(board.countRepetitions() == 1);
+   assertUnit(board.getGameState().status == PLAYING);
+   assertUnit(!board.isDrawClaimable());
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  a FEN with 99 moves since a capture or pawn
+ *         move, then one more rook move
+ * Output: a draw may be claimed by the fifty-move rule,
+ *         and black still has its king moves
+ ********************************************************/
+void TestBoard::fiftyMoves_draw()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   board.readFEN("4k3/8/8/8/8/8/8/R3K3 w - - 99 80");
+   bool isDrawBefore = board.isFiftyMoveDraw();
+
+   // EXERCISE
+   board.move(Move("a1a2"));
+
+   // VERIFY
+   assertUnit(!isDrawBefore);
+   assertUnit(board.getHalfmoveClock() == 100);
+   assertUnit(board.isFiftyMoveDraw());
+   assertUnit(board.getDrawClaim() == DRAW_FIFTY_MOVES);
+   assertUnit(board.getGameState().status == PLAYING);
+   assertUnit(board.getGameState().legalMoves.size() == 5);
+   assertUnit(board.perft(1) == 5);
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  the FEN of the starting position
+ * Output: the same board reset() sets up
+ ********************************************************/
+void TestBoard::readFEN_start()
+{
+   // SETUP
+   Board expected(nullptr, false /*noreset*/);
+   Board board(nullptr, false /*noreset*/);
+   board.move(Move("e2e4"));
+
+   // EXERCISE
+   board.readFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+   // VERIFY
+   assertUnit(board.getCurrentMove() == 0);
+   assertUnit(board.whiteTurn());
+   for (int c = 0; c < 8; c++)
+      for (int r = 0; r < 8; r++)
+      {
+         Position pos(c, r);
+         assertUnit(board[pos].getType()  == expected[pos].getType());
+         assertUnit(board[pos].isWhite()  == expected[pos].isWhite());
+         assertUnit(board[pos].isMoved()  == false);
+      }
+   assertUnit(board.getGameState().legalMoves.size() == 20);
+}  // TEARDOWN
+
+/********************************************************
+ *        +---a-b-c-d-e-f-g-h---+
+ *        |                     |
+ *        8           K     R   8
+ *        7                     7
+ *        6                     6
+ *        5                     5
+ *        4                     4
+ *        3                     3
+ *        2                     2
+ *        1   r       k         1
+ *        |                     |
+ *        +---a-b-c-d-e-f-g-h---+
+ * Input:  black to move on move 40, only white may castle long
+ * Output: black's turn, and only that castling right is held
+ ********************************************************/
+void TestBoard::readFEN_blackToMove()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+
+   // EXERCISE
+   board.readFEN("4k2r/8/8/8/8/8/8/R3K3 b Q - 3 40");
+
+   // VERIFY
+   assertUnit(board.getCurrentMove() == 79);
+   assertUnit(!board.whiteTurn());
+   assertUnit(board[Position("a1")].getType() == ROOK);
+   assertUnit(board[Position("a1")].isWhite());
+   assertUnit(board[Position("e8")].getType() == KING);
+   assertUnit(!board[Position("e8")].isWhite());
+   assertUnit(board.getCastlingRights() == CASTLE_WHITE_LONG);
+   assertUnit(board.canCastle(true  /*isWhite*/, false /*isKingSide*/));
+   assertUnit(!board.canCastle(false /*isWhite*/, true /*isKingSide*/));
+   assertUnit(board[Position("d4")].getType() == SPACE);
+}  // TEARDOWN
+
+/********************************************************
+ *        +---a-b-c-d-e-f-g-h---+
+ *        |                     |
+ *        8           K         8
+ *        7                     7
+ *        6                     6
+ *        5           p P       5
+ *        4                     4
+ *        3                     3
+ *        2                     2
+ *        1           k         1
+ *        |                     |
+ *        +---a-b-c-d-e-f-g-h---+
+ * Input:  black just played f7f5, so e5xf6 is possible
+ * Output: f6 is the en passant square, and white may take on it
+ ********************************************************/
+void TestBoard::readFEN_enPassant()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+
+   // EXERCISE
+   board.readFEN("4k3/8/8/4Pp2/8/8/8/4K3 w - f6 0 30");
+
+   // VERIFY
+   assertUnit(board.getCurrentMove() == 58);
+   assertUnit(board[Position("f5")].getType() == PAWN);
+   assertUnit(board.getEnPassant() == Position("f6"));
+   assertUnit(board.getGameState().legalMoves.count(Move("e5f6E")) == 1);
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  a rank too long, too few ranks, a bad letter,
+ *         and a bad side to move
+ * Output: each throws, and the board is left as it was
+ ********************************************************/
+void TestBoard::readFEN_bad()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   const char* fens[] =
+   {
+      "rnbqkbnr/ppppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1",
+      "rnbqkbnr/pppppppp/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1",
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNX w - - 0 1",
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x - - 0 1"
+   };
+   int numThrown = 0;
+
+   // EXERCISE
+   for (const char* fen : fens)
+   {
+      try
+      {
+         board.readFEN(fen);
+      }
+      catch (const std::string&)
+      {
+         numThrown++;
+      }
+   }
+
+   // VERIFY
+   assertUnit(numThrown == 4);
+   assertUnit(board[Position("e1")].getType() == KING);
+   assertUnit(board[Position("e2")].getType() == PAWN);
+   assertUnit(board.getCurrentMove() == 0);
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  1.e4 from the start
+ * Output: the FEN names e3 as the en passant square and
+ *         reads back to the same FEN
+ ********************************************************/
+void TestBoard::getFEN_roundTrip()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+   Board copy(nullptr, true /*noreset*/);
+   board.move(Move("e2e4"));
+
+   // EXERCISE
+   std::string fen = board.getFEN();
+   copy.readFEN(fen);
+
+   // VERIFY
+   assertUnit(fen == "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+   assertUnit(copy.getFEN() == fen);
+   assertUnit(copy.getKey() == board.getKey());
+}  // TEARDOWN
+
+/********************************************************
+ *        +---a-b-c-d-e-f-g-h---+
+ *        |                     |
+ *        8   R       K     R   8
+ *        7                     7
+ *        6                     6
+ *        5                     5
+ *        4                     4
+ *        3                     3
+ *        2                     2
+ *        1   r       k     r   1
+ *        |                     |
+ *        +---a-b-c-d-e-f-g-h---+
+ * Input:  the rook on a1 takes the rook on a8, then the
+ *         black king steps to f8 and back
+ * Output: white loses long castling, black loses both,
+ *         and white short castling is untouched
+ ********************************************************/
+void TestBoard::castling_rightsLost()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.readFEN("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+
+   // EXERCISE
+   board.move(Move("a1a8r"));
+   int afterCapture = board.getCastlingRights();
+   board.move(Move("e8f8"));
+   board.move(Move("e1d1"));
+
+   // VERIFY
+   assertUnit(afterCapture == (CASTLE_WHITE_SHORT | CASTLE_BLACK_SHORT));
+   assertUnit(board.getCastlingRights() == CASTLE_NONE);
+   assertUnit(board.getFEN() == "R4k1r/8/8/8/8/8/8/3K3R b - - 2 2");
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  the starting position, three moves deep
+ * Output: 8,902 positions, the published count
+ ********************************************************/
+void TestBoard::perft_start()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+
+   // EXERCISE
+   uint64_t count = board.perft(3);
+
+   // VERIFY
+   assertUnit(count == 8902);
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  "Kiwipete", two moves deep. Both sides can
+ *         castle both ways, and there are pins, en passant
+ *         captures, and promotions close by
+ * Output: 2,039 positions, the published count
+ ********************************************************/
+void TestBoard::perft_kiwipete()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.readFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+   // EXERCISE
+   uint64_t count = board.perft(2);
+
+   // VERIFY
+   assertUnit(count == 2039);
+}  // TEARDOWN
+
+/********************************************************
+ * Input:  three more published positions: an endgame
+ *         where en passant would expose the king, one
+ *         with under-promotions and castling through
+ *         check, and one where promotion meets castling
+ * Output: 2,812, 264, and 1,486 positions
+ ********************************************************/
+void TestBoard::perft_tricky()
+{
+   // SETUP
+   Board endgame(nullptr, true /*noreset*/);
+   Board promotion(nullptr, true /*noreset*/);
+   Board castling(nullptr, true /*noreset*/);
+   endgame.readFEN("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+   promotion.readFEN("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+   castling.readFEN("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8");
+
+   // EXERCISE
+   uint64_t countEndgame   = endgame.perft(3);
+   uint64_t countPromotion = promotion.perft(2);
+   uint64_t countCastling  = castling.perft(2);
+
+   // VERIFY
+   assertUnit(countEndgame   == 2812);
+   assertUnit(countPromotion == 264);
+   assertUnit(countCastling  == 1486);
+}  // TEARDOWN
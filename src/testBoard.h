@@ -23,27 +23,56 @@ public:
    void run()
    {
       // construct
-      construct_default();
+      timeTest(construct_default);
 
       // move
-      move_pawnSimple();
-      move_pawnCapture();
-      move_pawnDouble();
-      move_pawnEnpassant();
-      move_pawnPromotion();
-      move_rookSlide();
-      move_rookAttack();
-      move_bishopSlide();
-      move_bishopAttack();
-      move_knightMove();
-      move_knightAttack();
-      move_queenSlide();
-      move_queenAttack();
-      move_kingMove();
-      move_kingAttack();
+      timeTest(move_pawnSimple);
+      timeTest(move_pawnCapture);
+      timeTest(move_pawnDouble);
+      timeTest(move_pawnEnpassant);
+      timeTest(move_pawnPromotion);
+      timeTest(move_rookSlide);
+      timeTest(move_rookAttack);
+      timeTest(move_bishopSlide);
+      timeTest(move_bishopAttack);
+      timeTest(move_knightMove);
+      timeTest(move_knightAttack);
+      timeTest(move_queenSlide);
+      timeTest(move_queenAttack);
+      timeTest(move_kingMove);
+      timeTest(move_kingAttack);
 //      move_kingShortCastle();
 //      move_kingLongCastle();
 
+      // game state
+      timeTest(gameState_initial);
+      timeTest(gameState_check);
+      timeTest(gameState_checkmate);
+      timeTest(getAttackers_jumpers);
+      timeTest(isSquareUnderAttack_blocked);
+      timeTest(getAttackMap_start);
+      timeTest(getAttackMap_matchesAttacks);
+      timeTest(repetition_threefold);
+      timeTest(repetition_pawnMove);
+      timeTest(copy_keepsHistory);
+      timeTest(setHistory_fromFEN);
+      timeTest(key_incremental);
+      timeTest(occupied_incremental);
+      timeTest(fiftyMoves_draw);
+
+      // FEN
+      timeTest(readFEN_start);
+      timeTest(readFEN_blackToMove);
+      timeTest(readFEN_enPassant);
+      timeTest(readFEN_bad);
+      timeTest(getFEN_roundTrip);
+      timeTest(castling_rightsLost);
+
+      // perft: every line of legal moves, against published counts
+      timeTest(perft_start);
+      timeTest(perft_kiwipete);
+      timeTest(perft_tricky);
+
 //      // Get Current Move
       /*getCurrentMove_initial();
       getCurrentMove_second();
@@ -98,6 +127,31 @@ private:
    void move_kingShortCastle();
    void move_kingLongCastle();
 
+   void gameState_initial();
+   void gameState_check();
+   void gameState_checkmate();
+   void getAttackers_jumpers();
+   void isSquareUnderAttack_blocked();
+   void getAttackMap_start();
+   void getAttackMap_matchesAttacks();
+   void repetition_threefold();
+   void repetition_pawnMove();
+   void copy_keepsHistory();
+   void setHistory_fromFEN();
+   void key_incremental();
+   void occupied_incremental();
+   void fiftyMoves_draw();
+
+   void readFEN_start();
+   void readFEN_blackToMove();
+   void readFEN_enPassant();
+   void readFEN_bad();
+   void getFEN_roundTrip();
+   void castling_rightsLost();
+   void perft_start();
+   void perft_kiwipete();
+   void perft_tricky();
+
    void fetch_a1();
    void fetch_h8();
    void fetch_a8();
@@ -0,0 +1,466 @@
+/***********************************************************************
+ * Source File:
+ *    TEST BOOK
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for Polyglot hashing and the opening book,
+ *    both reading and building one
+ ************************************************************************/
+
+#include "testBook.h"
+#include "book.h"
+#include "bookBuilder.h"
+#include "polyglot.h"
+#include "pgn.h"
+#include "board.h"
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cassert>
+using namespace std;
+
+/***************************************************
+ * ADD ENTRY
+ * Append one big-endian book entry to a buffer
+ ***************************************************/
+static void addEntry(string& book, uint64_t key, uint16_t move, uint16_t weight)
+{
+   for (int i = 7; i >= 0; i--)
+      book += (char)((key >> (8 * i)) & 0xff);
+   book += (char)(move >> 8);
+   book += (char)(move & 0xff);
+   book += (char)(weight >> 8);
+   book += (char)(weight & 0xff);
+   book += string(4, '\0');
+}
+
+/***************************************************
+ * PGN THREE GAMES
+ * A small corpus for the builder tests
+ ***************************************************/
+static const char* PGN_THREE_GAMES =
+   "[Event \"1\"]\n\n1. e4 e5 2. Nf3 1-0\n\n"
+   "[Event \"2\"]\n\n1. e4 c5 1/2-1/2\n\n"
+   "[Event \"3\"]\n\n1. d4 d5 0-1\n";
+
+/*************************************
+ * KEY start position
+ * Input:  the starting position
+ * Output: 463b96181691fc9c
+ **************************************/
+void TestBook::key_start()
+{
+   // SETUP
+   Board board;
+
+   // EXERCISE
+   uint64_t key = polyglotKey(board);
+
+   // VERIFY
+   assertUnit(key == 0x463b96181691fc9cULL);
+}  // TEARDOWN
+
+/*************************************
+ * KEY after 1.e4 and 1...d5
+ * Input:  1.e4 d5
+ * Output: no en-passant file since nothing can capture
+ **************************************/
+void TestBook::key_afterE4()
+{
+   // SETUP
+   Board board;
+   const char* moves[] = { "e4", "d5" };
+
+   // EXERCISE
+   playSan(board, moves, 1);
+   uint64_t key1 = polyglotKey(board);
+   playSan(board, moves + 1, 1);
+   uint64_t key2 = polyglotKey(board);
+
+   // VERIFY
+   assertUnit(key1 == 0x823c9b50fd114196ULL);
+   assertUnit(key2 == 0x0756b94461c50fb0ULL);
+}  // TEARDOWN
+
+/*************************************
+ * KEY castling rights lost
+ * Input:  1.e4 d5 2.e5 f5 3.Ke2 Kf7
+ * Output: f5 may be taken en passant, then
+ *         both kings lose their rights
+ **************************************/
+void TestBook::key_castleLost()
+{
+   // SETUP
+   Board board;
+   const char* moves[] = { "e4", "d5", "e5", "f5", "Ke2", "Kf7" };
+
+   // EXERCISE
+   playSan(board, moves, 4);
+   uint64_t keyEnpassant = polyglotKey(board);
+   playSan(board, moves + 4, 1);
+   uint64_t keyWhite = polyglotKey(board);
+   playSan(board, moves + 5, 1);
+   uint64_t keyBlack = polyglotKey(board);
+
+   // VERIFY
+   assertUnit(keyEnpassant == 0x22a48b5a8e47ff78ULL);
+   assertUnit(keyWhite     == 0x652a607ca3f242c1ULL);
+   assertUnit(keyBlack     == 0x00fdd303c946bdd9ULL);
+}  // TEARDOWN
+
+/*************************************
+ * KEY en passant
+ * Input:  1.a4 b5 2.h4 b4 3.c4 bxc3 4.Ra3
+ * Output: c3 is en passant, then the rook loses queen-side rights
+ **************************************/
+void TestBook::key_enpassant()
+{
+   // SETUP
+   Board board;
+   const char* moves[] = { "a4", "b5", "h4", "b4", "c4", "bxc3", "Ra3" };
+
+   // EXERCISE
+   playSan(board, moves, 5);
+   uint64_t key1 = polyglotKey(board);
+   playSan(board, moves + 5, 2);
+   uint64_t key2 = polyglotKey(board);
+
+   // VERIFY
+   assertUnit(key1 == 0x3c8123ea7b067637ULL);
+   assertUnit(key2 == 0x5c3f9b829b279560ULL);
+}  // TEARDOWN
+
+/*************************************
+ * MOVE encode
+ * Input:  e2e4
+ * Output: to=e4 (4 + 3*8), from=e2 (4 + 1*8) << 6
+ **************************************/
+void TestBook::move_encode()
+{
+   // SETUP
+   Board board;
+   Move move;
+
+   // EXERCISE
+   uint16_t pgMove = moveToPolyglot(Move("e2e4"));
+   bool found = polyglotToMove(board, pgMove, move);
+
+   // VERIFY
+   assertUnit(pgMove == (28 | (12 << 6)));
+   assertUnit(found);
+   assertUnit(move.getText() == "e2e4");
+}  // TEARDOWN
+
+/*************************************
+ * MOVE castle
+ * Input:  1.e4 e5 2.Nf3 Nc6 3.Bc4 Bc5, O-O
+ * Output: encoded as e1h1 and decoded back to a castle
+ **************************************/
+void TestBook::move_castle()
+{
+   // SETUP
+   Board board;
+   const char* moves[] = { "e4", "e5", "Nf3", "Nc6", "Bc4", "Bc5" };
+   playSan(board, moves, 6);
+   Move castle = sanToMove(board, "O-O");
+   Move move;
+
+   // EXERCISE
+   uint16_t pgMove = moveToPolyglot(castle);
+   bool found = polyglotToMove(board, pgMove, move);
+
+   // VERIFY
+   assertUnit(pgMove == (7 | (4 << 6)));
+   assertUnit(found);
+   assertUnit(move.getMoveType() == Move::CASTLE_KING);
+}  // TEARDOWN
+
+/*************************************
+ * OPEN bad size
+ * Input:  a buffer that is not a multiple of 16 bytes
+ * Output: throws and the book is closed
+ **************************************/
+void TestBook::open_badSize()
+{
+   // SETUP
+   string data = "not a book";
+   OpeningBook book;
+   bool thrown = false;
+
+   // EXERCISE
+   try
+   {
+      book.open((const uint8_t*)data.data(), data.size());
+   }
+   catch (const string&)
+   {
+      thrown = true;
+   }
+
+   // VERIFY
+   assertUnit(thrown);
+   assertUnit(!book.isOpen());
+   assertUnit(book.size() == 0);
+}  // TEARDOWN
+
+/*************************************
+ * PROBE found
+ * Input:  three positions, the middle one with two moves
+ * Output: both moves of the middle position, in order
+ **************************************/
+void TestBook::probe_found()
+{
+   // SETUP
+   string data;
+   addEntry(data, 0x1000, 1, 10);
+   addEntry(data, 0x2000, 2, 20);
+   addEntry(data, 0x2000, 3, 30);
+   addEntry(data, 0x3000, 4, 40);
+   OpeningBook book;
+   book.open((const uint8_t*)data.data(), data.size());
+   vector<BookEntry> entries;
+
+   // EXERCISE
+   size_t num = book.probe(0x2000, entries);
+
+   // VERIFY
+   assertUnit(book.size() == 4);
+   assertUnit(num == 2);
+   assertUnit(entries.size() == 2);
+   if (entries.size() == 2)
+   {
+      assertUnit(entries[0].move == 2 && entries[0].weight == 20);
+      assertUnit(entries[1].move == 3 && entries[1].weight == 30);
+   }
+}  // TEARDOWN
+
+/*************************************
+ * PROBE missing
+ * Input:  keys before, between, and after the book
+ * Output: nothing found
+ **************************************/
+void TestBook::probe_missing()
+{
+   // SETUP
+   string data;
+   addEntry(data, 0x1000, 1, 10);
+   addEntry(data, 0x3000, 4, 40);
+   OpeningBook book;
+   book.open((const uint8_t*)data.data(), data.size());
+   vector<BookEntry> entries;
+
+   // EXERCISE
+   size_t before  = book.probe(0x0001, entries);
+   size_t between = book.probe(0x2000, entries);
+   size_t after   = book.probe(0xffffffffffffffffULL, entries);
+
+   // VERIFY
+   assertUnit(before == 0);
+   assertUnit(between == 0);
+   assertUnit(after == 0);
+}  // TEARDOWN
+
+/*************************************
+ * GET MOVE best
+ * Input:  e4 (weight 5), d4 (weight 9), and an illegal move (weight 99)
+ * Output: d4, the illegal move is ignored
+ **************************************/
+void TestBook::getMove_best()
+{
+   // SETUP
+   Board board;
+   uint64_t key = polyglotKey(board);
+   string data;
+   addEntry(data, key, moveToPolyglot(Move("e2e4")), 5);
+   addEntry(data, key, moveToPolyglot(Move("d2d4")), 9);
+   addEntry(data, key, moveToPolyglot(Move("e2e5")), 99);
+   OpeningBook book;
+   book.open((const uint8_t*)data.data(), data.size());
+   Move move;
+
+   // EXERCISE
+   bool found = book.getMove(board, move, true /*best*/);
+
+   // VERIFY
+   assertUnit(found);
+   assertUnit(move.getText() == "d2d4");
+}  // TEARDOWN
+
+/*************************************
+ * GET MOVE weighted
+ * Input:  e4 (weight 1), d4 (weight 3), c4 (weight 0)
+ * Output: both e4 and d4 are chosen over many tries, c4 never
+ **************************************/
+void TestBook::getMove_weighted()
+{
+   // SETUP
+   Board board;
+   uint64_t key = polyglotKey(board);
+   string data;
+   addEntry(data, key, moveToPolyglot(Move("e2e4")), 1);
+   addEntry(data, key, moveToPolyglot(Move("d2d4")), 3);
+   addEntry(data, key, moveToPolyglot(Move("c2c4")), 0);
+   OpeningBook book;
+   book.open((const uint8_t*)data.data(), data.size());
+   book.seed(42);
+   int numE4 = 0;
+   int numD4 = 0;
+   int numC4 = 0;
+
+   // EXERCISE
+   for (int i = 0; i < 400; i++)
+   {
+      Move move;
+      book.getMove(board, move);
+      if (move.getText() == "e2e4") numE4++;
+      if (move.getText() == "d2d4") numD4++;
+      if (move.getText() == "c2c4") numC4++;
+   }
+
+   // VERIFY
+   assertUnit(numE4 + numD4 == 400);
+   assertUnit(numC4 == 0);
+   assertUnit(numE4 > 50 && numD4 > numE4);
+}  // TEARDOWN
+
+/*************************************
+ * BUILD weights
+ * Input:  1.e4 e5 (1-0), 1.e4 c5 (draw), 1.d4 d5 (0-1), two plies
+ * Output: e4 scores 2*1 + 1 = 3 and comes before d4 with 0.
+ *         After 1.e4, c5 (a draw) outscores e5 (a loss)
+ **************************************/
+void TestBook::build_weights()
+{
+   // SETUP
+   BookBuilder builder(2 /*maxPly*/, 1 << 20, 1 /*numThreads*/);
+   istringstream in(PGN_THREE_GAMES);
+   ostringstream out;
+   Board board;
+   vector<BookEntry> entries;
+
+   // EXERCISE
+   size_t numGames = builder.addPgn(in);
+   size_t numEntries = builder.write(out);
+   string data = out.str();
+   OpeningBook book;
+   book.open((const uint8_t*)data.data(), data.size());
+   book.probe(polyglotKey(board), entries);
+
+   // VERIFY
+   assertUnit(numGames == 3);
+   assertUnit(numEntries == 5);
+   assertUnit(book.size() == 5);
+   assertUnit(entries.size() == 2);
+   if (entries.size() == 2)
+   {
+      assertUnit(entries[0].move == moveToPolyglot(Move("e2e4")));
+      assertUnit(entries[0].weight == 3);
+      assertUnit(entries[1].move == moveToPolyglot(Move("d2d4")));
+      assertUnit(entries[1].weight == 0);
+   }
+   board.move(Move("e2e4"));
+   book.probe(polyglotKey(board), entries);
+   assertUnit(entries.size() == 2);
+   if (entries.size() == 2)
+   {
+      assertUnit(entries[0].move == moveToPolyglot(Move("c7c5")));
+      assertUnit(entries[0].weight == 1);
+   }
+}  // TEARDOWN
+
+/*************************************
+ * BUILD minimum games
+ * Input:  the three games, moves must be played twice
+ * Output: only 1.e4 is left in the book
+ **************************************/
+void TestBook::build_minGames()
+{
+   // SETUP
+   BookBuilder builder(2 /*maxPly*/, 1 << 20, 1 /*numThreads*/);
+   builder.setMinGames(2);
+   istringstream in(PGN_THREE_GAMES);
+   ostringstream out;
+
+   // EXERCISE
+   builder.addPgn(in);
+   size_t numEntries = builder.write(out);
+
+   // VERIFY
+   assertUnit(numEntries == 1);
+   assertUnit(out.str().size() == BOOK_ENTRY_SIZE);
+}  // TEARDOWN
+
+/*************************************
+ * BUILD spill
+ * Input:  the same games with room for only a few
+ *         records, and with plenty of room
+ * Output: many runs, merged in tiers of fewer than
+ *         BOOK_MERGE_RUNS each, but the same book
+ **************************************/
+void TestBook::build_spill()
+{
+   // SETUP
+   BookBuilder small(8, 64 /*bytes*/, 1 /*numThreads*/);
+   BookBuilder large(8, 1 << 20, 1 /*numThreads*/);
+   ostringstream outSmall;
+   ostringstream outLarge;
+   vector<vector<Move>> games =
+   {
+      { Move("e2e4"), Move("e7e5"), Move("g1f3"), Move("b8c6") },
+      { Move("e2e4"), Move("c7c5"), Move("g1f3"), Move("d7d6") },
+      { Move("d2d4"), Move("d7d5"), Move("c2c4"), Move("e7e6") },
+      { Move("e2e4"), Move("e7e5"), Move("f1c4"), Move("g8f6") }
+   };
+
+   // EXERCISE
+   for (int i = 0; i < 20; i++)
+      for (size_t iGame = 0; iGame < games.size(); iGame++)
+      {
+         small.addGame(games[iGame], (GameResult)(iGame % 4));
+         large.addGame(games[iGame], (GameResult)(iGame % 4));
+      }
+   size_t numSmall = small.write(outSmall);
+   size_t numLarge = large.write(outLarge);
+
+   // VERIFY
+   assertUnit(small.getNumRuns() > 1);
+   assertUnit(small.getNumRuns() < BOOK_MERGE_RUNS * 4);
+   for (size_t i = 1; i < small.runLevels.size(); i++)
+      assertUnit(small.runLevels[i - 1] >= small.runLevels[i]);
+   for (size_t i = BOOK_MERGE_RUNS - 1; i < small.runLevels.size(); i++)
+      assertUnit(small.runLevels[i - BOOK_MERGE_RUNS + 1] != small.runLevels[i]);
+   assertUnit(large.getNumRuns() == 1);
+   assertUnit(numSmall == numLarge);
+   assertUnit(outSmall.str() == outLarge.str());
+}  // TEARDOWN
+
+/*************************************
+ * BUILD PGN with threads
+ * Input:  many copies of the three games, one and four threads
+ * Output: the same book either way
+ **************************************/
+void TestBook::build_pgnThreads()
+{
+   // SETUP
+   string pgn;
+   for (int i = 0; i < 300; i++)
+      pgn += string(PGN_THREE_GAMES) + "\n";
+   istringstream in1(pgn);
+   istringstream in4(pgn);
+   BookBuilder one(4, 1 << 20, 1 /*numThreads*/);
+   BookBuilder four(4, 1 << 20, 4 /*numThreads*/);
+   ostringstream out1;
+   ostringstream out4;
+
+   // EXERCISE
+   size_t numGames1 = one.addPgn(in1);
+   size_t numGames4 = four.addPgn(in4);
+   one.write(out1);
+   four.write(out4);
+
+   // VERIFY
+   assertUnit(numGames1 == 900);
+   assertUnit(numGames4 == 900);
+   assertUnit(out1.str() == out4.str());
+}  // TEARDOWN
@@ -0,0 +1,65 @@
+/***********************************************************************
+ * Header File:
+ *    TEST BOOK
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for Polyglot hashing and the opening book,
+ *    both reading and building one
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+
+/***************************************************
+ * BOOK TEST
+ * Test polyglotKey, the move encoding, OpeningBook, and BookBuilder
+ ***************************************************/
+class TestBook : public UnitTest
+{
+public:
+   void run()
+   {
+      // the published Polyglot test positions
+      timeTest(key_start);
+      timeTest(key_afterE4);
+      timeTest(key_castleLost);
+      timeTest(key_enpassant);
+
+      // move encoding
+      timeTest(move_encode);
+      timeTest(move_castle);
+
+      // the book itself
+      timeTest(open_badSize);
+      timeTest(probe_found);
+      timeTest(probe_missing);
+      timeTest(getMove_best);
+      timeTest(getMove_weighted);
+
+      // building a book
+      timeTest(build_weights);
+      timeTest(build_minGames);
+      timeTest(build_spill);
+      timeTest(build_pgnThreads);
+
+      report("Book");
+   }
+private:
+   void key_start();
+   void key_afterE4();
+   void key_castleLost();
+   void key_enpassant();
+   void move_encode();
+   void move_castle();
+   void open_badSize();
+   void probe_found();
+   void probe_missing();
+   void getMove_best();
+   void getMove_weighted();
+   void build_weights();
+   void build_minGames();
+   void build_spill();
+   void build_pgnThreads();
+};
@@ -0,0 +1,191 @@
+/***********************************************************************
+ * Source File:
+ *    TEST EVALUATE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the compact position and the evaluation
+ ************************************************************************/
+
+#include "testEvaluate.h"
+#include "evaluate.h"
+#include "board.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+/***************************************************
+ * RUN
+ ***************************************************/
+void TestEvaluate::run()
+{
+   timeTest(readFEN_matchesBoard);
+   timeTest(readFEN_bad);
+   timeTest(evaluate_start);
+   timeTest(evaluate_mirror);
+   timeTest(evaluate_material);
+   timeTest(evaluateBatch_matchesOne);
+
+   report("Evaluate");
+}
+
+/*************************************
+ * READ FEN matches board
+ * Input:  a middle game as FEN
+ * Output: the same pieces as a board that read it
+ **************************************/
+void TestEvaluate::readFEN_matchesBoard()
+{
+   // SETUP
+   const string fen = "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP1QBPPP/R3KB1R b KQ - 3 9";
+   Board board(nullptr, false /*noreset*/);
+   board.readFEN(fen);
+   CompactPosition position;
+
+   // EXERCISE
+   position.readFEN(fen);
+
+   // VERIFY
+   CompactPosition expected(board);
+   bool isSame = true;
+   for (int iColor = 0; iColor < 2; iColor++)
+      for (int iType = 0; iType < NUM_PIECE_TYPES; iType++)
+         isSame = isSame && position.pieces[iColor][iType] == expected.pieces[iColor][iType];
+   assertUnit(isSame);
+   assertUnit(!position.isWhiteToMove);
+   assertUnit(!expected.isWhiteToMove);
+   assertUnit(countSquares(position.getPieces(true)) == 16);
+   assertUnit(position.getPieces(false, KING) == squareBit(62));
+}  // TEARDOWN
+
+/*************************************
+ * READ FEN bad
+ * Input:  a rank of nine squares
+ * Output: a string is thrown and the position is unchanged
+ **************************************/
+void TestEvaluate::readFEN_bad()
+{
+   // SETUP
+   CompactPosition position;
+   position.readFEN("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+   bool thrown = false;
+
+   // EXERCISE
+   try
+   {
+      position.readFEN("4k3/9/8/8/8/8/8/4K3 w - - 0 1");
+   }
+   catch (const string&)
+   {
+      thrown = true;
+   }
+
+   // VERIFY
+   assertUnit(thrown);
+   assertUnit(position.getPieces(true, KING) == squareBit(4));
+}  // TEARDOWN
+
+/*************************************
+ * EVALUATE start
+ * Input:  the starting position
+ * Output: even
+ **************************************/
+void TestEvaluate::evaluate_start()
+{
+   // SETUP
+   Board board(nullptr, false /*noreset*/);
+   CompactPosition position(board);
+
+   // EXERCISE
+   int score = evaluate(position);
+
+   // VERIFY
+   assertUnit(score == 0);
+}  // TEARDOWN
+
+/*************************************
+ * EVALUATE mirror
+ * Input:  a position, and the same with the colors
+ *         swapped and the board flipped
+ * Output: the scores are opposite
+ **************************************/
+void TestEvaluate::evaluate_mirror()
+{
+   // SETUP
+   CompactPosition position;
+   CompactPosition mirror;
+   position.readFEN("r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP1QBPPP/R3KB1R w KQ - 0 1");
+   mirror.readFEN("r3kb1r/pp1qbppp/2n1pn2/2pp4/3P4/2N1PN2/PP2BPPP/R1BQ1RK1 b kq - 0 1");
+
+   // EXERCISE
+   int score = evaluate(position);
+   int scoreMirror = evaluate(mirror);
+
+   // VERIFY
+   assertUnit(score != 0);
+   assertUnit(score == -scoreMirror);
+}  // TEARDOWN
+
+/*************************************
+ * EVALUATE material
+ * Input:  kings and a white queen
+ * Output: white is ahead by about a queen
+ **************************************/
+void TestEvaluate::evaluate_material()
+{
+   // SETUP
+   CompactPosition position;
+   position.readFEN("4k3/8/8/8/3Q4/8/8/4K3 w - - 0 1");
+
+   // EXERCISE
+   int score = evaluate(position);
+
+   // VERIFY
+   assertUnit(score > 900);
+   assertUnit(score < 1000);
+}  // TEARDOWN
+
+/*************************************
+ * EVALUATE BATCH matches one
+ * Input:  a thousand random positions, a few more
+ *         than fit in whole chunks, on one thread
+ *         and on four
+ * Output: every score is what evaluate() gives
+ **************************************/
+void TestEvaluate::evaluateBatch_matchesOne()
+{
+   // SETUP
+   uint64_t state = 24680;
+   auto getRandom = [&state]()
+   {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      return state >> 33;
+   };
+   vector<CompactPosition> positions(1000);
+   for (CompactPosition& position : positions)
+   {
+      Bitboard occupied = 0;
+      for (int i = 0; i < 24; i++)
+      {
+         int square = (int)(getRandom() % 64);
+         if (occupied & squareBit(square))
+            continue;
+         occupied |= squareBit(square);
+         int iType = i < 2 ? 0 : (int)(getRandom() % (NUM_PIECE_TYPES - 1)) + 1;
+         position.pieces[i % 2][iType] |= squareBit(square);
+      }
+   }
+   vector<int> scoresOne(positions.size(), -1);
+   vector<int> scoresFour(positions.size(), -1);
+
+   // EXERCISE
+   evaluateBatch(positions.data(), positions.size(), scoresOne.data(), 1);
+   evaluateBatch(positions.data(), positions.size(), scoresFour.data(), 4);
+
+   // VERIFY
+   bool isSame = true;
+   for (size_t i = 0; i < positions.size(); i++)
+      isSame = isSame && scoresOne[i] == evaluate(positions[i]) &&
+                         scoresFour[i] == scoresOne[i];
+   assertUnit(isSame);
+}  // TEARDOWN
@@ -0,0 +1,31 @@
+/***********************************************************************
+ * Header File:
+ *    TEST EVALUATE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the compact position and the evaluation
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+
+/***************************************************
+ * EVALUATE TEST
+ * Test the compact position, one evaluation, and
+ * the batch
+ ***************************************************/
+class TestEvaluate : public UnitTest
+{
+public:
+   void run();
+
+private:
+   void readFEN_matchesBoard();
+   void readFEN_bad();
+   void evaluate_start();
+   void evaluate_mirror();
+   void evaluate_material();
+   void evaluateBatch_matchesOne();
+};
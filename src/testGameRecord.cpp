@@ -0,0 +1,410 @@
+/***********************************************************************
+ * Source File:
+ *    TEST GAME RECORD
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the binary game record and the PGN converter
+ ************************************************************************/
+
+#include "testGameRecord.h"
+#include "gameRecord.h"
+#include "pgn.h"
+#include "board.h"
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cassert>
+using namespace std;
+
+/*************************************
+ * ENCODE opening move
+ * Input:  starting position, e2e4
+ * Output: index 11 (a2 and b1..d2 come first), decodes back to e2e4
+ **************************************/
+void TestGameRecord::encode_opening()
+{
+   // SETUP
+   Board board;
+   Move move("e2e4");
+
+   // EXERCISE
+   uint8_t index = GameRecordWriter::encodeMove(board, move);
+   Move decoded = GameRecordReader::decodeMove(board, index);
+
+   // VERIFY
+   assertUnit(index == 11);
+   assertUnit(decoded.getText() == "e2e4");
+}  // TEARDOWN
+
+/*************************************
+ * ENCODE underpromotion
+ * Input:  white pawn on b7, black rook on a8, bxa8=N
+ * Output: each promotion has its own index, and the
+ *         knight decodes back to the knight
+ **************************************/
+void TestGameRecord::encode_underpromotion()
+{
+   // SETUP
+   Board board;
+   board.readFEN("r3k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+   Move knight = sanToMove(board, "bxa8=N");
+   Move queen  = sanToMove(board, "bxa8=Q");
+
+   // EXERCISE
+   uint8_t indexKnight = GameRecordWriter::encodeMove(board, knight);
+   uint8_t indexQueen  = GameRecordWriter::encodeMove(board, queen);
+   Move decoded = GameRecordReader::decodeMove(board, indexKnight);
+
+   // VERIFY
+   assertUnit(indexKnight != indexQueen);
+   assertUnit(decoded.getPromote() == KNIGHT);
+   assertUnit(decoded.getSource() == knight.getSource());
+   assertUnit(decoded.getDest() == knight.getDest());
+   assertUnit(moveToSan(board, decoded) == "bxa8=N");
+}  // TEARDOWN
+
+/*************************************
+ * ENCODE illegal move
+ * Input:  starting position, e2e5
+ * Output: throws
+ **************************************/
+void TestGameRecord::encode_illegal()
+{
+   // SETUP
+   Board board;
+   Move move("e2e5");
+   bool thrown = false;
+
+   // EXERCISE
+   try
+   {
+      GameRecordWriter::encodeMove(board, move);
+   }
+   catch (const string&)
+   {
+      thrown = true;
+   }
+
+   // VERIFY
+   assertUnit(thrown);
+}  // TEARDOWN
+
+/*************************************
+ * WRITE empty archive
+ * Input:  no games
+ * Output: header + one index entry, reads back with zero games
+ **************************************/
+void TestGameRecord::write_empty()
+{
+   // SETUP
+   GameRecordWriter writer;
+   ostringstream out;
+
+   // EXERCISE
+   writer.write(out);
+   string data = out.str();
+   GameRecordReader reader;
+   reader.open((const uint8_t*)data.data(), data.size());
+
+   // VERIFY
+   assertUnit(data.size() == GAME_RECORD_HEADER + 8);
+   assertUnit(data.substr(0, 4) == "CGR1");
+   assertUnit(reader.size() == 0);
+}  // TEARDOWN
+
+/*************************************
+ * WRITE two games
+ * Input:  1.e4 e5 (1-0) and 1.d4 (1/2-1/2)
+ * Output: one byte per move plus one result byte per game
+ **************************************/
+void TestGameRecord::write_twoGames()
+{
+   // SETUP
+   GameRecordWriter writer;
+   vector<Move> game1 = { Move("e2e4"), Move("e7e5") };
+   vector<Move> game2 = { Move("d2d4") };
+   ostringstream out;
+
+   // EXERCISE
+   writer.addGame(game1, RESULT_WHITE);
+   writer.addGame(game2, RESULT_DRAW);
+   writer.write(out);
+
+   // VERIFY
+   assertUnit(writer.size() == 2);
+   assertUnit(writer.data.size() == 3 + 2);
+   assertUnit(out.str().size() == GAME_RECORD_HEADER + 3 * 8 + 5);
+}  // TEARDOWN
+
+/*************************************
+ * READ bad magic number
+ * Input:  a buffer that is not an archive
+ * Output: throws and the reader is closed
+ **************************************/
+void TestGameRecord::read_badMagic()
+{
+   // SETUP
+   string data = "PGN1 this is not a game record";
+   GameRecordReader reader;
+   bool thrown = false;
+
+   // EXERCISE
+   try
+   {
+      reader.open((const uint8_t*)data.data(), data.size());
+   }
+   catch (const string&)
+   {
+      thrown = true;
+   }
+
+   // VERIFY
+   assertUnit(thrown);
+   assertUnit(!reader.isOpen());
+}  // TEARDOWN
+
+/*************************************
+ * READ corrupt offset
+ * Input:  three games, with the offset of the second
+ *         pointed past the end, then before the first
+ * Output: both throw and the reader is closed
+ **************************************/
+void TestGameRecord::read_corruptOffset()
+{
+   // SETUP
+   GameRecordWriter writer;
+   writer.addGame({ Move("e2e4") }, RESULT_WHITE);
+   writer.addGame({ Move("d2d4") }, RESULT_BLACK);
+   writer.addGame({ Move("c2c4") }, RESULT_DRAW);
+   ostringstream out;
+   writer.write(out);
+   string pastEnd = out.str();
+   string backward = out.str();
+   pastEnd[GAME_RECORD_HEADER + 8 + 6] = 0x7f;        // a huge offset
+   backward[GAME_RECORD_HEADER + 8] = 0;               // before the first game
+   GameRecordReader reader;
+   int numThrown = 0;
+
+   // EXERCISE
+   for (const string* pData : { &pastEnd, &backward })
+   {
+      try
+      {
+         reader.open((const uint8_t*)pData->data(), pData->size());
+      }
+      catch (const string&)
+      {
+         numThrown++;
+      }
+   }
+
+   // VERIFY
+   assertUnit(numThrown == 2);
+   assertUnit(!reader.isOpen());
+}  // TEARDOWN
+
+/*************************************
+ * READ random access
+ * Input:  three games
+ * Output: the middle game is found and replayed directly
+ **************************************/
+void TestGameRecord::read_randomAccess()
+{
+   // SETUP
+   GameRecordWriter writer;
+   writer.addGame({ Move("e2e4") }, RESULT_WHITE);
+   writer.addGame({ Move("g1f3"), Move("g8f6"), Move("b1c3") }, RESULT_BLACK);
+   writer.addGame({}, RESULT_UNKNOWN);
+   ostringstream out;
+   writer.write(out);
+   string data = out.str();
+   GameRecordReader reader;
+   vector<Move> moves;
+
+   // EXERCISE
+   reader.open((const uint8_t*)data.data(), data.size());
+   reader.getMoves(1, moves);
+
+   // VERIFY
+   assertUnit(reader.size() == 3);
+   assertUnit(reader.getResult(1) == RESULT_BLACK);
+   assertUnit(reader.getNumMoves(1) == 3);
+   assertUnit(reader.getNumMoves(2) == 0);
+   assertUnit(reader.getResult(2) == RESULT_UNKNOWN);
+   assertUnit(moves.size() == 3);
+   if (moves.size() == 3)
+   {
+      assertUnit(moves[0].getText() == "g1f3");
+      assertUnit(moves[1].getText() == "g8f6");
+      assertUnit(moves[2].getText() == "b1c3");
+   }
+}  // TEARDOWN
+
+/*************************************
+ * SAN pawn moves
+ * Input:  1.e4 d5
+ * Output: "exd5" is the capture, "e5" the push
+ **************************************/
+void TestGameRecord::san_pawn()
+{
+   // SETUP
+   Board board;
+   const char* moves[] = { "e4", "d5" };
+   playSan(board, moves, 2);
+
+   // EXERCISE
+   Move capture = sanToMove(board, "exd5");
+   Move push = sanToMove(board, "e5");
+
+   // VERIFY
+   assertUnit(capture.getSource() == Position("e4"));
+   assertUnit(capture.getDest() == Position("d5"));
+   assertUnit(moveToSan(board, capture) == "exd5");
+   assertUnit(moveToSan(board, push) == "e5");
+}  // TEARDOWN
+
+/*************************************
+ * SAN ambiguous knight
+ * Input:  1.Nf3 d5 2.d3 a6, both knights reach d2
+ * Output: "Nbd2" is required, "Nd2" throws
+ **************************************/
+void TestGameRecord::san_knightAmbiguous()
+{
+   // SETUP
+   Board board;
+   const char* moves[] = { "Nf3", "d5", "d3", "a6" };
+   playSan(board, moves, 4);
+   bool thrown = false;
+
+   // EXERCISE
+   Move move = sanToMove(board, "Nbd2");
+   try
+   {
+      sanToMove(board, "Nd2");
+   }
+   catch (const string&)
+   {
+      thrown = true;
+   }
+
+   // VERIFY
+   assertUnit(move.getSource() == Position("b1"));
+   assertUnit(moveToSan(board, move) == "Nbd2");
+   assertUnit(thrown);
+}  // TEARDOWN
+
+/*************************************
+ * SAN castle
+ * Input:  1.e4 e5 2.Nf3 Nc6 3.Bc4 Bc5
+ * Output: "O-O" is the king-side castle
+ **************************************/
+void TestGameRecord::san_castle()
+{
+   // SETUP
+   Board board;
+   const char* moves[] = { "e4", "e5", "Nf3", "Nc6", "Bc4", "Bc5" };
+   playSan(board, moves, 6);
+
+   // EXERCISE
+   Move move = sanToMove(board, "O-O");
+
+   // VERIFY
+   assertUnit(move.getMoveType() == Move::CASTLE_KING);
+   assertUnit(moveToSan(board, move) == "O-O");
+}  // TEARDOWN
+
+/*************************************
+ * SAN illegal
+ * Input:  starting position, "Ke2"
+ * Output: throws
+ **************************************/
+void TestGameRecord::san_illegal()
+{
+   // SETUP
+   Board board;
+   bool thrown = false;
+
+   // EXERCISE
+   try
+   {
+      sanToMove(board, "Ke2");
+   }
+   catch (const string&)
+   {
+      thrown = true;
+   }
+
+   // VERIFY
+   assertUnit(thrown);
+}  // TEARDOWN
+
+/*************************************
+ * PGN read tags
+ * Input:  tag pairs, comments, a variation, and NAGs
+ * Output: tags and main line moves only
+ **************************************/
+void TestGameRecord::pgn_readTags()
+{
+   // SETUP
+   istringstream in(
+      "[Event \"Club \\\"Open\\\"\"]\n"
+      "[White \"Gary\"]\n"
+      "[Result \"0-1\"]\n"
+      "\n"
+      "1. e4 {best by test} e5 (1... c5 2. Nf3) 2. Nf3 $1 Nc6 0-1\n");
+   PgnGame game;
+
+   // EXERCISE
+   bool found = readPgnGame(in, game);
+
+   // VERIFY
+   assertUnit(found);
+   assertUnit(game.tags["Event"] == "Club \"Open\"");
+   assertUnit(game.tags["White"] == "Gary");
+   assertUnit(game.result == RESULT_BLACK);
+   assertUnit(game.moves.size() == 4);
+   assertUnit(!readPgnGame(in, game));
+}  // TEARDOWN
+
+/*************************************
+ * PGN round trip
+ * Input:  two PGN games
+ * Output: PGN -> binary -> PGN -> moves are unchanged
+ **************************************/
+void TestGameRecord::pgn_roundTrip()
+{
+   // SETUP
+   istringstream in(
+      "[Event \"?\"]\n\n"
+      "1. e4 e5 2. Nf3 Nc6 3. Bc4 Bc5 4. O-O Nf6 5. d3 d6 1/2-1/2\n\n"
+      "[Event \"?\"]\n\n"
+      "1. f3 e5 2. g4 Qh4# 0-1\n");
+   GameRecordWriter writer;
+   ostringstream out;
+   ostringstream pgn;
+   GameRecordReader reader;
+   size_t numSkipped = 99;
+
+   // EXERCISE
+   size_t numGames = convertPgnToRecord(in, writer, &numSkipped);
+   writer.write(out);
+   string data = out.str();
+   reader.open((const uint8_t*)data.data(), data.size());
+   convertRecordToPgn(reader, pgn);
+   istringstream again(pgn.str());
+   PgnGame game1;
+   PgnGame game2;
+   readPgnGame(again, game1);
+   readPgnGame(again, game2);
+
+   // VERIFY
+   assertUnit(numGames == 2);
+   assertUnit(numSkipped == 0);
+   assertUnit(game1.moves.size() == 10);
+   assertUnit(game1.result == RESULT_DRAW);
+   assertUnit(game2.moves.size() == 4);
+   assertUnit(game2.result == RESULT_BLACK);
+   assertUnit(pgn.str().find("Qh4# 0-1") != string::npos);
+   assertUnit(pgn.str().find("4. O-O Nf6") != string::npos);
+}  // TEARDOWN
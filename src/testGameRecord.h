@@ -0,0 +1,62 @@
+/***********************************************************************
+ * Header File:
+ *    TEST GAME RECORD
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the binary game record and the PGN converter
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+
+/***************************************************
+ * GAME RECORD TEST
+ * Test the GameRecordWriter, GameRecordReader, and PGN
+ ***************************************************/
+class TestGameRecord : public UnitTest
+{
+public:
+   void run()
+   {
+      // encoding of a single move
+      timeTest(encode_opening);
+      timeTest(encode_underpromotion);
+      timeTest(encode_illegal);
+
+      // writer and reader
+      timeTest(write_empty);
+      timeTest(write_twoGames);
+      timeTest(read_badMagic);
+      timeTest(read_corruptOffset);
+      timeTest(read_randomAccess);
+
+      // SAN
+      timeTest(san_pawn);
+      timeTest(san_knightAmbiguous);
+      timeTest(san_castle);
+      timeTest(san_illegal);
+
+      // PGN
+      timeTest(pgn_readTags);
+      timeTest(pgn_roundTrip);
+
+      report("GameRecord");
+   }
+private:
+   void encode_opening();
+   void encode_underpromotion();
+   void encode_illegal();
+   void write_empty();
+   void write_twoGames();
+   void read_badMagic();
+   void read_corruptOffset();
+   void read_randomAccess();
+   void san_pawn();
+   void san_knightAmbiguous();
+   void san_castle();
+   void san_illegal();
+   void pgn_readTags();
+   void pgn_roundTrip();
+};
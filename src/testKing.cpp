@@ -46,6 +46,7 @@ void TestKing::getMoves_blocked()
    White p8(PAWN); board.board[4][5] = &p8; // e6
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    king.getMoves(moves, board);
@@ -104,6 +105,7 @@ void TestKing::getMoves_capture()
    Black p8(PAWN); board.board[4][5] = &p8; // e6
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    king.getMoves(moves, board);
@@ -154,6 +156,7 @@ void TestKing::getMoves_free()
    board.board[3][4] = &king;
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    king.getMoves(moves, board);
@@ -195,6 +198,7 @@ void TestKing::getMoves_end()
    King king(Position(0, 0), true /*white*/); // a1
    board.board[0][0] = &king;
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    king.getMoves(moves, board);
@@ -238,6 +242,7 @@ void TestKing::getMoves_whiteCastle()
    White p4(PAWN); board.board[5][1] = &p4; // f2
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    king.getMoves(moves, board);
@@ -291,6 +296,7 @@ void TestKing::getMoves_blackCastle()
    Black p4(PAWN); board.board[5][6] = &p4; // f6
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    king.getMoves(moves, board);
@@ -335,6 +341,7 @@ void TestKing::getMoves_whiteCastleKingMoved()
    BoardEmpty board;
    King king(Position(4, 0), true /*white*/); // e1
 	king.setLastMove(1); // King has moved
+   board.castling &= ~(CASTLE_WHITE_SHORT | CASTLE_WHITE_LONG);
    board.board[4][0] = &king;
    Rook qRook(Position(0, 0), true); board.board[0][0] = &qRook; // a1
    Rook kRook(Position(7, 0), true); board.board[7][0] = &qRook; // h1
@@ -344,6 +351,7 @@ void TestKing::getMoves_whiteCastleKingMoved()
    White p4(PAWN); board.board[5][1] = &p4; // f2
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    king.getMoves(moves, board);
@@ -392,12 +400,14 @@ void TestKing::getMoves_whiteCastleRookMoved()
 	qRook.setLastMove(1); // Rook has moved
    Rook kRook(Position(7, 0), true); board.board[7][0] = &qRook; // h1
 	kRook.setLastMove(1); // Rook has moved
+   board.castling &= ~(CASTLE_WHITE_SHORT | CASTLE_WHITE_LONG);
 
    White p2(PAWN); board.board[3][1] = &p2; // d2
    White p3(PAWN); board.board[4][1] = &p3; // e2
    White p4(PAWN); board.board[5][1] = &p4; // f2
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    king.getMoves(moves, board);
@@ -421,6 +431,59 @@ void TestKing::getMoves_whiteCastleRookMoved()
    board.board[5][1] = nullptr; // Spaces
 }
 
+/*************************************
+ * The black bishop on h3 attacks f1, so the king may not
+ * cross it to castle king side. Queen side is still fine
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 8                     8
+ * 7                     7
+ * 6                     6
+ * 5                     5
+ * 4                     4
+ * 3                   B 3
+ * 2         p p p       2
+ * 1   r     .(k).   r   1
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ **************************************/
+void TestKing::getMoves_whiteCastleThroughCheck()
+{
+   // SETUP
+   BoardEmpty board;
+   King king(Position(4, 0), true /*white*/); // e1
+   board.board[4][0] = &king;
+   Rook qRook(Position(0, 0), true); board.board[0][0] = &qRook; // a1
+   Rook kRook(Position(7, 0), true); board.board[7][0] = &kRook; // h1
+
+   White p2(PAWN); board.board[3][1] = &p2; // d2
+   White p3(PAWN); board.board[4][1] = &p3; // e2
+   White p4(PAWN); board.board[5][1] = &p4; // f2
+   Black bishop(BISHOP); board.board[7][2] = &bishop; // h3
+
+   set<Move> moves;
+   board.syncOccupied();
+
+   // EXERCISE
+   king.getMoves(moves, board);
+
+   // VERIFY
+   assertUnit(moves.size() == 3);
+   assertUnit(moves.find(Move("e1d1")) != moves.end()); // d1
+   assertUnit(moves.find(Move("e1f1")) != moves.end()); // f1, left for the board to refuse
+   assertUnit(moves.find(Move("e1g1c")) == moves.end()); // castle king side
+   assertUnit(moves.find(Move("e1c1C")) != moves.end()); // castle queen side
+
+   // TEARDOWN
+   board.board[4][0] = nullptr; // King
+   board.board[0][0] = nullptr; // Rooks
+   board.board[7][0] = nullptr; // Rooks
+   board.board[3][1] = nullptr; // Spaces
+   board.board[4][1] = nullptr; // Spaces
+   board.board[5][1] = nullptr; // Spaces
+   board.board[7][2] = nullptr; // Bishop
+}
+
 /*************************************
  * GET TYPE : king
  * Input:
@@ -24,16 +24,17 @@ public:
 
    void run()
    {     
-      getMoves_blocked();
-      getMoves_capture();
-      getMoves_free();
-      getMoves_end();
-      getMoves_whiteCastle();
-      getMoves_blackCastle();
-      getMoves_whiteCastleKingMoved();
-      getMoves_whiteCastleRookMoved();
-
-      getType();
+      timeTest(getMoves_blocked);
+      timeTest(getMoves_capture);
+      timeTest(getMoves_free);
+      timeTest(getMoves_end);
+      timeTest(getMoves_whiteCastle);
+      timeTest(getMoves_blackCastle);
+      timeTest(getMoves_whiteCastleKingMoved);
+      timeTest(getMoves_whiteCastleRookMoved);
+      timeTest(getMoves_whiteCastleThroughCheck);
+
+      timeTest(getType);
 
       report("King");
    }
@@ -46,5 +47,6 @@ private:
    void getMoves_blackCastle();
    void getMoves_whiteCastleKingMoved();
    void getMoves_whiteCastleRookMoved();
+   void getMoves_whiteCastleThroughCheck();
    void getType();
 };
@@ -40,6 +40,7 @@ void TestKnight::getMoves_end()
    White white(PAWN);
    board.board[5][2] = &white;
    set <Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    knight.getMoves(moves, board);
@@ -88,6 +89,7 @@ void TestKnight::getMoves_blocked()
 	White w8(PAWN); board.board[1][3] = &w8; // b4
 
 	set<Move> moves;
+	board.syncOccupied();
 
 	// EXERCISE
 	knight.getMoves(moves, board);
@@ -150,6 +152,7 @@ void TestKnight::getMoves_capture()
 	Black w8(PAWN); board.board[1][3] = &w8; // b4
 
 	set<Move> moves;
+	board.syncOccupied();
 
 	// EXERCISE
 	knight.getMoves(moves, board);
@@ -199,6 +202,7 @@ void TestKnight::getMoves_free()
 	Knight knight(Position(3, 4), true /*white*/);
 	board.board[3][4] = &knight; // d5
 	set<Move> moves;
+	board.syncOccupied();
 
 	// EXERCISE
 	knight.getMoves(moves, board);
@@ -22,12 +22,12 @@ public:
 
    void run()
    {
-      getMoves_blocked();
-      getMoves_capture();
-      getMoves_free();
-      getMoves_end();
+      timeTest(getMoves_blocked);
+      timeTest(getMoves_capture);
+      timeTest(getMoves_free);
+      timeTest(getMoves_end);
 //
-      getType();
+      timeTest(getType);
       
       report("Knight");
    }
@@ -0,0 +1,64 @@
+/***********************************************************************
+ * Source File:
+ *    TEST MAIN
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests as a program of their own, so the game does not
+ *    run them every time it starts. Usage:
+ *       chessTest                  run every suite
+ *       chessTest Board Pawn ...   run only the suites named
+ *       chessTest -list            name the suites
+ *    before the suite names, these options may be given:
+ *       -threads N   run independent suites on N threads, 0 for
+ *                    one per core (1)
+ *       -slowest N   list the N slowest tests (10)
+ *    The exit status is 0 only if every test passed.
+ ************************************************************************/
+
+#include "test.h"        // for TEST RUNNER
+#include <iostream>      // for COUT and CERR
+#include <string>        // for STRING
+#include <vector>        // for VECTOR
+#include <cstdlib>       // for ATOI
+using namespace std;
+
+/*********************************
+ * MAIN - Run the tests asked for
+ *********************************/
+int main(int argc, char** argv)
+{
+   TestOptions options;
+   int iArg = 1;
+   for (; iArg < argc && argv[iArg][0] == '-'; iArg++)
+   {
+      string option = argv[iArg];
+      if (option == "-list")
+      {
+         for (const string& name : getTestSuites())
+            cout << name << "\n";
+         return 0;
+      }
+      else if (option == "-threads" && iArg + 1 < argc)
+         options.numThreads = atoi(argv[++iArg]);
+      else if (option == "-slowest" && iArg + 1 < argc)
+         options.numSlowest = atoi(argv[++iArg]);
+      else
+      {
+         cerr << "Usage: chessTest [-list] [-threads N] [-slowest N] [suite...]\n";
+         return 2;
+      }
+   }
+   vector<string> suites(argv + iArg, argv + argc);
+
+   try
+   {
+      int numFailed = testRunner(suites, options);
+      return numFailed == 0 ? 0 : 1;
+   }
+   catch (const string& error)
+   {
+      cerr << "Error: " << error << endl;
+      return 2;
+   }
+}
@@ -21,44 +21,44 @@ public:
    void run() 
    {
       // Constructor
-      constructor_default();
+      timeTest(constructor_default);
 
       // Assign
-      read_simple();
-      read_capture();
-      read_enpassant();
-      read_castleKing();
-      read_castleQueen();
-      constructString_simple();
-      assign_simple();
-      assign_capture();
-      assign_enpassant();
-      assign_castleKing();
-      assign_castleQueen();
+      timeTest(read_simple);
+      timeTest(read_capture);
+      timeTest(read_enpassant);
+      timeTest(read_castleKing);
+      timeTest(read_castleQueen);
+      timeTest(constructString_simple);
+      timeTest(assign_simple);
+      timeTest(assign_capture);
+      timeTest(assign_enpassant);
+      timeTest(assign_castleKing);
+      timeTest(assign_castleQueen);
 
       // Get Text
-      getText_simple();
-      getText_capture();
-      getText_enpassant();
-      getText_castleKing();
-      getText_castleQueen();
+      timeTest(getText_simple);
+      timeTest(getText_capture);
+      timeTest(getText_enpassant);
+      timeTest(getText_castleKing);
+      timeTest(getText_castleQueen);
 
       // Letter from Piece Type
-      letterFromPieceType_space();
-      letterFromPieceType_pawn();
-      letterFromPieceType_bishop();
-      letterFromPieceType_knight();
-      letterFromPieceType_rook();
-      letterFromPieceType_queen();
-      letterFromPieceType_king();
+      timeTest(letterFromPieceType_space);
+      timeTest(letterFromPieceType_pawn);
+      timeTest(letterFromPieceType_bishop);
+      timeTest(letterFromPieceType_knight);
+      timeTest(letterFromPieceType_rook);
+      timeTest(letterFromPieceType_queen);
+      timeTest(letterFromPieceType_king);
 
       // Piece Type from Letter
-      pieceTypeFromLetter_pawn();
-      pieceTypeFromLetter_knight();
-      pieceTypeFromLetter_bishop();
-      pieceTypeFromLetter_rook();
-      pieceTypeFromLetter_king();
-      pieceTypeFromLetter_queen();
+      timeTest(pieceTypeFromLetter_pawn);
+      timeTest(pieceTypeFromLetter_knight);
+      timeTest(pieceTypeFromLetter_bishop);
+      timeTest(pieceTypeFromLetter_rook);
+      timeTest(pieceTypeFromLetter_king);
+      timeTest(pieceTypeFromLetter_queen);
 
       report("Move");
    }
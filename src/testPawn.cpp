@@ -41,6 +41,7 @@ void TestPawn::getMoves_simpleWhite()
    board.board[1][3] = &pawn;
    pawn.fWhite = true;
    set<Move> moves;
+   board.syncOccupied();
    
    // EXERCISE
    pawn.getMoves(moves, board);
@@ -78,6 +79,7 @@ void TestPawn::getMoves_simpleBlack()
    board.board[1][3] = &pawn;
    pawn.fWhite = false;
    set<Move> moves;
+   board.syncOccupied();
    
    // EXERCISE
    pawn.getMoves(moves, board);
@@ -116,6 +118,7 @@ void TestPawn::getMoves_initialAdvanceWhite()
    board.board[1][1] = &pawn;
    pawn.fWhite = true;
    set<Move> moves;
+   board.syncOccupied();
    
    // EXERCISE
    pawn.getMoves(moves, board);
@@ -154,6 +157,7 @@ void TestPawn::getMoves_initialAdvanceBlack()
    board.board[2][6] = &pawn;
    pawn.fWhite = false;
    set<Move> moves;
+   board.syncOccupied();
    
    // EXERCISE
    pawn.getMoves(moves, board);
@@ -199,6 +203,7 @@ void TestPawn::getMoves_captureWhite()
    board.board[2][6] = &blackC;
    pawn.fWhite = true;
    set<Move> moves;
+   board.syncOccupied();
    
    // EXERCISE
    pawn.getMoves(moves, board);
@@ -247,6 +252,7 @@ void TestPawn::getMoves_captureBlack()
    board.board[2][4] = &whiteC;
    pawn.fWhite = false;
    set<Move> moves;
+   board.syncOccupied();
    
    // EXERCISE
    pawn.getMoves(moves, board);
@@ -265,7 +271,8 @@ void TestPawn::getMoves_captureBlack()
 
 /*************************************
  * GET MOVES TEST Enpassant
- * Enpassant: white b5 can capture a5 and c5. Note that b6 is blocked
+ * Enpassant: white b5 can capture a5, which just moved two squares,
+ * but not c5. Note that b6 is blocked
  *
  * +---a-b-c-d-e-f-g-h---+
  * |                     |
@@ -293,20 +300,17 @@ void TestPawn::getMoves_enpassantWhite()
    board.board[1][5] = &blackB;
    board.board[2][4] = &blackC;
    pawn.fWhite = true;
-   
-//   // Set up en passant flags (assuming isEnPassant is a property on Pawn; adjust as needed)
-//   blackA.enPassant = true;
-//   blackC.enPassant = true;
-   
+   board.enPassant = Position(0, 5);   // a6, skipped by a7-a5
    set<Move> moves;
+   board.syncOccupied();
    
    // EXERCISE
    pawn.getMoves(moves, board);
    
    // VERIFY
-   assertUnit(moves.size() == 2);
+   assertUnit(moves.size() == 1);
    assertUnit(moves.find(Move("b5a6E")) != moves.end());
-   assertUnit(moves.find(Move("b5c6E")) != moves.end());
+   assertUnit(moves.find(Move("b5c6E")) == moves.end());
    
    // TEARDOWN
    board.board[1][4] = nullptr;
@@ -318,7 +322,8 @@ void TestPawn::getMoves_enpassantWhite()
 
 /*************************************
  * GET MOVES TEST Enpassant
- * Enpassant black f4 can capture e4 and g4. Note that f3 is blocked
+ * Enpassant black f4 can capture e4, which just moved two squares,
+ * but not g4. Note that f3 is blocked
  *
  * +---a-b-c-d-e-f-g-h---+
  * |                     |
@@ -346,20 +351,17 @@ void TestPawn::getMoves_enpassantBlack()
    board.board[5][2] = &blackF;
    board.board[6][3] = &whiteG;
    pawn.fWhite = false;
-   
-//   // Set up en passant flags (assuming isEnPassant is a property on Pawn; adjust as needed)
-//   whiteE.enPassant = true;
-//   whiteG.enPassant = true;
-   
+   board.enPassant = Position(4, 2);   // e3, skipped by e2-e4
    set<Move> moves;
+   board.syncOccupied();
    
    // EXERCISE
    pawn.getMoves(moves, board);
    
    // VERIFY
-   assertUnit(moves.size() == 2);
+   assertUnit(moves.size() == 1);
    assertUnit(moves.find(Move("f4e3E")) != moves.end());
-   assertUnit(moves.find(Move("f4g3E")) != moves.end());
+   assertUnit(moves.find(Move("f4g3E")) == moves.end());
    
    // TEARDOWN
    board.board[5][3] = nullptr;
@@ -371,7 +373,8 @@ void TestPawn::getMoves_enpassantBlack()
 /*************************************
  * GET MOVES TEST Promotion
  * Promotion: white pawn b7 can capture two pawns: a8 and c8. 
- *            It can also move into b8. All three are promoted to queen
+ *            It can also move into b8. Each of the three can promote
+ *            to a queen, rook, bishop, or knight
  *
  * +---a-b-c-d-e-f-g-h---+
  * |                     |
@@ -398,15 +401,19 @@ void TestPawn::getMoves_promotionWhite()
    board.board[2][7] = &blackC;
    pawn.fWhite = true;
    set<Move> moves;
+   board.syncOccupied();
    
    // EXERCISE
    pawn.getMoves(moves, board);
    
    // VERIFY
-   assertUnit(moves.size() == 3);
+   assertUnit(moves.size() == 12);
    assertUnit(moves.find(Move("b7a8Q")) != moves.end()); // promote via capture
    assertUnit(moves.find(Move("b7b8Q")) != moves.end()); // promote straight
    assertUnit(moves.find(Move("b7c8Q")) != moves.end()); // promote via capture
+   assertUnit(moves.find(Move("b7b8R")) != moves.end()); // under-promote
+   assertUnit(moves.find(Move("b7b8B")) != moves.end());
+   assertUnit(moves.find(Move("b7b8N")) != moves.end());
    
    // TEARDOWN
    board.board[1][6] = nullptr;
@@ -418,7 +425,8 @@ void TestPawn::getMoves_promotionWhite()
 /*************************************
  * GET MOVES TEST Promotion
  * Promotion: black pawn e2 can capture two rooks: d1 and f1.
- *            It can also move into e1. All three are promoted to queen
+ *            It can also move into e1. Each of the three can promote
+ *            to a queen, rook, bishop, or knight
  *
  * +---a-b-c-d-e-f-g-h---+
  * |                     |
@@ -445,15 +453,19 @@ void TestPawn::getMoves_promotionBlack()
    board.board[5][0] = &whiteF;
    pawn.fWhite = false;
    set<Move> moves;
+   board.syncOccupied();
    
    // EXERCISE
    pawn.getMoves(moves, board);
    
    // VERIFY
-   assertUnit(moves.size() == 3);
+   assertUnit(moves.size() == 12);
    assertUnit(moves.find(Move("e2d1Q")) != moves.end()); // promote via capture
    assertUnit(moves.find(Move("e2e1Q")) != moves.end()); // promote straight
    assertUnit(moves.find(Move("e2f1Q")) != moves.end()); // promote via capture
+   assertUnit(moves.find(Move("e2d1N")) != moves.end()); // under-promote
+   assertUnit(moves.find(Move("e2e1N")) != moves.end());
+   assertUnit(moves.find(Move("e2f1N")) != moves.end());
    
    // TEARDOWN
    board.board[4][1] = nullptr;
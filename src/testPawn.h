@@ -21,18 +21,18 @@ public:
 
    void run()
    {
-      getMoves_simpleWhite();
-      getMoves_simpleBlack();
-      getMoves_initialAdvanceWhite();
-      getMoves_initialAdvanceBlack();
-      getMoves_captureWhite();
-      getMoves_captureBlack();
-      getMoves_enpassantWhite();
-      getMoves_enpassantBlack();
-      getMoves_promotionWhite();
-      getMoves_promotionBlack();
+      timeTest(getMoves_simpleWhite);
+      timeTest(getMoves_simpleBlack);
+      timeTest(getMoves_initialAdvanceWhite);
+      timeTest(getMoves_initialAdvanceBlack);
+      timeTest(getMoves_captureWhite);
+      timeTest(getMoves_captureBlack);
+      timeTest(getMoves_enpassantWhite);
+      timeTest(getMoves_enpassantBlack);
+      timeTest(getMoves_promotionWhite);
+      timeTest(getMoves_promotionBlack);
 
-      getType();
+      timeTest(getType);
 
       report("Pawn");
    }
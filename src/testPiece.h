@@ -21,26 +21,26 @@ public:
 
    void run()
    {
-      assignment();
-
-      equals_same();
-      equals_different();
-      notEquals_same();
-      notEquals_different();
-
-      isWhite_white();
-      isWhite_black();
-      isMoved_initial();
-      isMoved_hasMoved();
-      getNMoves_initial();
-      getNMoves_hasMoved();
-
-      getPosition();
-      justMoved_initial();
-      justMoved_hasMoved();
-      justMoved_justMoved();
-
-      setLastMove();
+      timeTest(assignment);
+
+      timeTest(equals_same);
+      timeTest(equals_different);
+      timeTest(notEquals_same);
+      timeTest(notEquals_different);
+
+      timeTest(isWhite_white);
+      timeTest(isWhite_black);
+      timeTest(isMoved_initial);
+      timeTest(isMoved_hasMoved);
+      timeTest(getNMoves_initial);
+      timeTest(getNMoves_hasMoved);
+
+      timeTest(getPosition);
+      timeTest(justMoved_initial);
+      timeTest(justMoved_hasMoved);
+      timeTest(justMoved_justMoved);
+
+      timeTest(setLastMove);
 
       report("Piece");
    }
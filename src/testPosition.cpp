@@ -10,6 +10,7 @@
 
 #include "testPosition.h" // for POSITION_TEST
 #include "position.h"     // for POSITION
+#include "uiDraw.h"       // for SCREEN
 #include <cassert>        // for ASSERT
 
 
@@ -899,46 +900,46 @@ void PositionTest::getX_a1()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x00;
-   pos.squareWidth = 17;
-   pos.squareHeight = 19;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 19;
    int x = -99;
 
    // EXERCISE
-   x = pos.getX();
+   x = Screen::getX(pos);
 
    // VERIFY
    assertUnit(x == 17);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 void PositionTest::getY_a1()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x00;
-   pos.squareWidth = 17;
-   pos.squareHeight = 19;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 19;
    int y = -99;
 
    // EXERCISE
-   y = pos.getY();
+   y = Screen::getY(pos);
 
    // VERIFY
    assertUnit(y == 19);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 /*************************************
@@ -961,46 +962,46 @@ void PositionTest::getX_e7()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x46;
-   pos.squareWidth = 17;
-   pos.squareHeight = 19;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 19;
    int x = -99;
 
    // EXERCISE
-   x = pos.getX();
+   x = Screen::getX(pos);
 
    // VERIFY
    assertUnit(x == 17 * 5);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 void PositionTest::getY_e7()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x46;
-   pos.squareWidth = 17;
-   pos.squareHeight = 19;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 19;
    int y = -99;
 
    // EXERCISE
-   y = pos.getY();
+   y = Screen::getY(pos);
 
    // VERIFY
    assertUnit(y == 19 * 7);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 /*************************************
@@ -1011,44 +1012,44 @@ void PositionTest::getWidth_10()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
-   pos.squareWidth = 10;
-   pos.squareHeight = 99;
+   Screen::squareWidth = 10;
+   Screen::squareHeight = 99;
    int w = -99;
 
    // EXERCISE
-   w = pos.getSquareWidth();
+   w = Screen::getSquareWidth();
 
    // VERIFY
    assertUnit(w == 10);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 void PositionTest::getHeight_10()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
-   pos.squareWidth = 99;
-   pos.squareHeight = 10;
+   Screen::squareWidth = 99;
+   Screen::squareHeight = 10;
    int h = -99;
 
    // EXERCISE
-   h = pos.getSquareHeight();
+   h = Screen::getSquareHeight();
 
    // VERIFY
    assertUnit(h == 10);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 /*************************************
@@ -1059,48 +1060,48 @@ void PositionTest::setBoardWidthHeight_10()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
-   pos.squareWidth = 88;
-   pos.squareHeight = 99;
+   Screen::squareWidth = 88;
+   Screen::squareHeight = 99;
    int w = 10;
    int h = 10;
 
    // EXERCISE
-   pos.setBoardWidthHeight(w, h);
+   Screen::setBoardWidthHeight(w, h);
 
    // VERIFY
-   assertUnit(pos.squareWidth == 1.0);
-   assertUnit(pos.squareHeight == 1.0);
+   assertUnit(Screen::squareWidth == 1.0);
+   assertUnit(Screen::squareHeight == 1.0);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 void PositionTest::setBoardWidthHeight_420x830()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
-   pos.squareWidth = 88;
-   pos.squareHeight = 99;
+   Screen::squareWidth = 88;
+   Screen::squareHeight = 99;
    int w = 420;
    int h = 830;
 
    // EXERCISE
-   pos.setBoardWidthHeight(w, h);
+   Screen::setBoardWidthHeight(w, h);
 
    // VERIFY
-   assertUnit(pos.squareWidth == 42.0);
-   assertUnit(pos.squareHeight == 83.0);
+   assertUnit(Screen::squareWidth == 42.0);
+   assertUnit(Screen::squareHeight == 83.0);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 /*************************************
@@ -1123,24 +1124,24 @@ void PositionTest::setXY_a8()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x46;
-   pos.squareWidth = 17;
-   pos.squareHeight = 35;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 35;
    int x = 18;
    int y = 37;
 
    // EXERCISE
-   pos.setXY(x, y);
+   pos = Screen::getPosition(x, y);
 
    // VERIFY
    assertUnit(pos.colRow == 0x07);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 /*************************************
@@ -1163,24 +1164,24 @@ void PositionTest::setXY_a1()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x46;
-   pos.squareWidth = 17;
-   pos.squareHeight = 37;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 37;
    int x = 18;
    int y = 37 + (37 * 7) + 24;
 
    // EXERCISE
-   pos.setXY(x, y);
+   pos = Screen::getPosition(x, y);
 
    // VERIFY
    assertUnit(pos.colRow == 0x00);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 /*************************************
@@ -1203,24 +1204,24 @@ void PositionTest::setXY_h8()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x46;
-   pos.squareWidth = 17;
-   pos.squareHeight = 37;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 37;
    int x = 17 + (17 * 7) + 12;
    int y = 43;
 
    // EXERCISE
-   pos.setXY(x, y);
+   pos = Screen::getPosition(x, y);
 
    // VERIFY
    assertUnit(pos.colRow == 0x77);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 /*************************************
@@ -1243,24 +1244,24 @@ void PositionTest::setXY_h1()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x46;
-   pos.squareWidth = 17;
-   pos.squareHeight = 37;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 37;
    int x = 17 + (17 * 7) + 12;
    int y = 37 + (37 * 7) + 24;
 
    // EXERCISE
-   pos.setXY(x, y);
+   pos = Screen::getPosition(x, y);
 
    // VERIFY
    assertUnit(pos.colRow == 0x70);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 /*************************************
@@ -1282,24 +1283,24 @@ void PositionTest::setXY_invalidXMin()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x46;
-   pos.squareWidth = 17;
-   pos.squareHeight = 37;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 37;
    int x = 12;
    int y = 37 + (37 * 5) + 24;
 
    // EXERCISE
-   pos.setXY(x, y);
+   pos = Screen::getPosition(x, y);
 
    // VERIFY
    assertUnit(pos.colRow == 0xff);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 /*************************************
@@ -1321,24 +1322,24 @@ void PositionTest::setXY_invalidXMax()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x46;
-   pos.squareWidth = 17;
-   pos.squareHeight = 37;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 37;
    int x = 17 + (17 * 8) + 2;
    int y = 37 + (37 * 5) + 24;
 
    // EXERCISE
-   pos.setXY(x, y);
+   pos = Screen::getPosition(x, y);
 
    // VERIFY
    assertUnit(pos.colRow == 0xff);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 /*************************************
@@ -1360,24 +1361,24 @@ void PositionTest::setXY_invalidYMin()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x46;
-   pos.squareWidth = 17;
-   pos.squareHeight = 37;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 37;
    int x = 17 + (17 * 3) + 15;
    int y = 25;
 
    // EXERCISE
-   pos.setXY(x, y);
+   pos = Screen::getPosition(x, y);
 
    // VERIFY
    assertUnit(pos.colRow == 0x3f);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
 
 /*************************************
@@ -1399,22 +1400,22 @@ void PositionTest::setXY_invalidYMax()
 {
    // SETUP
    Position pos;
-   double squareWidth = pos.squareWidth;
-   double squareHeight = pos.squareHeight;
+   double squareWidth = Screen::squareWidth;
+   double squareHeight = Screen::squareHeight;
 
    pos.colRow = 0x46;
-   pos.squareWidth = 17;
-   pos.squareHeight = 37;
+   Screen::squareWidth = 17;
+   Screen::squareHeight = 37;
    int x = 17 + (17 * 3) + 15;
    int y = 37 + (37 * 8) + 2;
 
    // EXERCISE
-   pos.setXY(x, y);
+   pos = Screen::getPosition(x, y);
 
    // VERIFY
    assertUnit(pos.colRow == 0x3f);
 
    // TEARDOWN
-   pos.squareWidth = squareWidth;
-   pos.squareHeight = squareHeight;
+   Screen::squareWidth = squareWidth;
+   Screen::squareHeight = squareHeight;
 }
\ No newline at end of file
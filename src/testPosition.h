@@ -22,73 +22,73 @@ public:
    {
       reset();
       // get
-      getRow_zero();
-      getCol_zero();
-      getLocation_zero();
-      isValid_zero();
-      isInvalid_zero();
+      timeTest(getRow_zero);
+      timeTest(getCol_zero);
+      timeTest(getLocation_zero);
+      timeTest(isValid_zero);
+      timeTest(isInvalid_zero);
       
       
-      getRow_middle();
-      getCol_middle();
-      getLocation_middle();
-      isValid_middle();
-      isInvalid_middle();
+      timeTest(getRow_middle);
+      timeTest(getCol_middle);
+      timeTest(getLocation_middle);
+      timeTest(isValid_middle);
+      timeTest(isInvalid_middle);
       
-      getRow_end();
-      getCol_end();
-      getLocation_end();
-      isValid_end();
-      isInvalid_end();
+      timeTest(getRow_end);
+      timeTest(getCol_end);
+      timeTest(getLocation_end);
+      timeTest(isValid_end);
+      timeTest(isInvalid_end);
       
-      getRow_invalid();
-      getCol_invalid();
-      isValid_invalid();
-      isInvalid_invalid();
+      timeTest(getRow_invalid);
+      timeTest(getCol_invalid);
+      timeTest(isValid_invalid);
+      timeTest(isInvalid_invalid);
       
-      getRow_rowInvalid();
-      getCol_rowInvalid();
-      isValid_rowInvalid();
-      isInvalid_rowInvalid();
-      getRow_colInvalid();
-      getCol_colInvalid();
-      isValid_colInvalid();
-      isInvalid_colInvalid();
+      timeTest(getRow_rowInvalid);
+      timeTest(getCol_rowInvalid);
+      timeTest(isValid_rowInvalid);
+      timeTest(isInvalid_rowInvalid);
+      timeTest(getRow_colInvalid);
+      timeTest(getCol_colInvalid);
+      timeTest(isValid_colInvalid);
+      timeTest(isInvalid_colInvalid);
 
       // set
-      set_col();
-      set_row();
-      set_both();
-      set_text();
-      set_string();
-      set_copy();
+      timeTest(set_col);
+      timeTest(set_row);
+      timeTest(set_both);
+      timeTest(set_text);
+      timeTest(set_string);
+      timeTest(set_copy);
          
       // adjust
-      adjust_addColumn();
-      adjust_addRow();
-      adjust_offRight();
-      adjust_offTop();
-      adjust_offLeft();
-      adjust_offBottom();
-      adjust_invalid();
+      timeTest(adjust_addColumn);
+      timeTest(adjust_addRow);
+      timeTest(adjust_offRight);
+      timeTest(adjust_offTop);
+      timeTest(adjust_offLeft);
+      timeTest(adjust_offBottom);
+      timeTest(adjust_invalid);
 
       // pixels vs coordinates
-      getX_a1();
-      getY_a1();
-      getX_e7();
-      getY_e7();
-      getWidth_10();
-      getHeight_10();
-      setBoardWidthHeight_10();
-      setBoardWidthHeight_420x830();
-      setXY_a8();
-      setXY_a1();
-      setXY_h8();
-      setXY_h1();
-      setXY_invalidXMin();
-      setXY_invalidXMax();
-      setXY_invalidYMin();
-      setXY_invalidYMax();
+      timeTest(getX_a1);
+      timeTest(getY_a1);
+      timeTest(getX_e7);
+      timeTest(getY_e7);
+      timeTest(getWidth_10);
+      timeTest(getHeight_10);
+      timeTest(setBoardWidthHeight_10);
+      timeTest(setBoardWidthHeight_420x830);
+      timeTest(setXY_a8);
+      timeTest(setXY_a1);
+      timeTest(setXY_h8);
+      timeTest(setXY_h1);
+      timeTest(setXY_invalidXMin);
+      timeTest(setXY_invalidXMax);
+      timeTest(setXY_invalidYMin);
+      timeTest(setXY_invalidYMax);
       
       report("Position");
    }
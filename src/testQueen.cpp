@@ -47,6 +47,7 @@ void TestQueen::getMoves_blocked()
    White p8(PAWN); board.board[3][2] = &p8; // d3
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    queen.getMoves(moves, board);
@@ -88,6 +89,7 @@ void TestQueen::getMoves_slideToEnd()
    board.board[2][1] = &queen;
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    queen.getMoves(moves, board);
@@ -159,6 +161,7 @@ void TestQueen::getMoves_slideToBlock()
    White p7(PAWN); board.board[7][6] = &p7; // h7
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    queen.getMoves(moves, board);
@@ -238,6 +241,7 @@ void TestQueen::getMoves_slideToCapture()
    Black p8(PAWN); board.board[7][6] = &p8; // h2
 
    set<Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    queen.getMoves(moves, board);
@@ -0,0 +1,256 @@
+/***********************************************************************
+ * Source File:
+ *    TEST RASTER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the software raster graphics stream
+ ************************************************************************/
+
+#include "testRaster.h"
+#include "uiRaster.h"
+#include "board.h"
+#include "position.h"
+#include <sstream>
+#include <string>
+#include <cassert>
+using namespace std;
+
+/***************************************************
+ * TEST RASTER : IS COLOR
+ * Is one pixel this opaque color?
+ ***************************************************/
+bool TestRaster::isColor(const ogstreamRaster& raster, int x, int y,
+                         int red, int green, int blue)
+{
+   uint8_t rgba[4];
+   raster.getPixel(x, y, rgba);
+   return rgba[0] == red && rgba[1] == green && rgba[2] == blue &&
+          rgba[3] == 255;
+}
+
+/***************************************************
+ * TEST RASTER : CHECKSUM
+ * FNV-1a over every byte of the framebuffer
+ ***************************************************/
+uint32_t TestRaster::checksum(const ogstreamRaster& raster)
+{
+   uint32_t hash = 2166136261u;
+   size_t size = (size_t)raster.getWidth() * raster.getHeight() * 4;
+   for (size_t i = 0; i < size; i++)
+   {
+      hash ^= raster.getPixels()[i];
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
+/***************************************************
+ * RUN
+ ***************************************************/
+void TestRaster::run()
+{
+   // the framebuffer
+   timeTest(construct_black);
+   timeTest(display_squares);
+   timeTest(display_highlights);
+   timeTest(display_golden);
+   timeTest(display_repeatable);
+
+   // the files
+   timeTest(writePPM_header);
+   timeTest(writePNG_chunks);
+   timeTest(write_badFile);
+
+   report("Raster");
+}
+
+/*************************************
+ * CONSTRUCT black
+ * Input:  nothing
+ * Output: the size of the window, all opaque black
+ **************************************/
+void TestRaster::construct_black()
+{
+   // SETUP
+   // EXERCISE
+   ogstreamRaster raster;
+
+   // VERIFY
+   assertUnit(raster.getWidth()  == 10 * SIZE_SQUARE);
+   assertUnit(raster.getHeight() == 10 * SIZE_SQUARE);
+   assertUnit(isColor(raster, 0, 0, 0, 0, 0));
+   assertUnit(isColor(raster, 160, 160, 0, 0, 0));
+   assertUnit(isColor(raster, 319, 319, 0, 0, 0));
+}  // TEARDOWN
+
+/*************************************
+ * DISPLAY squares
+ * Input:  the starting position
+ * Output: a1 is dark, b1 is light, the rook on a1
+ *         is cream with a dark outline
+ **************************************/
+void TestRaster::display_squares()
+{
+   // SETUP
+   ogstreamRaster raster;
+   Board board(&raster);
+
+   // EXERCISE
+   board.display(Position(), Position());
+   raster.flush();
+
+   // VERIFY
+   assertUnit(isColor(raster, 40, 40, 120, 75, 35));     // a1
+   assertUnit(isColor(raster, 68, 36, 189, 159, 120));   // b1
+   assertUnit(isColor(raster, 48, 48, 239, 239, 229));   // rook on a1
+   assertUnit(isColor(raster, 80, 48, 60, 60, 60));      // knight's outline
+   assertUnit(isColor(raster, 176, 144, 189, 159, 120)); // empty e4
+}  // TEARDOWN
+
+/*************************************
+ * DISPLAY highlights
+ * Input:  hover over e2, select the knight on b1
+ * Output: the hover frame, the selected square,
+ *         and the knight's move to a3
+ **************************************/
+void TestRaster::display_highlights()
+{
+   // SETUP
+   ogstreamRaster raster;
+   Board board(&raster);
+
+   // EXERCISE
+   board.display(Position("e2"), Position("b1"));
+   raster.flush();
+
+   // VERIFY
+   assertUnit(isColor(raster, 161, 65, 204, 132, 63));   // e2 frame
+   assertUnit(isColor(raster, 176, 80, 239, 239, 229) ||
+              isColor(raster, 176, 80, 60, 60, 60));     // e2 pawn
+   assertUnit(isColor(raster, 68, 36, 200, 173, 67));    // b1 selected
+   assertUnit(isColor(raster, 48, 112, 179, 149, 50));   // a3 possible
+   assertUnit(isColor(raster, 112, 112, 179, 149, 50));  // c3 possible
+}  // TEARDOWN
+
+/*************************************
+ * DISPLAY golden
+ * Input:  the starting position
+ * Output: exactly the image we have always drawn.
+ *         If the drawing changes on purpose, this
+ *         value changes with it
+ **************************************/
+void TestRaster::display_golden()
+{
+   // SETUP
+   ogstreamRaster raster;
+   Board board(&raster);
+
+   // EXERCISE
+   board.display(Position(), Position());
+   raster.flush();
+
+   // VERIFY
+   assertUnit(checksum(raster) == 0x8cfaf263);
+}  // TEARDOWN
+
+/*************************************
+ * DISPLAY repeatable
+ * Input:  draw a checkmate, clear, and draw it again
+ * Output: the same pixels both times, and not
+ *         those of the starting position
+ **************************************/
+void TestRaster::display_repeatable()
+{
+   // SETUP
+   ogstreamRaster raster;
+   Board board(&raster);
+   board.readFEN("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3");
+   board.display(Position(), Position());
+   raster.flush();
+   uint32_t first = checksum(raster);
+
+   // EXERCISE
+   raster.clear();
+   board.display(Position(), Position());
+   raster.flush();
+
+   // VERIFY
+   assertUnit(checksum(raster) == first);
+   assertUnit(checksum(raster) != 0x8cfaf263);
+}  // TEARDOWN
+
+/*************************************
+ * WRITE PPM header
+ * Input:  a 3x2 image
+ * Output: "P6 3 2 255" and then 18 bytes, top row first
+ **************************************/
+void TestRaster::writePPM_header()
+{
+   // SETUP
+   ogstreamRaster raster(3, 2);
+   raster.plot(0, 1, (const unsigned char*)"\x11\x22\x33\xff");
+   ostringstream out;
+
+   // EXERCISE
+   raster.writePPM(out);
+
+   // VERIFY
+   string text = out.str();
+   assertUnit(text.size() == 11 + 18);
+   assertUnit(text.substr(0, 11) == "P6\n3 2\n255\n");
+   assertUnit(text.substr(11, 3) == "\x11\x22\x33");
+   assertUnit(text.substr(14, 3) == string(3, '\0'));
+}  // TEARDOWN
+
+/*************************************
+ * WRITE PNG chunks
+ * Input:  a 3x2 image
+ * Output: the signature, an IHDR with the size and
+ *         RGBA, and the standard IEND chunk
+ **************************************/
+void TestRaster::writePNG_chunks()
+{
+   // SETUP
+   ogstreamRaster raster(3, 2);
+   ostringstream out;
+
+   // EXERCISE
+   raster.writePNG(out);
+
+   // VERIFY
+   string data = out.str();
+   assertUnit(data.substr(0, 8) == "\x89PNG\r\n\x1a\n");
+   assertUnit(data.substr(8, 8) == string("\0\0\0\x0dIHDR", 8));
+   assertUnit(data.substr(16, 8) == string("\0\0\0\x03\0\0\0\x02", 8));
+   assertUnit(data[24] == 8);    // bits per channel
+   assertUnit(data[25] == 6);    // RGBA
+   assertUnit(data.size() > 12 &&
+              data.substr(data.size() - 12) ==
+              string("\0\0\0\0IEND\xae\x42\x60\x82", 12));
+}  // TEARDOWN
+
+/*************************************
+ * WRITE bad file
+ * Input:  a file in a directory that does not exist
+ * Output: a string is thrown
+ **************************************/
+void TestRaster::write_badFile()
+{
+   // SETUP
+   ogstreamRaster raster(3, 2);
+   bool thrown = false;
+
+   // EXERCISE
+   try
+   {
+      raster.write("/no/such/directory/board.png");
+   }
+   catch (const string&)
+   {
+      thrown = true;
+   }
+
+   // VERIFY
+   assertUnit(thrown);
+}  // TEARDOWN
@@ -0,0 +1,42 @@
+/***********************************************************************
+ * Header File:
+ *    TEST RASTER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the software raster graphics stream
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "unitTest.h"
+
+class ogstreamRaster;
+
+/***************************************************
+ * RASTER TEST
+ * Test the framebuffer and the image writers
+ ***************************************************/
+class TestRaster : public UnitTest
+{
+public:
+   void run();
+
+private:
+   // the framebuffer
+   void construct_black();
+   void display_squares();
+   void display_highlights();
+   void display_golden();
+   void display_repeatable();
+
+   // the files
+   void writePPM_header();
+   void writePNG_chunks();
+   void write_badFile();
+
+   static bool     isColor(const ogstreamRaster& raster, int x, int y,
+                           int red, int green, int blue);
+   static uint32_t checksum(const ogstreamRaster& raster);
+};
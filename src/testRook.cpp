@@ -41,6 +41,7 @@ void TestRook::getMoves_blocked()
    White w3(PAWN); board.board[2][2] = &w3; // c3
    White w4(PAWN); board.board[3][1] = &w4; // d2
    set <Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    rook.getMoves(moves, board);
@@ -82,6 +83,7 @@ void TestRook::getMoves_slideToEnd()
    Rook rook(Position(2, 1), true /*white*/);
    board.board[2][1] = &rook; // c2
    set <Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    rook.getMoves(moves, board);
@@ -137,6 +139,7 @@ void TestRook::getMoves_slideToBlock()
    White w3(PAWN); board.board[2][7] = &w3; // c8
    White w4(PAWN); board.board[7][1] = &w4; // h2
    set <Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    rook.getMoves(moves, board);
@@ -195,6 +198,7 @@ void TestRook::getMoves_slideToCapture()
    Black w3(PAWN); board.board[2][7] = &w3; // c8
    Black w4(PAWN); board.board[7][1] = &w4; // h2
    set <Move> moves;
+   board.syncOccupied();
 
    // EXERCISE
    rook.getMoves(moves, board);
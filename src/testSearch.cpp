@@ -0,0 +1,262 @@
+/***********************************************************************
+ * Source File:
+ *    TEST SEARCH
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the search and the background analysis
+ ************************************************************************/
+
+#include "testSearch.h"
+#include "search.h"
+#include "analysis.h"
+#include "board.h"
+#include "boardSnapshot.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/***************************************************
+ * RUN
+ ***************************************************/
+void TestSearch::run()
+{
+   timeTest(run_mateInOne);
+   timeTest(run_winsQueen);
+   timeTest(run_reportsEachDepth);
+   timeTest(run_seesRepetition);
+   timeTest(stop_beforeRun);
+   timeTest(stop_fromOtherThread);
+   timeTest(analysis_status);
+   timeTest(analysis_restart);
+
+   report("Search");
+}
+
+/*************************************
+ * RUN mate in one
+ * Input:  the black king is shut in by its own pawns
+ *         and the white rook can reach the back rank
+ *         +---a-b-c-d-e-f-g-h---+
+ *         |                     |
+ *         8                 K   8
+ *         7               P P P 7
+ *         1 r             k     1
+ *         |                     |
+ *         +---a-b-c-d-e-f-g-h---+
+ * Output: Ra8 is mate in one
+ **************************************/
+void TestSearch::run_mateInOne()
+{
+   // SETUP
+   Search search;
+
+   // EXERCISE
+   SearchResult result = search.run("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", 3);
+
+   // VERIFY
+   assertUnit(result.bestMove == Move("a1a8"));
+   assertUnit(result.score == SCORE_MATE - 1);
+   assertUnit(Search::isMateScore(result.score));
+   assertUnit(Search::getMateMoves(result.score) == 1);
+   assertUnit(result.depth == 1);
+}  // TEARDOWN
+
+/*************************************
+ * RUN wins queen
+ * Input:  the black queen on d5 is attacked by the
+ *         knight on c3 and defended by nothing
+ * Output: Nxd5, and white is well ahead
+ **************************************/
+void TestSearch::run_winsQueen()
+{
+   // SETUP
+   Search search;
+
+   // EXERCISE
+   SearchResult result = search.run("4k3/8/8/3q4/8/2N5/8/4K3 w - - 0 1", 2);
+
+   // VERIFY
+   assertUnit(result.bestMove == Move("c3d5q"));
+   assertUnit(result.score > 200);
+   assertUnit(result.depth == 2);
+   assertUnit(result.numNodes > 0);
+}  // TEARDOWN
+
+/*************************************
+ * RUN reports each depth
+ * Input:  the start, three plies deep
+ * Output: one report per depth, in order, each with
+ *         more nodes than the last
+ **************************************/
+void TestSearch::run_reportsEachDepth()
+{
+   // SETUP
+   Search search;
+   vector<SearchResult> results;
+
+   // EXERCISE
+   search.run("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 3,
+              [&results](const SearchResult& result) { results.push_back(result); });
+
+   // VERIFY
+   assertUnit(results.size() == 3);
+   for (size_t i = 0; i < results.size(); i++)
+   {
+      assertUnit(results[i].depth == (int)i + 1);
+      assertUnit(results[i].bestMove.getSource().isValid());
+   }
+   if (results.size() == 3)
+      assertUnit(results[2].numNodes > results[1].numNodes);
+}  // TEARDOWN
+
+/*************************************
+ * RUN sees repetition
+ * Input:  black, a queen down, has shuffled its king
+ *         between d8 and e8 while the queen went between
+ *         a1 and a2. Kd8 now repeats a position a third time
+ *         +---a-b-c-d-e-f-g-h---+
+ *         |                     |
+ *         8         k           8
+ *         1 Q       K           1
+ *         |                     |
+ *         +---a-b-c-d-e-f-g-h---+
+ * Output: from the board, Kd8 and a draw. From its FEN,
+ *         which has no history, black is lost
+ **************************************/
+void TestSearch::run_seesRepetition()
+{
+   // SETUP
+   Board board;
+   board.readFEN("3k4/8/8/8/8/8/8/Q3K3 w - - 0 1");
+   for (const char* text : { "a1a2", "d8e8", "a2a1", "e8d8",
+                             "a1a2", "d8e8", "a2a1" })
+      board.move(Move(text));
+   Search search;
+
+   // EXERCISE
+   SearchResult result = search.run(board, 1);
+   SearchResult resultFEN = search.run(board.getFEN(), 1);
+
+   // VERIFY
+   assertUnit(!board.isDrawClaimable());
+   assertUnit(result.bestMove.getText() == "e8d8");
+   assertUnit(result.score == 0);
+   assertUnit(resultFEN.score < -500);
+}  // TEARDOWN
+
+/*************************************
+ * STOP before run
+ * Input:  stop() is called before run()
+ * Output: no depth is finished and there is no move
+ **************************************/
+void TestSearch::stop_beforeRun()
+{
+   // SETUP
+   Search search;
+   search.stop();
+
+   // EXERCISE
+   SearchResult result = search.run("4k3/8/8/3q4/8/2N5/8/4K3 w - - 0 1", 4);
+
+   // VERIFY
+   assertUnit(search.isStopped());
+   assertUnit(result.depth == 0);
+   assertUnit(result.bestMove.getSource().isInvalid());
+}  // TEARDOWN
+
+/*************************************
+ * STOP from other thread
+ * Input:  a search of the start as deep as it can go,
+ *         stopped from this thread once depth 2 is in
+ * Output: run() returns promptly with the last depth
+ *         it finished
+ **************************************/
+void TestSearch::stop_fromOtherThread()
+{
+   // SETUP
+   Search search;
+   SearchResult result;
+   atomic<int> depth(0);
+   thread searcher([&]()
+   {
+      result = search.run("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 32,
+                          [&depth](const SearchResult& r) { depth = r.depth; });
+   });
+   while (depth < 2)
+      this_thread::sleep_for(chrono::milliseconds(1));
+
+   // EXERCISE
+   auto start = chrono::steady_clock::now();
+   search.stop();
+   searcher.join();
+   auto elapsed = chrono::steady_clock::now() - start;
+
+   // VERIFY
+   assertUnit(elapsed < chrono::milliseconds(250));
+   assertUnit(result.depth >= 2);
+   assertUnit(result.depth < 32);
+   assertUnit(result.bestMove.getSource().isValid());
+}  // TEARDOWN
+
+/*************************************
+ * ANALYSIS status
+ * Input:  the mate in one, analyzed in the background
+ * Output: the status soon shows the mate, with the move in SAN
+ **************************************/
+void TestSearch::analysis_status()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.readFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+   Analysis analysis;
+   string status;
+
+   // EXERCISE
+   analysis.start(board.getSnapshot(), board.getHistory());
+   for (int i = 0; i < 2000 && status.empty(); i++)
+   {
+      this_thread::sleep_for(chrono::milliseconds(1));
+      status = analysis.getStatus();
+   }
+
+   // VERIFY
+   assertUnit(status == "Ra8  #1  depth 1");
+}  // TEARDOWN
+
+/*************************************
+ * ANALYSIS restart
+ * Input:  the start is being analyzed when 1.e4 is
+ *         played, then the analysis is stopped
+ * Output: the status is cleared on the move, then
+ *         shows black's reply, then is cleared again
+ **************************************/
+void TestSearch::analysis_restart()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+   Analysis analysis;
+   analysis.start(board.getSnapshot(), board.getHistory());
+   this_thread::sleep_for(chrono::milliseconds(20));
+
+   // EXERCISE
+   board.move(Move("e2e4"));
+   analysis.start(board.getSnapshot(), board.getHistory());
+   string statusCleared = analysis.getStatus();
+   string status;
+   for (int i = 0; i < 2000 && status.empty(); i++)
+   {
+      this_thread::sleep_for(chrono::milliseconds(1));
+      status = analysis.getStatus();
+   }
+   analysis.stop();
+
+   // VERIFY
+   assertUnit(statusCleared.empty());
+   assertUnit(!status.empty());
+   assertUnit(status.find("e4") == string::npos);   // black's move, not white's
+   assertUnit(analysis.getStatus().empty());
+}  // TEARDOWN
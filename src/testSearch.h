@@ -0,0 +1,34 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SEARCH
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the search and the background analysis
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+
+/***************************************************
+ * SEARCH TEST
+ * Test finding mates and captures, reporting each
+ * depth, seeing repetitions, and stopping from
+ * another thread
+ ***************************************************/
+class TestSearch : public UnitTest
+{
+public:
+   void run();
+
+private:
+   void run_mateInOne();
+   void run_winsQueen();
+   void run_reportsEachDepth();
+   void run_seesRepetition();
+   void stop_beforeRun();
+   void stop_fromOtherThread();
+   void analysis_status();
+   void analysis_restart();
+};
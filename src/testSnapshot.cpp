@@ -0,0 +1,172 @@
+/***********************************************************************
+ * Source File:
+ *    TEST SNAPSHOT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the board snapshot
+ ************************************************************************/
+
+#include "testSnapshot.h"
+#include "boardSnapshot.h"
+#include "board.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/***************************************************
+ * RUN
+ ***************************************************/
+void TestSnapshot::run()
+{
+   timeTest(construct_start);
+   timeTest(getFEN_matchesBoard);
+   timeTest(publish_afterMove);
+   timeTest(publish_notByCopy);
+   timeTest(readers_concurrent);
+
+   report("Snapshot");
+}
+
+/*************************************
+ * CONSTRUCT start
+ * Input:  a new board
+ * Output: its snapshot has every piece, white to move,
+ *         every castling right, and the board's key
+ **************************************/
+void TestSnapshot::construct_start()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+
+   // EXERCISE
+   shared_ptr<const BoardSnapshot> pSnapshot = board.getSnapshot();
+
+   // VERIFY
+   assertUnit(pSnapshot != nullptr);
+   assertUnit(pSnapshot->whiteTurn());
+   assertUnit(pSnapshot->getCurrentMove() == 0);
+   assertUnit(pSnapshot->getCastlingRights() == CASTLE_ALL);
+   assertUnit(pSnapshot->getEnPassant().isInvalid());
+   assertUnit(pSnapshot->getKey() == board.getKey());
+   assertUnit(countSquares(pSnapshot->getPosition().getPieces(true))  == 16);
+   assertUnit(countSquares(pSnapshot->getPosition().getPieces(false)) == 16);
+}  // TEARDOWN
+
+/*************************************
+ * GET FEN matches board
+ * Input:  a FEN with every field set
+ * Output: the snapshot writes it back unchanged
+ **************************************/
+void TestSnapshot::getFEN_matchesBoard()
+{
+   // SETUP
+   const string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b Kq - 7 23";
+   Board board(nullptr, true /*noreset*/);
+   board.readFEN(fen);
+
+   // EXERCISE
+   string fenSnapshot = board.getSnapshot()->getFEN();
+
+   // VERIFY
+   assertUnit(fenSnapshot == fen);
+}  // TEARDOWN
+
+/*************************************
+ * PUBLISH after move
+ * Input:  a snapshot is held while 1.e4 is played
+ * Output: the held one still shows the start; the new
+ *         one shows e4 with e3 as the en passant square
+ **************************************/
+void TestSnapshot::publish_afterMove()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+   shared_ptr<const BoardSnapshot> pBefore = board.getSnapshot();
+   string fenBefore = pBefore->getFEN();
+
+   // EXERCISE
+   board.move(Move("e2e4"));
+   shared_ptr<const BoardSnapshot> pAfter = board.getSnapshot();
+
+   // VERIFY
+   assertUnit(pAfter != pBefore);
+   assertUnit(pBefore->getFEN() == fenBefore);
+   assertUnit(pAfter->getFEN() ==
+              "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+   assertUnit(pAfter->getKey() == board.getKey());
+}  // TEARDOWN
+
+/*************************************
+ * PUBLISH not by copy
+ * Input:  a copy of a board plays e2e4
+ * Output: the copy has no snapshot, and the board's
+ *         snapshot is still the start
+ **************************************/
+void TestSnapshot::publish_notByCopy()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+   shared_ptr<const BoardSnapshot> pBefore = board.getSnapshot();
+   Board copy(board);
+
+   // EXERCISE
+   copy.move(Move("e2e4"));
+
+   // VERIFY
+   assertUnit(copy.getSnapshot() == nullptr);
+   assertUnit(board.getSnapshot() == pBefore);
+   assertUnit(copy.getFEN() ==
+              "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+}  // TEARDOWN
+
+/*************************************
+ * READERS concurrent
+ * Input:  four threads copy the latest snapshot over and
+ *         over while the knights go out and back
+ * Output: every copy is a whole position: sixteen pieces
+ *         a side, and the side to move agrees with the
+ *         move number
+ **************************************/
+void TestSnapshot::readers_concurrent()
+{
+   // SETUP
+   Board board(nullptr, true /*noreset*/);
+   const char* moves[] = { "g1f3", "g8f6", "f3g1", "f6g8" };
+   atomic<bool> isDone(false);
+   atomic<int>  numBad(0);
+   atomic<int>  numRead(0);
+   vector<thread> readers;
+   for (int i = 0; i < 4; i++)
+      readers.push_back(thread([&]()
+      {
+         while (!isDone)
+         {
+            BoardSnapshot snapshot = *board.getSnapshot();
+            if (countSquares(snapshot.getPosition().getPieces(true))  != 16 ||
+                countSquares(snapshot.getPosition().getPieces(false)) != 16 ||
+                snapshot.whiteTurn() != (snapshot.getCurrentMove() % 2 == 0))
+               numBad++;
+            numRead++;
+         }
+      }));
+   
+   // the moves are quick, so let the readers get going first
+   while (numRead == 0)
+      this_thread::yield();
+
+   // EXERCISE
+   for (int i = 0; i < 400; i++)
+      board.move(Move(moves[i % 4]));
+   isDone = true;
+   for (thread& reader : readers)
+      reader.join();
+
+   // VERIFY
+   assertUnit(numBad == 0);
+   assertUnit(numRead > 0);
+   assertUnit(board.getSnapshot()->getCurrentMove() == 400);
+}  // TEARDOWN
@@ -0,0 +1,30 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SNAPSHOT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the board snapshot
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+
+/***************************************************
+ * SNAPSHOT TEST
+ * Test taking a snapshot, publishing one after each
+ * move, and reading them from other threads
+ ***************************************************/
+class TestSnapshot : public UnitTest
+{
+public:
+   void run();
+
+private:
+   void construct_start();
+   void getFEN_matchesBoard();
+   void publish_afterMove();
+   void publish_notByCopy();
+   void readers_concurrent();
+};
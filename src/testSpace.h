@@ -23,10 +23,10 @@ public:
 
    void run()
    {
-      construct_a1();
-      construct_h8();
-      construct_a8();
-      getType();
+      timeTest(construct_a1);
+      timeTest(construct_h8);
+      timeTest(construct_a8);
+      timeTest(getType);
 
       report("Space");
    }
@@ -0,0 +1,331 @@
+/***********************************************************************
+ * Source File:
+ *    TEST TABLEBASE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the compressed tablebase
+ ************************************************************************/
+
+#include "testTablebase.h"
+#include "tablebase.h"
+#include "bitbase.h"
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+using namespace std;
+
+/***************************************************
+ * TEST TABLEBASE : ROUND TRIP
+ * Compress and expand a buffer
+ ***************************************************/
+vector<uint8_t> TestTablebase::roundTrip(const vector<uint8_t>& in, size_t& sizeCompressed)
+{
+   vector<uint8_t> compressed;
+   Tablebase::compressBlock(in.data(), in.size(), compressed);
+   sizeCompressed = compressed.size();
+   vector<uint8_t> out(in.size());
+   Tablebase::decompressBlock(compressed.data(), compressed.size(),
+                              out.data(), out.size());
+   return out;
+}
+
+/***************************************************
+ * RUN
+ ***************************************************/
+void TestTablebase::run()
+{
+   BitbaseSet set;
+   set.generate("KPK");
+   pSet = &set;
+
+   // the block codec
+   timeTest(codec_runs);
+   timeTest(codec_literals);
+   timeTest(codec_corrupt);
+
+   // the file
+   timeTest(open_badMagic);
+   timeTest(write_sameValues);
+   timeTest(load_probe);
+
+   // the cache
+   timeTest(cache_evicts);
+   timeTest(cache_keepsRecent);
+   timeTest(cache_threads);
+
+   pSet = nullptr;
+   report("Tablebase");
+}
+
+/*************************************
+ * CODEC runs
+ * Input:  runs of 1, 2, 3, 130, and 131 equal bytes
+ * Output: unchanged after the round trip, and long runs shrink
+ **************************************/
+void TestTablebase::codec_runs()
+{
+   // SETUP
+   vector<uint8_t> in;
+   in.insert(in.end(), 1,   0x11);
+   in.insert(in.end(), 2,   0x22);
+   in.insert(in.end(), 3,   0x33);
+   in.insert(in.end(), 130, 0x44);
+   in.insert(in.end(), 131, 0x55);
+   size_t sizeCompressed = 0;
+
+   // EXERCISE
+   vector<uint8_t> out = roundTrip(in, sizeCompressed);
+
+   // VERIFY
+   assertUnit(out == in);
+   assertUnit(sizeCompressed < 20);
+}  // TEARDOWN
+
+/*************************************
+ * CODEC literals
+ * Input:  1000 random bytes
+ * Output: unchanged after the round trip, at most 1/128 larger
+ **************************************/
+void TestTablebase::codec_literals()
+{
+   // SETUP
+   mt19937 random(7);
+   vector<uint8_t> in(1000);
+   for (uint8_t& byte : in)
+      byte = (uint8_t)random();
+   size_t sizeCompressed = 0;
+
+   // EXERCISE
+   vector<uint8_t> out = roundTrip(in, sizeCompressed);
+
+   // VERIFY
+   assertUnit(out == in);
+   assertUnit(sizeCompressed <= in.size() + in.size() / 128 + 1);
+}  // TEARDOWN
+
+/*************************************
+ * CODEC corrupt
+ * Input:  a run that overflows the output
+ * Output: throws
+ **************************************/
+void TestTablebase::codec_corrupt()
+{
+   // SETUP
+   uint8_t in[] = { 200, 0x12 };   // 75 copies
+   uint8_t out[10];
+   bool thrown = false;
+
+   // EXERCISE
+   try
+   {
+      Tablebase::decompressBlock(in, sizeof(in), out, sizeof(out));
+   }
+   catch (const string&)
+   {
+      thrown = true;
+   }
+
+   // VERIFY
+   assertUnit(thrown);
+}  // TEARDOWN
+
+/*************************************
+ * OPEN bad magic
+ * Input:  a raw bitbase header
+ * Output: throws and the table is closed
+ **************************************/
+void TestTablebase::open_badMagic()
+{
+   // SETUP
+   string data = "CBB1KPK" + string(40, '\0');
+   Tablebase table;
+   bool thrown = false;
+
+   // EXERCISE
+   try
+   {
+      table.open((const uint8_t*)data.data(), data.size());
+   }
+   catch (const string&)
+   {
+      thrown = true;
+   }
+
+   // VERIFY
+   assertUnit(thrown);
+   assertUnit(!table.isOpen());
+}  // TEARDOWN
+
+/*************************************
+ * WRITE same values
+ * Input:  KPK compressed in 256-byte blocks
+ * Output: every position reads back the same, in less space
+ **************************************/
+void TestTablebase::write_sameValues()
+{
+   // SETUP
+   const Bitbase* pBase = pSet->find("KPK");
+   assert(pBase);
+   ostringstream out;
+   Tablebase table(1 << 20);
+   size_t numWrong = 0;
+
+   // EXERCISE
+   Tablebase::write(*pBase, out, 256);
+   string data = out.str();
+   table.open((const uint8_t*)data.data(), data.size());
+   for (size_t index = 0; index < pBase->size(); index++)
+      if (table.get(index) != pBase->get(index))
+         numWrong++;
+
+   // VERIFY
+   assertUnit(table.getSignature() == "KPK");
+   assertUnit(table.size() == pBase->size());
+   assertUnit(numWrong == 0);
+   assertUnit(data.size() < pBase->getNumBytes());
+   assertUnit(table.getNumMisses() == table.numBlocks);
+}  // TEARDOWN
+
+/*************************************
+ * LOAD and PROBE
+ * Input:  KPK written to a file and mapped through a BitbaseSet
+ * Output: the opposition position probes the same both ways
+ **************************************/
+void TestTablebase::load_probe()
+{
+   // SETUP
+   const Bitbase* pBase = pSet->find("KPK");
+   assert(pBase);
+   string fileName = string(P_tmpdir) + "/testTablebase.cbz";
+   BitbaseSet loaded;
+   BitbasePosition pos;
+   pos.numPieces = 3;
+   pos.whiteToMove = false;
+   pos.type[0] = KING;  pos.isWhite[0] = true;  pos.square[0] = 4 * 8 + 4;  // e5
+   pos.type[1] = PAWN;  pos.isWhite[1] = true;  pos.square[1] = 3 * 8 + 4;  // e4
+   pos.type[2] = KING;  pos.isWhite[2] = false; pos.square[2] = 6 * 8 + 4;  // e7
+   BitbaseValue value = BB_ILLEGAL;
+
+   // EXERCISE
+   Tablebase::write(*pBase, fileName);
+   loaded.loadTablebase(fileName);
+   bool found = loaded.probe(pos, value);
+   remove(fileName.c_str());
+
+   // VERIFY
+   assertUnit(found);
+   assertUnit(value == BB_LOSS);
+   assertUnit(loaded.find("KPK") == nullptr);
+}  // TEARDOWN
+
+/*************************************
+ * CACHE evicts
+ * Input:  a cache of one block per shard, two passes over the table
+ * Output: the second pass misses as often as the first
+ **************************************/
+void TestTablebase::cache_evicts()
+{
+   // SETUP
+   const Bitbase* pBase = pSet->find("KPK");
+   assert(pBase);
+   ostringstream out;
+   Tablebase::write(*pBase, out, 256);
+   string data = out.str();
+   Tablebase table(TABLEBASE_SHARDS);
+   table.open((const uint8_t*)data.data(), data.size());
+   size_t numBlocks = table.numBlocks;
+
+   // EXERCISE
+   for (int pass = 0; pass < 2; pass++)
+      for (size_t index = 0; index < table.size(); index += 256 * 4)
+         table.get(index);
+
+   // VERIFY
+   assertUnit(table.getNumMisses() == 2 * numBlocks);
+   size_t numCached = 0;
+   for (int i = 0; i < TABLEBASE_SHARDS; i++)
+      numCached += table.shards[i].blocks.size();
+   assertUnit(numCached <= TABLEBASE_SHARDS);
+}  // TEARDOWN
+
+/*************************************
+ * CACHE keeps recent
+ * Input:  two blocks per shard. Blocks A, B, and C all
+ *         fall in the first shard. A, B, A, then C
+ * Output: C pushes out B, which was used last longest
+ *         ago, so A still hits and B misses again
+ **************************************/
+void TestTablebase::cache_keepsRecent()
+{
+   // SETUP
+   const Bitbase* pBase = pSet->find("KPK");
+   assert(pBase);
+   ostringstream out;
+   Tablebase::write(*pBase, out, 256);
+   string data = out.str();
+   Tablebase table(2 * TABLEBASE_SHARDS);
+   table.open((const uint8_t*)data.data(), data.size());
+   const size_t A = 0;
+   const size_t B = 256 * 4 * TABLEBASE_SHARDS;
+   const size_t C = 256 * 4 * TABLEBASE_SHARDS * 2;
+   assert(table.numBlocks > 2 * TABLEBASE_SHARDS);
+   table.get(A);
+   table.get(B);
+   table.get(A);
+   table.get(C);
+
+   // EXERCISE
+   table.get(A);
+   size_t numMissesBefore = table.getNumMisses();
+   table.get(B);
+
+   // VERIFY
+   assertUnit(numMissesBefore == 3);
+   assertUnit(table.getNumHits() == 2);
+   assertUnit(table.getNumMisses() == 4);
+   assertUnit(table.shards[0].blocks.size() == 2);
+}  // TEARDOWN
+
+/*************************************
+ * CACHE threads
+ * Input:  four threads probing at random through a small cache
+ * Output: every probe agrees with the uncompressed table
+ **************************************/
+void TestTablebase::cache_threads()
+{
+   // SETUP
+   const Bitbase* pBase = pSet->find("KPK");
+   assert(pBase);
+   ostringstream out;
+   Tablebase::write(*pBase, out, 128);
+   string data = out.str();
+   Tablebase table(64);
+   table.open((const uint8_t*)data.data(), data.size());
+   atomic<int> numWrong(0);
+
+   // EXERCISE
+   vector<thread> threads;
+   for (int i = 0; i < 4; i++)
+      threads.push_back(thread([&, i]()
+      {
+         mt19937 random(i);
+         for (int j = 0; j < 20000; j++)
+         {
+            size_t index = random() % table.size();
+            if (table.get(index) != pBase->get(index))
+               numWrong++;
+         }
+      }));
+   for (thread& t : threads)
+      t.join();
+
+   // VERIFY
+   assertUnit(numWrong == 0);
+   assertUnit(table.getNumHits() + table.getNumMisses() == 80000);
+}  // TEARDOWN
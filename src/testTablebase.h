@@ -0,0 +1,47 @@
+/***********************************************************************
+ * Header File:
+ *    TEST TABLEBASE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the compressed tablebase
+ ************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "unitTest.h"
+
+class BitbaseSet;
+
+/***************************************************
+ * TABLEBASE TEST
+ * Test the codec, the file format, and the cache
+ ***************************************************/
+class TestTablebase : public UnitTest
+{
+public:
+   void run();
+
+private:
+   // the block codec
+   void codec_runs();
+   void codec_literals();
+   void codec_corrupt();
+
+   // the file
+   void open_badMagic();
+   void write_sameValues();
+   void load_probe();
+
+   // the cache
+   void cache_evicts();
+   void cache_keepsRecent();
+   void cache_threads();
+
+   static std::vector<uint8_t> roundTrip(const std::vector<uint8_t>& in,
+                                         size_t& sizeCompressed);
+
+   BitbaseSet* pSet;    // generated once and shared by the tests
+};
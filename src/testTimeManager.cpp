@@ -0,0 +1,300 @@
+/***********************************************************************
+ * Source File:
+ *    TEST TIME MANAGER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the time manager
+ ************************************************************************/
+
+#include "testTimeManager.h"
+#include "timeManager.h"
+#include "search.h"
+#include <chrono>
+#include <string>
+using namespace std;
+
+static const string FEN_START = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+/*************************************
+ * MAKE RESULT
+ * What an iteration of the search might report
+ **************************************/
+static SearchResult makeResult(const char* move, int score, int depth)
+{
+   SearchResult result;
+   result.bestMove = Move(move);
+   result.score = score;
+   result.depth = depth;
+   return result;
+}
+
+/***************************************************
+ * RUN
+ ***************************************************/
+void TestTimeManager::run()
+{
+   timeTest(construct_suddenDeath);
+   timeTest(construct_increment);
+   timeTest(construct_lastMove);
+   timeTest(construct_noTime);
+   timeTest(update_stable);
+   timeTest(update_bestMoveChanges);
+   timeTest(update_scoreDrops);
+   timeTest(update_neverPastHard);
+   timeTest(isHardLimitReached_everyNNodes);
+   timeTest(search_stopsAtHardLimit);
+   timeTest(search_finishesFirstIteration);
+   timeTest(search_reusedAfterTimeUp);
+
+   report("TimeManager");
+}
+
+/*************************************
+ * CONSTRUCT sudden death
+ * Input:  a minute left, no increment
+ * Output: less the overhead, a thirtieth is soft, and
+ *         four times that is hard
+ **************************************/
+void TestTimeManager::construct_suddenDeath()
+{
+   // SETUP
+   TimeControl timeControl(60000, 0);
+
+   // EXERCISE
+   TimeManager timeManager(timeControl);
+
+   // VERIFY
+   assertUnit(timeManager.getSoftLimit().count() == 1998);
+   assertUnit(timeManager.getHardLimit().count() == 7992);
+   assertUnit(timeManager.getSoftLimitAdjusted().count() == 1998);
+}  // TEARDOWN
+
+/*************************************
+ * CONSTRUCT increment
+ * Input:  ten seconds left and one more each move
+ * Output: the soft limit has three quarters of the
+ *         increment on top of its share of the clock
+ **************************************/
+void TestTimeManager::construct_increment()
+{
+   // SETUP
+   TimeControl timeControl(10000, 1000);
+
+   // EXERCISE
+   TimeManager timeManager(timeControl);
+
+   // VERIFY
+   assertUnit(timeManager.getSoftLimit().count() == 331 + 750);
+   assertUnit(timeManager.getHardLimit().count() == 4 * (331 + 750));
+}  // TEARDOWN
+
+/*************************************
+ * CONSTRUCT last move
+ * Input:  one move to go before the time control
+ * Output: both limits are all the time there is
+ **************************************/
+void TestTimeManager::construct_lastMove()
+{
+   // SETUP
+   TimeControl timeControl(1050, 0, 1 /*movesToGo*/);
+
+   // EXERCISE
+   TimeManager timeManager(timeControl);
+
+   // VERIFY
+   assertUnit(timeManager.getSoftLimit().count() == 1000);
+   assertUnit(timeManager.getHardLimit().count() == 1000);
+}  // TEARDOWN
+
+/*************************************
+ * CONSTRUCT no time
+ * Input:  less time than the overhead
+ * Output: both limits are zero, not negative
+ **************************************/
+void TestTimeManager::construct_noTime()
+{
+   // SETUP
+   TimeControl timeControl(30, 0);
+
+   // EXERCISE
+   TimeManager timeManager(timeControl);
+
+   // VERIFY
+   assertUnit(timeManager.getSoftLimit().count() == 0);
+   assertUnit(timeManager.getHardLimit().count() == 0);
+}  // TEARDOWN
+
+/*************************************
+ * UPDATE stable
+ * Input:  four iterations with the same best move
+ *         and the same score
+ * Output: the move held three times, so the soft
+ *         limit is down a fifth
+ **************************************/
+void TestTimeManager::update_stable()
+{
+   // SETUP
+   TimeManager timeManager(TimeControl(60000, 0));
+
+   // EXERCISE
+   for (int depth = 1; depth <= 4; depth++)
+      timeManager.update(makeResult("e2e4", 30, depth));
+
+   // VERIFY
+   assertUnit(timeManager.getSoftLimitAdjusted().count() == 1998 * 8 / 10);
+}  // TEARDOWN
+
+/*************************************
+ * UPDATE best move changes
+ * Input:  e4, then d4
+ * Output: half again as long
+ **************************************/
+void TestTimeManager::update_bestMoveChanges()
+{
+   // SETUP
+   TimeManager timeManager(TimeControl(60000, 0));
+   timeManager.update(makeResult("e2e4", 30, 1));
+
+   // EXERCISE
+   timeManager.update(makeResult("d2d4", 30, 2));
+
+   // VERIFY
+   assertUnit(timeManager.getSoftLimitAdjusted().count() == 1998 * 3 / 2);
+}  // TEARDOWN
+
+/*************************************
+ * UPDATE score drops
+ * Input:  e4 both times, but a pawn worse the second
+ * Output: half again as long, though the move held
+ **************************************/
+void TestTimeManager::update_scoreDrops()
+{
+   // SETUP
+   TimeManager timeManager(TimeControl(60000, 0));
+   timeManager.update(makeResult("e2e4", 50, 1));
+
+   // EXERCISE
+   timeManager.update(makeResult("e2e4", -50, 2));
+
+   // VERIFY
+   assertUnit(timeManager.getSoftLimitAdjusted().count() == 1998 * 3 / 2);
+}  // TEARDOWN
+
+/*************************************
+ * UPDATE never past hard
+ * Input:  two moves to go, and a search that changes
+ *         its mind and drops a rook
+ * Output: the soft limit stops at the hard limit
+ **************************************/
+void TestTimeManager::update_neverPastHard()
+{
+   // SETUP
+   TimeManager timeManager(TimeControl(1050, 0, 2 /*movesToGo*/));
+   timeManager.update(makeResult("e2e4", 0, 1));
+
+   // EXERCISE
+   timeManager.update(makeResult("d2d4", -500, 2));
+
+   // VERIFY
+   assertUnit(timeManager.getSoftLimit().count() == 500);
+   assertUnit(timeManager.getHardLimit().count() == 500);
+   assertUnit(timeManager.getSoftLimitAdjusted().count() == 500);
+}  // TEARDOWN
+
+/*************************************
+ * IS HARD LIMIT REACHED every N nodes
+ * Input:  no time at all
+ * Output: the clock is only read on a multiple of
+ *         TIME_CHECK_NODES, and then time is up
+ **************************************/
+void TestTimeManager::isHardLimitReached_everyNNodes()
+{
+   // SETUP
+   TimeManager timeManager(TimeControl(0, 0));
+
+   // EXERCISE
+   bool isReachedOne   = timeManager.isHardLimitReached(1);
+   bool isReachedOff   = timeManager.isHardLimitReached(TIME_CHECK_NODES + 1);
+   bool isReachedCheck = timeManager.isHardLimitReached(TIME_CHECK_NODES * 3);
+
+   // VERIFY
+   assertUnit(!isReachedOne);
+   assertUnit(!isReachedOff);
+   assertUnit(isReachedCheck);
+   assertUnit(timeManager.isSoftLimitReached());
+}  // TEARDOWN
+
+/*************************************
+ * SEARCH stops at hard limit
+ * Input:  the start, with a quarter second on the
+ *         clock and no depth limit worth the name
+ * Output: the search returns a move soon after the
+ *         hard limit, well short of the depth limit
+ **************************************/
+void TestTimeManager::search_stopsAtHardLimit()
+{
+   // SETUP
+   TimeManager timeManager(TimeControl(250, 0));
+   Search search;
+   search.setTimeManager(&timeManager);
+
+   // EXERCISE
+   SearchResult result = search.run(FEN_START, 64);
+
+   // VERIFY
+   assertUnit(timeManager.getElapsed() < chrono::milliseconds(150));
+   assertUnit(result.depth >= 1);
+   assertUnit(result.depth < 64);
+   assertUnit(result.bestMove.getSource().isValid());
+}  // TEARDOWN
+
+/*************************************
+ * SEARCH finishes first iteration
+ * Input:  no time on the clock at all
+ * Output: there is still a move to play
+ **************************************/
+void TestTimeManager::search_finishesFirstIteration()
+{
+   // SETUP
+   TimeManager timeManager(TimeControl(0, 0));
+   Search search;
+   search.setTimeManager(&timeManager);
+
+   // EXERCISE
+   SearchResult result = search.run(FEN_START, 64);
+
+   // VERIFY
+   assertUnit(result.depth == 1);
+   assertUnit(result.bestMove.getSource().isValid());
+}  // TEARDOWN
+
+/*************************************
+ * SEARCH reused after time is up
+ * Input:  one search, run twice with the last move
+ *         before the time control to play, so the soft
+ *         and hard limits are the same and the first run
+ *         is cut off part of the way through an iteration
+ * Output: the second run still gets its own time, and
+ *         finishes an iteration
+ **************************************/
+void TestTimeManager::search_reusedAfterTimeUp()
+{
+   // SETUP
+   Search search;
+   TimeManager timeManagerFirst(TimeControl(150, 0, 1));
+   search.setTimeManager(&timeManagerFirst);
+   SearchResult resultFirst = search.run(FEN_START, 64);
+   TimeManager timeManagerSecond(TimeControl(150, 0, 1));
+   search.setTimeManager(&timeManagerSecond);
+
+   // EXERCISE
+   SearchResult resultSecond = search.run(FEN_START, 64);
+
+   // VERIFY
+   assertUnit(timeManagerFirst.getElapsed() >= timeManagerFirst.getHardLimit());
+   assertUnit(resultFirst.depth >= 1);
+   assertUnit(resultSecond.depth >= 1);
+   assertUnit(resultSecond.bestMove.getSource().isValid());
+   assertUnit(!search.isStopped());
+}  // TEARDOWN
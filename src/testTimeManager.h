@@ -0,0 +1,38 @@
+/***********************************************************************
+ * Header File:
+ *    TEST TIME MANAGER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the time manager
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+
+/***************************************************
+ * TIME MANAGER TEST
+ * Test the limits worked out from the clock, how
+ * they move with the search, and that a search
+ * keeps to them
+ ***************************************************/
+class TestTimeManager : public UnitTest
+{
+public:
+   void run();
+
+private:
+   void construct_suddenDeath();
+   void construct_increment();
+   void construct_lastMove();
+   void construct_noTime();
+   void update_stable();
+   void update_bestMoveChanges();
+   void update_scoreDrops();
+   void update_neverPastHard();
+   void isHardLimitReached_everyNNodes();
+   void search_stopsAtHardLimit();
+   void search_finishesFirstIteration();
+   void search_reusedAfterTimeUp();
+};
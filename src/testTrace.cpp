@@ -0,0 +1,154 @@
+/***********************************************************************
+ * Source File:
+ *    TEST TRACE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the scoped timers and counters
+ ************************************************************************/
+
+#include "testTrace.h"
+#include "trace.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+using namespace std;
+
+/***************************************************
+ * RUN
+ ***************************************************/
+void TestTrace::run()
+{
+   timeTest(scope_counts);
+   timeTest(scope_nested);
+   timeTest(counter_adds);
+   timeTest(writeTrace_events);
+   timeTest(writeTrace_badFile);
+
+   report("Trace");
+}
+
+/*************************************
+ * SCOPE counts
+ * Input:  a site timed three times
+ * Output: three calls, the longest no more than the total
+ **************************************/
+void TestTrace::scope_counts()
+{
+   // SETUP
+   static TraceSite site("testTrace::counts");
+
+   // EXERCISE
+   for (int i = 0; i < 3; i++)
+      TraceScope scope(site);
+
+   // VERIFY
+   assertUnit(site.numCalls == 3);
+   assertUnit(site.maxNanoseconds <= site.nanoseconds);
+   assertUnit(site.isRegistered);
+}  // TEARDOWN
+
+/*************************************
+ * SCOPE nested
+ * Input:  one scope inside another
+ * Output: the outer one took at least as long as the inner one
+ **************************************/
+void TestTrace::scope_nested()
+{
+   // SETUP
+   static TraceSite outer("testTrace::outer");
+   static TraceSite inner("testTrace::inner");
+
+   // EXERCISE
+   {
+      TraceScope scopeOuter(outer);
+      TraceScope scopeInner(inner);
+   }
+
+   // VERIFY
+   assertUnit(outer.numCalls == 1);
+   assertUnit(inner.numCalls == 1);
+   assertUnit(outer.nanoseconds >= inner.nanoseconds);
+}  // TEARDOWN
+
+/*************************************
+ * COUNTER adds
+ * Input:  2, then 5, then 0
+ * Output: 7
+ **************************************/
+void TestTrace::counter_adds()
+{
+   // SETUP
+   static TraceCounter counter("testTrace::counter");
+
+   // EXERCISE
+   traceAdd(counter, 2);
+   traceAdd(counter, 5);
+   traceAdd(counter, 0);
+
+   // VERIFY
+   assertUnit(counter.value == 7);
+   assertUnit(counter.isRegistered);
+}  // TEARDOWN
+
+/*************************************
+ * WRITE TRACE events
+ * Input:  a scope recorded and a counter
+ * Output: a Chrome trace with a complete event and a counter event
+ **************************************/
+void TestTrace::writeTrace_events()
+{
+   // SETUP
+   static TraceSite site("testTrace::recorded");
+   static TraceCounter counter("testTrace::recordedCounter");
+   string fileName = string(P_tmpdir) + "/testTrace.json";
+   setTraceRecording(true);
+   {
+      TraceScope scope(site);
+   }
+   setTraceRecording(false);
+   traceAdd(counter, 42);
+
+   // EXERCISE
+   writeTrace(fileName.c_str());
+
+   // VERIFY
+   ifstream fin(fileName.c_str());
+   stringstream text;
+   text << fin.rdbuf();
+   string json = text.str();
+   assertUnit(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+   assertUnit(json.find("{\"name\":\"testTrace::recorded\",\"ph\":\"X\"") != string::npos);
+   assertUnit(json.find("{\"name\":\"testTrace::recordedCounter\",\"ph\":\"C\"") != string::npos);
+   assertUnit(json.find("\"args\":{\"value\":42}") != string::npos);
+   assertUnit(json.rfind("]}") != string::npos);
+
+   // TEARDOWN
+   fin.close();
+   remove(fileName.c_str());
+}
+
+/*************************************
+ * WRITE TRACE bad file
+ * Input:  a directory that does not exist
+ * Output: a string is thrown
+ **************************************/
+void TestTrace::writeTrace_badFile()
+{
+   // SETUP
+   bool thrown = false;
+
+   // EXERCISE
+   try
+   {
+      writeTrace("/no/such/directory/trace.json");
+   }
+   catch (const string&)
+   {
+      thrown = true;
+   }
+
+   // VERIFY
+   assertUnit(thrown);
+}  // TEARDOWN
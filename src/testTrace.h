@@ -0,0 +1,29 @@
+/***********************************************************************
+ * Header File:
+ *    TEST TRACE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The unit tests for the scoped timers and counters
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+
+/***************************************************
+ * TRACE TEST
+ * Test the sites, the counters, and the trace file
+ ***************************************************/
+class TestTrace : public UnitTest
+{
+public:
+   void run();
+
+private:
+   void scope_counts();
+   void scope_nested();
+   void counter_adds();
+   void writeTrace_events();
+   void writeTrace_badFile();
+};
@@ -0,0 +1,98 @@
+/***********************************************************************
+ * Source File:
+ *    TIME MANAGER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The soft and hard limits on thinking about one move
+ ************************************************************************/
+
+#include "timeManager.h"
+#include "search.h"      // for SEARCH RESULT
+#include <algorithm>     // for MIN and MAX
+using namespace std;
+
+// kept back for the time it takes the move to reach the clock
+const int64_t MOVE_OVERHEAD = 50;
+
+// with no time control in sight, plan as if this many moves are left
+const int MOVES_TO_GO_GUESS = 30;
+
+// how far past the soft limit the search may run
+const int64_t HARD_PER_SOFT = 4;
+
+// a score this many centipawns lower than last iteration is a drop
+const int SCORE_DROP_MIN = 20;
+const int SCORE_DROP_MAX = 200;
+
+/*************************************
+ * TIME MANAGER : CONSTRUCT
+ * The soft limit is an even share of the clock over the
+ * moves left, plus most of the increment. The hard limit
+ * is a few times that, but never more than half of what
+ * is left, or all of it on the last move before the
+ * time control
+ **************************************/
+TimeManager::TimeManager(const TimeControl& timeControl) :
+   timeStart(Clock::now()),
+   scorePrev(0),
+   numIterations(0),
+   numStable(0),
+   factorStability(1.0),
+   factorScore(1.0)
+{
+   int64_t msUsable = max((int64_t)0, timeControl.msRemaining - MOVE_OVERHEAD);
+   int movesToGo = timeControl.movesToGo > 0 ?
+                   min(timeControl.movesToGo, MOVES_TO_GO_GUESS) : MOVES_TO_GO_GUESS;
+
+   int64_t soft = msUsable / movesToGo + timeControl.msIncrement * 3 / 4;
+   int64_t hard = min(soft * HARD_PER_SOFT, movesToGo == 1 ? msUsable : msUsable / 2);
+   msSoft = Milliseconds(min(soft, hard));
+   msHard = Milliseconds(hard);
+}
+
+/*************************************
+ * TIME MANAGER : GET ELAPSED
+ **************************************/
+TimeManager::Milliseconds TimeManager::getElapsed() const
+{
+   return chrono::duration_cast<Milliseconds>(Clock::now() - timeStart);
+}
+
+/*************************************
+ * TIME MANAGER : GET SOFT LIMIT ADJUSTED
+ * Never past the hard limit, however unsettled the
+ * search is
+ **************************************/
+TimeManager::Milliseconds TimeManager::getSoftLimitAdjusted() const
+{
+   auto ms = (int64_t)(msSoft.count() * factorStability * factorScore);
+   return min(Milliseconds(ms), msHard);
+}
+
+/*************************************
+ * TIME MANAGER : UPDATE
+ * A best move that changes means the search has not
+ * made up its mind, so it gets half again as long. One
+ * that holds gets a tenth less for each iteration it
+ * holds, down to half. A score that falls means trouble
+ * the last iteration did not see, so up to twice as long
+ **************************************/
+void TimeManager::update(const SearchResult& result)
+{
+   if (numIterations++ > 0)
+   {
+      numStable = (result.bestMove == bestMovePrev) ? numStable + 1 : 0;
+      factorStability = numStable == 0 ? 1.5 : max(0.5, 1.1 - 0.1 * numStable);
+
+      int drop = scorePrev - result.score;
+      if (drop >= SCORE_DROP_MIN &&
+          !Search::isMateScore(scorePrev) && !Search::isMateScore(result.score))
+         factorScore = 1.0 + (double)min(drop, SCORE_DROP_MAX) / SCORE_DROP_MAX;
+      else
+         factorScore = 1.0;
+   }
+
+   bestMovePrev = result.bestMove;
+   scorePrev    = result.score;
+}
@@ -0,0 +1,100 @@
+/***********************************************************************
+ * Header File:
+ *    TIME MANAGER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Decide how long to think about one move of a timed game. The time
+ *    left on the clock and the increment become two limits:
+ *
+ *       soft  past this, do not start another iteration. It grows when
+ *             the best move keeps changing or the score falls, and
+ *             shrinks when the best move has held for several depths
+ *       hard  past this, stop the search where it is, even part of the
+ *             way through an iteration
+ *
+ *    Time is wall-clock time from a monotonic clock, so it counts the
+ *    time the engine is waiting as well as working, and never jumps
+ *    when the system clock is set. Reading the clock is cheap, some tens
+ *    of nanoseconds against the microseconds of a node, so checking it
+ *    less often saves little. The search asks every TIME_CHECK_NODES
+ *    nodes so the check stays off most nodes while the overrun past the
+ *    hard limit, a few milliseconds of nodes, stays well inside the
+ *    MOVE_OVERHEAD kept back from the clock.
+ ************************************************************************/
+
+#pragma once
+
+#include "move.h"        // for MOVE
+#include <chrono>
+#include <cstdint>
+
+struct SearchResult;
+
+// the nodes searched between looks at the clock: at some 50,000
+// nodes a second, about 5 milliseconds
+const uint64_t TIME_CHECK_NODES = 256;
+
+/***************************************************
+ * TIME CONTROL
+ * What the clock of the side to move says, in
+ * milliseconds. movesToGo is the moves left until
+ * the next time control, or 0 for the rest of the game
+ ***************************************************/
+struct TimeControl
+{
+   TimeControl(int64_t msRemaining = 0, int64_t msIncrement = 0, int movesToGo = 0) :
+      msRemaining(msRemaining), msIncrement(msIncrement), movesToGo(movesToGo) {}
+   int64_t msRemaining;
+   int64_t msIncrement;
+   int     movesToGo;
+};
+
+/***************************************************
+ * TIME MANAGER
+ * The limits for one move. The clock starts when
+ * the manager is made
+ ***************************************************/
+class TimeManager
+{
+public:
+   typedef std::chrono::steady_clock      Clock;
+   typedef std::chrono::milliseconds      Milliseconds;
+
+   TimeManager(const TimeControl& timeControl);
+
+   // the limits as first worked out from the clock
+   Milliseconds getSoftLimit() const { return msSoft; }
+   Milliseconds getHardLimit() const { return msHard; }
+
+   // the soft limit after the adjustments for stability and score
+   Milliseconds getSoftLimitAdjusted() const;
+
+   // time since the manager was made
+   Milliseconds getElapsed() const;
+
+   // look at the result of another iteration. A new best move or a
+   // lower score gives the search more time; the same best move less
+   void update(const SearchResult& result);
+
+   // is there time to start another iteration?
+   bool isSoftLimitReached() const { return getElapsed() >= getSoftLimitAdjusted(); }
+
+   // must the search stop now? Cheap enough to call every node: the
+   // clock is only read every TIME_CHECK_NODES calls
+   bool isHardLimitReached(uint64_t numNodes) const
+   {
+      return numNodes % TIME_CHECK_NODES == 0 && getElapsed() >= msHard;
+   }
+
+private:
+   Clock::time_point timeStart;
+   Milliseconds      msSoft;
+   Milliseconds      msHard;
+   Move              bestMovePrev;    // the best move of the last iteration
+   int               scorePrev;       // and its score
+   int               numIterations;
+   int               numStable;       // iterations the best move has held
+   double            factorStability;
+   double            factorScore;
+};
@@ -0,0 +1,430 @@
+/***********************************************************************
+ * Source File:
+ *    TOOL
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Command line utilities that work on game archives. Usage:
+ *       chessTool pgn2cgr <in.pgn> <out.cgr>
+ *       chessTool cgr2pgn <in.cgr> <out.pgn>
+ *       chessTool book <book.bin> [SAN moves...]
+ *       chessTool makebook [options] <out.bin> <in.pgn|in.cgr>...
+ *          -ply N      deepest position to record (24)
+ *          -min N      leave out moves played fewer than N times (1)
+ *          -threads N  worker threads (one per core)
+ *          -memory MB  statistics held before spilling to disk (64)
+ *       chessTool bitbase <signature> [threads]
+ *          generate KPK.cbb, KRKP.cbb, ... and every table they need
+ *       chessTool compress <in.cbb> <out.cbz> [block bytes]
+ *       chessTool render <positions.fen> <prefix> [png|ppm]
+ *          draw each FEN line to <prefix>1.png, <prefix>2.png, ...
+ *       chessTool evaluate <positions.fen> [threads]
+ *          print the score of each FEN line, in centipawns for white
+ *       chessTool perft <depth> [FEN]
+ *          count the lines of legal moves, after each first move and
+ *          in all, from the FEN or the starting position
+ *       chessTool search <ms left> <ms increment> [FEN]
+ *          think about one move as if the clock said this, printing
+ *          each depth, from the FEN or the starting position
+ ************************************************************************/
+
+#include "gameRecord.h"  // for GAME RECORD READER and WRITER
+#include "pgn.h"         // for the PGN converters
+#include "book.h"        // for OPENING BOOK
+#include "bookBuilder.h" // for BOOK BUILDER
+#include "bitbase.h"     // for BITBASE SET
+#include "tablebase.h"   // for TABLEBASE
+#include "polyglot.h"    // for the Polyglot key and move encoding
+#include "board.h"       // for BOARD
+#include "uiRaster.h"    // for the offscreen renderer
+#include "evaluate.h"    // for EVALUATE BATCH
+#include "search.h"      // for SEARCH
+#include "timeManager.h" // for TIME MANAGER
+#include <fstream>       // for IFSTREAM and OFSTREAM
+#include <iostream>      // for CERR
+#include <string>        // for STRING
+#include <vector>        // for VECTOR
+#include <cstdlib>       // for ATOI
+#include <chrono>        // for timing the renderer and the evaluation
+using namespace std;
+
+/*************************************
+ * PGN TO CGR
+ * Convert a PGN file into a binary game record
+ **************************************/
+static int pgnToCgr(const string& fileIn, const string& fileOut)
+{
+   ifstream fin(fileIn.c_str());
+   if (fin.fail())
+      throw string("Unable to open ") + fileIn;
+
+   GameRecordWriter writer;
+   size_t numSkipped = 0;
+   size_t numGames = convertPgnToRecord(fin, writer, &numSkipped);
+   writer.write(fileOut);
+
+   cout << numGames << " games written";
+   if (numSkipped)
+      cout << ", " << numSkipped << " skipped";
+   cout << endl;
+   return 0;
+}
+
+/*************************************
+ * CGR TO PGN
+ * Convert a binary game record back into PGN
+ **************************************/
+static int cgrToPgn(const string& fileIn, const string& fileOut)
+{
+   GameRecordReader reader(fileIn);
+   ofstream fout(fileOut.c_str());
+   if (fout.fail())
+      throw string("Unable to open ") + fileOut + " for writing";
+
+   size_t numGames = convertRecordToPgn(reader, fout);
+   cout << numGames << " games written" << endl;
+   return 0;
+}
+
+/*************************************
+ * BOOK
+ * List the book moves for the position reached
+ * by a sequence of SAN moves
+ **************************************/
+static int probeBook(const string& fileIn, int numMoves, char** moves)
+{
+   OpeningBook book(fileIn);
+   Board board;
+   for (int i = 0; i < numMoves; i++)
+      board.move(sanToMove(board, moves[i]));
+
+   uint64_t key = polyglotKey(board);
+   vector<BookEntry> entries;
+   book.probe(key, entries);
+
+   cout << hex << key << dec << ": " << entries.size() << " moves\n";
+   for (const BookEntry& entry : entries)
+   {
+      Move move;
+      if (polyglotToMove(board, entry.move, move))
+         cout << '\t' << moveToSan(board, move);
+      else
+         cout << "\t(" << entry.move << ')';
+      cout << '\t' << entry.weight << '\n';
+   }
+   return 0;
+}
+
+/*************************************
+ * MAKE BOOK
+ * Build a Polyglot book from PGN files and binary
+ * game records. Files ending in .cgr are records.
+ **************************************/
+static int makeBook(int argc, char** argv)
+{
+   int maxPly = 24;
+   int minGames = 1;
+   int numThreads = 0;
+   size_t memoryMB = 64;
+
+   int iArg = 2;
+   for (; iArg + 1 < argc && argv[iArg][0] == '-'; iArg += 2)
+   {
+      string option = argv[iArg];
+      int value = atoi(argv[iArg + 1]);
+      if (option == "-ply")
+         maxPly = value;
+      else if (option == "-min")
+         minGames = value;
+      else if (option == "-threads")
+         numThreads = value;
+      else if (option == "-memory")
+         memoryMB = (size_t)value;
+      else
+         throw string("Unknown option ") + option;
+   }
+   if (argc - iArg < 2)
+      throw string("makebook needs an output and at least one input");
+
+   BookBuilder builder(maxPly, memoryMB << 20, numThreads);
+   builder.setMinGames(minGames);
+   string fileOut = argv[iArg++];
+   for (; iArg < argc; iArg++)
+   {
+      string fileIn = argv[iArg];
+      if (fileIn.size() > 4 && fileIn.substr(fileIn.size() - 4) == ".cgr")
+      {
+         GameRecordReader reader(fileIn);
+         builder.addRecord(reader);
+      }
+      else
+      {
+         ifstream fin(fileIn.c_str());
+         if (fin.fail())
+            throw string("Unable to open ") + fileIn;
+         size_t numSkipped = 0;
+         builder.addPgn(fin, &numSkipped);
+         if (numSkipped)
+            cout << fileIn << ": " << numSkipped << " games skipped\n";
+      }
+   }
+
+   size_t numEntries = builder.write(fileOut);
+   cout << builder.getNumGames() << " games, "
+        << numEntries << " entries written" << endl;
+   return 0;
+}
+
+/*************************************
+ * BITBASE
+ * Generate an endgame table and those it depends
+ * on, saving each as <signature>.cbb
+ **************************************/
+static int makeBitbase(const string& signature, int numThreads)
+{
+   BitbaseSet set(numThreads);
+   set.generate(signature);
+   for (const string& name : set.getSignatures())
+   {
+      const Bitbase& base = *set.find(name);
+      base.save(base.getSignature() + ".cbb");
+
+      size_t count[4] = { 0, 0, 0, 0 };
+      for (size_t index = 0; index < base.size(); index++)
+         count[base.get(index)]++;
+      cout << base.getSignature() << ": "
+           << count[BB_WIN]  << " wins, "
+           << count[BB_DRAW] << " draws, "
+           << count[BB_LOSS] << " losses, "
+           << count[BB_ILLEGAL] << " illegal\n";
+   }
+   return 0;
+}
+
+/*************************************
+ * COMPRESS
+ * Turn a bitbase into a block-compressed tablebase
+ **************************************/
+static int compressBitbase(const string& fileIn, const string& fileOut,
+                           size_t blockSize)
+{
+   BitbaseSet set;
+   const Bitbase& base = set.load(fileIn);
+   Tablebase::write(base, fileOut, blockSize);
+
+   Tablebase table(fileOut);
+   ifstream fin(fileOut.c_str(), ios::binary | ios::ate);
+   cout << base.getSignature() << ": " << base.getNumBytes() << " bytes to "
+        << (size_t)fin.tellg() << " in blocks of " << blockSize << endl;
+   return 0;
+}
+
+/*************************************
+ * RENDER
+ * Draw a diagram of every position in a file of
+ * FEN strings, one per line. No window is opened
+ **************************************/
+static int renderPositions(const string& fileIn, const string& prefix,
+                           const string& format)
+{
+   if (format != "png" && format != "ppm")
+      throw string("Unknown image format ") + format;
+   ifstream fin(fileIn.c_str());
+   if (fin.fail())
+      throw string("Unable to open ") + fileIn;
+
+   ogstreamRaster raster;
+   Board board(&raster);
+   size_t numPositions = 0;
+   double seconds = 0.0;
+   string line;
+   while (getline(fin, line))
+   {
+      if (line.find_first_not_of(" \t\r") == string::npos)
+         continue;
+
+      auto start = chrono::steady_clock::now();
+      board.readFEN(line);
+      raster.clear();
+      board.display(Position(), Position());
+      raster.flush();
+      seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+      raster.write(prefix + to_string(++numPositions) + "." + format);
+   }
+
+   cout << numPositions << " positions drawn";
+   if (seconds > 0.0)
+      cout << ", " << (size_t)(numPositions / seconds) << " per second";
+   cout << endl;
+   return 0;
+}
+
+/*************************************
+ * EVALUATE POSITIONS
+ * Score every FEN in a file, one per line, and print
+ * each score in front of its FEN
+ **************************************/
+static int evaluatePositions(const string& fileIn, int numThreads)
+{
+   ifstream fin(fileIn.c_str());
+   if (fin.fail())
+      throw string("Unable to open ") + fileIn;
+
+   vector<string> fens;
+   vector<CompactPosition> positions;
+   string line;
+   while (getline(fin, line))
+   {
+      if (line.find_first_not_of(" \t\r") == string::npos)
+         continue;
+      positions.push_back(CompactPosition());
+      positions.back().readFEN(line);
+      fens.push_back(line);
+   }
+
+   vector<int> scores(positions.size());
+   auto start = chrono::steady_clock::now();
+   evaluateBatch(positions.data(), positions.size(), scores.data(), numThreads);
+   double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+   for (size_t i = 0; i < fens.size(); i++)
+      cout << scores[i] << '\t' << fens[i] << '\n';
+   cerr << positions.size() << " positions evaluated";
+   if (seconds > 0.0)
+      cerr << ", " << (size_t)(positions.size() / seconds) << " per second";
+   cerr << endl;
+   return 0;
+}
+
+/*************************************
+ * PERFT
+ * Count the lines of legal moves below each first move,
+ * then in all. Compared against another program's counts,
+ * the first move whose count differs shows where to look
+ **************************************/
+static int perft(int depth, const string& fen)
+{
+   if (depth < 1)
+      throw string("The depth must be at least 1");
+   Board board(nullptr, true /*noreset*/);
+   if (!fen.empty())
+      board.readFEN(fen);
+
+   auto start = chrono::steady_clock::now();
+   set<Move> moves;
+   board.getLegalMoves(moves);
+   uint64_t total = 0;
+   for (const Move& move : moves)
+   {
+      Board copy(nullptr, true /*noreset*/);
+      copy.readFEN(board.getFEN());
+      copy.move(move);
+      uint64_t count = copy.perft(depth - 1);
+      cout << move.getText() << '\t' << count << '\n';
+      total += count;
+   }
+   double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+   cout << "total\t" << total << endl;
+   cerr << moves.size() << " moves, depth " << depth;
+   if (seconds > 0.0)
+      cerr << ", " << (size_t)(total / seconds) << " positions per second";
+   cerr << endl;
+   return 0;
+}
+
+/*************************************
+ * SEARCH POSITION
+ * Search one position with the time a game clock would
+ * allow, and show how the time manager spent it
+ **************************************/
+static int searchPosition(int64_t msRemaining, int64_t msIncrement, const string& fen)
+{
+   Board board(nullptr, true /*noreset*/);
+   if (!fen.empty())
+      board.readFEN(fen);
+
+   TimeManager timeManager(TimeControl(msRemaining, msIncrement));
+   cerr << "soft " << timeManager.getSoftLimit().count() << " ms, hard "
+        << timeManager.getHardLimit().count() << " ms" << endl;
+
+   Search search;
+   search.setTimeManager(&timeManager);
+   SearchResult result = search.run(board, 64, [&](const SearchResult& result)
+   {
+      cout << "depth " << result.depth << '\t' << moveToSan(board, result.bestMove)
+           << '\t' << result.score << '\t' << result.numNodes << " nodes\t"
+           << timeManager.getElapsed().count() << " ms" << endl;
+   });
+
+   if (result.depth == 0)
+      throw string("There are no legal moves");
+   cout << "best\t" << moveToSan(board, result.bestMove) << endl;
+   cerr << result.numNodes << " nodes in " << timeManager.getElapsed().count()
+        << " ms, soft limit " << timeManager.getSoftLimitAdjusted().count()
+        << " ms at the end" << endl;
+   return 0;
+}
+
+/*************************************
+ * USAGE
+ **************************************/
+static int usage()
+{
+   cerr << "Usage:\n"
+        << "\tchessTool pgn2cgr <in.pgn> <out.cgr>\n"
+        << "\tchessTool cgr2pgn <in.cgr> <out.pgn>\n"
+        << "\tchessTool book <book.bin> [SAN moves...]\n"
+        << "\tchessTool makebook [-ply N] [-min N] [-threads N] [-memory MB]"
+        << " <out.bin> <in.pgn|in.cgr>...\n"
+        << "\tchessTool bitbase <signature> [threads]\n"
+        << "\tchessTool compress <in.cbb> <out.cbz> [block bytes]\n"
+        << "\tchessTool render <positions.fen> <prefix> [png|ppm]\n"
+        << "\tchessTool evaluate <positions.fen> [threads]\n"
+        << "\tchessTool perft <depth> [FEN]\n"
+        << "\tchessTool search <ms left> <ms increment> [FEN]\n";
+   return 1;
+}
+
+/*********************************
+ * MAIN - Dispatch on the command
+ *********************************/
+int main(int argc, char** argv)
+{
+   if (argc < 2)
+      return usage();
+   string command = argv[1];
+
+   try
+   {
+      if (command == "pgn2cgr" && argc == 4)
+         return pgnToCgr(argv[2], argv[3]);
+      if (command == "cgr2pgn" && argc == 4)
+         return cgrToPgn(argv[2], argv[3]);
+      if (command == "book" && argc >= 3)
+         return probeBook(argv[2], argc - 3, argv + 3);
+      if (command == "makebook")
+         return makeBook(argc, argv);
+      if (command == "bitbase" && (argc == 3 || argc == 4))
+         return makeBitbase(argv[2], argc == 4 ? atoi(argv[3]) : 0);
+      if (command == "compress" && (argc == 4 || argc == 5))
+         return compressBitbase(argv[2], argv[3],
+                                argc == 5 ? (size_t)atoi(argv[4]) : 4096);
+      if (command == "render" && (argc == 4 || argc == 5))
+         return renderPositions(argv[2], argv[3], argc == 5 ? argv[4] : "png");
+      if (command == "evaluate" && (argc == 3 || argc == 4))
+         return evaluatePositions(argv[2], argc == 4 ? atoi(argv[3]) : 0);
+      if (command == "perft" && (argc == 3 || argc == 4))
+         return perft(atoi(argv[2]), argc == 4 ? argv[3] : "");
+      if (command == "search" && (argc == 4 || argc == 5))
+         return searchPosition(atoll(argv[2]), atoll(argv[3]), argc == 5 ? argv[4] : "");
+   }
+   catch (const string& error)
+   {
+      cerr << "Error: " << error << endl;
+      return 1;
+   }
+
+   return usage();
+}
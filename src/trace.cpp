@@ -0,0 +1,362 @@
+/***********************************************************************
+ * Source File:
+ *    TRACE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The timers and counters behind TRACE_SCOPE and TRACE_COUNT, the
+ *    per-thread event buffers, and the two ways to read them: Chrome
+ *    trace JSON and a text summary.
+ ************************************************************************/
+
+#include "trace.h"
+#include <algorithm>            // for MIN and MAX
+#include <chrono>               // for STEADY_CLOCK
+#include <condition_variable>   // to wake the summary thread
+#include <cstdio>               // for FPRINTF
+#include <cstdlib>              // for GETENV
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// no thread keeps more events than this; the rest are only counted
+const size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+/***************************************************
+ * TRACE EVENT
+ * One finished scope
+ ***************************************************/
+struct TraceEvent
+{
+   const TraceSite* pSite;
+   uint64_t         begin;      // nanoseconds on the steady clock
+   uint64_t         duration;
+};
+
+/***************************************************
+ * THREAD EVENTS
+ * The events of one thread. They belong to the list
+ * below rather than the thread, so they outlive it
+ ***************************************************/
+struct ThreadEvents
+{
+   int                id;
+   vector<TraceEvent> events;
+   size_t             numDropped = 0;
+};
+
+// every site and counter that has been used, newest first
+static TraceSite*    pSites    = nullptr;
+static TraceCounter* pCounters = nullptr;
+static mutex         mutexSites;
+
+// the event buffer of every thread that has recorded anything
+static vector<unique_ptr<ThreadEvents>> threadEvents;
+static mutex                            mutexEvents;
+static thread_local ThreadEvents*       pEventsCurrent = nullptr;
+static atomic<bool>                     isRecording(false);
+
+// the summary thread
+static thread             threadSummary;
+static mutex              mutexSummary;
+static condition_variable cvSummary;
+static bool               isSummaryStopping = false;
+
+/***************************************************
+ * GET NOW
+ ***************************************************/
+static uint64_t getNow()
+{
+   return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+      chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/***************************************************
+ * REGISTER
+ * Put a site or counter on its list the first time
+ ***************************************************/
+template <class T>
+static void registerOnce(T& item, T*& pList)
+{
+   if (item.isRegistered.load(memory_order_acquire))
+      return;
+   lock_guard<mutex> lock(mutexSites);
+   if (item.isRegistered.load(memory_order_relaxed))
+      return;
+   item.pNext = pList;
+   pList = &item;
+   item.isRegistered.store(true, memory_order_release);
+}
+
+/***************************************************
+ * GET THREAD EVENTS
+ * This thread's buffer, made on first use
+ ***************************************************/
+static ThreadEvents& getThreadEvents()
+{
+   if (pEventsCurrent == nullptr)
+   {
+      lock_guard<mutex> lock(mutexEvents);
+      threadEvents.push_back(unique_ptr<ThreadEvents>(new ThreadEvents));
+      pEventsCurrent = threadEvents.back().get();
+      pEventsCurrent->id = (int)threadEvents.size() - 1;
+   }
+   return *pEventsCurrent;
+}
+
+/***************************************************
+ * TRACE SCOPE : CONSTRUCT and DESTRUCT
+ ***************************************************/
+TraceScope::TraceScope(TraceSite& site) : site(site)
+{
+   registerOnce(site, pSites);
+   begin = getNow();
+}
+
+TraceScope::~TraceScope()
+{
+   uint64_t duration = getNow() - begin;
+   site.numCalls.fetch_add(1, memory_order_relaxed);
+   site.nanoseconds.fetch_add(duration, memory_order_relaxed);
+   uint64_t longest = site.maxNanoseconds.load(memory_order_relaxed);
+   while (duration > longest &&
+          !site.maxNanoseconds.compare_exchange_weak(longest, duration,
+                                                     memory_order_relaxed))
+      ;
+
+   if (isRecording.load(memory_order_relaxed))
+   {
+      ThreadEvents& events = getThreadEvents();
+      if (events.events.size() < MAX_EVENTS_PER_THREAD)
+         events.events.push_back({ &site, begin, duration });
+      else
+         events.numDropped++;
+   }
+}
+
+/***************************************************
+ * TRACE ADD
+ ***************************************************/
+void traceAdd(TraceCounter& counter, uint64_t amount)
+{
+   registerOnce(counter, pCounters);
+   counter.value.fetch_add(amount, memory_order_relaxed);
+}
+
+/***************************************************
+ * SET TRACE RECORDING
+ ***************************************************/
+void setTraceRecording(bool isRecordingNew)
+{
+   isRecording = isRecordingNew;
+}
+
+/***************************************************
+ * WRITE JSON STRING
+ * Site names are literals, but quote them properly
+ ***************************************************/
+static void writeJsonString(ostream& out, const char* text)
+{
+   out << '"';
+   for (const char* p = text; *p; p++)
+   {
+      if (*p == '"' || *p == '\\')
+         out << '\\' << *p;
+      else if ((unsigned char)*p >= ' ')
+         out << *p;
+   }
+   out << '"';
+}
+
+/***************************************************
+ * WRITE TRACE
+ * Chrome's trace event format: each scope is a complete
+ * ("X") event, times are in microseconds from the first
+ * event, and each counter is one "C" event at the end
+ ***************************************************/
+void writeTrace(const char* fileName)
+{
+   ofstream fout(fileName);
+   if (fout.fail())
+      throw string("Unable to open ") + fileName + " for writing";
+
+   lock_guard<mutex> lock(mutexEvents);
+   uint64_t first = UINT64_MAX;
+   uint64_t last  = 0;
+   for (const unique_ptr<ThreadEvents>& pEvents : threadEvents)
+      for (const TraceEvent& event : pEvents->events)
+      {
+         first = min(first, event.begin);
+         last  = max(last, event.begin + event.duration);
+      }
+   if (first == UINT64_MAX)
+      first = last = getNow();
+
+   fout << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+   fout.setf(ios::fixed);
+   fout.precision(3);
+   const char* separator = "";
+   for (const unique_ptr<ThreadEvents>& pEvents : threadEvents)
+   {
+      fout << separator
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+           << pEvents->id << ",\"args\":{\"name\":\"thread " << pEvents->id
+           << "\"}}";
+      separator = ",\n";
+      for (const TraceEvent& event : pEvents->events)
+      {
+         fout << separator << "{\"name\":";
+         writeJsonString(fout, event.pSite->name);
+         fout << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << pEvents->id
+              << ",\"ts\":"  << (event.begin - first) / 1000.0
+              << ",\"dur\":" << event.duration / 1000.0 << "}";
+      }
+   }
+
+   lock_guard<mutex> lockSites(mutexSites);
+   for (const TraceCounter* p = pCounters; p; p = p->pNext)
+   {
+      fout << separator << "{\"name\":";
+      writeJsonString(fout, p->name);
+      fout << ",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":"
+           << (last - first) / 1000.0
+           << ",\"args\":{\"value\":" << p->value.load() << "}}";
+      separator = ",\n";
+   }
+   fout << "\n]}\n";
+
+   if (fout.fail())
+      throw string("Unable to write ") + fileName;
+}
+
+/***************************************************
+ * REPORT TRACE
+ * Sites by total time, then the counters
+ ***************************************************/
+void reportTrace()
+{
+   lock_guard<mutex> lock(mutexSites);
+
+   // copy the list so it can be sorted
+   const int MAX_SITES = 256;
+   TraceSite* sites[MAX_SITES];
+   int numSites = 0;
+   for (TraceSite* p = pSites; p && numSites < MAX_SITES; p = p->pNext)
+      sites[numSites++] = p;
+   for (int i = 1; i < numSites; i++)
+      for (int j = i; j > 0 && sites[j]->nanoseconds > sites[j - 1]->nanoseconds; j--)
+      {
+         TraceSite* pTemp = sites[j];
+         sites[j] = sites[j - 1];
+         sites[j - 1] = pTemp;
+      }
+
+   fprintf(stderr, "\nTimes by scope:\n");
+   fprintf(stderr, "   %-32s %12s %12s %10s %10s\n",
+           "scope", "calls", "total ms", "avg us", "max us");
+   for (int i = 0; i < numSites; i++)
+   {
+      uint64_t calls = sites[i]->numCalls.load();
+      uint64_t total = sites[i]->nanoseconds.load();
+      if (calls)
+         fprintf(stderr, "   %-32s %12llu %12.3f %10.3f %10.3f\n",
+                 sites[i]->name, (unsigned long long)calls,
+                 total / 1e6, total / 1e3 / calls,
+                 sites[i]->maxNanoseconds.load() / 1e3);
+   }
+
+   if (pCounters)
+   {
+      fprintf(stderr, "\nCounters:\n");
+      for (const TraceCounter* p = pCounters; p; p = p->pNext)
+         fprintf(stderr, "   %-32s %12llu\n",
+                 p->name, (unsigned long long)p->value.load());
+   }
+
+   lock_guard<mutex> lockEvents(mutexEvents);
+   size_t numDropped = 0;
+   for (const unique_ptr<ThreadEvents>& pEvents : threadEvents)
+      numDropped += pEvents->numDropped;
+   if (numDropped)
+      fprintf(stderr, "\n   %zu events were not recorded; the buffers were full\n",
+              numDropped);
+}
+
+/***************************************************
+ * START and STOP TRACE SUMMARY
+ ***************************************************/
+void startTraceSummary(int seconds)
+{
+   stopTraceSummary();
+   isSummaryStopping = false;
+   threadSummary = thread([seconds]()
+   {
+      unique_lock<mutex> lock(mutexSummary);
+      while (!cvSummary.wait_for(lock, chrono::seconds(seconds),
+                                 []() { return isSummaryStopping; }))
+         reportTrace();
+   });
+}
+
+void stopTraceSummary()
+{
+   if (!threadSummary.joinable())
+      return;
+   {
+      lock_guard<mutex> lock(mutexSummary);
+      isSummaryStopping = true;
+   }
+   cvSummary.notify_all();
+   threadSummary.join();
+}
+
+#ifdef TRACING
+
+/***************************************************
+ * TRACE REPORTER
+ * Read the environment at startup; save and print at
+ * exit. It is declared after the buffers, so it is
+ * destroyed before them. static does not hide a class
+ * name, so its name must differ from allocTrack's
+ ***************************************************/
+static struct TraceReporter
+{
+   TraceReporter()
+   {
+      const char* fileName = getenv("CHESS_TRACE");
+      if (fileName && *fileName)
+      {
+         this->fileName = fileName;
+         setTraceRecording(true);
+      }
+      const char* seconds = getenv("CHESS_TRACE_SUMMARY");
+      if (seconds && atoi(seconds) > 0)
+         startTraceSummary(atoi(seconds));
+   }
+
+   ~TraceReporter()
+   {
+      stopTraceSummary();
+      if (!fileName.empty())
+      {
+         try
+         {
+            writeTrace(fileName.c_str());
+            fprintf(stderr, "Trace written to %s\n", fileName.c_str());
+         }
+         catch (const string& error)
+         {
+            fprintf(stderr, "Error: %s\n", error.c_str());
+         }
+      }
+      reportTrace();
+   }
+
+   string fileName;
+} traceReporter;
+
+#endif // TRACING
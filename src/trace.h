@@ -0,0 +1,113 @@
+/***********************************************************************
+ * Header File:
+ *    TRACE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Scoped timers and counters for the hot paths. Compile everything
+ *    with -DTRACING to turn them on; otherwise TRACE_SCOPE and
+ *    TRACE_COUNT are nothing, and their arguments are not even evaluated.
+ *
+ *       void Board::move(const Move& move)
+ *       {
+ *          TRACE_SCOPE("Board::move");
+ *          ...
+ *       TRACE_COUNT("legal moves", moves.size());
+ *
+ *    Every scope adds its time to a site: calls, total, and longest.
+ *    While recording is on, each scope is also kept as an event, and
+ *    writeTrace() saves the events as Chrome trace JSON (open it in
+ *    chrome://tracing or Perfetto). reportTrace() prints a text summary.
+ *
+ *    A traced build reads two environment variables at startup:
+ *       CHESS_TRACE=file.json     record events and save them at exit
+ *       CHESS_TRACE_SUMMARY=N     print the summary every N seconds
+ *    The summary is printed once more at exit either way.
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/***************************************************
+ * TRACE SITE
+ * One timed scope. Sites are statics that are never
+ * destroyed, so they can still be read at exit
+ ***************************************************/
+struct TraceSite
+{
+   constexpr TraceSite(const char* name) :
+      name(name), numCalls(0), nanoseconds(0), maxNanoseconds(0),
+      isRegistered(false), pNext(nullptr) {}
+
+   const char*              name;
+   std::atomic<uint64_t>    numCalls;
+   std::atomic<uint64_t>    nanoseconds;      // total time inside
+   std::atomic<uint64_t>    maxNanoseconds;   // the longest single call
+   std::atomic<bool>        isRegistered;     // on the list of every site
+   TraceSite*               pNext;
+};
+
+/***************************************************
+ * TRACE COUNTER
+ * A number that only goes up
+ ***************************************************/
+struct TraceCounter
+{
+   constexpr TraceCounter(const char* name) :
+      name(name), value(0), isRegistered(false), pNext(nullptr) {}
+
+   const char*              name;
+   std::atomic<uint64_t>    value;
+   std::atomic<bool>        isRegistered;
+   TraceCounter*            pNext;
+};
+
+/***************************************************
+ * TRACE SCOPE
+ * Time from construction to destruction
+ ***************************************************/
+class TraceScope
+{
+public:
+   TraceScope(TraceSite& site);
+   ~TraceScope();
+private:
+   TraceSite& site;
+   uint64_t   begin;    // nanoseconds on the steady clock
+};
+
+// add to a counter
+void traceAdd(TraceCounter& counter, uint64_t amount);
+
+// keep every scope as an event for writeTrace(). Off by default
+void setTraceRecording(bool isRecording);
+
+// save the events as Chrome trace JSON. Call it while the traced threads
+// are idle. Throws a string if the file cannot be written
+void writeTrace(const char* fileName);
+
+// print every site and counter to stderr
+void reportTrace();
+
+// print the summary every so often from a thread of its own
+void startTraceSummary(int seconds);
+void stopTraceSummary();
+
+#ifdef TRACING
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b)  TRACE_CONCAT2(a, b)
+#define TRACE_SCOPE(name)                                                  \
+   static TraceSite TRACE_CONCAT(traceSite, __LINE__)(name);               \
+   TraceScope TRACE_CONCAT(traceScope, __LINE__)(TRACE_CONCAT(traceSite, __LINE__))
+#define TRACE_COUNT(name, amount)                                          \
+   do                                                                      \
+   {                                                                       \
+      static TraceCounter traceCounter(name);                              \
+      traceAdd(traceCounter, (uint64_t)(amount));                          \
+   } while (false)
+#else
+#define TRACE_SCOPE(name)         ((void)0)
+#define TRACE_COUNT(name, amount) ((void)0)
+#endif
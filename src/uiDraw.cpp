@@ -15,6 +15,7 @@
 #include <cassert>    // I feel the need... the need for asserts
 #include <time.h>     // for clock
 #include <cmath>      // for sin/cos in circles
+#include <cstring>    // for strlen
 
 #include "position.h"
 
@@ -42,9 +43,14 @@
 
 #include "uiDraw.h"
 #include "uiInteract.h"
+#include "allocTrack.h"
+#include "trace.h"
 
 using namespace std;
 
+double Screen::squareWidth  = (double)SIZE_SQUARE;
+double Screen::squareHeight = (double)SIZE_SQUARE;
+
 // pieces: black and white with better contrast
 const int RGB_WHITE[] = { 240, 240, 230 };  // Slight cream color
 const int RGB_BLACK[] = { 30, 30, 40 };     // Dark grey-blue
@@ -73,6 +79,7 @@ const int RGB_BLACK_OUTLINE[] = { 200, 200, 200 }; // Light outline for black pi
  *************************************************************************/
 void ogstream::flush()
 {
+   ALLOC_SCOPE(ALLOC_RENDER, "ogstream::flush");
    string sOut;
    string sIn = str();
 
@@ -100,13 +107,68 @@ void ogstream::flush()
    str("");
 }
 
+/*************************************************************************
+ * THE TEXT CACHE
+ * Nothing is cached until the first frame is drawn
+ *************************************************************************/
+unsigned int ogstream::listLabels = 0;
+map<string, unsigned int> ogstream::listStatus;
+unsigned int ogstream::listGlyphs = 0;
+
+// one display list per character of the line 1 font
+const int NUM_GLYPHS = 128;
+
+/*************************************************************************
+ * INVALIDATE TEXT
+ * Delete the display lists so the text is built again on the next frame.
+ * Must be called while the OpenGL context is current
+ ************************************************************************/
+void ogstream::invalidateText()
+{
+   if (listLabels)
+      glDeleteLists(listLabels, 1);
+   listLabels = 0;
+
+   for (auto& message : listStatus)
+      glDeleteLists(message.second, 1);
+   listStatus.clear();
+
+   if (listGlyphs)
+      glDeleteLists(listGlyphs, NUM_GLYPHS);
+   listGlyphs = 0;
+}
+
 /*************************************************************************
  * DRAW GAME STATUS TEXT
- * Draw CHECK or CHECKMATE message at the top of the board
+ * Draw CHECK or CHECKMATE message at the top of the board. Line 1, such as
+ * the analysis, goes in smaller text below the board. There are only a few
+ * line 0 messages, so each is compiled into a display list the first time
+ * it is drawn. Line 1 changes every few moments, so it is not cached as a
+ * whole: it is drawn from one display list per character instead
  ************************************************************************/
-void ogstream::drawGameStatus(const char* message) const
+void ogstream::drawGameStatus(const char* message, int line)
 {
-    void* pFont = GLUT_BITMAP_TIMES_ROMAN_24;
+    if (line == 0)
+    {
+        auto it = listStatus.find(message);
+        if (it != listStatus.end())
+        {
+            glCallList(it->second);
+            return;
+        }
+    }
+    else if (listGlyphs == 0)
+    {
+        listGlyphs = glGenLists(NUM_GLYPHS);
+        for (int ch = 0; ch < NUM_GLYPHS; ch++)
+        {
+            glNewList(listGlyphs + ch, GL_COMPILE);
+            glutBitmapCharacter(GLUT_TEXT, ch);
+            glEndList();
+        }
+    }
+
+    void* pFont = (line == 0) ? GLUT_BITMAP_TIMES_ROMAN_24 : GLUT_TEXT;
     
     // Calculate message width for centering
     int messageLength = 0;
@@ -117,14 +179,31 @@ void ogstream::drawGameStatus(const char* message) const
     GLfloat xPos = (GLfloat)(SIZE_SQUARE * 5.5) - (messageLength / 2.0);
     
     // Position vertically - between outer border and coordinate letters
-    // Just below row 9, in the margin area
-    GLfloat yPos = (GLfloat)(SIZE_SQUARE * 8.75);
+    // Just below row 9, in the margin area. Line 1 sits between the
+    // bottom of the board and the letters under it
+    GLfloat yPos = (line == 0) ? (GLfloat)(SIZE_SQUARE * 8.75) :
+                                 (GLfloat)(SIZE_SQUARE * 0.55);
+
+    // Line 1: one call for the whole string, a glyph list per character
+    if (line != 0)
+    {
+        glColor3ub(220, 20, 60);  // Crimson red
+        glRasterPos2f(xPos, yPos);
+        glListBase(listGlyphs);
+        glCallLists((GLsizei)strlen(message), GL_UNSIGNED_BYTE, message);
+        glListBase(0);
+        return;
+    }
     
     // Draw red text
+    GLuint list = glGenLists(1);
+    glNewList(list, GL_COMPILE_AND_EXECUTE);
     glColor3ub(220, 20, 60);  // Crimson red
     glRasterPos2f(xPos, yPos);
     for (const char* p = message; *p; p++)
         glutBitmapCharacter(pFont, *p);
+    glEndList();
+    listStatus[message] = list;
 }
 
 /*************************************************************************
@@ -138,7 +217,7 @@ void ogstream::drawText(const Position& topLeft, const char* text) const
     void* pFont = GLUT_TEXT;
 
     // prepare to draw the text from the top-left corner
-    glRasterPos2f((GLfloat)topLeft.getX(), (GLfloat)topLeft.getY());
+    glRasterPos2f((GLfloat)Screen::getX(topLeft), (GLfloat)Screen::getY(topLeft));
 
     // loop through the text
     for (const char* p = text; *p; p++)
@@ -156,7 +235,7 @@ void ogstream::drawLetter(const Position& topLeft, char letter) const
     void* pFont = GLUT_TEXT;
 
     // prepare to draw the text from the top-left corner
-    glRasterPos2f((GLfloat)topLeft.getX(), (GLfloat)topLeft.getY());
+    glRasterPos2f((GLfloat)Screen::getX(topLeft), (GLfloat)Screen::getY(topLeft));
 
     // loop through the text
     glutBitmapCharacter(pFont, letter);
@@ -175,60 +254,127 @@ void glColor(const int * rgb)
 }
 
 /************************************************************************
-* DRAW Piece WITH OUTLINE
-* Enhanced piece drawing with outline - only outer edges for cleaner look
+* ADD VERTEX
+* Put one corner on the end of a vertex array
+*   INPUT  rgb  RGB color in integers (0...255)
+*          x,y  Where the corner goes
 *************************************************************************/
-void ogstream::drawPiece(bool black, Rect rectangle[], int num) const
+void ogstream::addVertex(vector<Vertex>& vertices, const int* rgb, int x, int y)
+{
+   // the same color glColor() would give
+   Vertex vertex;
+   vertex.x = (short)x;
+   vertex.y = (short)y;
+   for (int i = 0; i < 3; i++)
+      vertex.rgba[i] = (unsigned char)(rgb[i] * 255 / 256.0 + 0.5);
+   vertex.rgba[3] = 255;
+   vertices.push_back(vertex);
+}
+
+/************************************************************************
+* ADD SQUARE
+* Put a quad covering one square of the board, less an inset on each side
+*************************************************************************/
+void ogstream::addSquare(vector<Vertex>& vertices, const int* rgb,
+                         int row, int col, int inset)
+{
+   int x0 = (col + 0) * SIZE_SQUARE + inset + SIZE_SQUARE;
+   int x1 = (col + 1) * SIZE_SQUARE - inset + SIZE_SQUARE;
+   int y0 = (row + 0) * SIZE_SQUARE + inset + SIZE_SQUARE;
+   int y1 = (row + 1) * SIZE_SQUARE - inset + SIZE_SQUARE;
+   addVertex(vertices, rgb, x0, y0);
+   addVertex(vertices, rgb, x1, y0);
+   addVertex(vertices, rgb, x1, y1);
+   addVertex(vertices, rgb, x0, y1);
+}
+
+/************************************************************************
+* DRAW VERTICES
+* Send a whole vertex array to OpenGL in one call. Client-side arrays
+* are OpenGL 1.1, so this works everywhere, software rendering included
+*************************************************************************/
+void ogstream::drawVertices(const vector<Vertex>& vertices, unsigned int mode)
+{
+   if (vertices.empty())
+      return;
+   glVertexPointer(2, GL_SHORT, sizeof(Vertex), &vertices[0].x);
+   glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), vertices[0].rgba);
+   glDrawArrays((GLenum)mode, 0, (GLsizei)vertices.size());
+}
+
+/************************************************************************
+* DRAW PIECE
+* Queue the filled rectangles of a piece for finishFrame()
+*************************************************************************/
+void ogstream::drawPiece(bool black, const Rect rectangle[], int num)
 {
    assert(position.isValid());
-   GLint x = (GLint)((position.getCol() + 0.5) * SIZE_SQUARE + SIZE_SQUARE);
-   GLint y = (GLint)((position.getRow() + 0.5) * SIZE_SQUARE + SIZE_SQUARE);
+   int x = (int)((position.getCol() + 0.5) * SIZE_SQUARE + SIZE_SQUARE);
+   int y = (int)((position.getRow() + 0.5) * SIZE_SQUARE + SIZE_SQUARE);
 
-   // Draw the filled piece
-   glBegin(GL_QUADS);
-   glColor(black ? RGB_BLACK : RGB_WHITE);
+   const int* rgb = black ? RGB_BLACK : RGB_WHITE;
    for (int i = 0; i < num; i++)
    {
-      glVertex2i(x + rectangle[i].x0, y + rectangle[i].y0);
-      glVertex2i(x + rectangle[i].x1, y + rectangle[i].y1);
-      glVertex2i(x + rectangle[i].x2, y + rectangle[i].y2);
-      glVertex2i(x + rectangle[i].x3, y + rectangle[i].y3);
+      addVertex(pieceQuads, rgb, x + rectangle[i].x0, y + rectangle[i].y0);
+      addVertex(pieceQuads, rgb, x + rectangle[i].x1, y + rectangle[i].y1);
+      addVertex(pieceQuads, rgb, x + rectangle[i].x2, y + rectangle[i].y2);
+      addVertex(pieceQuads, rgb, x + rectangle[i].x3, y + rectangle[i].y3);
    }
-   glEnd();
 }
 
 /************************************************************************
 * DRAW PIECE OUTLINE
-* Draw outline around the entire piece silhouette
+* Queue the outline of each rectangle as four separate lines
 *************************************************************************/
-void ogstream::drawPieceOutline(bool black, Rect rectangle[], int num) const
+void ogstream::drawPieceOutline(bool black, const Rect rectangle[], int num)
 {
-   GLint x = (GLint)((position.getCol() + 0.5) * SIZE_SQUARE + SIZE_SQUARE);
-   GLint y = (GLint)((position.getRow() + 0.5) * SIZE_SQUARE + SIZE_SQUARE);
+   int x = (int)((position.getCol() + 0.5) * SIZE_SQUARE + SIZE_SQUARE);
+   int y = (int)((position.getRow() + 0.5) * SIZE_SQUARE + SIZE_SQUARE);
 
-   // Set thin line width for all pieces
-   glLineWidth(1.0f);
-   glColor(black ? RGB_BLACK_OUTLINE : RGB_WHITE_OUTLINE);
-   
-   // Draw outline for each rectangle
+   const int* rgb = black ? RGB_BLACK_OUTLINE : RGB_WHITE_OUTLINE;
    for (int i = 0; i < num; i++)
    {
-      glBegin(GL_LINE_LOOP);
-      glVertex2i(x + rectangle[i].x0, y + rectangle[i].y0);
-      glVertex2i(x + rectangle[i].x1, y + rectangle[i].y1);
-      glVertex2i(x + rectangle[i].x2, y + rectangle[i].y2);
-      glVertex2i(x + rectangle[i].x3, y + rectangle[i].y3);
-      glEnd();
+      int xs[4] = { rectangle[i].x0, rectangle[i].x1, rectangle[i].x2, rectangle[i].x3 };
+      int ys[4] = { rectangle[i].y0, rectangle[i].y1, rectangle[i].y2, rectangle[i].y3 };
+      for (int j = 0; j < 4; j++)
+      {
+         addVertex(pieceLines, rgb, x + xs[j],           y + ys[j]);
+         addVertex(pieceLines, rgb, x + xs[(j + 1) % 4], y + ys[(j + 1) % 4]);
+      }
    }
 }
 
+/************************************************************************
+* FINISH FRAME
+* Draw the highlights, then the pieces on top of them, then their
+* outlines: three calls no matter how many pieces are on the board
+*************************************************************************/
+void ogstream::finishFrame()
+{
+   ALLOC_SCOPE(ALLOC_RENDER, "ogstream::finishFrame");
+   TRACE_SCOPE("ogstream::finishFrame");
+   glEnableClientState(GL_VERTEX_ARRAY);
+   glEnableClientState(GL_COLOR_ARRAY);
+   drawVertices(highlights, GL_QUADS);
+   drawVertices(pieceQuads, GL_QUADS);
+   glLineWidth(1.0f);
+   drawVertices(pieceLines, GL_LINES);
+   glDisableClientState(GL_COLOR_ARRAY);
+   glDisableClientState(GL_VERTEX_ARRAY);
+
+   // start the next frame empty. clear() keeps the memory
+   highlights.clear();
+   pieceQuads.clear();
+   pieceLines.clear();
+}
+
 /************************************************************************
 * DRAW King
 * Draw a king with outline
 *************************************************************************/
 void ogstream::drawKing(const Position& pos, bool black)
 {
-   Rect rectangles[] =
+   static const Rect rectangles[] =
    {
       { 1,8,  -1,8,  -1,1,   1,1},     // cross vertical
       {-3,6,   3,6,   3,4,  -3,4},     // cross horizontal
@@ -249,7 +395,7 @@ void ogstream::drawKing(const Position& pos, bool black)
 *************************************************************************/
 void ogstream::drawQueen(const Position& pos, bool black)
 {
-   Rect rectangles[] =
+   static const Rect rectangles[] =
    {
       { 8,8,   5,8,   5,5,   8,5 },     // right crown jewel
       {-8,8,  -5,8,  -5,5,  -8,5 },     // left crown jewel
@@ -275,7 +421,7 @@ void ogstream::drawQueen(const Position& pos, bool black)
 *************************************************************************/
 void ogstream::drawRook(const Position& pos, bool black)
 {
-   Rect rectangles[] =
+   static const Rect rectangles[] =
    {
       {-8,7,  -8,4,  -4,4,  -4,7},   // left battlement
       { 8,7,   8,4,   4,4,   4,7},   // right battlement
@@ -297,7 +443,7 @@ void ogstream::drawRook(const Position& pos, bool black)
 *************************************************************************/
 void ogstream::drawKnight(const Position& pos, bool black)
 {
-   Rect rectangles[] =
+   static const Rect rectangles[] =
    {
       {-7,3,  -3,6,  -1,3,  -5,0},  // muzzle
       {-2,6,  -2,8,   0,8,   0,3},  // head
@@ -319,7 +465,7 @@ void ogstream::drawKnight(const Position& pos, bool black)
 *************************************************************************/
 void ogstream::drawBishop(const Position& pos, bool black)
 {
-    Rect rectangles[] =
+    static const Rect rectangles[] =
     {
        {-1,8,  -1,2,   1,2,   1,8 },   // center of head
        { 1,8,   1,2,   5,2,   5,5 },   // right part of head
@@ -342,7 +488,7 @@ void ogstream::drawBishop(const Position& pos, bool black)
 *************************************************************************/
 void ogstream::drawPawn(const Position& pos, bool black)
 {
-   Rect rectangles[] =
+   static const Rect rectangles[] =
    {
       { 1,7,  -1,7,  -2,5,  2,5 }, // top of head
       { 3,5,  -3,5,  -3,3,  3,3 }, // bottom of head
@@ -355,6 +501,40 @@ void ogstream::drawPawn(const Position& pos, bool black)
    drawPieceOutline(black, rectangles, 4);
 }
 
+/************************************************************************
+* BUILD BOARD
+* Fill the vertex arrays of the squares and of the two boxes around
+* them: one around the coordinates and one around the edge
+************************************************************************/
+void ogstream::buildBoard()
+{
+   for (int row = 0; row < 8; row++)
+      for (int col = 0; col < 8; col++)
+         addSquare(boardQuads,
+                   (row + col) % 2 == 0 ? RGB_BLACK_SQUARE : RGB_WHITE_SQUARE,
+                   row, col, 1 /*inset*/);
+
+   int inners[2]  = { SIZE_SQUARE / 2, SIZE_SQUARE - 2 };
+   int outters[2] = { 8 * SIZE_SQUARE + SIZE_SQUARE + SIZE_SQUARE / 2,
+                      SIZE_SQUARE + 8 * SIZE_SQUARE + 2 };
+   for (int i = 0; i < 2; i++)
+   {
+      int corners[5][2] =
+      {
+         { inners[i],  inners[i]  },
+         { inners[i],  outters[i] },
+         { outters[i], outters[i] },
+         { outters[i], inners[i]  },
+         { inners[i],  inners[i]  }
+      };
+      for (int j = 0; j < 4; j++)
+      {
+         addVertex(boardLines, RGB_SQUARE, corners[j][0],     corners[j][1]);
+         addVertex(boardLines, RGB_SQUARE, corners[j + 1][0], corners[j + 1][1]);
+      }
+   }
+}
+
 /************************************************************************
 * DRAW BOARD
 * Draw the chess board. Note that all coordinates are in the origional
@@ -363,54 +543,34 @@ void ogstream::drawPawn(const Position& pos, bool black)
 ************************************************************************/
 void ogstream::drawBoard()
 {
-   // draw the squares of the board
-   glBegin(GL_QUADS);
-   for (int row = 0; row < 8; row++)
-      for (int col = 0; col < 8; col++)
-      {
-         // set the checker-board color
-         if ((row + col) % 2 == 0)
-            glColor(RGB_BLACK_SQUARE);
-         else
-            glColor(RGB_WHITE_SQUARE);
-
-         // draw the square
-         Position pos;
-         GLint x0 = (GLint)((col + 0) * SIZE_SQUARE + 1 + SIZE_SQUARE);
-         GLint x1 = (GLint)((col + 1) * SIZE_SQUARE - 1 + SIZE_SQUARE);
-         GLint y0 = (GLint)((row + 0) * SIZE_SQUARE + 1 + SIZE_SQUARE);
-         GLint y1 = (GLint)((row + 1) * SIZE_SQUARE - 1 + SIZE_SQUARE);
-         glVertex2i(x0, y0);
-         glVertex2i(x1, y0);
-         glVertex2i(x1, y1);
-         glVertex2i(x0, y1);
-      }
-   glEnd();
-
-   // draw a box around the coordinates
-   glBegin(GL_LINE_STRIP);
-   glColor(RGB_SQUARE);
-   GLint inner = SIZE_SQUARE / 2;
-   GLint outter = 8 * SIZE_SQUARE + SIZE_SQUARE + SIZE_SQUARE / 2;
-   glVertex2i(inner, inner);
-   glVertex2i(inner, outter);
-   glVertex2i(outter, outter);
-   glVertex2i(outter, inner);
-   glVertex2i(inner, inner);
-   glEnd();
-   
-   // draw a box around the edge
-   inner = SIZE_SQUARE - 2;
-   outter = SIZE_SQUARE + 8 * SIZE_SQUARE + 2;
-   glBegin(GL_LINE_STRIP);
-   glVertex2i(inner, inner);
-   glVertex2i(inner, outter);
-   glVertex2i(outter, outter);
-   glVertex2i(outter, inner);
-   glVertex2i(inner, inner);
-   glEnd();
+   // the squares and the boxes around them never change, so they
+   // are built once and drawn with two calls
+   if (boardQuads.empty())
+      buildBoard();
+   glEnableClientState(GL_VERTEX_ARRAY);
+   glEnableClientState(GL_COLOR_ARRAY);
+   drawVertices(boardQuads, GL_QUADS);
+   drawVertices(boardLines, GL_LINES);
+   glDisableClientState(GL_COLOR_ARRAY);
+   glDisableClientState(GL_VERTEX_ARRAY);
+
+   // the coordinates: compiled the first time, replayed after that
+   if (listLabels == 0)
+   {
+      listLabels = glGenLists(1);
+      glNewList(listLabels, GL_COMPILE);
+      drawLabels();
+      glEndList();
+   }
+   glCallList(listLabels);
+}
 
-   
+/************************************************************************
+* DRAW LABELS
+* The letters and numbers around the board, one glutBitmapCharacter each
+************************************************************************/
+void ogstream::drawLabels()
+{
    // draw the letters along the bottom and the top
    glColor(RGB_LETTERS);
    const GLfloat WIDTH_LETTER  = 4.0;  // width of one letter
@@ -473,28 +633,11 @@ void ogstream::drawSelected(const Position& pos)
    if (pos.isInvalid())
       return;
 
-   // find the row and column
-   int row = pos.getRow();
-   int col = pos.getCol();
-
-   // set the color and drawing style
-   glBegin(GL_QUADS);
-   glColor(RGB_SELECTED);
-
-   // draw the square
-   glVertex2i((GLint)((col + 0) * SIZE_SQUARE + 3 + SIZE_SQUARE),
-              (GLint)((row + 0) * SIZE_SQUARE + 3 + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 1) * SIZE_SQUARE - 3 + SIZE_SQUARE),
-              (GLint)((row + 0) * SIZE_SQUARE + 3 + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 1) * SIZE_SQUARE - 3 + SIZE_SQUARE),
-              (GLint)((row + 1) * SIZE_SQUARE - 3 + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 0) * SIZE_SQUARE + 3 + SIZE_SQUARE),
-              (GLint)((row + 1) * SIZE_SQUARE - 3 + SIZE_SQUARE));
-
-   // indicate we are finished
-   glEnd();
+   // queue the square for finishFrame()
+   addSquare(highlights, RGB_SELECTED, pos.getRow(), pos.getCol(), 3 /*inset*/);
 }
 
+
 /************************************************************************
 * DRAW HOVER
 * Highlight a chess square:
@@ -510,40 +653,14 @@ void ogstream::drawHover(const Position& pos)
    int row = pos.getRow();
    int col = pos.getCol();
 
-   // set the color and drawing style
-   glBegin(GL_QUADS);
-   glColor(RGB_HOVER);
-
-   // draw the square
-   glVertex2i((GLint)((col + 0) * SIZE_SQUARE + SIZE_SQUARE),
-              (GLint)((row + 0) * SIZE_SQUARE + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 1) * SIZE_SQUARE + SIZE_SQUARE),
-              (GLint)((row + 0) * SIZE_SQUARE + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 1) * SIZE_SQUARE + SIZE_SQUARE),
-              (GLint)((row + 1) * SIZE_SQUARE + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 0) * SIZE_SQUARE + SIZE_SQUARE),
-              (GLint)((row + 1) * SIZE_SQUARE + SIZE_SQUARE));
-
-   // set the checker-board color
-   if ((row + col) % 2 == 0)
-      glColor(RGB_BLACK_SQUARE);
-   else
-      glColor(RGB_WHITE_SQUARE);
-
-   // draw the inner square
-   glVertex2i((GLint)((col + 0) * SIZE_SQUARE + 2 + SIZE_SQUARE),
-              (GLint)((row + 0) * SIZE_SQUARE + 2 + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 1) * SIZE_SQUARE - 2 + SIZE_SQUARE),
-              (GLint)((row + 0) * SIZE_SQUARE + 2 + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 1) * SIZE_SQUARE - 2 + SIZE_SQUARE),
-              (GLint)((row + 1) * SIZE_SQUARE - 2 + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 0) * SIZE_SQUARE + 2 + SIZE_SQUARE),
-              (GLint)((row + 1) * SIZE_SQUARE - 2 + SIZE_SQUARE));
-
-   // finish the drawing
-   glEnd();
+   // a frame: the whole square, then the checker-board color inside it
+   addSquare(highlights, RGB_HOVER, row, col, 0 /*inset*/);
+   addSquare(highlights,
+             (row + col) % 2 == 0 ? RGB_BLACK_SQUARE : RGB_WHITE_SQUARE,
+             row, col, 2 /*inset*/);
 }
 
+
 /************************************************************************
 * DRAW POSSIBLE
 * Highlight a chess square:
@@ -555,24 +672,7 @@ void ogstream::drawPossible(const Position& pos)
    if (pos.isInvalid())
       return;
 
-   // find the row and column
-   int row = pos.getRow();
-   int col = pos.getCol();
-
-   // set the color and drawing style
-   glBegin(GL_QUADS);
-   glColor(RGB_POSSIBLE);
-
-   // draw the square
-   glVertex2i((GLint)((col + 0) * SIZE_SQUARE + 7 + SIZE_SQUARE),
-              (GLint)((row + 0) * SIZE_SQUARE + 7 + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 1) * SIZE_SQUARE - 7 + SIZE_SQUARE),
-              (GLint)((row + 0) * SIZE_SQUARE + 7 + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 1) * SIZE_SQUARE - 7 + SIZE_SQUARE),
-              (GLint)((row + 1) * SIZE_SQUARE - 7 + SIZE_SQUARE));
-   glVertex2i((GLint)((col + 0) * SIZE_SQUARE + 7 + SIZE_SQUARE),
-              (GLint)((row + 1) * SIZE_SQUARE - 7 + SIZE_SQUARE));
-
-   // finish the drawing
-   glEnd();
+   // queue the square for finishFrame()
+   addSquare(highlights, RGB_POSSIBLE, pos.getRow(), pos.getCol(), 7 /*inset*/);
 }
+
@@ -8,14 +8,73 @@
  *    of procedural functions here because each draw function does not
  *    retain state. In other words, they are verbs (functions), not nouns
  *    (variables) or a mixture (objects)
+ *
+ *    The board, the highlights, and the pieces are not sent to OpenGL one
+ *    rectangle at a time. They are collected into vertex arrays and drawn
+ *    with a handful of calls when the frame is finished. The text around
+ *    the board is compiled into display lists the first time it is drawn
+ *    and replayed after that.
  ************************************************************************/
 
 #pragma once
 
 #include "position.h"
+#include <vector>     // for the vertex arrays
+#include <map>        // for the cached status messages
 #include <sstream>    // for OSTRINGSTRING
 using std::string;
 
+class PositionTest;
+
+/*************************************************************************
+ * SCREEN
+ * Where the squares are in the window, in pixels. There is a square's
+ * margin around the board, so the window is ten squares across, and a
+ * square is SIZE_SQUARE pixels until the window is resized.
+ *************************************************************************/
+class Screen
+{
+    friend class PositionTest;
+public:
+    static int getX(const Position& pos)
+    {
+        return (int)((double)pos.getCol() * squareWidth + squareWidth);
+    }
+    static int getY(const Position& pos)
+    {
+        return (int)((double)pos.getRow() * squareHeight + squareHeight);
+    }
+
+    // the square under the mouse. y goes down from the top of the window
+    static Position getPosition(double x, double y)
+    {
+        Position pos;
+        int col = (int)(x / squareWidth) - 1;
+        int row = 8 - (int)(y / squareHeight);
+        if (col < 0 || col > 7)
+            pos.colRow = 0xff;
+        else if (row < 0 || row > 7)
+            pos.colRow = 0x3f;
+        else
+            pos.set(col, row);
+        return pos;
+    }
+
+    static double getSquareWidth()  { return squareWidth;  }
+    static double getSquareHeight() { return squareHeight; }
+    static void setBoardWidthHeight(int widthBoard, int heightBoard)
+    {
+        if (widthBoard < 0 || heightBoard < 0)
+            return;
+        squareWidth  = (double)widthBoard  / 10.0; // 8 squares + 2 spaces
+        squareHeight = (double)heightBoard / 10.0;
+    }
+
+private:
+    static double squareWidth;
+    static double squareHeight;
+};
+
  /*************************************************************************
   * GRAPHICS STREAM
   * A graphics stream that behaves much like COUT except on a drawn screen.
@@ -50,11 +109,37 @@ public:
     virtual void drawSelected(const Position& pos);
     virtual void drawHover(   const Position& pos);
     virtual void drawPossible(const Position& pos);
-    virtual void drawGameStatus(const char* message) const;
+    virtual void drawGameStatus(const char* message, int line = 0);
+
+    // Draw the highlights and pieces queued since the last frame
+    virtual void finishFrame();
+
+    // Throw away the cached text, as when the window changes size
+    static void invalidateText();
 
 protected:
     Position position;
 
+    /************************************************************************
+    * VERTEX
+    * One corner of a shape, ready for glDrawArrays
+    *************************************************************************/
+    struct Vertex
+    {
+        short x;
+        short y;
+        unsigned char rgba[4];
+    };
+
+    // the geometry, shared by every way of drawing it
+    void buildBoard();
+
+    std::vector<Vertex> boardQuads;  // the squares: built once
+    std::vector<Vertex> boardLines;  // the two boxes: built once
+    std::vector<Vertex> highlights;  // selected, hover, and possible squares
+    std::vector<Vertex> pieceQuads;  // the pieces of this frame
+    std::vector<Vertex> pieceLines;  // their outlines
+
 private:
 
     /************************************************************************
@@ -73,8 +158,20 @@ private:
         int y3;
     };
 
-    void drawPiece(bool black, Rect rectangle[], int num) const;
-    void drawPieceOutline(bool black, Rect rectangle[], int num) const;
+    void drawPiece(bool black, const Rect rectangle[], int num);
+    void drawPieceOutline(bool black, const Rect rectangle[], int num);
     void drawText(const Position& topLeft, const char* text) const;
     void drawLetter(const Position& topLeft, char letter) const;
+
+    static void addVertex(std::vector<Vertex>& vertices, const int* rgb,
+                          int x, int y);
+    static void addSquare(std::vector<Vertex>& vertices, const int* rgb,
+                          int row, int col, int inset);
+    static void drawVertices(const std::vector<Vertex>& vertices, unsigned int mode);
+    static void drawLabels();
+
+    // display lists belong to the OpenGL context, not to one stream
+    static unsigned int listLabels;                        // 0 if not built
+    static std::map<std::string, unsigned int> listStatus; // one per fixed message
+    static unsigned int listGlyphs;                        // line 1 font, 0 if not built
 };
@@ -13,7 +13,6 @@
 #include <string>     // need you ask?
 #include <sstream>    // convert an integer into text
 #include <cassert>    // I feel the need... the need for asserts
-#include <time.h>     // for clock
 #include <cstdlib>    // for rand()
 
 
@@ -32,7 +31,6 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <Gl/glut.h>           // OpenGL library we copied
-#include <ctime>            // for ::Sleep();
 #include <Windows.h>
 
 #define _USE_MATH_DEFINES
@@ -40,6 +38,7 @@
 #endif // _WIN32
 
 #include "uiInteract.h"
+#include "uiDraw.h"      // for the text cache
 
 using namespace std;
 
@@ -52,50 +51,20 @@ Position      Interface::posHover = -1;
 Position      Interface::posSelect = -1;
 Position      Interface::posSelectPrevious = -1;
 bool          Interface::initialized = false;
-double        Interface::timePeriod = 0.2; // default to 5 frames/second
-unsigned long Interface::nextTick = 0;        // redraw now please
+double        Interface::timePeriod = 0.0; // draw only when something changes
+bool          Interface::timerRunning = false;
 void* Interface::p = NULL;
 void (*Interface::callBack)(Interface*, void*) = NULL;
 char          Interface::key = '\0';
 
-double Position::squareWidth  = (double)SIZE_SQUARE;
-double Position::squareHeight = (double)SIZE_SQUARE;
-
-
-/*********************************************************************
- * SLEEP
- * Pause for a while.  We want to put the program to sleep until it
- * is time to draw again.  Note that this requires us to tell the OS
- * that we are idle.  the nanosleep function performs this task for us
- *   INPUT: msSleep: sleep time in milliseconds
- *********************************************************************/
-void sleep(unsigned long msSleep)
-{
-   // Windows handles sleep one way
-#ifdef _WIN32
-   ::Sleep(msSleep + 35);
-
-   // Unix-based operating systems (OS-X, Linux) do it another
-#else // LINUX, XCODE
-   timespec req = {};
-   time_t sec = (int)(msSleep / 1000);
-   msSleep -= (sec * 1000);
-
-   req.tv_sec = sec;
-   req.tv_nsec = msSleep * 1000000L;
-
-   while (nanosleep(&req, &req) == -1)
-      ;
-#endif // LINUX, XCODE
-   return;
-}
 
 /************************************************************************
  * DRAW CALLBACK
- * This is the main callback from OpenGL. It gets called constantly by
- * the graphics engine to refresh and draw the window.  Here we will
- * clear the background buffer, draw on it, and send it to the forefront
- * when the appropriate time period has passsed.
+ * This is the main callback from OpenGL. It gets called when the window
+ * needs to be drawn: after input, on the animation timer, or when the
+ * window system has lost what was there.  Here we will clear the
+ * background buffer, draw on it, and send it to the forefront.  Between
+ * frames we are idle, so the process uses no CPU.
  *
  * Note: This and all other callbacks can't be member functions, they must
  * have global scope for OpenGL to see them.
@@ -111,13 +80,6 @@ void drawCallback()
    //calls the client's display function
    assert(ui.callBack != NULL);
    ui.callBack(&ui, ui.p);
-   
-   //loop until the timer runs out
-   if (!ui.isTimeToDraw())
-      sleep((unsigned long)((ui.getNextTick() - clock()) / 1000));
-
-   // from this point, set the next draw time
-   ui.setNextDrawTime();
 
    // bring forth the background buffer
    glutSwapBuffers();
@@ -142,14 +104,14 @@ void clickCallback(int button, int state, int x, int y)
       Interface ui;
 
       // get coordinates from screen dimensions
-      Position pos;
-      pos.setXY((double)x, (double)y);
+      Position pos = Screen::getPosition((double)x, (double)y);
 
       // if the current cell is selected, then deselect it
       if (ui.getSelectPosition() == pos)
          ui.clearSelectPosition();
       else
          ui.setSelectPosition(pos);
+      ui.requestRedraw();
    }
 }
 
@@ -164,10 +126,9 @@ void moveCallback(int x, int y)
    // Even though this is a local variable, all the members are static
    // so we are actually getting the same version as in the constructor.
    Interface ui;
-   Position pos;
 
    // get coordinates from screen dimensions
-   pos.setXY((double)x, (double)y);
+   Position pos = Screen::getPosition((double)x, (double)y);
 
    ui.setHoverPosition(pos);
 }
@@ -180,14 +141,18 @@ void moveCallback(int x, int y)
  *************************************************************************/
 void resizeCallback(int width, int height)
 {
-    // Even though this is a local variable, the square_width and square_height
-    // member variables are static.
-    Position pos;
-    pos.setBoardWidthHeight(width, height);
+    // the squares grow and shrink with the window
+    Screen::setBoardWidthHeight(width, height);
 
     // This tells OpenGl to use the original dimensions of the board
     // when drawing, which is SIZE_SQUARE*10 X SIZE_SQUARE*10 
     glViewport(0, 0, width, height);
+
+    // the cached text was laid out for the old size
+    ogstream::invalidateText();
+
+    Interface ui;
+    ui.requestRedraw();
 }
 
 /************************************************************************
@@ -200,35 +165,47 @@ void closeCallback()
 }
 
 /************************************************************************
- * INTEFACE : IS TIME TO DRAW
- * Have we waited long enough to draw swap the background buffer with
- * the foreground buffer?
+ * INTERFACE : REQUEST REDRAW
+ * Something on the screen changed.  GLUT merges the requests, so we draw
+ * one frame the next time it gets around to it
  *************************************************************************/
-bool Interface::isTimeToDraw()
+void Interface::requestRedraw()
 {
-   return ((unsigned int)clock() >= nextTick);
+   if (initialized)
+      glutPostRedisplay();
 }
 
 /************************************************************************
- * INTERFACE : SET NEXT DRAW TIME
- * What time should we draw the buffer again?  This is a function of
- * the current time and the frames per second.
+ * TIMER CALLBACK
+ * Draw a frame and, if the timer is still wanted, schedule the next one
  *************************************************************************/
-void Interface::setNextDrawTime()
+void timerCallback(int /*value*/)
 {
-   nextTick = clock() + static_cast<unsigned long> (timePeriod * CLOCKS_PER_SEC);
+   Interface ui;
+   ui.timerRunning = false;
+   if (ui.frameRate() <= 0.0)
+      return;
+
+   ui.requestRedraw();
+   ui.timerRunning = true;
+   glutTimerFunc((unsigned int)(ui.frameRate() * 1000.0), timerCallback, 0);
 }
 
 /************************************************************************
  * INTERFACE : SET FRAMES PER SECOND
- * The frames per second dictates the speed of the game.  The more frames
- * per second, the quicker the game will appear to the user.  We will default
- * to 30 frames/second but the client can set this at will.
- *    INPUT  value        The number of frames per second.  5 is default
+ * Frames are normally only drawn when something changes.  Animations need
+ * more than that, so this starts a timer that draws value frames a second.
+ *    INPUT  value        The number of frames per second.  0, the default,
+ *                        stops the timer
  *************************************************************************/
 void Interface::setFramesPerSecond(double value)
 {
-    timePeriod = (1.0 / value);
+   timePeriod = value > 0.0 ? 1.0 / value : 0.0;
+   if (timePeriod > 0.0 && initialized && !timerRunning)
+   {
+      timerRunning = true;
+      glutTimerFunc((unsigned int)(timePeriod * 1000.0), timerCallback, 0);
+   }
 }
 
 /***************************************************************
@@ -242,6 +219,7 @@ void keyboardCallback(unsigned char key, int x, int y)
    // so we are actually getting the same version as in the constructor.
    Interface ui;
    ui.keyEvent(key, true /*fDown*/);
+   ui.requestRedraw();
 }
 
 /***************************************************************
@@ -282,9 +260,8 @@ void Interface::initialize(const char * title)
    // create the window
    int argc = 0;
    glutInit(&argc, NULL);
-   Position pos;
-   int xMax = 10 * (int)pos.getSquareWidth();
-   int yMax = 10 * (int)pos.getSquareHeight();
+   int xMax = 10 * (int)Screen::getSquareWidth();
+   int yMax = 10 * (int)Screen::getSquareHeight();
    glutInitWindowSize(xMax, yMax); //  size ofthe window
             
    glutInitWindowPosition( 10, 10);                // initial position 
@@ -299,7 +276,6 @@ void Interface::initialize(const char * title)
 
    // register the callbacks so OpenGL knows how to call us
    glutDisplayFunc(       drawCallback    );
-   glutIdleFunc(          drawCallback    );
    glutMouseFunc(         clickCallback   );
    glutPassiveMotionFunc( moveCallback    );
    glutReshapeFunc(       resizeCallback  );
@@ -309,6 +285,10 @@ void Interface::initialize(const char * title)
    glutWMCloseFunc(      closeCallback   );
 #endif 
    initialized = true;
+
+   // a timer asked for before the window existed starts now
+   if (timePeriod > 0.0)
+      setFramesPerSecond(1.0 / timePeriod);
    
    // done
    return;
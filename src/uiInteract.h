@@ -12,6 +12,9 @@
  *    3. callback     - Specified in Run, this user-provided
  *                      function will get called with every frame
  *    4. isDown()     - Is a given key pressed on this loop?
+ *    Frames are only drawn when something changes: input events
+ *    and requestRedraw() ask for one. setFramesPerSecond() adds a
+ *    timer for animations.
  **********************************************/
 
 #pragma once
@@ -25,6 +28,7 @@
  ********************************************/
 class Interface
 {
+   friend void timerCallback(int value);
 public:
    Interface() {}
    // Constructor if you want to set up the window with anything but
@@ -37,24 +41,20 @@ public:
    // This will set the game in motion
    void run(void (*callBack)(Interface*, void*), void* p);
 
-   // Is it time to redraw the screen
-   bool isTimeToDraw();
-
-   // Set the next draw time based on current time and time period
-   void setNextDrawTime();
-
-   // Retrieve the next tick time... the time of the next draw.
-   unsigned long getNextTick() { return nextTick; };
+   // Ask for another frame. Several requests before the next
+   // frame is drawn result in just one frame
+   void requestRedraw();
 
    char getKey()         const { return key;     }
    
    void keyEvent(int key, bool fDown);
    void resetKey();
    
-   // How many frames per second are we configured for?
+   // Also redraw on a timer, for animations. 0 turns the timer off,
+   // which is the default: we then only draw when something changes
    void setFramesPerSecond(double value);
 
-   // Current frame rate
+   // Time between timed frames, or 0 if there is no timer
    double frameRate() const { return timePeriod; };
 
    Position  getSelectPosition()   const { return posSelect; }
@@ -79,6 +79,8 @@ public:
 
    void setHoverPosition(const Position & pos)
    {
+      if (pos != posHover)
+         requestRedraw();
       posHover = pos;
    }
 
@@ -89,8 +91,8 @@ private:
    void initialize(const char* title);
 
    static bool         initialized;    // only run the constructor once!
-   static double       timePeriod;     // interval between frame draws
-   static unsigned long nextTick;      // time (from clock()) of our next draw
+   static double       timePeriod;     // interval between timed frames
+   static bool         timerRunning;   // is a timer callback pending?
 
    static Position  posHover;          // mouse hover position in chess coordinates
    static Position  posSelect;         // mouse clicked position in chess coordinates
@@ -106,6 +108,12 @@ private:
  ***************************************************************/
 void keyboardCallback(unsigned char key, int x, int y);
 
+/***************************************************************
+ * TIMER CALLBACK
+ * Draw a frame on the animation timer
+ ***************************************************************/
+void timerCallback(int value);
+
 /************************************************************************
  * RUN
  * Set the game in action.  We will get control back in our drawCallback
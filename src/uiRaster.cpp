@@ -0,0 +1,516 @@
+/***********************************************************************
+ * Source File:
+ *    USER INTERFACE RASTER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Software rendering of the board into an RGBA framebuffer, and
+ *    the PPM and PNG writers for the result
+ ************************************************************************/
+
+#include "uiRaster.h"
+#include <fstream>
+#include <algorithm>
+#include <cassert>
+using namespace std;
+
+// the colors of the text, as uiDraw.cpp has them
+const int RGB_RASTER_LETTERS[] = { 100, 100, 100 };
+const int RGB_RASTER_STATUS[]  = { 220, 20, 60 };
+
+// every character is five pixels wide and seven high
+const int FONT_WIDTH   = 5;
+const int FONT_HEIGHT  = 7;
+const int FONT_ADVANCE = 6;
+
+/***************************************************
+ * FONT
+ * A 5x7 bitmap per character, top row first, the
+ * high bit of each row on the left. Lower-case letters
+ * we have no glyph for are drawn in upper case
+ ***************************************************/
+struct Glyph
+{
+   char    letter;
+   uint8_t rows[FONT_HEIGHT];
+};
+
+static const Glyph FONT[] =
+{
+   { '!', { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04 } },
+   { '-', { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 } },
+   { '.', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C } },
+   { '0', { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E } },
+   { '1', { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+   { '2', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F } },
+   { '3', { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E } },
+   { '4', { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 } },
+   { '5', { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E } },
+   { '6', { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E } },
+   { '7', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+   { '8', { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E } },
+   { '9', { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C } },
+   { 'A', { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+   { 'B', { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E } },
+   { 'C', { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E } },
+   { 'D', { 0x1E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1E } },
+   { 'E', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F } },
+   { 'F', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 } },
+   { 'G', { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F } },
+   { 'H', { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+   { 'I', { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+   { 'J', { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C } },
+   { 'K', { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } },
+   { 'L', { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F } },
+   { 'M', { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+   { 'N', { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 } },
+   { 'O', { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+   { 'P', { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 } },
+   { 'Q', { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D } },
+   { 'R', { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+   { 'S', { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E } },
+   { 'T', { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+   { 'U', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+   { 'V', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 } },
+   { 'W', { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A } },
+   { 'X', { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 } },
+   { 'Y', { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 } },
+   { 'Z', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F } },
+   { 'a', { 0x00, 0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F } },
+   { 'b', { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E } },
+   { 'c', { 0x00, 0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E } },
+   { 'd', { 0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F } },
+   { 'e', { 0x00, 0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E } },
+   { 'f', { 0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08 } },
+   { 'g', { 0x00, 0x0F, 0x11, 0x11, 0x0F, 0x01, 0x0E } },
+   { 'h', { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11 } }
+};
+
+/***************************************************
+ * FIND GLYPH
+ * The bitmap of a character, or null if we have none
+ ***************************************************/
+static const Glyph* findGlyph(char letter)
+{
+   for (const Glyph& glyph : FONT)
+      if (glyph.letter == letter)
+         return &glyph;
+   if (letter >= 'a' && letter <= 'z')
+      return findGlyph((char)(letter - 'a' + 'A'));
+   return nullptr;
+}
+
+/***************************************************
+ * TO RGBA
+ * The same bytes glColor() in uiDraw.cpp ends up with
+ ***************************************************/
+static void toRGBA(const int* rgb, unsigned char rgba[4])
+{
+   for (int i = 0; i < 3; i++)
+      rgba[i] = (unsigned char)(rgb[i] * 255 / 256.0 + 0.5);
+   rgba[3] = 255;
+}
+
+/*************************************************************************
+ * RASTER : CONSTRUCT
+ *************************************************************************/
+ogstreamRaster::ogstreamRaster(int width, int height) :
+   width(width), height(height), pixels((size_t)width * height * 4)
+{
+   assert(width > 0 && height > 0);
+   clear();
+}
+
+/*************************************************************************
+ * RASTER : CLEAR
+ * Opaque black, as the window is cleared before each frame
+ *************************************************************************/
+void ogstreamRaster::clear()
+{
+   for (size_t i = 0; i < pixels.size(); i += 4)
+   {
+      pixels[i + 0] = 0;
+      pixels[i + 1] = 0;
+      pixels[i + 2] = 0;
+      pixels[i + 3] = 255;
+   }
+}
+
+/*************************************************************************
+ * RASTER : GET PIXEL
+ *************************************************************************/
+void ogstreamRaster::getPixel(int x, int y, uint8_t rgba[4]) const
+{
+   assert(x >= 0 && x < width && y >= 0 && y < height);
+   const uint8_t* p = &pixels[((size_t)y * width + x) * 4];
+   for (int i = 0; i < 4; i++)
+      rgba[i] = p[i];
+}
+
+/*************************************************************************
+ * RASTER : FILL TRIANGLE
+ * Every pixel whose center is inside the triangle. Pixels on an edge go
+ * to the triangle on its left or top so shared edges are drawn once.
+ * Coordinates are doubled so that pixel centers are integers too
+ *************************************************************************/
+void ogstreamRaster::fillTriangle(const Vertex& a, const Vertex& b, const Vertex& c)
+{
+   long ax = 2 * a.x, ay = 2 * a.y;
+   long bx = 2 * b.x, by = 2 * b.y;
+   long cx = 2 * c.x, cy = 2 * c.y;
+
+   // make it counter-clockwise
+   long area = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+   if (area == 0)
+      return;
+   if (area < 0)
+   {
+      std::swap(bx, cx);
+      std::swap(by, cy);
+   }
+
+   // the pixels that might be covered
+   int xMin = max(0,          (int)min({ a.x, b.x, c.x }));
+   int xMax = min(width - 1,  (int)max({ a.x, b.x, c.x }));
+   int yMin = max(0,          (int)min({ a.y, b.y, c.y }));
+   int yMax = min(height - 1, (int)max({ a.y, b.y, c.y }));
+
+   // an edge owns its pixels if it is a top or a left edge
+   long ex[3] = { bx - ax, cx - bx, ax - cx };
+   long ey[3] = { by - ay, cy - by, ay - cy };
+   long ox[3] = { ax, bx, cx };
+   long oy[3] = { ay, by, cy };
+   long bias[3];
+   for (int i = 0; i < 3; i++)
+   {
+      bool topLeft = (ey[i] == 0 && ex[i] < 0) || ey[i] < 0;
+      bias[i] = topLeft ? 0 : -1;
+   }
+
+   for (int y = yMin; y <= yMax; y++)
+      for (int x = xMin; x <= xMax; x++)
+      {
+         long px = 2 * x + 1;
+         long py = 2 * y + 1;
+         bool inside = true;
+         for (int i = 0; i < 3 && inside; i++)
+            inside = ex[i] * (py - oy[i]) - ey[i] * (px - ox[i]) + bias[i] >= 0;
+         if (inside)
+            plot(x, y, a.rgba);
+      }
+}
+
+/*************************************************************************
+ * RASTER : FILL QUADS
+ * Each four vertices are one convex quad, split into two triangles
+ *************************************************************************/
+void ogstreamRaster::fillQuads(const vector<Vertex>& vertices)
+{
+   for (size_t i = 0; i + 3 < vertices.size(); i += 4)
+   {
+      fillTriangle(vertices[i], vertices[i + 1], vertices[i + 2]);
+      fillTriangle(vertices[i], vertices[i + 2], vertices[i + 3]);
+   }
+}
+
+/***************************************************
+ * CEILING DIVIDE
+ * The smallest integer at least num / den, den > 0
+ ***************************************************/
+static long ceilDivide(long num, long den)
+{
+   return num >= 0 ? (num + den - 1) / den : -((-num) / den);
+}
+
+/*************************************************************************
+ * RASTER : DRAW LINES
+ * Each two vertices are a one-pixel line. The line covers the pixels
+ * between its ends along the longer axis, start included and end left
+ * off. Across it, we take the pixel the line passes through at each
+ * pixel center, the lower one when it falls exactly between two
+ *************************************************************************/
+void ogstreamRaster::drawLines(const vector<Vertex>& vertices)
+{
+   for (size_t i = 0; i + 1 < vertices.size(); i += 2)
+   {
+      long x0 = vertices[i].x;
+      long y0 = vertices[i].y;
+      long x1 = vertices[i + 1].x;
+      long y1 = vertices[i + 1].y;
+      bool xMajor = labs(x1 - x0) >= labs(y1 - y0);
+
+      // step along the major axis, from the low end
+      long major0 = xMajor ? x0 : y0;
+      long minor0 = xMajor ? y0 : x0;
+      long major1 = xMajor ? x1 : y1;
+      long minor1 = xMajor ? y1 : x1;
+      if (major1 < major0)
+      {
+         std::swap(major0, major1);
+         std::swap(minor0, minor1);
+      }
+
+      long dMajor = major1 - major0;
+      long dMinor = minor1 - minor0;
+      for (long major = major0; major < major1; major++)
+      {
+         // minor coordinate at the pixel center, as a fraction over 2 * dMajor
+         long num = 2 * minor0 * dMajor + dMinor * (2 * (major - major0) + 1);
+         long minor = ceilDivide(num, 2 * dMajor) - 1;
+         if (xMajor)
+            plot((int)major, (int)minor, vertices[i].rgba);
+         else
+            plot((int)minor, (int)major, vertices[i].rgba);
+      }
+   }
+}
+
+/*************************************************************************
+ * RASTER : DRAW STRING
+ * Characters sit on the baseline at (x, y), each scale pixels square
+ *************************************************************************/
+void ogstreamRaster::drawString(int x, int y, const char* text,
+                                const int* rgb, int scale)
+{
+   unsigned char rgba[4];
+   toRGBA(rgb, rgba);
+   for (const char* p = text; *p; p++, x += FONT_ADVANCE * scale)
+   {
+      const Glyph* pGlyph = findGlyph(*p);
+      if (!pGlyph)
+         continue;
+      for (int row = 0; row < FONT_HEIGHT; row++)
+         for (int col = 0; col < FONT_WIDTH; col++)
+            if (pGlyph->rows[row] & (0x10 >> col))
+               for (int i = 0; i < scale; i++)
+                  for (int j = 0; j < scale; j++)
+                     plot(x + col * scale + i,
+                          y + (FONT_HEIGHT - 1 - row) * scale + j, rgba);
+   }
+}
+
+/*************************************************************************
+ * RASTER : FLUSH
+ * Text written with << goes in the letters' color, one line per row
+ *************************************************************************/
+void ogstreamRaster::flush()
+{
+   string text = str();
+   size_t start = 0;
+   while (start < text.size())
+   {
+      size_t end = text.find('\n', start);
+      if (end == string::npos)
+         end = text.size();
+      drawString(Screen::getX(position), Screen::getY(position),
+                 text.substr(start, end - start).c_str(), RGB_RASTER_LETTERS, 1);
+      position.adjustRow(-1);
+      start = end + 1;
+   }
+   str("");
+}
+
+/*************************************************************************
+ * RASTER : DRAW BOARD
+ * The squares, the boxes around them, and the coordinates
+ *************************************************************************/
+void ogstreamRaster::drawBoard()
+{
+   if (boardQuads.empty())
+      buildBoard();
+   fillQuads(boardQuads);
+   drawLines(boardLines);
+
+   // a-h along the bottom and the top, 1-8 along the sides
+   const int TEXT_MARGIN = 2;
+   for (int i = 0; i < 8; i++)
+   {
+      char letter[2] = { (char)('a' + i), '\0' };
+      char number[2] = { (char)('1' + i), '\0' };
+      int center = SIZE_SQUARE + i * SIZE_SQUARE + SIZE_SQUARE / 2;
+      drawString(center - FONT_WIDTH / 2, TEXT_MARGIN,
+                 letter, RGB_RASTER_LETTERS, 1);
+      drawString(center - FONT_WIDTH / 2, 10 * SIZE_SQUARE - TEXT_MARGIN - FONT_HEIGHT,
+                 letter, RGB_RASTER_LETTERS, 1);
+      drawString(TEXT_MARGIN, center - FONT_HEIGHT / 2,
+                 number, RGB_RASTER_LETTERS, 1);
+      drawString(10 * SIZE_SQUARE - TEXT_MARGIN - FONT_WIDTH, center - FONT_HEIGHT / 2,
+                 number, RGB_RASTER_LETTERS, 1);
+   }
+}
+
+/*************************************************************************
+ * RASTER : DRAW GAME STATUS
+ * Large text centered in the top margin, or for line 1, small text
+ * centered between the board and the letters below it
+ *************************************************************************/
+void ogstreamRaster::drawGameStatus(const char* message, int line)
+{
+   const int scale = (line == 0) ? 2 : 1;
+   int length = 0;
+   for (const char* p = message; *p; p++)
+      length += FONT_ADVANCE * scale;
+   int y = (line == 0) ? (int)(SIZE_SQUARE * 8.75) : (int)(SIZE_SQUARE * 0.55);
+   drawString((int)(SIZE_SQUARE * 5.5) - length / 2, y,
+              message, RGB_RASTER_STATUS, scale);
+}
+
+/*************************************************************************
+ * RASTER : FINISH FRAME
+ * The highlights, the pieces, and their outlines, in that order
+ *************************************************************************/
+void ogstreamRaster::finishFrame()
+{
+   fillQuads(highlights);
+   fillQuads(pieceQuads);
+   drawLines(pieceLines);
+
+   highlights.clear();
+   pieceQuads.clear();
+   pieceLines.clear();
+}
+
+/*************************************************************************
+ * RASTER : WRITE PPM
+ * The binary form: a short text header and then RGB bytes
+ *************************************************************************/
+void ogstreamRaster::writePPM(ostream& out) const
+{
+   out << "P6\n" << width << " " << height << "\n255\n";
+   for (int y = height - 1; y >= 0; y--)
+      for (int x = 0; x < width; x++)
+         out.write((const char*)&pixels[((size_t)y * width + x) * 4], 3);
+}
+
+/***************************************************
+ * CRC 32
+ * The checksum PNG puts on every chunk
+ ***************************************************/
+static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t size)
+{
+   static uint32_t table[256];
+   static bool initialized = false;
+   if (!initialized)
+   {
+      for (uint32_t n = 0; n < 256; n++)
+      {
+         uint32_t c = n;
+         for (int k = 0; k < 8; k++)
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+         table[n] = c;
+      }
+      initialized = true;
+   }
+
+   crc = ~crc;
+   for (size_t i = 0; i < size; i++)
+      crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+   return ~crc;
+}
+
+/***************************************************
+ * PUT BIG
+ * PNG integers are big-endian
+ ***************************************************/
+static void putBig(vector<uint8_t>& out, uint32_t value)
+{
+   out.push_back((uint8_t)(value >> 24));
+   out.push_back((uint8_t)(value >> 16));
+   out.push_back((uint8_t)(value >> 8));
+   out.push_back((uint8_t)(value));
+}
+
+/***************************************************
+ * WRITE CHUNK
+ * Length, type, data, and the CRC of type and data
+ ***************************************************/
+static void writeChunk(ostream& out, const char* type, const vector<uint8_t>& data)
+{
+   vector<uint8_t> chunk;
+   putBig(chunk, (uint32_t)data.size());
+   chunk.insert(chunk.end(), type, type + 4);
+   chunk.insert(chunk.end(), data.begin(), data.end());
+   putBig(chunk, crc32(0, chunk.data() + 4, chunk.size() - 4));
+   out.write((const char*)chunk.data(), chunk.size());
+}
+
+/*************************************************************************
+ * RASTER : WRITE PNG
+ * An RGBA PNG. The image data is a zlib stream of stored (uncompressed)
+ * deflate blocks: larger than it could be, but quick to write and it
+ * needs no compression library
+ *************************************************************************/
+void ogstreamRaster::writePNG(ostream& out) const
+{
+   static const uint8_t SIGNATURE[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+   out.write((const char*)SIGNATURE, sizeof(SIGNATURE));
+
+   // IHDR: size, 8 bits per channel, RGBA, no interlace
+   vector<uint8_t> header;
+   putBig(header, (uint32_t)width);
+   putBig(header, (uint32_t)height);
+   header.push_back(8);
+   header.push_back(6);
+   header.push_back(0);
+   header.push_back(0);
+   header.push_back(0);
+   writeChunk(out, "IHDR", header);
+
+   // the scanlines, top first, each with filter type 0
+   vector<uint8_t> raw;
+   raw.reserve((size_t)height * (width * 4 + 1));
+   for (int y = height - 1; y >= 0; y--)
+   {
+      raw.push_back(0);
+      const uint8_t* row = &pixels[(size_t)y * width * 4];
+      raw.insert(raw.end(), row, row + width * 4);
+   }
+
+   // IDAT: zlib header, stored blocks of up to 65535 bytes, Adler-32
+   vector<uint8_t> data;
+   data.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+   data.push_back(0x78);
+   data.push_back(0x01);
+   for (size_t i = 0; i < raw.size(); i += 65535)
+   {
+      size_t size = min(raw.size() - i, (size_t)65535);
+      data.push_back(i + size == raw.size() ? 1 : 0);
+      data.push_back((uint8_t)(size & 0xff));
+      data.push_back((uint8_t)(size >> 8));
+      data.push_back((uint8_t)(~size & 0xff));
+      data.push_back((uint8_t)((~size >> 8) & 0xff));
+      data.insert(data.end(), raw.begin() + i, raw.begin() + i + size);
+   }
+   uint32_t s1 = 1;
+   uint32_t s2 = 0;
+   for (uint8_t byte : raw)
+   {
+      s1 = (s1 + byte) % 65521;
+      s2 = (s2 + s1) % 65521;
+   }
+   putBig(data, (s2 << 16) | s1);
+   writeChunk(out, "IDAT", data);
+
+   writeChunk(out, "IEND", vector<uint8_t>());
+}
+
+/*************************************************************************
+ * RASTER : WRITE
+ * PNG if the name ends in .png, otherwise PPM
+ *************************************************************************/
+void ogstreamRaster::write(const string& fileName) const
+{
+   ofstream fout(fileName.c_str(), ios::binary);
+   if (fout.fail())
+      throw string("Unable to open ") + fileName + " for writing";
+
+   bool isPNG = fileName.size() > 4 &&
+                fileName.compare(fileName.size() - 4, 4, ".png") == 0;
+   if (isPNG)
+      writePNG(fout);
+   else
+      writePPM(fout);
+
+   if (fout.fail())
+      throw string("Unable to write ") + fileName;
+}
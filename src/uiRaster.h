@@ -0,0 +1,79 @@
+/***********************************************************************
+ * Header File:
+ *    USER INTERFACE RASTER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A graphics stream that draws into memory instead of an OpenGL
+ *    window. It takes the same geometry ogstream builds, fills it into
+ *    an RGBA framebuffer in software, and writes the result as a PPM or
+ *    PNG image. No display or GPU is needed, so it suits rendering
+ *    diagrams in bulk, and since the output does not depend on a driver
+ *    it is exactly the same from run to run.
+ ************************************************************************/
+
+#pragma once
+
+#include "uiDraw.h"   // because we draw the same things as ogstream
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <iostream>
+
+class TestRaster;
+
+/*************************************************************************
+ * RASTER GRAPHICS STREAM
+ * An ogstream that renders into an in-memory framebuffer. Like OpenGL,
+ * the origin is the bottom-left corner and y goes up
+ *************************************************************************/
+class ogstreamRaster : public ogstream
+{
+   friend TestRaster;
+public:
+   // the default size matches the window: a square margin on each side
+   ogstreamRaster(int width  = 10 * SIZE_SQUARE,
+                  int height = 10 * SIZE_SQUARE);
+   ~ogstreamRaster() { flush(); }
+
+   // start a new image: the whole framebuffer goes black
+   void clear();
+
+   // the ogstream methods that touch the screen
+   void flush();
+   void drawBoard();
+   void drawGameStatus(const char* message, int line = 0);
+   void finishFrame();
+
+   // the image
+   int            getWidth()  const { return width;  }
+   int            getHeight() const { return height; }
+   const uint8_t* getPixels() const { return pixels.data(); }
+   void           getPixel(int x, int y, uint8_t rgba[4]) const;
+
+   // write it out, top row first. Throws a string on error
+   void writePPM(std::ostream& out) const;
+   void writePNG(std::ostream& out) const;
+   void write(const std::string& fileName) const;   // by extension
+
+private:
+   void fillQuads(const std::vector<Vertex>& vertices);
+   void fillTriangle(const Vertex& a, const Vertex& b, const Vertex& c);
+   void drawLines(const std::vector<Vertex>& vertices);
+   void drawString(int x, int y, const char* text, const int* rgb, int scale);
+   void plot(int x, int y, const unsigned char rgba[4])
+   {
+      if (x >= 0 && x < width && y >= 0 && y < height)
+      {
+         uint8_t* p = &pixels[((size_t)y * width + x) * 4];
+         p[0] = rgba[0];
+         p[1] = rgba[1];
+         p[2] = rgba[2];
+         p[3] = rgba[3];
+      }
+   }
+
+   int width;
+   int height;
+   std::vector<uint8_t> pixels;    // RGBA, bottom row first
+};
@@ -19,17 +19,39 @@
 
 #define assertEquals(value, test) assertUnitParameters(closeEnough(value, test), #test, __LINE__, __FUNCTION__)
 #define assertUnit(condition)              assertUnitParameters(condition, #condition, __LINE__, __FUNCTION__)
+#define timeTest(test)                     timeTestParameters([this]() { test(); }, #test)
 
 #include <iostream>  // for std::cerr
 #include <iomanip>   // for std::setw
 #include <string>    // for std::string
 #include <vector>    // for std::vector
 #include <map>       // for std::map
+#include <chrono>    // for std::chrono::steady_clock
+
+/*************************************************************
+ * TEST TIME
+ * How long one test took, in milliseconds of wall time
+ *************************************************************/
+struct TestTime
+{
+   std::string suite;
+   std::string test;
+   double      milliseconds;
+};
 
 class UnitTest
 {
 public:
    UnitTest() { reset(); }
+
+   // how many tests have failed in the reports so far
+   int getNumFailed() const { return numFailed; }
+
+   // how long each test took, for the reports so far
+   const std::vector<TestTime>& getTimes() const { return times; }
+
+   // where report() writes. A suite on a worker thread gets its own
+   void setOutput(std::ostream& out) { pOut = &out; }
    
 private:
    // a test failure is a failure string and a line number
@@ -42,6 +64,15 @@ private:
    // each test has a name (the key) and the list of failures(value).
    std::map<std::string, std::vector<Failure>> tests;
 
+   // failures from earlier calls to report()
+   int numFailed = 0;
+
+   // each test is charged the time from its call to its return, so
+   // work a run() does between the tests is charged to none of them
+   std::map<std::string, double> elapsed;
+   std::vector<TestTime> times;
+   std::ostream* pOut = &std::cout;
+
 protected:
 
    // for closeEnough() and assertEquals(), what is the tolerance?
@@ -61,6 +92,7 @@ protected:
    void reset()
    {
       tests.clear();
+      elapsed.clear();
    }
    
    /*************************************************************
@@ -73,19 +105,19 @@ protected:
       for (auto & test : tests)
          if (!test.second.empty())
          {
-            std::cout << "\t" << test.first << "()\n";
+            (*pOut) << "\t" << test.first << "()\n";
             for (auto & failure : test.second)
-               std::cout << "\t\tline:"   << failure.lineNumber
-                         << " condition:" << failure.failure << "\n";
+               (*pOut) << "\t\tline:"   << failure.lineNumber
+                       << " condition:" << failure.failure << "\n";
          }
 
       // name the test case
-      std::cout << std::left << std::setw(15) << name << ":\t";
+      (*pOut) << std::left << std::setw(15) << name << ":\t";
 
       // handle the no test case
       if (tests.empty())
       {
-         std::cout << "There were no tests]\n";
+         (*pOut) << "There were no tests]\n";
          return;
       }
 
@@ -94,15 +126,20 @@ protected:
       for (auto& test : tests)
          numSuccess += (test.second.empty() ? 1 : 0);
       double successRate = (double)numSuccess / (double)tests.size();
+      numFailed += (int)tests.size() - numSuccess;
 
       // display the summary
-      std::cout.setf(std::ios::fixed | std::ios::showpoint);
-      std::cout.precision(1);
-      std::cout << "There were "
+      pOut->setf(std::ios::fixed | std::ios::showpoint);
+      pOut->precision(1);
+      (*pOut) << "There were "
          << tests.size()
          << " tests run for a success rate of: "
          << (successRate * 100.0) << "%\n";
 
+      // keep the times for the caller
+      for (auto& test : elapsed)
+         times.push_back(TestTime{ name, test.first, test.second });
+
       // after we have reported, the reset for the next report
       reset();
    }
@@ -128,6 +165,19 @@ protected:
          tests[sFunc];
       }
    }
+
+   /*************************************************************
+    * TIME TEST PARAMETERS
+    * Run one test, charging it the wall time of the call
+    *************************************************************/
+   template <class Test>
+   void timeTestParameters(Test test, const char* name)
+   {
+      auto start = std::chrono::steady_clock::now();
+      test();
+      auto stop = std::chrono::steady_clock::now();
+      elapsed[name] += std::chrono::duration<double, std::milli>(stop - start).count();
+   }
    
 
 };